@@ -0,0 +1,23 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Meta-header for the \link alignment alignment module \endlink.
+ */
+
+#pragma once
+
+#include <bio/alignment/chain.hpp>
+#include <bio/alignment/coverage.hpp>
+#include <bio/alignment/msa_profile.hpp>
+#include <bio/alignment/pileup.hpp>
+
+/*!\defgroup alignment Alignment
+ * \brief The alignment module provides kernels that operate on alignments of sequences.
+ *
+ * Alignments are represented with the types of the other modules, e.g. rows over bio::alphabet::gapped letters
+ * stored in a bio::ranges::concatenated_sequences.
+ */
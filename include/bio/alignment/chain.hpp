@@ -0,0 +1,518 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::alignment::chainer, bio::alignment::chain_all and bio::alignment::classify_overlap.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace bio::alignment
+{
+
+/*!\brief An exact match (e.g. of a minimizer) between a query and a target sequence.
+ * \ingroup alignment
+ */
+struct anchor
+{
+    //!\brief The position of the first letter in the query.
+    uint32_t query  = 0;
+    //!\brief The position of the first letter in the target.
+    uint32_t target = 0;
+    //!\brief The length of the match.
+    uint32_t length = 0;
+
+    //!\brief Anchors are equal if their members are equal.
+    friend bool operator==(anchor const &, anchor const &) = default;
+};
+
+/*!\brief A colinear chain of anchors.
+ * \ingroup alignment
+ */
+struct chain
+{
+    //!\brief The score of the chain.
+    int32_t  score        = 0;
+    //!\brief The number of anchors.
+    uint32_t anchors      = 0;
+    //!\brief The first query position covered by the chain.
+    uint32_t query_begin  = 0;
+    //!\brief One past the last query position covered by the chain.
+    uint32_t query_end    = 0;
+    //!\brief The first target position covered by the chain.
+    uint32_t target_begin = 0;
+    //!\brief One past the last target position covered by the chain.
+    uint32_t target_end   = 0;
+
+    //!\brief Chains are equal if their members are equal.
+    friend bool operator==(chain const &, chain const &) = default;
+};
+
+/*!\brief The dynamic programming algorithm of bio::alignment::chainer.
+ * \ingroup alignment
+ */
+enum class chaining_mode
+{
+    //!\brief Every anchor looks at a bounded number of predecessors; concave gap costs (see bio::alignment::chainer).
+    lookback,
+    //!\brief Range maximum queries over all predecessors in `O(n log n)`; linear distance costs.
+    range_max,
+    //!\brief bio::alignment::chaining_mode::range_max for lists of at least
+    //!       bio::alignment::chaining_options::range_max_threshold anchors, lookback otherwise.
+    automatic
+};
+
+/*!\brief Options for bio::alignment::chainer.
+ * \ingroup alignment
+ */
+struct chaining_options
+{
+    //!\brief The largest distance between consecutive anchors, on the query and on the target.
+    uint32_t      max_distance        = 5'000;
+    //!\brief The largest difference between the query and target distances of consecutive anchors (lookback).
+    uint32_t      max_skew            = 500;
+    //!\brief The number of preceding anchors (in target order) that are considered as predecessors (lookback).
+    size_t        max_lookback        = 50;
+    //!\brief The cost of the difference of the distances, per 100 letters (lookback; plus a logarithmic term).
+    uint32_t      gap_cost            = 15;
+    //!\brief The cost of the sum of the query and target distances, per 100 letters (range_max).
+    uint32_t      distance_cost       = 1;
+    //!\brief The algorithm.
+    chaining_mode mode                = chaining_mode::automatic;
+    //!\brief The number of anchors from which bio::alignment::chaining_mode::automatic uses range_max.
+    size_t        range_max_threshold = 10'000;
+    //!\brief Chains with a smaller score are discarded.
+    int32_t       min_score           = 40;
+    //!\brief Chains with fewer anchors are discarded.
+    uint32_t      min_anchors         = 3;
+    //!\brief The number of threads used by bio::alignment::chain_all().
+    size_t        threads             = 1;
+};
+
+/*!\brief Colinear chaining of anchors between a query and a target.
+ * \ingroup alignment
+ * \details
+ *
+ * The anchors are sorted by target, then query position. The score `f(i)` of the best chain ending in anchor `i`
+ * is the anchor's length or, if larger, `f(j) + gain(j, i) - cost(j, i)` for a predecessor `j` that starts before
+ * `i` on both sequences, at most bio::alignment::chaining_options::max_distance letters away:
+ *
+ *   * **lookback** (as in minimap2): `j` is one of the bio::alignment::chaining_options::max_lookback preceding
+ *     anchors; `gain` is the number of new matching letters, `min(dq, dt, length)`, and
+ *     `cost = gap_cost * l / 100 + log2(l) / 2` for the difference `l = |dq - dt|` of the distances (at most
+ *     bio::alignment::chaining_options::max_skew). The costs are tabulated for all `l` when the chainer is
+ *     constructed, so the inner loop has no `log` calls.
+ *   * **range_max**: all anchors are considered; `gain` is the anchor's length and
+ *     `cost = ceil(distance_cost * (dq + dt) / 100)`. Because the cost is linear in the positions, the best
+ *     predecessor is the maximum of `100 * f(j) + distance_cost * (q_j + t_j)` over the anchors in the query
+ *     window, found with a segment tree indexed by query order; anchors that fall out of the target window are
+ *     removed from the tree. This is exact and takes `O(n log n)` for any number of anchors.
+ *
+ * Chains are extracted greedily by decreasing score: a chain follows the predecessors until an anchor that belongs
+ * to a better chain, whose score is subtracted. Chains with too few anchors or too low a score are discarded.
+ *
+ * Anchors must be between one query and one target on one strand; collect the reverse strand separately.
+ *
+ * The chainer keeps its buffers between calls, so chaining the anchors of one read after another does not allocate
+ * memory once the buffers are large enough. Use one chainer per thread; bio::alignment::chain_all() does this.
+ *
+ * ### Example
+ *
+ * \include test/snippet/alignment/chain.cpp
+ */
+class chainer
+{
+private:
+    //!\brief The options.
+    chaining_options      opts{};
+    //!\brief The gap costs of the lookback mode by difference of distances.
+    std::vector<int32_t>  gap_costs = std::vector<int32_t>(1, 0);
+    //!\brief The sorted anchors.
+    std::vector<anchor>   sorted;
+    //!\brief The score of the best chain ending in each anchor.
+    std::vector<int32_t>  scores;
+    //!\brief The predecessor of each anchor in its best chain (or `-1`).
+    std::vector<int64_t>  predecessors;
+    //!\brief The chains of the last call of #run().
+    std::vector<chain>    chains;
+    //!\brief The anchors of the chains (indices into #sorted, ascending within a chain).
+    std::vector<uint32_t> chain_anchors;
+    //!\brief The offsets of the chains in #chain_anchors.
+    std::vector<size_t>   offsets{0};
+    //!\brief Scratch space: anchor order by query / by score, used flags.
+    std::vector<uint32_t> order;
+    //!\brief Scratch space: the position of every anchor in query order.
+    std::vector<uint32_t> rank;
+    //!\brief Scratch space: the segment tree of the range_max mode (key and anchor index).
+    std::vector<std::pair<int64_t, int64_t>> tree;
+
+    //!\brief The key of an empty leaf of the segment tree.
+    static constexpr std::pair<int64_t, int64_t> empty_key{std::numeric_limits<int64_t>::min(), -1};
+
+    //!\brief The DP with a bounded number of predecessors.
+    void fill_lookback() noexcept
+    {
+        size_t const n = sorted.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            anchor const a    = sorted[i];
+            int32_t      best = a.length;
+            int64_t      pred = -1;
+
+            size_t const first = i > opts.max_lookback ? i - opts.max_lookback : 0;
+            for (size_t j = i; j-- > first;)
+            {
+                anchor const b  = sorted[j];
+                uint32_t     dt = a.target - b.target;
+                if (dt > opts.max_distance)
+                    break;
+                if (dt == 0 || b.query >= a.query)
+                    continue;
+                uint32_t const dq = a.query - b.query;
+                if (dq > opts.max_distance)
+                    continue;
+                uint32_t const skew = dq > dt ? dq - dt : dt - dq;
+                if (skew > opts.max_skew)
+                    continue;
+
+                int32_t const gain  = static_cast<int32_t>(std::min({dq, dt, a.length}));
+                int32_t const score = scores[j] + gain - gap_costs[skew];
+                if (score > best)
+                {
+                    best = score;
+                    pred = j;
+                }
+            }
+            scores[i]       = best;
+            predecessors[i] = pred;
+        }
+    }
+
+    //!\brief The DP with range maximum queries.
+    void fill_range_max()
+    {
+        size_t const n = sorted.size();
+
+        // leaves in query order
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::ranges::sort(order, [&](uint32_t const l, uint32_t const r) { return sorted[l].query < sorted[r].query; });
+        rank.resize(n);
+        for (size_t r = 0; r < n; ++r)
+            rank[order[r]] = r;
+
+        size_t const leaves = std::bit_ceil(std::max<size_t>(n, 1));
+        tree.assign(2 * leaves, empty_key);
+        auto update = [&](size_t leaf, std::pair<int64_t, int64_t> const value)
+        {
+            leaf += leaves;
+            tree[leaf] = value;
+            for (leaf /= 2; leaf > 0; leaf /= 2)
+                tree[leaf] = std::max(tree[2 * leaf], tree[2 * leaf + 1]);
+        };
+        auto query = [&](size_t l, size_t r) // [l, r)
+        {
+            std::pair<int64_t, int64_t> ret = empty_key;
+            for (l += leaves, r += leaves; l < r; l /= 2, r /= 2)
+            {
+                if (l & 1)
+                    ret = std::max(ret, tree[l++]);
+                if (r & 1)
+                    ret = std::max(ret, tree[--r]);
+            }
+            return ret;
+        };
+        auto query_rank = [&](uint32_t const q) // the first leaf with a query position of at least q
+        {
+            return std::ranges::partition_point(order, [&](uint32_t const j) { return sorted[j].query < q; }) -
+                   order.begin();
+        };
+
+        int64_t const c      = opts.distance_cost;
+        size_t        oldest = 0; // the first anchor in the tree
+        for (size_t i = 0; i < n;)
+        {
+            // anchors with the same target position cannot chain to each other
+            size_t end = i;
+            while (end < n && sorted[end].target == sorted[i].target)
+                ++end;
+
+            uint32_t const t = sorted[i].target;
+            for (; oldest < i && t - sorted[oldest].target > opts.max_distance; ++oldest)
+                update(rank[oldest], empty_key);
+
+            for (size_t k = i; k < end; ++k)
+            {
+                anchor const   a  = sorted[k];
+                uint32_t const lo = a.query > opts.max_distance ? a.query - opts.max_distance : 0;
+                auto const [key, j] = query(query_rank(lo), query_rank(a.query));
+
+                scores[k]       = a.length;
+                predecessors[k] = -1;
+                if (j >= 0)
+                {
+                    // floor((key - c * (q + t)) / 100) = f(j) - ceil(c * (dq + dt) / 100)
+                    int64_t const diff = key - c * (static_cast<int64_t>(a.query) + a.target);
+                    int64_t const add  = diff >= 0 ? diff / 100 : -((-diff + 99) / 100);
+                    if (add > 0)
+                    {
+                        scores[k] += static_cast<int32_t>(add);
+                        predecessors[k] = j;
+                    }
+                }
+            }
+
+            for (size_t k = i; k < end; ++k)
+                update(rank[k],
+                       {100 * static_cast<int64_t>(scores[k]) +
+                          c * (static_cast<int64_t>(sorted[k].query) + sorted[k].target),
+                        static_cast<int64_t>(k)});
+            i = end;
+        }
+    }
+
+    //!\brief Extract the chains greedily by decreasing score.
+    void backtrack()
+    {
+        size_t const n = sorted.size();
+        chains.clear();
+        chain_anchors.clear();
+        offsets.assign(1, 0);
+
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        std::ranges::sort(order,
+                          [&](uint32_t const l, uint32_t const r)
+                          { return scores[l] > scores[r] || (scores[l] == scores[r] && l > r); });
+
+        // reuse rank as used flags
+        rank.assign(n, 0);
+        for (uint32_t const end : order)
+        {
+            if (rank[end])
+                continue;
+
+            size_t const first = chain_anchors.size();
+            int64_t      i     = end;
+            for (; i >= 0 && !rank[i]; i = predecessors[i])
+            {
+                rank[i] = 1;
+                chain_anchors.push_back(static_cast<uint32_t>(i));
+            }
+
+            int32_t const  score = scores[end] - (i >= 0 ? scores[i] : 0);
+            uint32_t const count = static_cast<uint32_t>(chain_anchors.size() - first);
+            if (score < opts.min_score || count < opts.min_anchors)
+            {
+                chain_anchors.resize(first);
+                continue;
+            }
+
+            std::reverse(chain_anchors.begin() + first, chain_anchors.end());
+            chain c{.score = score, .anchors = count};
+            anchor const & head = sorted[chain_anchors[first]];
+            c.query_begin       = head.query;
+            c.target_begin      = head.target;
+            for (size_t k = first; k < chain_anchors.size(); ++k)
+            {
+                anchor const & a = sorted[chain_anchors[k]];
+                c.query_end      = std::max(c.query_end, a.query + a.length);
+                c.target_end     = std::max(c.target_end, a.target + a.length);
+            }
+            chains.push_back(c);
+            offsets.push_back(chain_anchors.size());
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    chainer()                            = default; //!< Defaulted.
+    chainer(chainer const &)             = default; //!< Defaulted.
+    chainer(chainer &&)                  = default; //!< Defaulted.
+    chainer & operator=(chainer const &) = default; //!< Defaulted.
+    chainer & operator=(chainer &&)      = default; //!< Defaulted.
+    ~chainer()                           = default; //!< Defaulted.
+
+    /*!\brief Construct with options; tabulates the gap costs.
+     * \param[in] options The options.
+     */
+    explicit chainer(chaining_options const options) : opts{options}, gap_costs(options.max_skew + 1, 0)
+    {
+        for (size_t l = 1; l < gap_costs.size(); ++l)
+            gap_costs[l] = static_cast<int32_t>(opts.gap_cost * l / 100.0 + 0.5 * std::log2(static_cast<double>(l)));
+    }
+    //!\}
+
+    //!\brief The options.
+    chaining_options const & options() const noexcept { return opts; }
+
+    /*!\brief Chain anchors.
+     * \param[in] anchors The anchors between a query and a target, in any order.
+     * \returns The chains by decreasing score; valid until the next call.
+     * \details
+     *
+     * ### Complexity
+     *
+     * `O(n log n)` for sorting; the lookback DP takes `O(n * max_lookback)`, the range_max DP `O(n log n)`.
+     */
+    std::span<chain const> run(std::span<anchor const> const anchors)
+    {
+        sorted.assign(anchors.begin(), anchors.end());
+        std::ranges::sort(sorted,
+                          [](anchor const & l, anchor const & r)
+                          { return l.target < r.target || (l.target == r.target && l.query < r.query); });
+        scores.resize(sorted.size());
+        predecessors.resize(sorted.size());
+
+        bool const range_max = opts.mode == chaining_mode::range_max ||
+                               (opts.mode == chaining_mode::automatic && sorted.size() >= opts.range_max_threshold);
+        if (range_max)
+            fill_range_max();
+        else
+            fill_lookback();
+
+        backtrack();
+        return chains;
+    }
+
+    //!\brief The chains of the last call of #run().
+    std::span<chain const> result() const noexcept { return chains; }
+
+    //!\brief The anchors of a chain of the last call of #run(), sorted by target position.
+    std::vector<anchor> anchors_of(size_t const i) const
+    {
+        assert(i < chains.size());
+        std::vector<anchor> ret;
+        for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+            ret.push_back(sorted[chain_anchors[k]]);
+        return ret;
+    }
+
+    //!\brief The score of the best chain ending in each anchor (sorted by target position) of the last call.
+    std::span<int32_t const> anchor_scores() const noexcept { return scores; }
+};
+
+/*!\brief Chain the anchors of many reads, possibly in parallel.
+ * \ingroup alignment
+ * \param[in] anchor_lists The anchors of every read, e.g. a bio::ranges::concatenated_sequences of
+ *                         bio::alignment::anchor.
+ * \param[in] options      The options.
+ * \returns The chains of every read, by decreasing score.
+ * \details
+ *
+ * With bio::alignment::chaining_options::threads greater than one, the lists are split into contiguous blocks that
+ * are processed by separate chainers.
+ */
+template <std::ranges::random_access_range lists_t>
+    //!\cond
+    requires(std::ranges::sized_range<lists_t> &&
+             std::ranges::contiguous_range<std::ranges::range_reference_t<lists_t>> &&
+             std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<lists_t>>, anchor>)
+//!\endcond
+std::vector<std::vector<chain>> chain_all(lists_t && anchor_lists, chaining_options const options = {})
+{
+    size_t const                    n       = std::ranges::size(anchor_lists);
+    size_t const                    threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+    std::vector<std::vector<chain>> ret(n);
+    std::vector<std::exception_ptr> errors(threads);
+
+    auto work = [&](size_t const t)
+    {
+        try
+        {
+            chainer c{options};
+            for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+            {
+                auto &&                 list = anchor_lists[i];
+                std::span<chain const> chains = c.run(std::span<anchor const>{std::ranges::data(list),
+                                                                              std::ranges::size(list)});
+                ret[i].assign(chains.begin(), chains.end());
+            }
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work, t);
+    work(0);
+    for (std::thread & w : workers)
+        w.join();
+
+    for (std::exception_ptr const & e : errors)
+        if (e)
+            std::rethrow_exception(e);
+    return ret;
+}
+
+/*!\brief The relation of two reads given by a chain between them.
+ * \ingroup alignment
+ */
+enum class overlap_type
+{
+    //!\brief The chain ends in the middle of both reads (e.g. a repeat).
+    internal,
+    //!\brief The query is contained in the target.
+    query_contained,
+    //!\brief The target is contained in the query.
+    target_contained,
+    //!\brief The end of the query overlaps the start of the target.
+    query_to_target,
+    //!\brief The end of the target overlaps the start of the query.
+    target_to_query
+};
+
+/*!\brief Classify a chain between two reads as an overlap, containment or internal match.
+ * \ingroup alignment
+ * \param[in] c             The chain.
+ * \param[in] query_length  The length of the query.
+ * \param[in] target_length The length of the target.
+ * \param[in] max_overhang  The largest unaligned part at an end of the overlap that is tolerated.
+ * \details
+ *
+ * The chain is extended to the ends of the reads (as in miniasm): if the unaligned parts before and after the
+ * chain on the side where they are shorter exceed `max_overhang`, the match is internal; otherwise the reads
+ * overlap or one contains the other.
+ */
+constexpr overlap_type classify_overlap(chain const & c,
+                                        uint32_t const query_length,
+                                        uint32_t const target_length,
+                                        uint32_t const max_overhang = 1'000) noexcept
+{
+    uint32_t const query_left   = c.query_begin;
+    uint32_t const query_right  = query_length - c.query_end;
+    uint32_t const target_left  = c.target_begin;
+    uint32_t const target_right = target_length - c.target_end;
+
+    uint32_t const overhang = std::min(query_left, target_left) + std::min(query_right, target_right);
+    if (overhang > max_overhang)
+        return overlap_type::internal;
+    if (query_left <= target_left && query_right <= target_right)
+        return overlap_type::query_contained;
+    if (query_left >= target_left && query_right >= target_right)
+        return overlap_type::target_contained;
+    return query_left > target_left ? overlap_type::query_to_target : overlap_type::target_to_query;
+}
+
+} // namespace bio::alignment
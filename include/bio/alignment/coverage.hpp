@@ -0,0 +1,318 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::alignment::coverage and bio::alignment::coverage_track.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bio/alphabet/cigar/cigar.hpp>
+
+namespace bio::alignment
+{
+
+/*!\brief Options for bio::alignment::coverage.
+ * \ingroup alignment
+ */
+struct coverage_options
+{
+    //!\brief Whether deletions (`D`) count as coverage; reference skips (`N`) never do.
+    bool   count_deletions = true;
+    //!\brief The number of threads used by bio::alignment::coverage::add_all().
+    size_t threads         = 1;
+};
+
+/*!\brief The depth of every position of a reference sequence.
+ * \ingroup alignment
+ * \details
+ *
+ * Depths are stored as `uint16_t` if the maximum depth allows it and as `uint32_t` otherwise.
+ */
+class coverage_track
+{
+private:
+    //!\brief The depths if #is_narrow().
+    std::vector<uint16_t> narrow;
+    //!\brief The depths otherwise.
+    std::vector<uint32_t> wide;
+    //!\brief The largest depth.
+    uint32_t              max = 0;
+
+    //!\brief bio::alignment::coverage fills the track.
+    friend class coverage;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    coverage_track()                                   = default; //!< Defaulted.
+    coverage_track(coverage_track const &)             = default; //!< Defaulted.
+    coverage_track(coverage_track &&)                  = default; //!< Defaulted.
+    coverage_track & operator=(coverage_track const &) = default; //!< Defaulted.
+    coverage_track & operator=(coverage_track &&)      = default; //!< Defaulted.
+    ~coverage_track()                                  = default; //!< Defaulted.
+    //!\}
+
+    //!\brief The number of positions.
+    size_t size() const noexcept { return is_narrow() ? narrow.size() : wide.size(); }
+
+    //!\brief The depth at a position.
+    uint32_t operator[](size_t const position) const noexcept
+    {
+        assert(position < size());
+        return is_narrow() ? narrow[position] : wide[position];
+    }
+
+    //!\brief The largest depth.
+    uint32_t max_depth() const noexcept { return max; }
+
+    //!\brief Whether the depths are stored as `uint16_t`.
+    bool is_narrow() const noexcept { return max <= std::numeric_limits<uint16_t>::max(); }
+
+    //!\brief The depths if #is_narrow() (empty otherwise).
+    std::vector<uint16_t> const & narrow_depths() const noexcept { return narrow; }
+
+    //!\brief The depths if not #is_narrow() (empty otherwise).
+    std::vector<uint32_t> const & wide_depths() const noexcept { return wide; }
+};
+
+/*!\brief Accumulates the coverage of one reference sequence from CIGAR alignments.
+ * \ingroup alignment
+ * \details
+ *
+ * Every alignment adds `+1` at the start and `-1` after the end of each run of reference-consuming operations
+ * (`M`, `=`, `X` and, optionally, `D`) to a difference array, so adding an alignment costs a few writes
+ * regardless of its length. #track() computes the depths as prefix sums. Alignments that extend past the end of the
+ * reference are clipped.
+ *
+ * Use one object per reference sequence (chromosome). The difference array holds 4 bytes per position;
+ * #add_all() with several threads uses one partial array per additional thread, which are summed at the end.
+ *
+ * ### Example
+ *
+ * \include test/snippet/alignment/coverage.cpp
+ */
+class coverage
+{
+private:
+    //!\brief The options.
+    coverage_options     opts{};
+    //!\brief The difference array (one more entry than positions).
+    std::vector<int32_t> diff;
+
+    //!\brief Add the runs of one alignment to a difference array.
+    template <typename cigar_t>
+    static void add_to(std::vector<int32_t> & d, uint64_t const position, cigar_t && cigar, bool const deletions)
+    {
+        uint64_t const length    = d.size() - 1;
+        uint64_t       ref       = position;
+        uint64_t       run_start = position;
+        auto           close_run = [&]()
+        {
+            if (run_start < ref && run_start < length)
+            {
+                ++d[run_start];
+                --d[std::min(ref, length)];
+            }
+        };
+
+        for (alphabet::cigar const c : cigar)
+        {
+            uint32_t const n = get<0>(c);
+            switch (get<1>(c).to_char())
+            {
+                case 'M':
+                case '=':
+                case 'X':
+                    ref += n;
+                    break;
+                case 'D':
+                    if (!deletions)
+                    {
+                        close_run();
+                        run_start = ref + n;
+                    }
+                    ref += n;
+                    break;
+                case 'N':
+                    close_run();
+                    ref += n;
+                    run_start = ref;
+                    break;
+                default: // I, S, H, P
+                    break;
+            }
+        }
+        close_run();
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    coverage()                             = default; //!< Defaulted.
+    coverage(coverage const &)             = default; //!< Defaulted.
+    coverage(coverage &&)                  = default; //!< Defaulted.
+    coverage & operator=(coverage const &) = default; //!< Defaulted.
+    coverage & operator=(coverage &&)      = default; //!< Defaulted.
+    ~coverage()                            = default; //!< Defaulted.
+
+    /*!\brief Construct for a reference sequence.
+     * \param[in] reference_length The length of the reference sequence.
+     * \param[in] options          The options.
+     */
+    explicit coverage(size_t const reference_length, coverage_options const options = {}) :
+      opts{options},
+      diff(reference_length + 1, 0)
+    {}
+    //!\}
+
+    //!\brief The options.
+    coverage_options const & options() const noexcept { return opts; }
+
+    //!\brief The length of the reference sequence.
+    size_t size() const noexcept { return diff.empty() ? 0 : diff.size() - 1; }
+
+    /*!\brief Add an alignment.
+     * \param[in] position The reference position of the first aligned letter (0-based).
+     * \param[in] cigar    The CIGAR of the alignment.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the number of CIGAR operations.
+     */
+    template <std::ranges::input_range cigar_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<cigar_t>, alphabet::cigar>
+    //!\endcond
+    void add(uint64_t const position, cigar_t && cigar)
+    {
+        assert(!diff.empty());
+        add_to(diff, position, cigar, opts.count_deletions);
+    }
+
+    /*!\brief Add many alignments, possibly in parallel.
+     * \param[in] positions The positions of the alignments.
+     * \param[in] cigars    The CIGARs of the alignments, e.g. a bio::ranges::concatenated_sequences.
+     * \throws std::invalid_argument If `positions` and `cigars` have different sizes.
+     * \details
+     *
+     * With bio::alignment::coverage_options::threads greater than one, the alignments are split into contiguous
+     * blocks; every thread but the first adds its block to a partial difference array that is summed into the
+     * object's array at the end.
+     */
+    template <std::ranges::random_access_range positions_t, std::ranges::random_access_range cigars_t>
+        //!\cond
+        requires(std::ranges::sized_range<positions_t> && std::ranges::sized_range<cigars_t> &&
+                 std::convertible_to<std::ranges::range_reference_t<positions_t>, uint64_t> &&
+                 std::ranges::input_range<std::ranges::range_reference_t<cigars_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<cigars_t>>, alphabet::cigar>)
+    //!\endcond
+    void add_all(positions_t && positions, cigars_t && cigars)
+    {
+        size_t const n = std::ranges::size(positions);
+        if (std::ranges::size(cigars) != n)
+            throw std::invalid_argument{"There must be one CIGAR per position."};
+
+        auto add_block = [&](std::vector<int32_t> & d, size_t const first, size_t const last)
+        {
+            for (size_t i = first; i < last; ++i)
+                add_to(d, positions[i], cigars[i], opts.count_deletions);
+        };
+
+        size_t const threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n, 1));
+        if (threads == 1)
+        {
+            add_block(diff, 0, n);
+            return;
+        }
+
+        std::vector<std::vector<int32_t>> partial(threads - 1);
+        std::vector<std::thread>          workers;
+        for (size_t t = 1; t < threads; ++t)
+        {
+            workers.emplace_back(
+              [&, t]()
+              {
+                  partial[t - 1].assign(diff.size(), 0);
+                  add_block(partial[t - 1], n * t / threads, n * (t + 1) / threads);
+              });
+        }
+        add_block(diff, 0, n / threads);
+        for (std::thread & w : workers)
+            w.join();
+
+        // merge: every thread sums a slice of all partial arrays
+        workers.clear();
+        auto merge = [&](size_t const first, size_t const last)
+        {
+            for (std::vector<int32_t> const & p : partial)
+                for (size_t i = first; i < last; ++i)
+                    diff[i] += p[i];
+        };
+        for (size_t t = 1; t < threads; ++t)
+            workers.emplace_back(merge, diff.size() * t / threads, diff.size() * (t + 1) / threads);
+        merge(0, diff.size() / threads);
+        for (std::thread & w : workers)
+            w.join();
+    }
+
+    /*!\brief Compute the depths.
+     * \details
+     *
+     * The depths are stored as `uint16_t` if the maximum depth is at most 65535, as `uint32_t` otherwise.
+     *
+     * ### Complexity
+     *
+     * Linear in the length of the reference sequence (two passes).
+     */
+    coverage_track track() const
+    {
+        coverage_track ret;
+        size_t const   n = size();
+
+        int64_t depth = 0;
+        int64_t max   = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            depth += diff[i];
+            max = std::max(max, depth);
+        }
+        ret.max = static_cast<uint32_t>(std::min<int64_t>(max, std::numeric_limits<uint32_t>::max()));
+
+        auto fill = [&](auto & out)
+        {
+            out.resize(n);
+            int64_t running = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                running += diff[i];
+                out[i] = static_cast<std::ranges::range_value_t<decltype(out)>>(running);
+            }
+        };
+        if (ret.is_narrow())
+            fill(ret.narrow);
+        else
+            fill(ret.wide);
+        return ret;
+    }
+
+    //!\brief Remove all alignments.
+    void clear() noexcept { std::ranges::fill(diff, 0); }
+};
+
+} // namespace bio::alignment
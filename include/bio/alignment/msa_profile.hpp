@@ -0,0 +1,345 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::alignment::msa_profile.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bio/alphabet/concept.hpp>
+#include <bio/alphabet/gap/gapped.hpp>
+#include <bio/alphabet/quality/concept.hpp>
+
+namespace bio::alignment
+{
+
+/*!\brief Options for bio::alignment::msa_profile.
+ * \ingroup alignment
+ */
+struct msa_options
+{
+    //!\brief The number of threads; each processes a contiguous block of columns.
+    size_t threads = 1;
+};
+
+/*!\brief Per-column letter counts, profile, consensus and entropy of a multiple sequence alignment.
+ * \ingroup alignment
+ * \tparam alph_t The alphabet of the rows, e.g. bio::alphabet::gapped<bio::alphabet::dna5>.
+ * \details
+ *
+ * The alignment is a random-access range of rows of equal length. For every column, the profile holds the number
+ * of rows with each rank; for a bio::alphabet::gapped alphabet the gap is simply the last rank. If qualities are
+ * given, every letter is additionally weighted with `1 - e`, where `e` is the error probability of its phred score
+ * (gaps have weight `1`); otherwise the weights are the counts. Consensus, frequencies and entropy are derived from
+ * the weights.
+ *
+ * The columns are processed in tiles whose 8-bit counters fit into the L1 cache, laid out rank-major (all columns
+ * of rank 0, then all columns of rank 1, ...). Every row segment of a tile is converted to a byte buffer of ranks
+ * and added to the counters with one comparison per rank over the contiguous bytes, which compilers vectorise
+ * (a one-hot histogram); the counters are flushed into the 32-bit counts every 255 rows. Blocks of columns can
+ * be processed by several threads (see bio::alignment::msa_options).
+ *
+ * ### Example
+ *
+ * \include test/snippet/alignment/msa_profile.cpp
+ */
+template <alphabet::writable_semialphabet alph_t>
+    //!\cond
+    requires(alphabet::size<alph_t> < 255)
+//!\endcond
+class msa_profile
+{
+public:
+    //!\brief The number of ranks.
+    static constexpr size_t alphabet_size = alphabet::size<alph_t>;
+
+private:
+    //!\brief The number of columns in a tile (the 8-bit counters of a tile take about 16 KiB).
+    static constexpr size_t tile_columns = std::max<size_t>(16384 / alphabet_size / 64 * 64, 64);
+    //!\brief The number of rows after which the 8-bit counters are flushed.
+    static constexpr size_t flush_rows   = 255;
+
+    //!\brief The number of rows.
+    size_t                row_count    = 0;
+    //!\brief The number of columns.
+    size_t                column_count = 0;
+    //!\brief The counts, `alphabet_size` per column.
+    std::vector<uint32_t> count_table;
+    //!\brief The weights, `alphabet_size` per column.
+    std::vector<float>    weight_table;
+
+    //!\brief The weight of a phred score: `1 - 10^(-q/10)`.
+    static float phred_weight(size_t const phred)
+    {
+        static std::array<float, 128> const table = []()
+        {
+            std::array<float, 128> ret{};
+            for (size_t q = 0; q < ret.size(); ++q)
+                ret[q] = static_cast<float>(1.0 - std::pow(10.0, -static_cast<double>(q) / 10.0));
+            return ret;
+        }();
+        return table[std::min<size_t>(phred, table.size() - 1)];
+    }
+
+    //!\brief Check the shape of the alignment.
+    template <typename rows_t>
+    void init(rows_t && rows)
+    {
+        row_count    = std::ranges::size(rows);
+        column_count = row_count == 0 ? 0 : std::ranges::size(rows[0]);
+        for (size_t r = 0; r < row_count; ++r)
+            if (std::ranges::size(rows[r]) != column_count)
+                throw std::invalid_argument{"All rows of the alignment must have the same length."};
+
+        count_table.assign(column_count * alphabet_size, 0);
+        weight_table.assign(column_count * alphabet_size, 0.0f);
+    }
+
+    //!\brief Count the columns `[first, last)`; `quals` is only used if `weighted`.
+    template <bool weighted, typename rows_t, typename quals_t>
+    void count_columns(rows_t & rows, quals_t & quals, size_t const first, size_t const last)
+    {
+        std::vector<uint8_t> ranks(tile_columns);
+        std::vector<uint8_t> counters(alphabet_size * tile_columns);
+        std::vector<float>   letter_weights(weighted ? tile_columns : 0);
+        std::vector<float>   sums(weighted ? alphabet_size * tile_columns : 0);
+
+        for (size_t c0 = first; c0 < last; c0 += tile_columns)
+        {
+            size_t const nc = std::min(tile_columns, last - c0);
+            std::ranges::fill(sums, 0.0f);
+
+            for (size_t r0 = 0; r0 < row_count; r0 += flush_rows)
+            {
+                std::ranges::fill(counters, 0);
+                for (size_t r = r0; r < std::min(r0 + flush_rows, row_count); ++r)
+                {
+                    auto const it = std::ranges::begin(rows[r]) + c0;
+                    for (size_t c = 0; c < nc; ++c)
+                        ranks[c] = alphabet::to_rank(alph_t{it[c]});
+
+                    // one-hot histogram: one comparison per rank for a whole row segment
+                    for (uint8_t k = 0; k < alphabet_size; ++k)
+                    {
+                        uint8_t * const counters_k = counters.data() + k * tile_columns;
+                        for (size_t c = 0; c < nc; ++c)
+                            counters_k[c] += ranks[c] == k;
+                    }
+
+                    if constexpr (weighted)
+                    {
+                        auto const qit = std::ranges::begin(quals[r]) + c0;
+                        for (size_t c = 0; c < nc; ++c)
+                        {
+                            bool const is_gap =
+                              alphabet::detail::is_gapped_alphabet<alph_t> && ranks[c] == alphabet_size - 1;
+                            letter_weights[c] = is_gap ? 1.0f : phred_weight(alphabet::to_phred(qit[c]));
+                        }
+
+                        for (uint8_t k = 0; k < alphabet_size; ++k)
+                        {
+                            float * const sums_k = sums.data() + k * tile_columns;
+                            for (size_t c = 0; c < nc; ++c)
+                                sums_k[c] += ranks[c] == k ? letter_weights[c] : 0.0f;
+                        }
+                    }
+                }
+
+                for (size_t c = 0; c < nc; ++c)
+                    for (size_t k = 0; k < alphabet_size; ++k)
+                        count_table[(c0 + c) * alphabet_size + k] += counters[k * tile_columns + c];
+            }
+
+            for (size_t c = 0; c < nc; ++c)
+            {
+                for (size_t k = 0; k < alphabet_size; ++k)
+                {
+                    size_t const i  = (c0 + c) * alphabet_size + k;
+                    weight_table[i] = weighted ? sums[k * tile_columns + c] : static_cast<float>(count_table[i]);
+                }
+            }
+        }
+    }
+
+    //!\brief Count all columns, possibly on several threads.
+    template <bool weighted, typename rows_t, typename quals_t>
+    void count(rows_t & rows, quals_t & quals, msa_options const & opts)
+    {
+        size_t const n_tiles = (column_count + tile_columns - 1) / tile_columns;
+        size_t const threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n_tiles, 1));
+        if (threads == 1)
+        {
+            count_columns<weighted>(rows, quals, 0, column_count);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t)
+        {
+            size_t const first = std::min(n_tiles * t / threads * tile_columns, column_count);
+            size_t const last  = std::min(n_tiles * (t + 1) / threads * tile_columns, column_count);
+            workers.emplace_back([&, first, last]() { count_columns<weighted>(rows, quals, first, last); });
+        }
+        for (std::thread & w : workers)
+            w.join();
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    msa_profile()                                = default; //!< Defaulted.
+    msa_profile(msa_profile const &)             = default; //!< Defaulted.
+    msa_profile(msa_profile &&)                  = default; //!< Defaulted.
+    msa_profile & operator=(msa_profile const &) = default; //!< Defaulted.
+    msa_profile & operator=(msa_profile &&)      = default; //!< Defaulted.
+    ~msa_profile()                               = default; //!< Defaulted.
+
+    /*!\brief Compute the profile of an alignment.
+     * \param[in] rows    The rows of the alignment, e.g. a bio::ranges::concatenated_sequences.
+     * \param[in] options The options.
+     * \throws std::invalid_argument If the rows have different lengths.
+     */
+    template <std::ranges::random_access_range rows_t>
+        //!\cond
+        requires(std::ranges::sized_range<rows_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<rows_t>> &&
+                 std::ranges::sized_range<std::ranges::range_reference_t<rows_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<rows_t>>, alph_t>)
+    //!\endcond
+    explicit msa_profile(rows_t && rows, msa_options const options = {})
+    {
+        init(rows);
+        count<false>(rows, rows, options);
+    }
+
+    /*!\brief Compute the quality-weighted profile of an alignment.
+     * \param[in] rows      The rows of the alignment, e.g. a bio::ranges::concatenated_sequences.
+     * \param[in] qualities The qualities of the rows; same shape as `rows`, qualities at gaps are ignored.
+     * \param[in] options   The options.
+     * \throws std::invalid_argument If the rows have different lengths or the qualities a different shape.
+     */
+    template <std::ranges::random_access_range rows_t, std::ranges::random_access_range quals_t>
+        //!\cond
+        requires(std::ranges::sized_range<rows_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<rows_t>> &&
+                 std::ranges::sized_range<std::ranges::range_reference_t<rows_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<rows_t>>, alph_t> &&
+                 std::ranges::sized_range<quals_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<quals_t>> &&
+                 std::ranges::sized_range<std::ranges::range_reference_t<quals_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<quals_t>>>)
+    //!\endcond
+    msa_profile(rows_t && rows, quals_t && qualities, msa_options const options = {})
+    {
+        init(rows);
+        if (std::ranges::size(qualities) != row_count)
+            throw std::invalid_argument{"There must be one quality row per alignment row."};
+        for (size_t r = 0; r < row_count; ++r)
+            if (std::ranges::size(qualities[r]) != column_count)
+                throw std::invalid_argument{"Quality rows must have the same length as the alignment rows."};
+
+        count<true>(rows, qualities, options);
+    }
+    //!\}
+
+    //!\brief The number of rows.
+    size_t rows() const noexcept { return row_count; }
+
+    //!\brief The number of columns.
+    size_t columns() const noexcept { return column_count; }
+
+    //!\brief The number of rows with each rank in a column.
+    std::span<uint32_t const> counts(size_t const column) const noexcept
+    {
+        assert(column < column_count);
+        return {count_table.data() + column * alphabet_size, alphabet_size};
+    }
+
+    //!\brief The (quality-weighted) counts of each rank in a column.
+    std::span<float const> weights(size_t const column) const noexcept
+    {
+        assert(column < column_count);
+        return {weight_table.data() + column * alphabet_size, alphabet_size};
+    }
+
+    //!\brief The relative frequency of each rank in a column (all zero for columns without weight).
+    std::array<float, alphabet_size> frequencies(size_t const column) const noexcept
+    {
+        std::array<float, alphabet_size> ret{};
+        std::span<float const> const     w     = weights(column);
+        float const                      total = std::accumulate(w.begin(), w.end(), 0.0f);
+        if (total > 0.0f)
+            for (size_t k = 0; k < alphabet_size; ++k)
+                ret[k] = w[k] / total;
+        return ret;
+    }
+
+    //!\brief The frequencies of all columns (position-specific frequency profile).
+    std::vector<std::array<float, alphabet_size>> profile() const
+    {
+        std::vector<std::array<float, alphabet_size>> ret(column_count);
+        for (size_t c = 0; c < column_count; ++c)
+            ret[c] = frequencies(c);
+        return ret;
+    }
+
+    //!\brief The letter with the largest weight in a column (the smallest rank if several have it).
+    alph_t consensus(size_t const column) const noexcept
+    {
+        std::span<float const> const w = weights(column);
+        return alphabet::assign_rank_to(std::ranges::max_element(w) - w.begin(), alph_t{});
+    }
+
+    //!\brief The consensus of all columns.
+    std::vector<alph_t> consensus() const
+    {
+        std::vector<alph_t> ret(column_count);
+        for (size_t c = 0; c < column_count; ++c)
+            ret[c] = consensus(c);
+        return ret;
+    }
+
+    //!\brief The Shannon entropy of a column in bits.
+    float entropy(size_t const column) const noexcept
+    {
+        float ret = 0.0f;
+        for (float const f : frequencies(column))
+            if (f > 0.0f)
+                ret -= f * std::log2(f);
+        return ret;
+    }
+};
+
+/*!\name Deduction guides
+ * \relates bio::alignment::msa_profile
+ * \{
+ */
+//!\brief Deduce the alphabet from the rows.
+template <typename rows_t>
+msa_profile(rows_t &&, msa_options = {})
+  -> msa_profile<std::ranges::range_value_t<std::ranges::range_reference_t<rows_t>>>;
+
+//!\brief Deduce the alphabet from the rows.
+template <typename rows_t, std::ranges::range quals_t>
+msa_profile(rows_t &&, quals_t &&, msa_options = {})
+  -> msa_profile<std::ranges::range_value_t<std::ranges::range_reference_t<rows_t>>>;
+//!\}
+
+} // namespace bio::alignment
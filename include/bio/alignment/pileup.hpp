@@ -0,0 +1,332 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::alignment::pileup.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/concept.hpp>
+
+namespace bio::alignment
+{
+
+/*!\brief Options for bio::alignment::pileup.
+ * \ingroup alignment
+ */
+struct pileup_options
+{
+    //!\brief Letters with a lower phred score are not counted.
+    uint8_t min_quality = 0;
+    //!\brief The number of threads used by bio::alignment::pileup_regions.
+    size_t  threads     = 1;
+};
+
+/*!\brief The pileup of one reference position.
+ * \ingroup alignment
+ */
+struct pileup_column
+{
+    //!\brief The reference position.
+    uint64_t                position = 0;
+    //!\brief The number of aligned letters, indexed by bio::alphabet::dna5 rank.
+    std::array<uint32_t, 5> counts{};
+    //!\brief The sum of the phred scores of the aligned letters, indexed by bio::alphabet::dna5 rank.
+    std::array<uint32_t, 5> quality_sums{};
+    //!\brief The number of reads with a deletion at this position.
+    uint32_t                deletions  = 0;
+    //!\brief The number of reads with an insertion between the previous position and this one.
+    uint32_t                insertions = 0;
+
+    //!\brief The number of reads that cover the position with a letter or a deletion.
+    uint32_t depth() const noexcept { return std::accumulate(counts.begin(), counts.end(), deletions); }
+
+    //!\brief Defaulted.
+    friend bool operator==(pileup_column const &, pileup_column const &) = default;
+};
+
+/*!\brief An aligned read as consumed by bio::alignment::pileup.
+ * \ingroup alignment
+ * \tparam cigar_t The type of the CIGAR, a range over bio::alphabet::cigar.
+ * \tparam seq_t   The type of the sequence, a random-access range over bio::alphabet::dna5.
+ * \tparam qual_t  The type of the qualities, a random-access range over a bio::alphabet::quality_alphabet.
+ * \details
+ *
+ * The members can be views into the storage of a batch of records, e.g. elements of
+ * bio::ranges::concatenated_sequences. If the qualities are empty, no letter is filtered by quality and the
+ * quality sums are not updated.
+ */
+template <typename cigar_t, typename seq_t, typename qual_t>
+struct pileup_record
+{
+    //!\brief The reference position of the first aligned letter (0-based).
+    uint64_t position = 0;
+    //!\brief The CIGAR.
+    cigar_t  cigar{};
+    //!\brief The sequence.
+    seq_t    sequence{};
+    //!\brief The qualities (or an empty range).
+    qual_t   qualities{};
+};
+
+/*!\brief A streaming pileup of aligned reads.
+ * \ingroup alignment
+ * \details
+ *
+ * Records are added in order of their position with #add(). Every record is applied to the columns it covers as
+ * soon as it is added, so the reads themselves are not stored. The columns are held in a ring buffer that spans
+ * the positions between the current record and the end of the furthest-reaching read; a column is emitted (and
+ * its slot reused) as soon as a record with a larger position arrives, because no later record can touch it.
+ * The ring buffer only grows if a read spans more positions than ever before, so there are no allocations in the
+ * steady state.
+ *
+ * Only columns covered by at least one read (or insertion) are emitted. Use one object per thread; independent
+ * regions (e.g. chromosomes) can be processed in parallel with bio::alignment::pileup_regions.
+ *
+ * ### Example
+ *
+ * \include test/snippet/alignment/pileup.cpp
+ */
+class pileup
+{
+private:
+    //!\brief The options.
+    pileup_options             opts{};
+    //!\brief The columns; position `p` is stored at `p & (ring.size() - 1)`. Columns outside the window are empty.
+    std::vector<pileup_column> ring = std::vector<pileup_column>(1024);
+    //!\brief The first position of the window.
+    uint64_t                   window_begin = 0;
+    //!\brief One after the last position of the window.
+    uint64_t                   window_end   = 0;
+
+    //!\brief The column of a position in the window.
+    pileup_column & at(uint64_t const position) noexcept { return ring[position & (ring.size() - 1)]; }
+
+    //!\brief Emit and clear the columns before `position`.
+    template <typename emit_t>
+    void emit_until(uint64_t const position, emit_t & emit)
+    {
+        for (; window_begin < std::min(position, window_end); ++window_begin)
+        {
+            pileup_column & col = at(window_begin);
+            if (col.depth() > 0 || col.insertions > 0)
+            {
+                col.position = window_begin;
+                emit(std::as_const(col));
+            }
+            col = pileup_column{};
+        }
+
+        if (window_begin < position)
+            window_begin = window_end = position;
+    }
+
+    //!\brief Make sure the ring buffer can hold the window up to `end`.
+    void reserve_until(uint64_t const end)
+    {
+        if (end - window_begin <= ring.size())
+            return;
+
+        std::vector<pileup_column> bigger(std::bit_ceil(end - window_begin));
+        for (uint64_t p = window_begin; p < window_end; ++p)
+            bigger[p & (bigger.size() - 1)] = at(p);
+        ring.swap(bigger);
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    pileup()                           = default; //!< Defaulted.
+    pileup(pileup const &)             = default; //!< Defaulted.
+    pileup(pileup &&)                  = default; //!< Defaulted.
+    pileup & operator=(pileup const &) = default; //!< Defaulted.
+    pileup & operator=(pileup &&)      = default; //!< Defaulted.
+    ~pileup()                          = default; //!< Defaulted.
+
+    //!\brief Construct with options.
+    explicit pileup(pileup_options const options) : opts{options} {}
+    //!\}
+
+    //!\brief The options.
+    pileup_options const & options() const noexcept { return opts; }
+
+    /*!\brief Add a record and emit the columns that are complete.
+     * \param[in] record The record; its position must not be smaller than that of the previous record.
+     * \param[in] emit   Called with a bio::alignment::pileup_column for every complete column, in order.
+     * \throws std::invalid_argument If the record is out of order, its CIGAR consumes more letters than the
+     * sequence has, or the qualities are neither empty nor as long as the sequence.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the number of CIGAR operations and aligned letters of the record plus the number of emitted
+     * columns.
+     */
+    template <typename cigar_t, typename seq_t, typename qual_t, typename emit_t>
+        //!\cond
+        requires(std::ranges::input_range<cigar_t> &&
+                 std::same_as<std::ranges::range_value_t<cigar_t>, alphabet::cigar> &&
+                 std::ranges::random_access_range<seq_t> && std::ranges::sized_range<seq_t> &&
+                 std::same_as<std::ranges::range_value_t<seq_t>, alphabet::dna5> &&
+                 std::ranges::random_access_range<qual_t> && std::ranges::sized_range<qual_t> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<qual_t>>)
+    //!\endcond
+    void add(pileup_record<cigar_t, seq_t, qual_t> const & record, emit_t && emit)
+    {
+        if (record.position < window_begin)
+            throw std::invalid_argument{"Pileup records must be sorted by position."};
+
+        size_t const seq_size  = std::ranges::size(record.sequence);
+        bool const   has_quals = !std::ranges::empty(record.qualities);
+        if (has_quals && std::ranges::size(record.qualities) != seq_size)
+            throw std::invalid_argument{"The qualities must be empty or as long as the sequence."};
+
+        // reference and query span (a trailing insertion is tallied at the position after the read)
+        uint64_t ref_span   = 0;
+        size_t   query_span = 0;
+        bool     trailing_i = false;
+        for (alphabet::cigar const c : record.cigar)
+        {
+            uint32_t const n  = get<0>(c);
+            char const     op = get<1>(c).to_char();
+            ref_span += (op == 'M' || op == '=' || op == 'X' || op == 'D' || op == 'N') ? n : 0;
+            query_span += (op == 'M' || op == '=' || op == 'X' || op == 'I' || op == 'S') ? n : 0;
+            trailing_i = op == 'I' || (trailing_i && (op == 'S' || op == 'H' || op == 'P'));
+        }
+        if (query_span > seq_size)
+            throw std::invalid_argument{"The CIGAR consumes more letters than the sequence has."};
+
+        emit_until(record.position, emit);
+        uint64_t const end = record.position + ref_span + trailing_i;
+        reserve_until(end);
+        window_end = std::max(window_end, end);
+
+        uint64_t   ref = record.position;
+        size_t     q   = 0;
+        auto const seq = std::ranges::begin(record.sequence);
+        auto const qal = std::ranges::begin(record.qualities);
+        for (alphabet::cigar const c : record.cigar)
+        {
+            uint32_t const n = get<0>(c);
+            switch (get<1>(c).to_char())
+            {
+                case 'M':
+                case '=':
+                case 'X':
+                    for (uint32_t i = 0; i < n; ++i, ++ref, ++q)
+                    {
+                        uint8_t const r = alphabet::to_rank(seq[q]);
+                        if (has_quals)
+                        {
+                            int const phred = std::max<int>(alphabet::to_phred(qal[q]), 0);
+                            if (phred < opts.min_quality)
+                                continue;
+                            at(ref).quality_sums[r] += phred;
+                        }
+                        ++at(ref).counts[r];
+                    }
+                    break;
+                case 'I':
+                    ++at(ref).insertions;
+                    q += n;
+                    break;
+                case 'D':
+                    for (uint32_t i = 0; i < n; ++i, ++ref)
+                        ++at(ref).deletions;
+                    break;
+                case 'N':
+                    ref += n;
+                    break;
+                case 'S':
+                    q += n;
+                    break;
+                default: // H, P
+                    break;
+            }
+        }
+    }
+
+    //!\brief Emit all remaining columns; afterwards records may start at any position again.
+    template <typename emit_t>
+    void finish(emit_t && emit)
+    {
+        emit_until(window_end, emit);
+        window_begin = window_end = 0;
+    }
+};
+
+/*!\brief Compute the pileups of independent regions in parallel.
+ * \ingroup alignment
+ * \param[in] regions The regions, a random-access range of ranges of bio::alignment::pileup_record, each sorted by
+ *                    position.
+ * \param[in] emit    Called with the index of the region and a bio::alignment::pileup_column; calls for the same
+ *                    region are sequential and in order, calls for different regions may be concurrent.
+ * \param[in] options The options; bio::alignment::pileup_options::threads threads process one region at a time.
+ * \throws std::invalid_argument See bio::alignment::pileup::add(); the first exception is rethrown after all threads
+ * are done.
+ */
+template <std::ranges::random_access_range regions_t, typename emit_t>
+    //!\cond
+    requires(std::ranges::sized_range<regions_t> && std::ranges::input_range<std::ranges::range_reference_t<regions_t>>)
+//!\endcond
+void pileup_regions(regions_t && regions, emit_t && emit, pileup_options const options = {})
+{
+    size_t const        n_regions = std::ranges::size(regions);
+    std::atomic<size_t> next{0};
+    std::exception_ptr  error;
+    std::atomic_flag    has_error{};
+
+    auto work = [&]()
+    {
+        pileup p{options};
+        for (size_t i = next++; i < n_regions; i = next++)
+        {
+            try
+            {
+                auto emit_i = [&](pileup_column const & col) { emit(i, col); };
+                for (auto && record : regions[i])
+                    p.add(record, emit_i);
+                p.finish(emit_i);
+            }
+            catch (...)
+            {
+                if (!has_error.test_and_set())
+                    error = std::current_exception();
+                p = pileup{options};
+            }
+        }
+    };
+
+    size_t const threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n_regions, 1));
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+    for (std::thread & w : workers)
+        w.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace bio::alignment
@@ -178,6 +178,7 @@
 #include <bio/alphabet/composite/all.hpp>
 #include <bio/alphabet/concept.hpp>
 #include <bio/alphabet/gap/all.hpp>
+#include <bio/alphabet/lookup_tables.hpp>
 #include <bio/alphabet/mask/all.hpp>
 #include <bio/alphabet/nucleotide/all.hpp>
 #include <bio/alphabet/quality/all.hpp>
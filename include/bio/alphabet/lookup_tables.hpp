@@ -0,0 +1,305 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::alphabet::lookup_tables and bio::alphabet::chars_to_ranks.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <bio/alphabet/concept.hpp>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSSE3__)
+#    include <tmmintrin.h>
+#endif
+
+namespace bio::alphabet
+{
+
+/*!\brief The set of precomputed conversion tables for an alphabet (see bio::alphabet::lookup_tables).
+ * \ingroup alphabet
+ * \tparam alph_t The alphabet type.
+ * \details
+ *
+ * All tables are derived from the alphabet's customisation points (bio::alphabet::assign_char_to,
+ * bio::alphabet::to_char and bio::alphabet::char_is_valid_for), so they are consistent with these by definition.
+ * Characters are always interpreted as unsigned, i.e. tables of size 256 are indexed with
+ * `static_cast<uint8_t>(c)`.
+ *
+ * Besides the scalar tables, two "nibble-split" forms are provided that are suitable for byte-shuffle
+ * instructions (`pshufb`/`vpshufb`) that look up 16-byte tables:
+ *
+ *   1. Validity: `c` is valid iff `(valid_lo[c & 0xF] & valid_hi[c >> 4]) != 0`. This is possible for every
+ *      alphabet whose set of valid characters has at most 8 distinct "rows" (sets of low nibbles for a given high
+ *      nibble); #valid_by_nibbles indicates whether it is exact.
+ *   2. Rank: `char_to_rank[c] == rank_by_nibbles[c >> 4][c & 0xF]`. A vectorised lookup only needs the
+ *      sub-tables of the high nibbles that occur in valid characters (#valid_high_nibbles) if only valid
+ *      characters need to be converted.
+ */
+template <typename alph_t>
+struct char_lookup_tables
+{
+    //!\brief The rank that bio::alphabet::assign_char_to produces for every character.
+    std::array<uint8_t, 256>                char_to_rank{};
+    //!\brief The character that bio::alphabet::to_char produces for every rank.
+    std::array<char, size<alph_t>>          rank_to_char{};
+    //!\brief Bit `c % 64` of `valid_mask[c / 64]` is set iff bio::alphabet::char_is_valid_for is true for `c`.
+    std::array<uint64_t, 4>                 valid_mask{};
+    //!\brief Validity bits by low nibble (see above).
+    std::array<uint8_t, 16>                 valid_lo{};
+    //!\brief Validity bits by high nibble (see above).
+    std::array<uint8_t, 16>                 valid_hi{};
+    //!\brief Whether #valid_lo and #valid_hi represent the validity exactly; if not, both are all zero.
+    bool                                    valid_by_nibbles = false;
+    //!\brief #char_to_rank split into 16 tables of 16 entries, indexed by high and low nibble.
+    std::array<std::array<uint8_t, 16>, 16> rank_by_nibbles{};
+    //!\brief Bit `h` is set iff there is a valid character whose high nibble is `h`.
+    uint16_t                                valid_high_nibbles = 0;
+
+    //!\brief Whether the character is valid for the alphabet; same as bio::alphabet::char_is_valid_for.
+    constexpr bool is_valid(char const c) const noexcept
+    {
+        uint8_t const i = static_cast<uint8_t>(c);
+        return (valid_mask[i / 64] >> (i % 64)) & 1ull;
+    }
+};
+
+/*!\brief Precomputed scalar and SIMD-friendly conversion tables for an alphabet.
+ * \ingroup alphabet
+ * \tparam alph_t The alphabet type; must satisfy bio::alphabet::detail::writable_constexpr_alphabet, have `char`
+ * as bio::alphabet::char_t and a size of at most 256.
+ * \details
+ *
+ * The tables are computed once at compile-time, for every alphabet (including user-defined ones). They allow
+ * writing bulk conversion kernels once, generically, instead of per alphabet. See bio::alphabet::char_lookup_tables
+ * for the available tables and bio::alphabet::chars_to_ranks for a kernel that uses them.
+ *
+ * ### Example
+ *
+ * \include test/snippet/alphabet/lookup_tables.cpp
+ */
+template <typename alph_t>
+    //!\cond
+    requires(detail::writable_constexpr_alphabet<alph_t> && std::same_as<char_t<alph_t>, char> &&
+             size<alph_t> <= 256)
+//!\endcond
+inline constexpr char_lookup_tables<alph_t> lookup_tables = []() constexpr
+{
+    char_lookup_tables<alph_t> ret{};
+
+    std::array<uint16_t, 16> rows{}; // valid low nibbles per high nibble
+    for (size_t i = 0; i < 256; ++i)
+    {
+        char const c                            = static_cast<char>(i);
+        ret.char_to_rank[i]                     = to_rank(assign_char_to(c, alph_t{}));
+        ret.rank_by_nibbles[i >> 4][i & 0b1111] = ret.char_to_rank[i];
+
+        if (char_is_valid_for<alph_t>(c))
+        {
+            ret.valid_mask[i / 64] |= 1ull << (i % 64);
+            ret.valid_high_nibbles |= 1u << (i >> 4);
+            rows[i >> 4] |= 1u << (i & 0b1111);
+        }
+    }
+
+    for (size_t r = 0; r < size<alph_t>; ++r)
+        ret.rank_to_char[r] = to_char(assign_rank_to(r, alph_t{}));
+
+    // every distinct non-empty row gets one bit; a character is valid iff its row has the bit of its low nibble
+    std::array<uint16_t, 8> patterns{};
+    size_t                  n_patterns = 0;
+    ret.valid_by_nibbles               = true;
+    for (size_t h = 0; h < 16 && ret.valid_by_nibbles; ++h)
+    {
+        if (rows[h] == 0)
+            continue;
+
+        size_t k = 0;
+        while (k < n_patterns && patterns[k] != rows[h])
+            ++k;
+
+        if (k == n_patterns)
+        {
+            if (n_patterns == patterns.size())
+            {
+                ret.valid_by_nibbles = false;
+                break;
+            }
+            patterns[n_patterns++] = rows[h];
+        }
+        ret.valid_hi[h] |= 1u << k;
+    }
+
+    if (ret.valid_by_nibbles)
+    {
+        for (size_t k = 0; k < n_patterns; ++k)
+            for (size_t l = 0; l < 16; ++l)
+                if ((patterns[k] >> l) & 1u)
+                    ret.valid_lo[l] |= 1u << k;
+    }
+    else
+    {
+        ret.valid_lo = {};
+        ret.valid_hi = {};
+    }
+
+    return ret;
+}
+();
+
+} // namespace bio::alphabet
+
+namespace bio::alphabet::detail
+{
+
+/*!\brief The high nibbles of the valid characters of an alphabet, as an array.
+ * \ingroup alphabet
+ * \hideinitializer
+ */
+template <typename alph_t>
+inline constexpr auto valid_high_nibbles = []() constexpr
+{
+    std::array<uint8_t, std::popcount(lookup_tables<alph_t>.valid_high_nibbles)> ret{};
+    size_t                                                                       j = 0;
+    for (uint8_t h = 0; h < 16; ++h)
+        if ((lookup_tables<alph_t>.valid_high_nibbles >> h) & 1u)
+            ret[j++] = h;
+    return ret;
+}
+();
+
+/*!\brief Whether chars_to_ranks() uses the vectorised code path for an alphabet.
+ * \ingroup alphabet
+ * \details
+ *
+ * Every distinct high nibble costs one additional shuffle per vector; beyond 8 the scalar loop is comparable.
+ */
+template <typename alph_t>
+inline constexpr bool chars_to_ranks_vectorised = lookup_tables<alph_t>.valid_by_nibbles &&
+                                                  valid_high_nibbles<alph_t>.size() > 0 &&
+                                                  valid_high_nibbles<alph_t>.size() <= 8;
+
+} // namespace bio::alphabet::detail
+
+namespace bio::alphabet
+{
+
+/*!\brief Convert a sequence of characters to ranks of an alphabet, stopping at the first invalid character.
+ * \ingroup alphabet
+ * \tparam alph_t The alphabet type; see bio::alphabet::lookup_tables for the requirements.
+ * \param[in] in The characters.
+ * \param[out] out Where the ranks are written; must be at least as large as `in`.
+ * \returns The position of the first character that is not valid for `alph_t` (see bio::alphabet::char_is_valid_for)
+ * or `in.size()`.
+ * \details
+ *
+ * The ranks of all characters before the returned position are written to `out`; the values behind are
+ * unspecified. This is equivalent to calling bio::alphabet::assign_char_strictly_to on every character and
+ * converting the result with bio::alphabet::to_rank, but the check and the conversion are performed on 32 (AVX2) or
+ * 16 (SSSE3) characters at once via the nibble-split tables of bio::alphabet::lookup_tables.
+ *
+ * ### Complexity
+ *
+ * Linear in the size of `in`.
+ *
+ * ### Exceptions
+ *
+ * No-throw guarantee.
+ */
+template <typename alph_t>
+size_t chars_to_ranks(std::string_view const in, std::span<uint8_t> const out) noexcept
+{
+    assert(out.size() >= in.size());
+
+    constexpr char_lookup_tables<alph_t> const & tables = lookup_tables<alph_t>;
+    size_t                                       i      = 0;
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+    if constexpr (detail::chars_to_ranks_vectorised<alph_t>)
+    {
+        constexpr auto & high_nibbles = detail::valid_high_nibbles<alph_t>;
+#    if defined(__AVX2__)
+        using vec_t            = __m256i;
+        constexpr size_t width = 32;
+
+        auto load_table = [](uint8_t const * ptr)
+        { return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr))); };
+        auto load     = [](char const * ptr) { return _mm256_loadu_si256(reinterpret_cast<vec_t const *>(ptr)); };
+        auto store    = [](uint8_t * ptr, vec_t const v) { _mm256_storeu_si256(reinterpret_cast<vec_t *>(ptr), v); };
+        auto set1     = [](uint8_t const v) { return _mm256_set1_epi8(static_cast<char>(v)); };
+        auto shuffle  = [](vec_t const tbl, vec_t const idx) { return _mm256_shuffle_epi8(tbl, idx); };
+        auto and_     = [](vec_t const a, vec_t const b) { return _mm256_and_si256(a, b); };
+        auto or_      = [](vec_t const a, vec_t const b) { return _mm256_or_si256(a, b); };
+        auto eq       = [](vec_t const a, vec_t const b) { return _mm256_cmpeq_epi8(a, b); };
+        auto srli4    = [](vec_t const a) { return _mm256_srli_epi16(a, 4); };
+        auto movemask = [](vec_t const a) { return static_cast<uint32_t>(_mm256_movemask_epi8(a)); };
+#    else
+        using vec_t            = __m128i;
+        constexpr size_t width = 16;
+
+        auto load_table = [](uint8_t const * ptr) { return _mm_loadu_si128(reinterpret_cast<vec_t const *>(ptr)); };
+        auto load       = [](char const * ptr) { return _mm_loadu_si128(reinterpret_cast<vec_t const *>(ptr)); };
+        auto store      = [](uint8_t * ptr, vec_t const v) { _mm_storeu_si128(reinterpret_cast<vec_t *>(ptr), v); };
+        auto set1       = [](uint8_t const v) { return _mm_set1_epi8(static_cast<char>(v)); };
+        auto shuffle    = [](vec_t const tbl, vec_t const idx) { return _mm_shuffle_epi8(tbl, idx); };
+        auto and_       = [](vec_t const a, vec_t const b) { return _mm_and_si128(a, b); };
+        auto or_        = [](vec_t const a, vec_t const b) { return _mm_or_si128(a, b); };
+        auto eq         = [](vec_t const a, vec_t const b) { return _mm_cmpeq_epi8(a, b); };
+        auto srli4      = [](vec_t const a) { return _mm_srli_epi16(a, 4); };
+        auto movemask   = [](vec_t const a) { return static_cast<uint32_t>(_mm_movemask_epi8(a)); };
+#    endif
+
+        vec_t const nibble_mask = set1(0x0F);
+        vec_t const zero        = set1(0);
+        vec_t const valid_lo    = load_table(tables.valid_lo.data());
+        vec_t const valid_hi    = load_table(tables.valid_hi.data());
+
+        vec_t rank_tables[high_nibbles.size()];
+        vec_t high_nibble_values[high_nibbles.size()];
+        for (size_t k = 0; k < high_nibbles.size(); ++k)
+        {
+            rank_tables[k]        = load_table(tables.rank_by_nibbles[high_nibbles[k]].data());
+            high_nibble_values[k] = set1(high_nibbles[k]);
+        }
+
+        for (; i + width <= in.size(); i += width)
+        {
+            vec_t const chars = load(in.data() + i);
+            vec_t const lo    = and_(chars, nibble_mask);
+            vec_t const hi    = and_(srli4(chars), nibble_mask);
+
+            // an invalid character somewhere in this block; let the scalar loop find it
+            if (movemask(eq(and_(shuffle(valid_lo, lo), shuffle(valid_hi, hi)), zero)) != 0)
+                break;
+
+            vec_t ranks = zero;
+            for (size_t k = 0; k < high_nibbles.size(); ++k)
+                ranks = or_(ranks, and_(shuffle(rank_tables[k], lo), eq(hi, high_nibble_values[k])));
+            store(out.data() + i, ranks);
+        }
+    }
+#endif
+
+    for (; i < in.size(); ++i)
+    {
+        if (!tables.is_valid(in[i]))
+            return i;
+        out[i] = tables.char_to_rank[static_cast<uint8_t>(in[i])];
+    }
+
+    return in.size();
+}
+
+} // namespace bio::alphabet
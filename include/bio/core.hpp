@@ -296,3 +296,99 @@ namespace views = ranges::views;
  */
 namespace bio::ranges::detail
 {}
+
+// ============================================================================
+//  Preprocessing namespaces
+// ============================================================================
+
+/*!\namespace bio::preprocessing
+ * \brief The preprocessing module's namespace.
+ * \ingroup preprocessing
+ */
+namespace bio::preprocessing
+{}
+
+/*!\if DEV
+ * \namespace bio::preprocessing::detail
+ * \brief The internal BioC++ namespace.
+ * \ingroup preprocessing
+ * \details
+ * The contents of this namespace are not visible to consumers of the library and the documentation is
+ * only generated for developers.
+ * \sa https://github.com/biocpp/biocpp-core/wiki/Documentation
+ * \endif
+ */
+namespace bio::preprocessing::detail
+{}
+
+// ============================================================================
+//  Alignment namespaces
+// ============================================================================
+
+/*!\namespace bio::alignment
+ * \brief The alignment module's namespace.
+ * \ingroup alignment
+ */
+namespace bio::alignment
+{}
+
+/*!\if DEV
+ * \namespace bio::alignment::detail
+ * \brief The internal BioC++ namespace.
+ * \ingroup alignment
+ * \details
+ * The contents of this namespace are not visible to consumers of the library and the documentation is
+ * only generated for developers.
+ * \sa https://github.com/biocpp/biocpp-core/wiki/Documentation
+ * \endif
+ */
+namespace bio::alignment::detail
+{}
+
+// ============================================================================
+//  Search namespaces
+// ============================================================================
+
+/*!\namespace bio::search
+ * \brief The search module's namespace.
+ * \ingroup search
+ */
+namespace bio::search
+{}
+
+/*!\if DEV
+ * \namespace bio::search::detail
+ * \brief The internal BioC++ namespace.
+ * \ingroup search
+ * \details
+ * The contents of this namespace are not visible to consumers of the library and the documentation is
+ * only generated for developers.
+ * \sa https://github.com/biocpp/biocpp-core/wiki/Documentation
+ * \endif
+ */
+namespace bio::search::detail
+{}
+
+// ============================================================================
+//  K-mer namespaces
+// ============================================================================
+
+/*!\namespace bio::kmer
+ * \brief The k-mer module's namespace.
+ * \ingroup kmer
+ */
+namespace bio::kmer
+{}
+
+/*!\if DEV
+ * \namespace bio::kmer::detail
+ * \brief The internal BioC++ namespace.
+ * \ingroup kmer
+ * \details
+ * The contents of this namespace are not visible to consumers of the library and the documentation is
+ * only generated for developers.
+ * \sa https://github.com/biocpp/biocpp-core/wiki/Documentation
+ * \endif
+ */
+namespace bio::kmer::detail
+{}
@@ -0,0 +1,29 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Meta-header for the \link kmer k-mer module \endlink.
+ */
+
+#pragma once
+
+#include <bio/kmer/de_bruijn_graph.hpp>
+#include <bio/kmer/distance_matrix.hpp>
+#include <bio/kmer/error_corrector.hpp>
+#include <bio/kmer/hash.hpp>
+#include <bio/kmer/hyperloglog.hpp>
+#include <bio/kmer/interleaved_bloom_filter.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+#include <bio/kmer/kmer_counter.hpp>
+#include <bio/kmer/minhash.hpp>
+
+/*!\defgroup kmer K-mer
+ * \brief The k-mer module provides sketches, counters, indexes and read correction over the k-mers of nucleotide
+ *        sequences.
+ *
+ * k-mers of up to 32 letters are represented as packed 2-bit codes in a `uint64_t` (see
+ * bio::kmer::for_each_kmer()); hash values are derived from the codes with bio::kmer::mix64().
+ */
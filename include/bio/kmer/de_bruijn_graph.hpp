@@ -0,0 +1,422 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::de_bruijn_graph.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/detail/radix_sort.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief Options for bio::kmer::de_bruijn_graph.
+ * \ingroup kmer
+ */
+struct de_bruijn_graph_options
+{
+    //!\brief The length of the k-mers (1 to 32; odd if canonical).
+    uint8_t k         = 31;
+    //!\brief Whether a k-mer and its reverse complement are the same node (bidirected graph).
+    bool    canonical = true;
+    //!\brief The number of threads used for computing the edges and the unitigs.
+    size_t  threads   = 1;
+};
+
+/*!\brief A node-centric de Bruijn graph over a set of k-mer codes.
+ * \ingroup kmer
+ * \details
+ *
+ * The nodes are the (canonical) k-mers, stored as a sorted array of codes (see bio::kmer::for_each_kmer()); two
+ * nodes are connected if they overlap by `k - 1` letters. Edges are not stored explicitly but as an 8-bit mask per
+ * node: bit `c` (0 to 3) is set if appending letter `c` (`A`, `C`, `G`, `T`) to the node's code and dropping the
+ * first letter gives a node, and bit `4 + c` if prepending `c` and dropping the last letter does. In a canonical
+ * graph, the neighbours are looked up by their canonical code, i.e. the graph is bidirected and a node can be
+ * traversed in both orientations.
+ *
+ * A node is found by a binary search in a bucket of the sorted array; the buckets are given by the top bits of the
+ * codes (about 16 nodes per bucket), so the graph takes about 9.5 bytes per node, e.g. 2.9 GB for 300 million
+ * k-mers. The construction needs another 8 bytes per k-mer if the codes are not already sorted.
+ *
+ * Canonical graphs require an odd `k`, so that no k-mer is its own reverse complement.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/de_bruijn_graph.cpp
+ */
+class de_bruijn_graph
+{
+public:
+    //!\brief The type of the container of unitigs.
+    using unitigs_type = ranges::concatenated_sequences<ranges::bitcompressed_vector<alphabet::dna4>>;
+
+    //!\brief Returned by #find() if a k-mer is not in the graph.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    //!\brief The options.
+    de_bruijn_graph_options opts{};
+    //!\brief The sorted (canonical) codes of the nodes.
+    std::vector<uint64_t>   codes;
+    //!\brief The edge masks of the nodes.
+    std::vector<uint8_t>    masks;
+    //!\brief The index of the first node of every bucket (and the number of nodes at the end).
+    std::vector<size_t>     buckets{0, 0};
+    //!\brief The codes are shifted right by this to get their bucket.
+    unsigned                bucket_shift = 64;
+
+    //!\brief A node in an orientation (`reverse` if traversed as the reverse complement of its code).
+    struct oriented_node
+    {
+        //!\brief The index of the node.
+        size_t index;
+        //!\brief Whether the node is traversed as its reverse complement.
+        bool   reverse;
+
+        //!\brief The same node in the other orientation.
+        oriented_node flip() const noexcept { return {index, !reverse}; }
+
+        //!\brief Nodes are ordered by index, then orientation.
+        friend auto operator<=>(oriented_node const &, oriented_node const &) = default;
+    };
+
+    //!\brief Reverse the order of the four bits of a nibble (i.e. complement the letters of an edge mask).
+    static constexpr uint8_t complement_letters(uint8_t const nibble) noexcept
+    {
+        return ((nibble & 1) << 3) | ((nibble & 2) << 1) | ((nibble & 4) >> 1) | ((nibble & 8) >> 3);
+    }
+
+    //!\brief The code of a node as traversed.
+    uint64_t code_of(oriented_node const n) const noexcept
+    {
+        return n.reverse ? reverse_complement(codes[n.index], opts.k) : codes[n.index];
+    }
+
+    //!\brief The letters that can follow a node as traversed.
+    uint8_t out_letters(oriented_node const n) const noexcept
+    {
+        return n.reverse ? complement_letters(masks[n.index] >> 4) : masks[n.index] & 0x0F;
+    }
+
+    //!\brief The letters that can precede a node as traversed.
+    uint8_t in_letters(oriented_node const n) const noexcept
+    {
+        return n.reverse ? complement_letters(masks[n.index] & 0x0F) : masks[n.index] >> 4;
+    }
+
+    //!\brief The node (in orientation) of a k-mer code; it must be in the graph.
+    oriented_node locate(uint64_t const code) const noexcept
+    {
+        uint64_t const key = opts.canonical ? std::min(code, reverse_complement(code, opts.k)) : code;
+        return {find_canonical(key), key != code};
+    }
+
+    //!\brief The node that follows `n` with letter `c`.
+    oriented_node successor(oriented_node const n, uint8_t const c) const noexcept
+    {
+        return locate(((code_of(n) << 2) | c) & kmer_mask(opts.k));
+    }
+
+    //!\brief The node that precedes `n` with letter `c`.
+    oriented_node predecessor(oriented_node const n, uint8_t const c) const noexcept
+    {
+        return locate((code_of(n) >> 2) | (static_cast<uint64_t>(c) << (2 * (opts.k - 1))));
+    }
+
+    /*!\brief The next node on a unitig: the only successor of `n`, if `n` is its only predecessor and it is a
+     *        different node. Symmetric: `v` follows `u` if and only if `u.flip()` follows `v.flip()`.
+     */
+    std::optional<oriented_node> extension(oriented_node const n) const noexcept
+    {
+        uint8_t const out = out_letters(n);
+        if (std::popcount(out) != 1)
+            return std::nullopt;
+        oriented_node const next = successor(n, std::countr_zero(out));
+        if (std::popcount(in_letters(next)) != 1 || next.index == n.index)
+            return std::nullopt;
+        return next;
+    }
+
+    //!\brief Whether a unitig starts at `n`, i.e. `n` is not the extension of another node.
+    bool starts_unitig(oriented_node const n) const noexcept
+    {
+        uint8_t const in = in_letters(n);
+        if (std::popcount(in) != 1)
+            return true;
+        // the only successor of the predecessor is n, so extension(pred) needs no lookup
+        oriented_node const pred = predecessor(n, std::countr_zero(in));
+        return std::popcount(out_letters(pred)) != 1 || pred.index == n.index;
+    }
+
+    //!\brief The bucket of a code.
+    size_t bucket_of(uint64_t const code) const noexcept { return bucket_shift < 64 ? code >> bucket_shift : 0; }
+
+    //!\brief Binary search for a canonical code in its bucket.
+    size_t find_canonical(uint64_t const code) const noexcept
+    {
+        size_t const b     = bucket_of(code);
+        auto const   first = codes.begin() + buckets[b];
+        auto const   last  = codes.begin() + buckets[b + 1];
+        auto const   it    = std::lower_bound(first, last, code);
+        return it != last && *it == code ? it - codes.begin() : npos;
+    }
+
+    //!\brief Call `fn(t)` on `threads` threads and rethrow the first exception.
+    template <typename fn_t>
+    void run_parallel(size_t const threads, fn_t && fn) const
+    {
+        std::vector<std::exception_ptr> errors(threads);
+        auto                            work = [&](size_t const t)
+        {
+            try
+            {
+                fn(t);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (std::thread & w : workers)
+            w.join();
+
+        for (std::exception_ptr const & e : errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+
+    //!\brief Walk the unitig that starts at `n`, append its letters to `letters` and return its last node.
+    template <typename stop_fn_t>
+    oriented_node walk(oriented_node n, std::vector<alphabet::dna4> & letters, stop_fn_t && stop) const
+    {
+        uint64_t const code = code_of(n);
+        for (size_t i = opts.k; i > 0; --i)
+            letters.push_back(alphabet::dna4{}.assign_rank((code >> (2 * (i - 1))) & 3));
+
+        for (std::optional<oriented_node> next = extension(n); next && !stop(*next); next = extension(n))
+        {
+            letters.push_back(alphabet::dna4{}.assign_rank(code_of(*next) & 3));
+            n = *next;
+        }
+        return n;
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    de_bruijn_graph()                                    = default; //!< Defaulted.
+    de_bruijn_graph(de_bruijn_graph const &)             = default; //!< Defaulted.
+    de_bruijn_graph(de_bruijn_graph &&)                  = default; //!< Defaulted.
+    de_bruijn_graph & operator=(de_bruijn_graph const &) = default; //!< Defaulted.
+    de_bruijn_graph & operator=(de_bruijn_graph &&)      = default; //!< Defaulted.
+    ~de_bruijn_graph()                                   = default; //!< Defaulted.
+
+    /*!\brief Construct from k-mer codes.
+     * \param[in] kmers   The codes of the k-mers, e.g. those counted at least twice by bio::kmer::kmer_counter; in
+     *                    any order and orientation, with duplicates.
+     * \param[in] options The options.
+     * \throws std::invalid_argument If `k` is not between 1 and 32, or even in a canonical graph.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the number of k-mers (radix sort, unless they are already sorted) plus eight lookups per node.
+     */
+    explicit de_bruijn_graph(std::vector<uint64_t> kmers, de_bruijn_graph_options const options = {}) :
+      opts{options},
+      codes{std::move(kmers)}
+    {
+        detail::check_k(options.k);
+        if (options.canonical && options.k % 2 == 0)
+            throw std::invalid_argument{"k must be odd in a canonical de Bruijn graph."};
+
+        if (opts.canonical)
+            for (uint64_t & code : codes)
+                code = canonical(code, opts.k);
+        if (!std::ranges::is_sorted(codes))
+        {
+            std::vector<uint64_t> scratch;
+            detail::radix_sort(codes, scratch, 2 * opts.k);
+        }
+        codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+        codes.shrink_to_fit();
+
+        // about 16 nodes per bucket
+        unsigned const bucket_bits = std::min<unsigned>(std::bit_width(codes.size() / 16), 2 * opts.k);
+        bucket_shift               = 2 * opts.k - bucket_bits;
+        buckets.assign((size_t{1} << bucket_bits) + 1, 0);
+        for (uint64_t const code : codes)
+            ++buckets[bucket_of(code) + 1];
+        for (size_t b = 1; b < buckets.size(); ++b)
+            buckets[b] += buckets[b - 1];
+
+        masks.resize(codes.size());
+        size_t const n       = codes.size();
+        size_t const threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n, 1));
+        run_parallel(threads,
+                     [&](size_t const t)
+                     {
+                         uint64_t const mask = kmer_mask(opts.k);
+                         for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+                         {
+                             uint8_t edges = 0;
+                             for (uint64_t c = 0; c < 4; ++c)
+                             {
+                                 uint64_t const succ = ((codes[i] << 2) | c) & mask;
+                                 uint64_t const pred = (codes[i] >> 2) | (c << (2 * (opts.k - 1)));
+                                 edges |= contains(succ) << c;
+                                 edges |= contains(pred) << (4 + c);
+                             }
+                             masks[i] = edges;
+                         }
+                     });
+    }
+    //!\}
+
+    //!\brief The options.
+    de_bruijn_graph_options const & options() const noexcept { return opts; }
+
+    //!\brief The number of nodes.
+    size_t size() const noexcept { return codes.size(); }
+
+    //!\brief The sorted (canonical) codes of the nodes.
+    std::span<uint64_t const> nodes() const noexcept { return codes; }
+
+    //!\brief The edge masks of the nodes (successor letters in bits 0 to 3, predecessor letters in bits 4 to 7).
+    std::span<uint8_t const> edge_masks() const noexcept { return masks; }
+
+    /*!\name Lookup
+     * \{
+     */
+    //!\brief The index of a k-mer (in either orientation in a canonical graph) or #npos.
+    size_t find(uint64_t const code) const noexcept
+    {
+        return find_canonical(opts.canonical ? canonical(code, opts.k) : code);
+    }
+
+    //!\brief Whether a k-mer is a node.
+    bool contains(uint64_t const code) const noexcept { return find(code) != npos; }
+    //!\}
+
+    /*!\brief Compute the unitigs, i.e. the maximal non-branching paths, possibly in parallel.
+     * \returns The sequences of the unitigs.
+     * \details
+     *
+     * Every node is in exactly one unitig; the unitigs of a canonical graph may contain a node in either
+     * orientation. With bio::kmer::de_bruijn_graph_options::threads greater than one, the nodes are split into
+     * contiguous blocks and every thread walks the unitigs that start in its block; the walks only read the graph.
+     * A unitig is reported by the walk from the end with the smaller node index, so the result does not depend on
+     * the number of threads. Cycles without a start are walked at the end.
+     *
+     * ### Complexity
+     *
+     * Linear in the number of nodes (at most two walks per unitig, with a lookup per step).
+     */
+    unitigs_type unitigs() const
+    {
+        size_t const              n       = codes.size();
+        size_t const              threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n, 1));
+        std::vector<uint8_t>      visited(n);
+        std::vector<unitigs_type> partial(threads);
+
+        run_parallel(threads,
+                     [&](size_t const t)
+                     {
+                         std::vector<alphabet::dna4> letters;
+                         std::vector<size_t>         path;
+                         for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+                         {
+                             for (bool const reverse : {false, true})
+                             {
+                                 oriented_node const first{i, reverse};
+                                 if ((reverse && !opts.canonical) || !starts_unitig(first))
+                                     continue;
+
+                                 letters.clear();
+                                 path.assign(1, i);
+                                 oriented_node const last = walk(first,
+                                                                 letters,
+                                                                 [&](oriented_node const next)
+                                                                 {
+                                                                     path.push_back(next.index);
+                                                                     return next.index == i;
+                                                                 });
+                                 // the same unitig is also walked in the other direction from its last node
+                                 if (opts.canonical && last.flip() < first)
+                                     continue;
+
+                                 partial[t].push_back(letters);
+                                 // only this thread reports the unitig, so no other thread writes these bytes
+                                 for (size_t const j : path)
+                                     visited[j] = 1;
+                             }
+                         }
+                     });
+
+        unitigs_type ret;
+        size_t       count = 0, letters = 0;
+        for (unitigs_type const & p : partial)
+        {
+            count += p.size();
+            letters += p.concat_size();
+        }
+        ret.reserve(count, letters);
+        for (unitigs_type & p : partial)
+        {
+            for (auto && unitig : p)
+                ret.push_back(unitig);
+            p.clear();
+        }
+
+        // cycles without a start
+        std::vector<alphabet::dna4> letters_of_cycle;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (visited[i])
+                continue;
+
+            letters_of_cycle.clear();
+            visited[i] = 1;
+            walk(oriented_node{i, false},
+                 letters_of_cycle,
+                 [&](oriented_node const next) { return std::exchange(visited[next.index], 1) != 0; });
+            ret.push_back(letters_of_cycle);
+        }
+        return ret;
+    }
+
+    //!\brief Graphs are equal if they have the same options (except threads) and nodes.
+    friend bool operator==(de_bruijn_graph const & lhs, de_bruijn_graph const & rhs) noexcept
+    {
+        return lhs.opts.k == rhs.opts.k && lhs.opts.canonical == rhs.opts.canonical && lhs.codes == rhs.codes;
+    }
+};
+
+} // namespace bio::kmer
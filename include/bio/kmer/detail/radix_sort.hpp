@@ -0,0 +1,53 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::detail::radix_sort.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace bio::kmer::detail
+{
+
+/*!\brief Sort k-mer codes with a least-significant-digit radix sort (8-bit digits).
+ * \param[in,out] values  The codes.
+ * \param[in,out] scratch A buffer of the same size (resized if necessary).
+ * \param[in]     bits    The number of significant bits of the codes.
+ * \details
+ *
+ * The histograms of all digits are computed in one pass; digits that are the same for all codes are skipped.
+ */
+inline void radix_sort(std::vector<uint64_t> & values, std::vector<uint64_t> & scratch, unsigned const bits)
+{
+    unsigned const                       digits = (bits + 7) / 8;
+    std::vector<std::array<size_t, 256>> histograms(digits);
+    for (uint64_t const v : values)
+        for (unsigned d = 0; d < digits; ++d)
+            ++histograms[d][(v >> (8 * d)) & 0xFF];
+
+    scratch.resize(values.size());
+    for (unsigned d = 0; d < digits; ++d)
+    {
+        std::array<size_t, 256> & offsets = histograms[d];
+        if (std::ranges::find(offsets, values.size()) != offsets.end())
+            continue;
+
+        std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), size_t{0});
+        for (uint64_t const v : values)
+            scratch[offsets[(v >> (8 * d)) & 0xFF]++] = v;
+        values.swap(scratch);
+    }
+}
+
+} // namespace bio::kmer::detail
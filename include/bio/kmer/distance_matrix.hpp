@@ -0,0 +1,427 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::distance_matrix, bio::kmer::all_vs_all() and bio::kmer::mash_distance().
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+#include <bio/kmer/minhash.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief The Mash distance of two inputs with a given Jaccard index.
+ * \ingroup kmer
+ * \param[in] jaccard The Jaccard index of the k-mer sets, e.g. from bio::kmer::jaccard().
+ * \param[in] k       The length of the k-mers.
+ * \returns `-ln(2j / (1 + j)) / k`, capped at `1` (also for a Jaccard index of `0`).
+ * \details
+ *
+ * This estimates the per-letter mutation rate between two sequences under a Poisson model (Ondov et al., 2016).
+ */
+inline double mash_distance(double const jaccard, uint8_t const k)
+{
+    if (jaccard <= 0.0)
+        return 1.0;
+    return std::min(-std::log(2.0 * jaccard / (1.0 + jaccard)) / k, 1.0);
+}
+
+/*!\brief The Mash distance of the inputs of two sketches.
+ * \ingroup kmer
+ * \param[in] lhs A sketch.
+ * \param[in] rhs Another sketch.
+ * \throws std::invalid_argument If the sketches are not bio::kmer::minhash_sketch::compatible().
+ */
+inline double mash_distance(minhash_sketch const & lhs, minhash_sketch const & rhs)
+{
+    return mash_distance(jaccard(lhs, rhs), lhs.options().k);
+}
+
+/*!\brief Options for bio::kmer::all_vs_all() and bio::kmer::all_vs_all_sparse().
+ * \ingroup kmer
+ */
+struct all_vs_all_options
+{
+    //!\brief The length of the k-mers of k-mer sets; ignored for sketches, which store it.
+    uint8_t k            = 0;
+    //!\brief bio::kmer::all_vs_all_sparse() only reports pairs with at most this distance.
+    double  max_distance = 1.0;
+    //!\brief The number of inputs per side of a tile of the pair space.
+    size_t  tile_size    = 64;
+    //!\brief The number of threads.
+    size_t  threads      = 1;
+};
+
+/*!\brief The pairwise distances of `n` inputs, stored as a condensed upper triangle.
+ * \ingroup kmer
+ * \details
+ *
+ * The `n * (n - 1) / 2` distances of the pairs `i < j` are stored row by row, i.e. in the order of
+ * bio::views::pairwise_combine (and of `scipy.spatial.distance.squareform`). They are stored as `float`, which is
+ * more precise than the estimates and halves the memory of large matrices.
+ */
+class distance_matrix
+{
+private:
+    //!\brief The number of inputs.
+    size_t             n = 0;
+    //!\brief The condensed distances.
+    std::vector<float> values;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    distance_matrix()                                    = default; //!< Defaulted.
+    distance_matrix(distance_matrix const &)             = default; //!< Defaulted.
+    distance_matrix(distance_matrix &&)                  = default; //!< Defaulted.
+    distance_matrix & operator=(distance_matrix const &) = default; //!< Defaulted.
+    distance_matrix & operator=(distance_matrix &&)      = default; //!< Defaulted.
+    ~distance_matrix()                                   = default; //!< Defaulted.
+
+    //!\brief Construct a matrix of `size` inputs with all distances `0`.
+    explicit distance_matrix(size_t const size) : n{size}, values(size < 2 ? 0 : size * (size - 1) / 2, 0.0f) {}
+    //!\}
+
+    //!\brief The number of inputs (rows and columns).
+    size_t size() const noexcept { return n; }
+
+    //!\brief The position of the pair `i < j` in the condensed distances.
+    size_t index(size_t const i, size_t const j) const noexcept { return i * n - i * (i + 1) / 2 + (j - i - 1); }
+
+    //!\brief The distance of the inputs `i` and `j` (`0` on the diagonal).
+    float operator()(size_t const i, size_t const j) const noexcept
+    {
+        if (i == j)
+            return 0.0f;
+        return i < j ? values[index(i, j)] : values[index(j, i)];
+    }
+
+    //!\brief The condensed distances.
+    std::span<float const> condensed() const noexcept { return values; }
+
+    //!\overload
+    std::span<float> condensed() noexcept { return values; }
+
+    //!\brief Matrices are equal if they have the same size and distances.
+    friend bool operator==(distance_matrix const &, distance_matrix const &) = default;
+};
+
+/*!\brief A pair of inputs and their distance, as reported by bio::kmer::all_vs_all_sparse().
+ * \ingroup kmer
+ */
+struct distance_entry
+{
+    //!\brief The index of the first input.
+    uint32_t i        = 0;
+    //!\brief The index of the second input (greater than bio::kmer::distance_entry::i).
+    uint32_t j        = 0;
+    //!\brief The distance.
+    float    distance = 0.0f;
+
+    //!\brief Defaulted.
+    friend bool operator==(distance_entry const &, distance_entry const &) = default;
+};
+
+} // namespace bio::kmer
+
+namespace bio::kmer::detail
+{
+
+#if defined(__AVX2__)
+//!\brief The mask of the 64-bit lanes of `lhs` that are greater than those of `rhs` (signed).
+inline uint32_t lanes_greater(__m256i const lhs, __m256i const rhs)
+{
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lhs, rhs))));
+}
+#endif
+
+/*!\brief Merge two sorted, distinct arrays of hash values until `limit` distinct values are consumed.
+ * \ingroup kmer
+ * \returns The number of values in both arrays and the number of distinct values consumed.
+ * \details
+ *
+ * This computes the same counts as bio::kmer::jaccard(). With AVX2, blocks of four values of each array are
+ * compared all-against-all (three lane rotations); the values of both blocks that are not greater than the smaller
+ * block maximum are consumed, so the state after every step is that of the scalar merge and no match is counted
+ * twice. The blocks are processed while at least eight values are left before the limit; the rest is merged
+ * without branches on the comparison.
+ */
+inline std::pair<size_t, size_t> merge_intersect(std::span<uint64_t const> const a,
+                                                 std::span<uint64_t const> const b,
+                                                 size_t const                    limit)
+{
+    size_t i = 0, j = 0, shared = 0;
+
+#if defined(__AVX2__)
+    __m256i const sign = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+    while (i + 4 <= a.size() && j + 4 <= b.size() && i + j - shared + 8 <= limit)
+    {
+        __m256i const va = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(a.data() + i));
+        __m256i const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b.data() + j));
+
+        // every lane of a against every lane of b
+        __m256i const e0    = _mm256_cmpeq_epi64(va, vb);
+        __m256i const e1    = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0b00'11'10'01));
+        __m256i const e2    = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0b01'00'11'10));
+        __m256i const e3    = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0b10'01'00'11));
+        __m256i const equal = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+
+        // the lanes that are not greater than the smaller block maximum (unsigned, via the flipped sign bit)
+        int64_t const  max   = static_cast<int64_t>(std::min(a[i + 3], b[j + 3]));
+        __m256i const  bound = _mm256_xor_si256(_mm256_set1_epi64x(max), sign);
+        uint32_t const a_le  = ~lanes_greater(_mm256_xor_si256(va, sign), bound) & 0xFu;
+        uint32_t const b_le  = ~lanes_greater(_mm256_xor_si256(vb, sign), bound) & 0xFu;
+        uint32_t const hits  = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(equal))) & a_le;
+
+        shared += std::popcount(hits);
+        i += std::popcount(a_le);
+        j += std::popcount(b_le);
+    }
+#endif
+
+    size_t total = i + j - shared;
+    for (; total < limit && i < a.size() && j < b.size(); ++total)
+    {
+        uint64_t const x = a[i], y = b[j];
+        shared += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    total += std::min(limit - total, (a.size() - i) + (b.size() - j));
+
+    return {shared, total};
+}
+
+/*!\brief Call `fun(i, j, t)` for all pairs `i < j < n` on `threads` threads (`t` is the thread number).
+ * \ingroup kmer
+ * \details
+ *
+ * The triangle of pairs is split into square tiles of `tile_size` rows and columns (triangles on the diagonal);
+ * the threads take the next unprocessed tile until all are done. The inputs of a tile are reused for
+ * `tile_size` pairs each, so they stay in the cache if a tile's inputs fit.
+ */
+template <typename fun_t>
+void for_each_pair_tiled(size_t const n, size_t const tile_size, size_t const threads, fun_t && fun)
+{
+    size_t const tile  = std::max<size_t>(tile_size, 1);
+    size_t const sides = (n + tile - 1) / tile;
+
+    std::vector<std::pair<size_t, size_t>> tiles;
+    tiles.reserve(sides * (sides + 1) / 2);
+    for (size_t r = 0; r < sides; ++r)
+        for (size_t c = r; c < sides; ++c)
+            tiles.emplace_back(r, c);
+
+    std::atomic<size_t>             next{0};
+    std::vector<std::exception_ptr> errors(threads);
+    auto                            work = [&](size_t const t)
+    {
+        try
+        {
+            for (size_t x = next++; x < tiles.size(); x = next++)
+            {
+                auto const [r, c] = tiles[x];
+                for (size_t i = r * tile; i < std::min(n, (r + 1) * tile); ++i)
+                    for (size_t j = std::max(i + 1, c * tile); j < std::min(n, (c + 1) * tile); ++j)
+                        fun(i, j, t);
+            }
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+            next      = tiles.size();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work, t);
+    work(0);
+    for (std::thread & w : workers)
+        w.join();
+
+    for (std::exception_ptr const & e : errors)
+        if (e)
+            std::rethrow_exception(e);
+}
+
+/*!\brief The hash values (or k-mer codes) of the inputs of bio::kmer::all_vs_all(), their k and sketch size.
+ * \ingroup kmer
+ */
+struct all_vs_all_inputs
+{
+    //!\brief The sorted hash values of every input.
+    std::vector<std::span<uint64_t const>> hashes;
+    //!\brief The length of the k-mers.
+    uint8_t                                k     = 0;
+    //!\brief The sketch size that bounds the merge.
+    size_t                                 limit = std::numeric_limits<size_t>::max();
+};
+
+//!\brief Collect the inputs of bio::kmer::all_vs_all() from sketches or k-mer sets.
+template <typename inputs_t>
+all_vs_all_inputs collect_inputs(inputs_t && inputs, all_vs_all_options const & options)
+{
+    all_vs_all_inputs ret;
+    ret.hashes.reserve(std::ranges::size(inputs));
+
+    if constexpr (std::same_as<std::ranges::range_value_t<inputs_t>, minhash_sketch>)
+    {
+        for (minhash_sketch const & s : inputs)
+        {
+            if (!ret.hashes.empty() && !s.compatible(inputs[0]))
+                throw std::invalid_argument{"Only sketches with the same k, sketch size and scaling can be compared."};
+            ret.hashes.emplace_back(s.hashes());
+        }
+        if (!ret.hashes.empty())
+        {
+            ret.k = inputs[0].options().k;
+            if (inputs[0].options().sketch_size > 0)
+                ret.limit = inputs[0].options().sketch_size;
+        }
+    }
+    else
+    {
+        if (options.k == 0 || options.k > 32)
+            throw std::invalid_argument{"The k-mer length of k-mer sets must be between 1 and 32."};
+        for (auto && set : inputs)
+            ret.hashes.emplace_back(std::ranges::data(set), std::ranges::size(set));
+        ret.k = options.k;
+    }
+
+    if (ret.hashes.size() > std::numeric_limits<uint32_t>::max())
+        throw std::invalid_argument{"At most 2^32 - 1 inputs can be compared."};
+    return ret;
+}
+
+/*!\brief Inputs of bio::kmer::all_vs_all(): sketches or sorted, distinct k-mer codes (or hash values).
+ * \ingroup kmer
+ */
+template <typename inputs_t>
+concept all_vs_all_range =
+  std::ranges::random_access_range<inputs_t> && std::ranges::sized_range<inputs_t> &&
+  (std::same_as<std::ranges::range_value_t<inputs_t>, minhash_sketch> ||
+   (std::ranges::contiguous_range<std::ranges::range_reference_t<inputs_t>> &&
+    std::ranges::sized_range<std::ranges::range_reference_t<inputs_t>> &&
+    std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<inputs_t>>, uint64_t>));
+
+} // namespace bio::kmer::detail
+
+namespace bio::kmer
+{
+
+/*!\brief Compute the Mash distances of all pairs of inputs, possibly in parallel.
+ * \ingroup kmer
+ * \param[in] inputs  Compatible bio::kmer::minhash_sketch es, or k-mer sets as contiguous ranges of sorted,
+ *                    distinct `uint64_t` (e.g. bio::kmer::de_bruijn_graph::nodes() or a
+ *                    bio::ranges::concatenated_sequences<std::vector<uint64_t>>).
+ * \param[in] options The options; bio::kmer::all_vs_all_options::k is required for k-mer sets.
+ * \returns The condensed matrix of bio::kmer::mash_distance() for every pair.
+ * \throws std::invalid_argument If the sketches are not bio::kmer::minhash_sketch::compatible() or k is not between
+ *                               1 and 32 for k-mer sets.
+ * \details
+ *
+ * The result is the same as that of bio::kmer::mash_distance() over bio::views::pairwise_combine of the sketches
+ * (for k-mer sets, the exact Jaccard index is used). The pair space is processed in tiles of
+ * bio::kmer::all_vs_all_options::tile_size inputs per side that are distributed over the threads, and the Jaccard
+ * index of every pair is computed by a merge-intersection of the sorted hash values that compares blocks of four
+ * values with AVX2 (if available).
+ *
+ * ### Complexity
+ *
+ * `O(n² s)` for `n` inputs of size `s`, with less than one branch per merged value.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/distance_matrix.cpp
+ */
+template <detail::all_vs_all_range inputs_t>
+distance_matrix all_vs_all(inputs_t && inputs, all_vs_all_options const options = {})
+{
+    detail::all_vs_all_inputs const in = detail::collect_inputs(inputs, options);
+    size_t const                    n  = in.hashes.size();
+    distance_matrix                 ret{n};
+    std::span<float> const          out = ret.condensed();
+
+    size_t const threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+    detail::for_each_pair_tiled(n,
+                                options.tile_size,
+                                threads,
+                                [&](size_t const i, size_t const j, size_t)
+                                {
+                                    auto const [shared, total] =
+                                      detail::merge_intersect(in.hashes[i], in.hashes[j], in.limit);
+                                    double const jac = total == 0 ? 0.0 : static_cast<double>(shared) / total;
+                                    out[ret.index(i, j)] = static_cast<float>(mash_distance(jac, in.k));
+                                });
+    return ret;
+}
+
+/*!\brief Compute the pairs of inputs within a maximum Mash distance, possibly in parallel.
+ * \ingroup kmer
+ * \param[in] inputs  See bio::kmer::all_vs_all().
+ * \param[in] options The options; only pairs up to bio::kmer::all_vs_all_options::max_distance are reported.
+ * \returns The pairs `i < j` with their distance, sorted by `i` and `j`.
+ * \throws std::invalid_argument See bio::kmer::all_vs_all().
+ * \details
+ *
+ * Computes the same distances as bio::kmer::all_vs_all() but stores only the close pairs, e.g. for clustering
+ * many genomes whose full matrix does not fit into memory.
+ */
+template <detail::all_vs_all_range inputs_t>
+std::vector<distance_entry> all_vs_all_sparse(inputs_t && inputs, all_vs_all_options const options = {})
+{
+    detail::all_vs_all_inputs const in = detail::collect_inputs(inputs, options);
+    size_t const                    n  = in.hashes.size();
+
+    size_t const                             threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+    std::vector<std::vector<distance_entry>> found(threads);
+    detail::for_each_pair_tiled(n,
+                                options.tile_size,
+                                threads,
+                                [&](size_t const i, size_t const j, size_t const t)
+                                {
+                                    auto const [shared, total] =
+                                      detail::merge_intersect(in.hashes[i], in.hashes[j], in.limit);
+                                    double const jac  = total == 0 ? 0.0 : static_cast<double>(shared) / total;
+                                    double const dist = mash_distance(jac, in.k);
+                                    if (dist <= options.max_distance)
+                                        found[t].push_back({static_cast<uint32_t>(i),
+                                                            static_cast<uint32_t>(j),
+                                                            static_cast<float>(dist)});
+                                });
+
+    std::vector<distance_entry> ret;
+    for (std::vector<distance_entry> const & f : found)
+        ret.insert(ret.end(), f.begin(), f.end());
+    std::ranges::sort(ret, [](distance_entry const & l, distance_entry const & r)
+                      { return l.i < r.i || (l.i == r.i && l.j < r.j); });
+    return ret;
+}
+
+} // namespace bio::kmer
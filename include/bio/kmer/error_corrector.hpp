@@ -0,0 +1,473 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::error_corrector.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <bio/alphabet/quality/concept.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief A set of k-mer codes: has a member `contains(code)` or is a predicate on codes.
+ * \ingroup kmer
+ * \details
+ *
+ * E.g. `std::unordered_set<uint64_t>` or a lambda that queries a Bloom filter.
+ */
+template <typename t>
+concept kmer_set = requires(t const & set, uint64_t const code) {
+                       {
+                           set.contains(code)
+                           } -> std::convertible_to<bool>;
+                   } || std::predicate<t const &, uint64_t>;
+
+/*!\brief Options for bio::kmer::error_corrector.
+ * \ingroup kmer
+ */
+struct error_correction_options
+{
+    //!\brief The length of the k-mers (1 to 32).
+    uint8_t k               = 31;
+    //!\brief Whether the set holds canonical k-mers (see bio::kmer::canonical()).
+    bool    canonical       = true;
+    //!\brief Other positions in a weak stretch are only tried if their phred score is at most this.
+    uint8_t max_quality     = 20;
+    //!\brief The maximum number of substitutions per read.
+    size_t  max_corrections = 4;
+    //!\brief The number of threads used by bio::kmer::error_corrector::correct_all().
+    size_t  threads         = 1;
+};
+
+/*!\brief Corrects substitution errors in reads using a set of solid (trusted) k-mers.
+ * \ingroup kmer
+ * \tparam set_t The type of the set of solid k-mers; must model bio::kmer::kmer_set.
+ * \details
+ *
+ * The solid k-mers are usually those that occur at least a few times in the dataset (e.g. counted with
+ * bio::kmer::kmer_counter), whereas sequencing errors create k-mers that occur once. The set can be a hash set or
+ * a Bloom filter (passed as a predicate).
+ *
+ * For every read, the forward and reverse complement codes of all k-mers are computed once. Weak k-mers (not in the
+ * set or containing `N`) form stretches; for an isolated substitution error at position `p`, the stretch consists
+ * of the (up to `k`) k-mers that contain `p`. Candidate positions are, in this order:
+ *
+ *   1. the position that is only covered by the last weak k-mer if the stretch is followed by a solid k-mer, and
+ *      the position only covered by the first weak k-mer if it is preceded by one;
+ *   2. the other positions of the stretch whose phred score is at most
+ *      bio::kmer::error_correction_options::max_quality, lowest quality first (all positions without qualities).
+ *
+ * A substitution is applied if exactly one of the other letters makes all k-mers that contain the position solid.
+ * Substituting a letter changes the codes of these k-mers by an XOR of a single shifted 2-bit delta (the delta is
+ * the same for the reverse complement), so candidates are tested without recomputing any codes. `N` is replaced like
+ * any other letter.
+ *
+ * Reads are ranges over a bio::kmer::kmer_alphabet, e.g. bio::alphabet::dna5 or bio::alphabet::qualified
+ * thereof; their letters are replaced in place (the quality of a bio::alphabet::qualified letter is kept).
+ *
+ * ### Thread safety
+ *
+ * The corrector holds buffers that are reused between reads, so use one per thread; #correct_all() does this.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/error_corrector.cpp
+ */
+template <kmer_set set_t>
+class error_corrector
+{
+private:
+    //!\brief The solid k-mers.
+    set_t const *            solid_set = nullptr;
+    //!\brief The options.
+    error_correction_options opts{};
+
+    //!\brief The 2-bit codes of the current read (`N` is stored as `0`).
+    std::vector<uint8_t>  codes;
+    //!\brief Whether a letter of the current read is `N`.
+    std::vector<uint8_t>  is_n;
+    //!\brief The phred scores of the current read.
+    std::vector<uint8_t>  quals;
+    //!\brief The forward codes of all k-mers.
+    std::vector<uint64_t> fwd;
+    //!\brief The reverse complement codes of all k-mers.
+    std::vector<uint64_t> rev;
+    //!\brief The number of `N` in every k-mer.
+    std::vector<uint32_t> n_count;
+    //!\brief Whether every k-mer is solid.
+    std::vector<uint8_t>  solid;
+    //!\brief The candidate positions of the current stretch.
+    std::vector<size_t>   candidates;
+    //!\brief The substituted positions of the current read.
+    std::vector<size_t>   corrected;
+
+    //!\brief Whether a k-mer is in the set.
+    bool contains(uint64_t const f, uint64_t const r) const
+    {
+        uint64_t const code = opts.canonical ? std::min(f, r) : f;
+        if constexpr (requires { solid_set->contains(code); })
+            return solid_set->contains(code);
+        else
+            return std::invoke(*solid_set, code);
+    }
+
+    //!\brief Compute the codes and the solidity of all k-mers of the current read.
+    void compute_kmers()
+    {
+        size_t const   k     = opts.k;
+        size_t const   n     = codes.size();
+        size_t const   count = n >= k ? n - k + 1 : 0;
+        uint64_t const mask  = kmer_mask(opts.k);
+
+        fwd.resize(count);
+        rev.resize(count);
+        n_count.resize(count);
+        solid.resize(count);
+
+        uint64_t f = 0, r = 0;
+        uint32_t ns = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            f = ((f << 2) | codes[i]) & mask;
+            r = (r >> 2) | (static_cast<uint64_t>(3 - codes[i]) << (2 * (k - 1)));
+            ns += is_n[i];
+            if (i + 1 >= k)
+            {
+                size_t const s = i + 1 - k;
+                if (s > 0)
+                    ns -= is_n[s - 1];
+                fwd[s]     = f;
+                rev[s]     = r;
+                n_count[s] = ns;
+                solid[s]   = ns == 0 && contains(f, r);
+            }
+        }
+    }
+
+    /*!\brief The letter that makes all k-mers containing position `p` solid, if there is exactly one.
+     * \returns The 2-bit code of the letter or `4`.
+     */
+    uint8_t find_substitution(size_t const p) const
+    {
+        size_t const k     = opts.k;
+        size_t const first = p + 1 >= k ? p + 1 - k : 0;
+        size_t const last  = std::min(p, fwd.size() - 1);
+
+        // N in other positions cannot be fixed here
+        for (size_t s = first; s <= last; ++s)
+            if (n_count[s] > is_n[p])
+                return 4;
+
+        uint8_t found = 4;
+        for (uint8_t c = 0; c < 4; ++c)
+        {
+            if (c == codes[p] && !is_n[p])
+                continue;
+
+            uint64_t const delta = codes[p] ^ c;
+            bool           ok    = true;
+            for (size_t s = first; ok && s <= last; ++s)
+                ok = contains(fwd[s] ^ (delta << (2 * (k - 1 - (p - s)))), rev[s] ^ (delta << (2 * (p - s))));
+
+            if (ok)
+            {
+                if (found != 4)
+                    return 4; // ambiguous
+                found = c;
+            }
+        }
+        return found;
+    }
+
+    //!\brief Apply a substitution to the codes.
+    void substitute(size_t const p, uint8_t const c) noexcept
+    {
+        size_t const   k     = opts.k;
+        size_t const   first = p + 1 >= k ? p + 1 - k : 0;
+        size_t const   last  = std::min(p, fwd.size() - 1);
+        uint64_t const delta = codes[p] ^ c;
+
+        for (size_t s = first; s <= last; ++s)
+        {
+            fwd[s] ^= delta << (2 * (k - 1 - (p - s)));
+            rev[s] ^= delta << (2 * (p - s));
+            n_count[s] -= is_n[p];
+            solid[s] = 1;
+        }
+        codes[p] = c;
+        is_n[p]  = 0;
+    }
+
+    //!\brief Try to correct the weak stretch of k-mers `[a, b]`; returns the corrected position or `SIZE_MAX`.
+    size_t correct_stretch(size_t const a, size_t const b)
+    {
+        size_t const k    = opts.k;
+        size_t const end  = b + k; // one past the last position of the stretch
+
+        candidates.clear();
+        if (b + 1 < fwd.size())
+            candidates.push_back(b);
+        if (a > 0 && a + k - 1 != b)
+            candidates.push_back(a + k - 1);
+
+        size_t const bounded = candidates.size();
+        for (size_t p = a; p < end; ++p)
+            if (quals[p] <= opts.max_quality && std::ranges::find(candidates, p) == candidates.end())
+                candidates.push_back(p);
+        std::stable_sort(candidates.begin() + bounded,
+                         candidates.end(),
+                         [&](size_t const lhs, size_t const rhs) { return quals[lhs] < quals[rhs]; });
+
+        for (size_t const p : candidates)
+        {
+            if (uint8_t const c = find_substitution(p); c != 4)
+            {
+                substitute(p, c);
+                return p;
+            }
+        }
+        return std::numeric_limits<size_t>::max();
+    }
+
+    //!\brief Correct the current read; the substituted positions are stored in #corrected.
+    void correct_impl()
+    {
+        compute_kmers();
+        corrected.clear();
+
+        for (size_t i = 0; i < solid.size() && corrected.size() < opts.max_corrections;)
+        {
+            if (solid[i])
+            {
+                ++i;
+                continue;
+            }
+
+            size_t b = i;
+            while (b + 1 < solid.size() && !solid[b + 1])
+                ++b;
+
+            // after a substitution, the stretch may still contain weak k-mers; rescan it
+            if (size_t const p = correct_stretch(i, b); p != std::numeric_limits<size_t>::max())
+                corrected.push_back(p);
+            else
+                i = b + 1;
+        }
+    }
+
+    //!\brief Load a read (and its qualities).
+    template <typename read_t, typename qual_fn_t>
+    void load(read_t && read, qual_fn_t && qual)
+    {
+        using alph_t                 = std::ranges::range_value_t<read_t>;
+        constexpr auto const & table = detail::two_bit_codes<alph_t>;
+
+        codes.clear();
+        is_n.clear();
+        quals.clear();
+        size_t i = 0;
+        for (auto && l : read)
+        {
+            alph_t const  v = l;
+            uint8_t const c = table[alphabet::to_rank(v)];
+            codes.push_back(c > 3 ? 0 : c);
+            is_n.push_back(c > 3);
+            quals.push_back(qual(i++, v));
+        }
+    }
+
+    //!\brief Write the corrected letters back.
+    template <typename read_t>
+    void store(read_t && read) const
+    {
+        using alph_t = std::ranges::range_value_t<read_t>;
+        auto it      = std::ranges::begin(read);
+        for (size_t const p : corrected)
+        {
+            alph_t v = it[p];
+            alphabet::assign_char_to("ACGT"[codes[p]], v);
+            it[p] = v;
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    error_corrector()                                    = default; //!< Defaulted.
+    error_corrector(error_corrector const &)             = default; //!< Defaulted.
+    error_corrector(error_corrector &&)                  = default; //!< Defaulted.
+    error_corrector & operator=(error_corrector const &) = default; //!< Defaulted.
+    error_corrector & operator=(error_corrector &&)      = default; //!< Defaulted.
+    ~error_corrector()                                   = default; //!< Defaulted.
+
+    /*!\brief Construct from a set of solid k-mers and options.
+     * \param[in] solid_kmers The solid k-mers; must outlive the corrector.
+     * \param[in] options     The options.
+     * \throws std::invalid_argument If `k` is not between 1 and 32.
+     */
+    explicit error_corrector(set_t const & solid_kmers, error_correction_options const options = {}) :
+      solid_set{&solid_kmers},
+      opts{options}
+    {
+        detail::check_k(options.k);
+    }
+    //!\}
+
+    //!\brief The options.
+    error_correction_options const & options() const noexcept { return opts; }
+
+    /*!\name Single reads
+     * \{
+     */
+    /*!\brief Correct a read in place.
+     * \param[in,out] read The read, a random-access range over a bio::kmer::kmer_alphabet; qualities are used if
+     *                     the alphabet is a bio::alphabet::quality_alphabet (e.g. bio::alphabet::qualified).
+     * \returns The number of substituted letters.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the length of the read, plus `k` set lookups per tested letter.
+     */
+    template <std::ranges::random_access_range read_t>
+        //!\cond
+        requires kmer_alphabet<std::ranges::range_value_t<read_t>>
+    //!\endcond
+    size_t correct(read_t && read)
+    {
+        using alph_t = std::ranges::range_value_t<read_t>;
+        load(read,
+             [](size_t, alph_t const l) -> uint8_t
+             {
+                 if constexpr (alphabet::quality_alphabet<alph_t>)
+                     return alphabet::to_phred(l);
+                 else
+                     return 0;
+             });
+        correct_impl();
+        store(read);
+        return corrected.size();
+    }
+
+    /*!\brief Correct a read in place, using separate qualities.
+     * \param[in,out] read      The read, a random-access range over a bio::kmer::kmer_alphabet.
+     * \param[in]     qualities The qualities, a random-access range over a bio::alphabet::quality_alphabet of the
+     *                          same size.
+     * \returns The number of substituted letters.
+     */
+    template <std::ranges::random_access_range read_t, std::ranges::random_access_range qual_t>
+        //!\cond
+        requires(kmer_alphabet<std::ranges::range_value_t<read_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<qual_t>>)
+    //!\endcond
+    size_t correct(read_t && read, qual_t && qualities)
+    {
+        auto const it = std::ranges::begin(qualities);
+        load(read, [&](size_t const i, auto) -> uint8_t { return alphabet::to_phred(it[i]); });
+        correct_impl();
+        store(read);
+        return corrected.size();
+    }
+    //!\}
+
+    /*!\name Batches of reads
+     * \{
+     */
+    /*!\brief Correct many reads in place, possibly in parallel.
+     * \param[in,out] reads The reads, e.g. a bio::ranges::concatenated_sequences.
+     * \returns The number of substituted letters of every read.
+     * \details
+     *
+     * With bio::kmer::error_correction_options::threads greater than one, the reads are split into contiguous
+     * blocks that are corrected by copies of this corrector.
+     */
+    template <std::ranges::random_access_range reads_t>
+        //!\cond
+        requires(std::ranges::sized_range<reads_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<reads_t>> &&
+                 kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>>)
+    //!\endcond
+    std::vector<size_t> correct_all(reads_t && reads) const
+    {
+        return correct_all_impl(std::ranges::size(reads), [&](error_corrector & c, size_t const i)
+                                { return c.correct(reads[i]); });
+    }
+
+    /*!\brief Correct many reads in place, using separate qualities, possibly in parallel.
+     * \param[in,out] reads     The reads, e.g. a bio::ranges::concatenated_sequences.
+     * \param[in]     qualities The qualities of every read.
+     * \returns The number of substituted letters of every read.
+     */
+    template <std::ranges::random_access_range reads_t, std::ranges::random_access_range quals_t>
+        //!\cond
+        requires(std::ranges::sized_range<reads_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<reads_t>> &&
+                 kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<quals_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<quals_t>>>)
+    //!\endcond
+    std::vector<size_t> correct_all(reads_t && reads, quals_t && qualities) const
+    {
+        assert(std::ranges::size(reads) <= std::ranges::size(qualities));
+        return correct_all_impl(std::ranges::size(reads), [&](error_corrector & c, size_t const i)
+                                { return c.correct(reads[i], qualities[i]); });
+    }
+    //!\}
+
+private:
+    //!\brief Call `fn(corrector, i)` for all reads, in parallel blocks.
+    template <typename fn_t>
+    std::vector<size_t> correct_all_impl(size_t const n, fn_t && fn) const
+    {
+        std::vector<size_t>             ret(n);
+        size_t const                    threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n, 1));
+        std::vector<std::exception_ptr> errors(threads);
+
+        auto work = [&](size_t const t)
+        {
+            try
+            {
+                error_corrector c{*solid_set, opts};
+                for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+                    ret[i] = fn(c, i);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (std::thread & w : workers)
+            w.join();
+
+        for (std::exception_ptr const & e : errors)
+            if (e)
+                std::rethrow_exception(e);
+        return ret;
+    }
+};
+
+} // namespace bio::kmer
@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::mix64 and bio::kmer::detail::multiply_high.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+namespace bio::kmer
+{
+
+/*!\brief A 64-bit mixing function (the finaliser of MurmurHash3).
+ * \ingroup kmer
+ * \details
+ *
+ * The function is a bijection on 64-bit integers whose output bits depend on all input bits, so it turns packed
+ * k-mer codes into uniformly distributed hash values (e.g. for sketching and cardinality estimation) without
+ * collisions.
+ */
+constexpr uint64_t mix64(uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51'afd7'ed55'8ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ce'b9fe'1a85'ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/*!\brief Apply bio::kmer::mix64 to many values.
+ * \ingroup kmer
+ * \param[in]  in  The values.
+ * \param[out] out The hash values; must be at least as large as `in` (may be the same as `in`).
+ * \details
+ *
+ * The iterations are independent, so the loop is vectorised by the compiler (with AVX2, AVX-512 or NEON if
+ * enabled); hashing a buffer of k-mer codes in a separate pass is therefore cheaper than hashing every code inside
+ * the (sequential) extraction loop.
+ */
+inline void mix64(std::span<uint64_t const> const in, std::span<uint64_t> const out) noexcept
+{
+    assert(out.size() >= in.size());
+
+    for (size_t i = 0; i < in.size(); ++i)
+        out[i] = mix64(in[i]);
+}
+
+} // namespace bio::kmer
+
+namespace bio::kmer::detail
+{
+
+/*!\brief The upper 64 bits of the 128-bit product of two integers.
+ * \ingroup kmer
+ * \details
+ *
+ * `multiply_high(hash, n)` maps a uniformly distributed hash value to `[0, n)` without a division.
+ */
+constexpr uint64_t multiply_high(uint64_t const a, uint64_t const b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128_t;
+    return static_cast<uint64_t>((static_cast<uint128_t>(a) * b) >> 64);
+#else
+    uint64_t const a_lo = a & 0xFFFF'FFFFull, a_hi = a >> 32;
+    uint64_t const b_lo = b & 0xFFFF'FFFFull, b_hi = b >> 32;
+    uint64_t const mid  = (a_lo * b_lo >> 32) + (a_hi * b_lo & 0xFFFF'FFFFull) + a_lo * b_hi;
+    return a_hi * b_hi + (a_hi * b_lo >> 32) + (mid >> 32);
+#endif
+}
+
+} // namespace bio::kmer::detail
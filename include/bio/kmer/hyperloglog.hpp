@@ -0,0 +1,276 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::hyperloglog and bio::kmer::estimate_distinct_kmers.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bio/kmer/hash.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief Options for bio::kmer::hyperloglog.
+ * \ingroup kmer
+ */
+struct hyperloglog_options
+{
+    //!\brief The length of the k-mers (1 to 32).
+    uint8_t k         = 21;
+    //!\brief Whether canonical k-mers are counted, i.e. whether a k-mer and its reverse complement are the same.
+    bool    canonical = true;
+    //!\brief The number of registers is `2^precision` (4 to 18); the relative error is about `1.04 / 2^(p/2)`.
+    uint8_t precision = 14;
+    //!\brief The number of threads used by bio::kmer::estimate_distinct_kmers().
+    size_t  threads   = 1;
+};
+
+/*!\brief A HyperLogLog estimator of the number of distinct k-mers.
+ * \ingroup kmer
+ * \details
+ *
+ * Every k-mer code is hashed with bio::kmer::mix64(); the first `p` bits of the 64-bit hash value select one of
+ * `2^p` registers, which holds the maximum number of leading zeros (plus one) of the remaining bits seen so far.
+ * The estimator uses 64-bit hash values (as HyperLogLog++), so there is no correction for hash collisions at large
+ * cardinalities, and the improved estimator of Ertl (2017, "New cardinality estimation algorithms for HyperLogLog
+ * sketches"), which is unbiased for small cardinalities without the empirical bias tables of HyperLogLog++.
+ *
+ * Hash values are processed in blocks: the register indices and values of a block are computed in a loop without
+ * dependencies (vectorised by the compiler) before the registers are updated.
+ *
+ * Estimators with the same options can be merged (the register-wise maximum), e.g. to combine per-thread partial
+ * results; the merged estimator is identical to one that has seen all inputs.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/hyperloglog.cpp
+ */
+class hyperloglog
+{
+private:
+    //!\brief The options.
+    hyperloglog_options   opts{};
+    //!\brief The registers.
+    std::vector<uint8_t>  regs = std::vector<uint8_t>(size_t{1} << opts.precision);
+    //!\brief The hash values of the current sequence.
+    std::vector<uint64_t> buffer;
+
+    //!\brief The number of hash values whose register indices and values are computed at a time.
+    static constexpr size_t block_size = 256;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    hyperloglog()                                = default; //!< Defaulted.
+    hyperloglog(hyperloglog const &)             = default; //!< Defaulted.
+    hyperloglog(hyperloglog &&)                  = default; //!< Defaulted.
+    hyperloglog & operator=(hyperloglog const &) = default; //!< Defaulted.
+    hyperloglog & operator=(hyperloglog &&)      = default; //!< Defaulted.
+    ~hyperloglog()                               = default; //!< Defaulted.
+
+    /*!\brief Construct with options.
+     * \throws std::invalid_argument If `k` is not between 1 and 32 or the precision is not between 4 and 18.
+     */
+    explicit hyperloglog(hyperloglog_options const options) : opts{options}
+    {
+        detail::check_k(options.k);
+        if (options.precision < 4 || options.precision > 18)
+            throw std::invalid_argument{"The precision must be between 4 and 18."};
+        regs.assign(size_t{1} << options.precision, 0);
+    }
+    //!\}
+
+    //!\brief The options.
+    hyperloglog_options const & options() const noexcept { return opts; }
+
+    //!\brief The registers.
+    std::vector<uint8_t> const & registers() const noexcept { return regs; }
+
+    /*!\brief Add the k-mers of a sequence.
+     * \param[in] seq The sequence, a range over a bio::kmer::kmer_alphabet.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the length of the sequence.
+     */
+    template <std::ranges::input_range rng_t>
+        //!\cond
+        requires kmer_alphabet<std::ranges::range_value_t<rng_t>>
+    //!\endcond
+    void add(rng_t && seq)
+    {
+        buffer.clear();
+        kmer_codes(seq, kmer_options{.k = opts.k, .canonical = opts.canonical}, buffer);
+        mix64(buffer, buffer);
+        add_hashes(buffer);
+    }
+
+    //!\brief Add hash values directly (e.g. from another source of k-mers); they are not hashed again.
+    void add_hashes(std::span<uint64_t const> const hashes) noexcept
+    {
+        int const      p     = opts.precision;
+        // guarantees at most 64 - p leading zeros
+        uint64_t const guard = uint64_t{1} << (p - 1);
+
+        std::array<uint32_t, block_size> indices;
+        std::array<uint8_t, block_size>  values;
+
+        for (size_t first = 0; first < hashes.size(); first += block_size)
+        {
+            size_t const n = std::min(block_size, hashes.size() - first);
+            for (size_t i = 0; i < n; ++i)
+            {
+                uint64_t const h = hashes[first + i];
+                indices[i]       = static_cast<uint32_t>(h >> (64 - p));
+                values[i]        = static_cast<uint8_t>(std::countl_zero((h << p) | guard) + 1);
+            }
+
+            for (size_t i = 0; i < n; ++i)
+                regs[indices[i]] = std::max(regs[indices[i]], values[i]);
+        }
+    }
+
+    /*!\brief Add the k-mers seen by another estimator.
+     * \throws std::invalid_argument If the estimators have different k, canonicalisation or precision.
+     */
+    void merge(hyperloglog const & other)
+    {
+        if (opts.k != other.opts.k || opts.canonical != other.opts.canonical || opts.precision != other.opts.precision)
+            throw std::invalid_argument{"Only estimators with the same k and precision can be merged."};
+
+        for (size_t i = 0; i < regs.size(); ++i)
+            regs[i] = std::max(regs[i], other.regs[i]);
+    }
+
+    /*!\brief The estimated number of distinct k-mers.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the number of registers.
+     */
+    double estimate() const noexcept
+    {
+        int const    q = 64 - opts.precision;
+        double const m = static_cast<double>(regs.size());
+
+        std::array<size_t, 66> histogram{};
+        for (uint8_t const r : regs)
+            ++histogram[r];
+
+        // sigma and tau of Ertl (2017), algorithm 6
+        auto sigma = [](double x)
+        {
+            if (x == 1.0)
+                return std::numeric_limits<double>::infinity();
+            double y = 1.0, z = x, old = 0.0;
+            do
+            {
+                old = z;
+                x *= x;
+                z += x * y;
+                y += y;
+            }
+            while (z != old);
+            return z;
+        };
+        auto tau = [](double x)
+        {
+            if (x == 0.0 || x == 1.0)
+                return 0.0;
+            double y = 1.0, z = 1.0 - x, old = 0.0;
+            do
+            {
+                old = z;
+                x   = std::sqrt(x);
+                y *= 0.5;
+                z -= (1.0 - x) * (1.0 - x) * y;
+            }
+            while (z != old);
+            return z / 3.0;
+        };
+
+        double z = m * tau(1.0 - histogram[q + 1] / m);
+        for (int k = q; k >= 1; --k)
+            z = 0.5 * (z + histogram[k]);
+        z += m * sigma(histogram[0] / m);
+
+        return m * m / (2.0 * std::log(2.0) * z);
+    }
+
+    //!\brief Reset all registers.
+    void clear() noexcept { std::ranges::fill(regs, 0); }
+
+    //!\brief Estimators are equal if they have the same k, canonicalisation, precision and registers.
+    friend bool operator==(hyperloglog const & lhs, hyperloglog const & rhs) noexcept
+    {
+        return lhs.opts.k == rhs.opts.k && lhs.opts.canonical == rhs.opts.canonical && lhs.regs == rhs.regs;
+    }
+};
+
+/*!\brief Estimate the number of distinct k-mers in many sequences, possibly in parallel.
+ * \ingroup kmer
+ * \param[in] sequences The sequences, e.g. a bio::ranges::concatenated_sequences of bio::alphabet::dna5 (reads).
+ * \param[in] options   The options.
+ * \returns The estimate.
+ * \throws std::invalid_argument See bio::kmer::hyperloglog::hyperloglog().
+ * \details
+ *
+ * The sequences are read once. With bio::kmer::hyperloglog_options::threads greater than one, they are split into
+ * contiguous blocks that are processed by separate estimators, which are merged at the end; the result does not
+ * depend on the number of threads.
+ *
+ * ### Complexity
+ *
+ * Linear in the total length of the sequences.
+ */
+template <std::ranges::random_access_range seqs_t>
+    //!\cond
+    requires(std::ranges::sized_range<seqs_t> &&
+             kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<seqs_t>>>)
+//!\endcond
+double estimate_distinct_kmers(seqs_t && sequences, hyperloglog_options const options = {})
+{
+    size_t const n       = std::ranges::size(sequences);
+    size_t const threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+
+    std::vector<hyperloglog> estimators(threads, hyperloglog{options});
+    auto work = [&](size_t const t)
+    {
+        for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+            estimators[t].add(sequences[i]);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work, t);
+    work(0);
+    for (std::thread & w : workers)
+        w.join();
+
+    for (size_t t = 1; t < threads; ++t)
+        estimators[0].merge(estimators[t]);
+    return estimators[0].estimate();
+}
+
+} // namespace bio::kmer
@@ -0,0 +1,577 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::interleaved_bloom_filter and its agents.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/kmer/hash.hpp>
+#include <bio/ranges/container/aligned_allocator.hpp>
+#include <bio/ranges/container/bitvector.hpp>
+
+namespace bio::kmer::detail
+{
+
+//!\brief The seeds of the hash functions of bio::kmer::interleaved_bloom_filter.
+inline constexpr std::array<uint64_t, 5> ibf_seeds{0xbc5b'73d8'e6b1'e2b5ull,
+                                                   0x9e37'79b9'7f4a'7c15ull,
+                                                   0x93c4'67e3'7db0'c7a9ull,
+                                                   0xe4d3'5ec6'a4a0'2e2bull,
+                                                   0x43e9'2b43'b1bd'2a11ull};
+
+/*!\brief The header of the serialised bio::kmer::interleaved_bloom_filter.
+ * \details
+ *
+ * The header has 64 bytes, so the words that follow it are aligned to cache lines if the file is (e.g. when it is
+ * memory-mapped).
+ */
+struct ibf_header
+{
+    //!\brief Identifies the format (and the byte order).
+    uint64_t magic              = 0x3146'4249'5050'4342ull; // "BCPPIBF1" in little-endian order
+    //!\brief The number of bins.
+    uint64_t bins               = 0;
+    //!\brief The number of bits per bin.
+    uint64_t bin_size           = 0;
+    //!\brief The number of hash functions.
+    uint64_t hash_count         = 0;
+    //!\brief The number of words per bit position (`ceil(bins / 64)`).
+    uint64_t words_per_position = 0;
+    //!\brief Reserved.
+    uint64_t reserved[3]{};
+
+    //!\brief Whether the fields describe a filter that can be constructed (the size of the data is not checked).
+    bool valid() const noexcept
+    {
+        // ceil(bins / 64) without overflowing for bins close to 2^64
+        return magic == ibf_header{}.magic && bins > 0 && bin_size > 0 && hash_count >= 1 &&
+               hash_count <= ibf_seeds.size() && words_per_position > 0 &&
+               words_per_position == bins / 64 + (bins % 64 != 0);
+    }
+};
+
+static_assert(sizeof(ibf_header) == 64);
+
+} // namespace bio::kmer::detail
+
+namespace bio::kmer
+{
+
+/*!\brief Options for bio::kmer::interleaved_bloom_filter.
+ * \ingroup kmer
+ */
+struct interleaved_bloom_filter_options
+{
+    //!\brief The number of bins, e.g. references.
+    size_t  bins       = 64;
+    //!\brief The number of bits per bin.
+    size_t  bin_size   = 1024 * 1024;
+    //!\brief The number of hash functions (1 to 5).
+    uint8_t hash_count = 2;
+};
+
+class ibf_membership_agent;
+class ibf_counting_agent;
+
+/*!\brief A read-only interleaved Bloom filter over existing storage, e.g. a memory-mapped file.
+ * \ingroup kmer
+ * \details
+ *
+ * See bio::kmer::interleaved_bloom_filter for the layout; this class provides the queries of the filter without
+ * owning the words. It is created by bio::kmer::interleaved_bloom_filter::view() or from the serialised format.
+ */
+class interleaved_bloom_filter_view
+{
+private:
+    //!\brief The number of bins.
+    size_t           bin_count = 0;
+    //!\brief The number of bits per bin.
+    size_t           bits      = 0;
+    //!\brief The number of hash functions.
+    size_t           hashes    = 0;
+    //!\brief The number of words per bit position.
+    size_t           words     = 0;
+    //!\brief The words.
+    uint64_t const * data_ptr  = nullptr;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    interleaved_bloom_filter_view()                                                  = default; //!< Defaulted.
+    interleaved_bloom_filter_view(interleaved_bloom_filter_view const &)             = default; //!< Defaulted.
+    interleaved_bloom_filter_view(interleaved_bloom_filter_view &&)                  = default; //!< Defaulted.
+    interleaved_bloom_filter_view & operator=(interleaved_bloom_filter_view const &) = default; //!< Defaulted.
+    interleaved_bloom_filter_view & operator=(interleaved_bloom_filter_view &&)      = default; //!< Defaulted.
+    ~interleaved_bloom_filter_view()                                                 = default; //!< Defaulted.
+
+    //!\brief Construct from the dimensions and the words (`bin_size * ceil(bins / 64)`).
+    interleaved_bloom_filter_view(size_t const     bins,
+                                  size_t const     bin_size,
+                                  size_t const     hash_count,
+                                  uint64_t const * data) noexcept :
+      bin_count{bins},
+      bits{bin_size},
+      hashes{hash_count},
+      words{(bins + 63) / 64},
+      data_ptr{data}
+    {}
+
+    /*!\brief Construct from the serialised format (see bio::kmer::interleaved_bloom_filter::write()).
+     * \param[in] bytes The serialised filter, e.g. a memory-mapped file; must be aligned to 8 bytes and outlive the
+     *                  view.
+     * \throws std::invalid_argument If the bytes are not a serialised filter of this byte order.
+     * \details
+     *
+     * The words are used in place, i.e. nothing is copied.
+     */
+    explicit interleaved_bloom_filter_view(std::span<std::byte const> const bytes)
+    {
+        detail::ibf_header header;
+        if (bytes.size() < sizeof(header))
+            throw std::invalid_argument{"The data is too small to be an interleaved Bloom filter."};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (!header.valid())
+            throw std::invalid_argument{"The data is not an interleaved Bloom filter."};
+        if ((bytes.size() - sizeof(header)) / sizeof(uint64_t) / header.words_per_position < header.bin_size)
+            throw std::invalid_argument{"The interleaved Bloom filter is truncated."};
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(uint64_t) != 0)
+            throw std::invalid_argument{"The interleaved Bloom filter must be aligned to 8 bytes."};
+
+        *this = interleaved_bloom_filter_view{header.bins,
+                                              header.bin_size,
+                                              header.hash_count,
+                                              reinterpret_cast<uint64_t const *>(bytes.data() + sizeof(header))};
+    }
+    //!\}
+
+    //!\brief The number of bins.
+    size_t bins() const noexcept { return bin_count; }
+
+    //!\brief The number of bits per bin.
+    size_t bin_size() const noexcept { return bits; }
+
+    //!\brief The number of hash functions.
+    size_t hash_count() const noexcept { return hashes; }
+
+    //!\brief The number of words per bit position, i.e. `ceil(bins() / 64)`.
+    size_t words_per_position() const noexcept { return words; }
+
+    //!\brief The words; the bits of all bins at bit position `p` are the words `[p * words_per_position(), …)`.
+    std::span<uint64_t const> raw_data() const noexcept { return {data_ptr, bits * words}; }
+
+    //!\brief The bit position of a value for the i-th hash function.
+    size_t position(uint64_t const value, size_t const i) const noexcept
+    {
+        return detail::multiply_high(mix64(value ^ detail::ibf_seeds[i]), bits);
+    }
+
+    //!\brief Whether a value may be in a single bin (no false negatives).
+    bool contains(uint64_t const value, size_t const bin) const noexcept
+    {
+        assert(bin < bin_count);
+        for (size_t i = 0; i < hashes; ++i)
+            if (!(data_ptr[position(value, i) * words + bin / 64] & (1ull << (bin % 64))))
+                return false;
+        return true;
+    }
+
+    //!\brief Returns an agent for membership queries.
+    ibf_membership_agent membership_agent() const;
+
+    //!\brief Returns an agent for counting queries.
+    ibf_counting_agent counting_agent() const;
+};
+
+/*!\brief An interleaved Bloom filter: one Bloom filter per bin whose bits are interleaved across the bins.
+ * \ingroup kmer
+ * \details
+ *
+ * Every bin (e.g. a reference genome) is a Bloom filter of bio::kmer::interleaved_bloom_filter_options::bin_size
+ * bits over 64-bit values (k-mer codes, minimizers or their hash values), all with the same hash functions. The bits
+ * of all bins at the same position are stored next to each other, i.e. position `p` is a bitvector of
+ * `ceil(bins / 64)` words in which bit `b` belongs to bin `b`. Querying a value therefore reads one such bitvector
+ * per hash function (a few cache lines, even for thousands of bins) and combines them with a bitwise AND; the result
+ * is the set of bins that may contain the value. Values are mapped to positions with bio::kmer::mix64() and a
+ * multiply-shift reduction (no division).
+ *
+ * Queries are made with agents (bio::kmer::ibf_membership_agent and bio::kmer::ibf_counting_agent) that own the
+ * result buffers, so one agent per thread can query the same filter concurrently.
+ *
+ * The filter can be written to a stream in a simple format: a 64-byte header followed by the words in native byte
+ * order. A memory-mapped file in this format can be queried in place with bio::kmer::interleaved_bloom_filter_view.
+ * The class also supports cereal serialisation.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/interleaved_bloom_filter.cpp
+ */
+class interleaved_bloom_filter
+{
+private:
+    //!\brief The options.
+    interleaved_bloom_filter_options                               opts{};
+    //!\brief The words (cache-line aligned).
+    std::vector<uint64_t, ranges::aligned_allocator<uint64_t, 64>> data;
+
+    //!\brief The number of words per bit position.
+    size_t words_per_position() const noexcept { return (opts.bins + 63) / 64; }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    interleaved_bloom_filter()                                             = default; //!< Defaulted.
+    interleaved_bloom_filter(interleaved_bloom_filter const &)             = default; //!< Defaulted.
+    interleaved_bloom_filter(interleaved_bloom_filter &&)                  = default; //!< Defaulted.
+    interleaved_bloom_filter & operator=(interleaved_bloom_filter const &) = default; //!< Defaulted.
+    interleaved_bloom_filter & operator=(interleaved_bloom_filter &&)      = default; //!< Defaulted.
+    ~interleaved_bloom_filter()                                            = default; //!< Defaulted.
+
+    /*!\brief Construct an empty filter.
+     * \throws std::invalid_argument If the number of bins or the bin size is 0 or the number of hash functions is not
+     *                               between 1 and 5.
+     */
+    explicit interleaved_bloom_filter(interleaved_bloom_filter_options const options) : opts{options}
+    {
+        if (options.bins == 0 || options.bin_size == 0)
+            throw std::invalid_argument{"The number of bins and the bin size must not be 0."};
+        if (options.hash_count < 1 || options.hash_count > detail::ibf_seeds.size())
+            throw std::invalid_argument{"The number of hash functions must be between 1 and 5."};
+        data.assign(options.bin_size * words_per_position(), 0);
+    }
+    //!\}
+
+    //!\brief The options.
+    interleaved_bloom_filter_options const & options() const noexcept { return opts; }
+
+    //!\brief The number of bins.
+    size_t bins() const noexcept { return opts.bins; }
+
+    //!\brief The number of bits per bin.
+    size_t bin_size() const noexcept { return opts.bin_size; }
+
+    //!\brief The number of hash functions.
+    size_t hash_count() const noexcept { return opts.hash_count; }
+
+    //!\brief Returns a non-owning view of the filter (invalidated by moving or destroying the filter).
+    interleaved_bloom_filter_view view() const noexcept
+    {
+        return {opts.bins, opts.bin_size, opts.hash_count, data.data()};
+    }
+
+    //!\brief The words; see bio::kmer::interleaved_bloom_filter_view::raw_data().
+    std::span<uint64_t const> raw_data() const noexcept { return data; }
+
+    /*!\brief Insert a value into a bin.
+     * \details
+     *
+     * Inserting into different bins from different threads is not safe, because the bits of 64 bins share a word.
+     */
+    void emplace(uint64_t const value, size_t const bin) noexcept
+    {
+        assert(bin < opts.bins);
+        interleaved_bloom_filter_view const v     = view();
+        size_t const                        words = words_per_position();
+        for (size_t i = 0; i < opts.hash_count; ++i)
+            data[v.position(value, i) * words + bin / 64] |= 1ull << (bin % 64);
+    }
+
+    //!\brief Insert values into a bin.
+    void emplace(std::span<uint64_t const> const values, size_t const bin) noexcept
+    {
+        for (uint64_t const value : values)
+            emplace(value, bin);
+    }
+
+    //!\brief Whether a value may be in a single bin; see bio::kmer::interleaved_bloom_filter_view::contains().
+    bool contains(uint64_t const value, size_t const bin) const noexcept { return view().contains(value, bin); }
+
+    //!\brief Remove all values from a bin.
+    void clear(size_t const bin) noexcept
+    {
+        assert(bin < opts.bins);
+        size_t const words = words_per_position();
+        for (size_t p = 0; p < opts.bin_size; ++p)
+            data[p * words + bin / 64] &= ~(1ull << (bin % 64));
+    }
+
+    //!\brief Returns an agent for membership queries.
+    ibf_membership_agent membership_agent() const;
+
+    //!\brief Returns an agent for counting queries.
+    ibf_counting_agent counting_agent() const;
+
+    /*!\brief Write the filter in the format read by #read() and bio::kmer::interleaved_bloom_filter_view.
+     * \throws std::runtime_error If writing fails.
+     */
+    void write(std::ostream & stream) const
+    {
+        detail::ibf_header const header{.bins               = opts.bins,
+                                        .bin_size           = opts.bin_size,
+                                        .hash_count         = opts.hash_count,
+                                        .words_per_position = words_per_position()};
+        stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<char const *>(data.data()), data.size() * sizeof(uint64_t));
+        if (!stream)
+            throw std::runtime_error{"Could not write the interleaved Bloom filter."};
+    }
+
+    /*!\brief Read a filter written by #write().
+     * \throws std::runtime_error If reading fails or the data is not a serialised filter of this byte order.
+     * \details
+     *
+     * A corrupt header cannot make this allocate much more memory than the stream holds: the size of the data is
+     * checked against the rest of the stream if the stream is seekable, otherwise the filter grows with the data read.
+     */
+    static interleaved_bloom_filter read(std::istream & stream)
+    {
+        detail::ibf_header header;
+        stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!stream || !header.valid())
+            throw std::runtime_error{"The data is not an interleaved Bloom filter."};
+
+        uint64_t             available = std::numeric_limits<uint64_t>::max(); // bytes after the header
+        std::streampos const start     = stream.tellg();
+        if (start != std::streampos{-1} && stream.seekg(0, std::ios::end))
+        {
+            available = stream.tellg() - start;
+            stream.seekg(start);
+        }
+        if (!stream || available / sizeof(uint64_t) / header.words_per_position < header.bin_size)
+            throw std::runtime_error{"The interleaved Bloom filter is truncated."};
+
+        interleaved_bloom_filter ret{{.bins       = header.bins,
+                                      .bin_size   = 1,
+                                      .hash_count = static_cast<uint8_t>(header.hash_count)}};
+        ret.opts.bin_size    = header.bin_size;
+        uint64_t const total = header.bin_size * header.words_per_position;
+        for (uint64_t n = 0; n < total;)
+        {
+            uint64_t const next =
+              available == std::numeric_limits<uint64_t>::max() ? std::min(total, std::max(2 * n, uint64_t{1} << 20))
+                                                                 : total;
+            ret.data.reserve(next);
+            ret.data.resize(next);
+            if (!stream.read(reinterpret_cast<char *>(ret.data.data() + n), (next - n) * sizeof(uint64_t)))
+                throw std::runtime_error{"The interleaved Bloom filter is truncated."};
+            n = next;
+        }
+        return ret;
+    }
+
+    //!\brief Filters are equal if they have the same options and bits.
+    friend bool operator==(interleaved_bloom_filter const & lhs, interleaved_bloom_filter const & rhs) noexcept
+    {
+        return lhs.opts.bins == rhs.opts.bins && lhs.opts.bin_size == rhs.opts.bin_size &&
+               lhs.opts.hash_count == rhs.opts.hash_count && lhs.data == rhs.data;
+    }
+
+    //!\cond DEV
+    /*!\brief Serialisation support function.
+     * \tparam archive_t Type of `archive`; must satisfy bio::cereal_archive.
+     * \param[in] archive The archive being serialised from/to.
+     *
+     * \attention These functions are never called directly, see \ref howto_use_cereal for more details.
+     */
+    template <typename archive_t>
+    void serialize(archive_t & archive)
+    {
+        archive(opts.bins, opts.bin_size, opts.hash_count, data);
+    }
+    //!\endcond
+};
+
+/*!\brief Determines the bins of a bio::kmer::interleaved_bloom_filter that may contain values.
+ * \ingroup kmer
+ * \details
+ *
+ * Created by bio::kmer::interleaved_bloom_filter::membership_agent(); the agent owns the result bitvector, so use
+ * one per thread. The agent refers to the filter, i.e. it must not outlive it.
+ */
+class ibf_membership_agent
+{
+private:
+    //!\brief The filter.
+    interleaved_bloom_filter_view ibf{};
+    //!\brief The result.
+    ranges::bitvector             result;
+
+    //!\brief `result &= bins(value)`.
+    void intersect(uint64_t const value) noexcept
+    {
+        size_t const     words = ibf.words_per_position();
+        uint64_t * const out   = result.raw_data().data();
+        for (size_t i = 0; i < ibf.hash_count(); ++i)
+            ranges::detail::bitvector_and(out, ibf.raw_data().data() + ibf.position(value, i) * words, words);
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    ibf_membership_agent()                                         = default; //!< Defaulted.
+    ibf_membership_agent(ibf_membership_agent const &)             = default; //!< Defaulted.
+    ibf_membership_agent(ibf_membership_agent &&)                  = default; //!< Defaulted.
+    ibf_membership_agent & operator=(ibf_membership_agent const &) = default; //!< Defaulted.
+    ibf_membership_agent & operator=(ibf_membership_agent &&)      = default; //!< Defaulted.
+    ~ibf_membership_agent()                                        = default; //!< Defaulted.
+
+    //!\brief Construct for a filter.
+    explicit ibf_membership_agent(interleaved_bloom_filter_view const filter) :
+      ibf{filter},
+      result(filter.bins(), true)
+    {}
+    //!\}
+
+    /*!\brief The bins that may contain a value.
+     * \returns A bitvector with one bit per bin; valid until the next query.
+     */
+    ranges::bitvector const & contains(uint64_t const value) noexcept
+    {
+        result.assign(ibf.bins(), true);
+        intersect(value);
+        return result;
+    }
+
+    /*!\brief The bins that may contain all values.
+     * \returns A bitvector with one bit per bin; valid until the next query.
+     * \details
+     *
+     * The bitvectors of the values are combined with a (SIMD) bitwise AND; the query stops once no bin is left.
+     */
+    ranges::bitvector const & contains_all(std::span<uint64_t const> const values) noexcept
+    {
+        result.assign(ibf.bins(), true);
+        for (size_t v = 0; v < values.size(); ++v)
+        {
+            intersect(values[v]);
+            // checking after every value would cost as much as the intersection itself
+            if (v % 8 == 7 && result.none())
+                break;
+        }
+        return result;
+    }
+};
+
+/*!\brief Counts the values that each bin of a bio::kmer::interleaved_bloom_filter may contain.
+ * \ingroup kmer
+ * \details
+ *
+ * Created by bio::kmer::interleaved_bloom_filter::counting_agent(); the agent owns the result buffers, so use one
+ * per thread. The agent refers to the filter, i.e. it must not outlive it.
+ *
+ * A read is typically assigned to the bins that contain at least a threshold of its k-mers or minimizers
+ * (#bins_above()); the threshold is usually derived from the number of errors allowed (k-mer lemma).
+ */
+class ibf_counting_agent
+{
+private:
+    //!\brief The filter.
+    interleaved_bloom_filter_view ibf{};
+    //!\brief The bin bitvector of a value.
+    std::vector<uint64_t>         bins;
+    //!\brief The counts.
+    std::vector<uint32_t>         counts;
+    //!\brief The bins above the threshold.
+    ranges::bitvector             selected;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    ibf_counting_agent()                                       = default; //!< Defaulted.
+    ibf_counting_agent(ibf_counting_agent const &)             = default; //!< Defaulted.
+    ibf_counting_agent(ibf_counting_agent &&)                  = default; //!< Defaulted.
+    ibf_counting_agent & operator=(ibf_counting_agent const &) = default; //!< Defaulted.
+    ibf_counting_agent & operator=(ibf_counting_agent &&)      = default; //!< Defaulted.
+    ~ibf_counting_agent()                                      = default; //!< Defaulted.
+
+    //!\brief Construct for a filter.
+    explicit ibf_counting_agent(interleaved_bloom_filter_view const filter) :
+      ibf{filter},
+      bins(filter.words_per_position()),
+      counts(filter.bins()),
+      selected(filter.bins(), false)
+    {}
+    //!\}
+
+    /*!\brief For every bin, the number of values it may contain.
+     * \returns One count per bin; valid until the next query.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the number of values times the number of words per position, plus the number of hits.
+     */
+    std::vector<uint32_t> const & count(std::span<uint64_t const> const values) noexcept
+    {
+        size_t const words = ibf.words_per_position();
+        std::ranges::fill(counts, 0);
+        for (uint64_t const value : values)
+        {
+            uint64_t const * const row = ibf.raw_data().data();
+            std::copy_n(row + ibf.position(value, 0) * words, words, bins.data());
+            for (size_t i = 1; i < ibf.hash_count(); ++i)
+                ranges::detail::bitvector_and(bins.data(), row + ibf.position(value, i) * words, words);
+
+            for (size_t w = 0; w < words; ++w)
+                for (uint64_t word = bins[w]; word != 0; word &= word - 1)
+                    ++counts[w * 64 + std::countr_zero(word)];
+        }
+        return counts;
+    }
+
+    /*!\brief The bins that may contain at least `threshold` of the values.
+     * \returns A bitvector with one bit per bin; valid until the next query.
+     */
+    ranges::bitvector const & bins_above(std::span<uint64_t const> const values, size_t const threshold) noexcept
+    {
+        count(values);
+        for (size_t b = 0; b < counts.size(); ++b)
+            selected[b] = counts[b] >= threshold;
+        return selected;
+    }
+};
+
+inline ibf_membership_agent interleaved_bloom_filter_view::membership_agent() const
+{
+    return ibf_membership_agent{*this};
+}
+
+inline ibf_counting_agent interleaved_bloom_filter_view::counting_agent() const
+{
+    return ibf_counting_agent{*this};
+}
+
+inline ibf_membership_agent interleaved_bloom_filter::membership_agent() const
+{
+    return ibf_membership_agent{view()};
+}
+
+inline ibf_counting_agent interleaved_bloom_filter::counting_agent() const
+{
+    return ibf_counting_agent{view()};
+}
+
+} // namespace bio::kmer
@@ -0,0 +1,198 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::for_each_kmer and related functions for packed k-mer codes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/alphabet/nucleotide/concept.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief Options for the extraction of k-mer codes.
+ * \ingroup kmer
+ */
+struct kmer_options
+{
+    //!\brief The length of the k-mers (1 to 32).
+    uint8_t k         = 21;
+    //!\brief Whether the smaller of the code of a k-mer and that of its reverse complement is used.
+    bool    canonical = true;
+};
+
+/*!\brief A nucleotide alphabet whose letters can be mapped to 2-bit codes.
+ * \ingroup kmer
+ * \details
+ *
+ * This includes bio::alphabet::dna4, bio::alphabet::dna5, bio::alphabet::rna4 and bio::alphabet::rna5 as well as
+ * bio::alphabet::qualified composites of these.
+ */
+template <typename t>
+concept kmer_alphabet = alphabet::nucleotide_alphabet<t> && (alphabet::size<t> <= 4096);
+
+} // namespace bio::kmer
+
+namespace bio::kmer::detail
+{
+
+/*!\brief Maps the ranks of an alphabet to 2-bit codes (`A=0, C=1, G=2, T/U=3`); other letters are mapped to `4`.
+ * \ingroup kmer
+ */
+template <kmer_alphabet alph_t>
+inline constexpr std::array<uint8_t, alphabet::size<alph_t>> two_bit_codes = []()
+{
+    std::array<uint8_t, alphabet::size<alph_t>> ret{};
+    for (size_t r = 0; r < ret.size(); ++r)
+    {
+        switch (alphabet::to_char(alphabet::assign_rank_to(r, alph_t{})))
+        {
+            case 'A':
+                ret[r] = 0;
+                break;
+            case 'C':
+                ret[r] = 1;
+                break;
+            case 'G':
+                ret[r] = 2;
+                break;
+            case 'T':
+            case 'U':
+                ret[r] = 3;
+                break;
+            default:
+                ret[r] = 4;
+                break;
+        }
+    }
+    return ret;
+}();
+
+//!\brief Throw if `k` is not in `[1, 32]`.
+inline void check_k(uint8_t const k)
+{
+    if (k < 1 || k > 32)
+        throw std::invalid_argument{"k must be between 1 and 32."};
+}
+
+} // namespace bio::kmer::detail
+
+namespace bio::kmer
+{
+
+/*!\name Packed k-mer codes
+ * \brief k-mers of up to 32 letters as 2-bit codes in a single `uint64_t`.
+ * \details
+ *
+ * Codes are packed with the first letter in the most significant position (like bio::preprocessing::pack_dna4),
+ * i.e. codes of equal length compare like the k-mers.
+ * \{
+ */
+
+//!\brief The bit mask of the code of a k-mer.
+constexpr uint64_t kmer_mask(uint8_t const k) noexcept
+{
+    return k >= 32 ? ~0ull : (1ull << (2 * k)) - 1ull;
+}
+
+//!\brief The code of the reverse complement of a k-mer.
+constexpr uint64_t reverse_complement(uint64_t const code, uint8_t const k) noexcept
+{
+    uint64_t x = ~code;
+    // reverse the 2-bit groups
+    x = ((x >> 2) & 0x3333'3333'3333'3333ull) | ((x & 0x3333'3333'3333'3333ull) << 2);
+    x = ((x >> 4) & 0x0F0F'0F0F'0F0F'0F0Full) | ((x & 0x0F0F'0F0F'0F0F'0F0Full) << 4);
+    x = ((x >> 8) & 0x00FF'00FF'00FF'00FFull) | ((x & 0x00FF'00FF'00FF'00FFull) << 8);
+    x = ((x >> 16) & 0x0000'FFFF'0000'FFFFull) | ((x & 0x0000'FFFF'0000'FFFFull) << 16);
+    x = (x >> 32) | (x << 32);
+    return x >> (64 - 2 * k);
+}
+
+//!\brief The smaller of the code of a k-mer and that of its reverse complement.
+constexpr uint64_t canonical(uint64_t const code, uint8_t const k) noexcept
+{
+    return std::min(code, reverse_complement(code, k));
+}
+
+/*!\brief Call a function for every k-mer of a sequence.
+ * \param[in] seq     The sequence, a range over a bio::kmer::kmer_alphabet.
+ * \param[in] options The options.
+ * \param[in] fn      Called with the position of the first letter and the code of every k-mer.
+ * \throws std::invalid_argument If `k` is not between 1 and 32.
+ * \details
+ *
+ * The forward and reverse complement codes are updated with a shift and an OR per letter. k-mers that contain a
+ * letter other than `A`, `C`, `G` and `T` (or `U`), e.g. `N`, are skipped.
+ *
+ * ### Complexity
+ *
+ * Linear in the length of the sequence.
+ */
+template <std::ranges::input_range rng_t, typename fn_t>
+    //!\cond
+    requires kmer_alphabet<std::ranges::range_value_t<rng_t>>
+//!\endcond
+void for_each_kmer(rng_t && seq, kmer_options const options, fn_t && fn)
+{
+    using alph_t = std::ranges::range_value_t<rng_t>;
+    detail::check_k(options.k);
+
+    constexpr auto const & codes = detail::two_bit_codes<alph_t>;
+    uint8_t const          k     = options.k;
+    uint64_t const         mask  = kmer_mask(k);
+    size_t const           shift = 2 * (k - 1);
+
+    uint64_t fwd   = 0;
+    uint64_t rev   = 0;
+    size_t   valid = 0;
+    size_t   pos   = 0;
+    for (auto && l : seq)
+    {
+        alph_t const  v = l;
+        uint8_t const c = codes[alphabet::to_rank(v)];
+        ++pos;
+        if (c > 3)
+        {
+            valid = 0;
+            continue;
+        }
+
+        fwd = ((fwd << 2) | c) & mask;
+        rev = (rev >> 2) | (static_cast<uint64_t>(3 - c) << shift);
+        if (++valid >= k)
+            fn(pos - k, options.canonical ? std::min(fwd, rev) : fwd);
+    }
+}
+
+/*!\brief Append the codes of all k-mers of a sequence to a vector.
+ * \param[in]  seq     The sequence, a range over a bio::kmer::kmer_alphabet.
+ * \param[in]  options The options.
+ * \param[out] out     The codes are appended to this vector.
+ * \throws std::invalid_argument If `k` is not between 1 and 32.
+ * \details
+ *
+ * See bio::kmer::for_each_kmer().
+ */
+template <std::ranges::input_range rng_t>
+    //!\cond
+    requires kmer_alphabet<std::ranges::range_value_t<rng_t>>
+//!\endcond
+void kmer_codes(rng_t && seq, kmer_options const options, std::vector<uint64_t> & out)
+{
+    for_each_kmer(seq, options, [&](size_t, uint64_t const code) { out.push_back(code); });
+}
+//!\}
+
+} // namespace bio::kmer
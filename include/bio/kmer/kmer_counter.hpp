@@ -0,0 +1,508 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::kmer_counter.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <queue>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <bio/kmer/detail/radix_sort.hpp>
+#include <bio/kmer/hash.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief Options for bio::kmer::kmer_counter.
+ * \ingroup kmer
+ */
+struct kmer_counter_options
+{
+    //!\brief The length of the k-mers (1 to 32).
+    uint8_t               k                   = 31;
+    //!\brief Whether canonical k-mers are counted, i.e. whether a k-mer and its reverse complement are the same.
+    bool                  canonical           = true;
+    //!\brief The length of the minimizers that determine the partition of a k-mer (at most k).
+    uint8_t               minimizer_length    = 11;
+    //!\brief The number of partitions (and temporary files).
+    size_t                partitions          = 256;
+    //!\brief The approximate upper bound of the memory used for buffers and counting, in bytes.
+    size_t                memory_budget       = size_t{1} << 30;
+    //!\brief The number of threads used by bio::kmer::kmer_counter::add_all() and for counting.
+    size_t                threads             = 1;
+    //!\brief Only k-mers that occur at least this often are reported.
+    uint64_t              min_count           = 1;
+    //!\brief The directory in which a directory for the temporary files is created.
+    std::filesystem::path temporary_directory = std::filesystem::temp_directory_path();
+};
+
+//!\brief A k-mer code and its number of occurrences.
+//!\ingroup kmer
+struct kmer_count
+{
+    //!\brief The code of the k-mer (see bio::kmer::for_each_kmer()).
+    uint64_t kmer  = 0;
+    //!\brief The number of occurrences.
+    uint64_t count = 0;
+
+    //!\brief Defaulted.
+    friend bool operator==(kmer_count const &, kmer_count const &) = default;
+};
+
+/*!\brief Counts k-mers of datasets that are larger than the main memory, using temporary files.
+ * \ingroup kmer
+ * \details
+ *
+ * The counter works in two phases:
+ *
+ *   1. #add() and #add_all() extract the (canonical) k-mer codes of the sequences and append them to one of
+ *      bio::kmer::kmer_counter_options::partitions temporary files, chosen by the minimizer of the k-mer (the
+ *      m-mer with the smallest hash value, see bio::kmer::kmer_counter_options::minimizer_length). Consecutive
+ *      k-mers usually share their minimizer, so the codes are collected in per-partition buffers that are written
+ *      in large blocks. Every k-mer is in exactly one partition.
+ *   2. #for_each_count() reads one partition at a time into memory, sorts it with a radix sort and counts equal
+ *      codes; the counts of every partition are written to another temporary file, and these sorted files are
+ *      finally merged, so the k-mers are reported in ascending order of their codes.
+ *
+ * Both phases can use several threads. The write buffers of phase 1 take up half of the memory budget; in phase 2,
+ * a partition with `n` k-mers needs `16n` bytes, and only as many partitions as fit into the budget are counted at
+ * the same time (a single partition that is larger than the budget is counted alone). Increase the number of
+ * partitions if the partitions are too large; note that up to twice bio::kmer::kmer_counter_options::partitions files
+ * are open at the same time.
+ *
+ * The temporary files are removed when the counter is destroyed.
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/kmer_counter.cpp
+ */
+class kmer_counter
+{
+private:
+    //!\brief The k-mer codes of one thread, waiting to be written to the partition files.
+    class spiller
+    {
+    private:
+        //!\brief The counter.
+        kmer_counter *                           counter = nullptr;
+        //!\brief One buffer per partition.
+        std::vector<std::vector<uint64_t>>       buffers;
+        //!\brief The positions and hash values of the m-mers of the current sequence.
+        std::vector<std::pair<size_t, uint64_t>> mmers;
+        //!\brief The indexes (into #mmers) of the minimizer candidates of the current window.
+        std::deque<size_t>                       window;
+
+    public:
+        //!\brief Construct for a counter.
+        explicit spiller(kmer_counter & c) : counter{&c}, buffers(c.opts.partitions)
+        {
+            for (std::vector<uint64_t> & b : buffers)
+                b.reserve(c.buffer_capacity);
+        }
+
+        //!\brief Partition the k-mers of a sequence.
+        template <typename rng_t>
+        void add(rng_t && seq)
+        {
+            kmer_counter_options const & opts = counter->opts;
+            uint8_t const                m    = std::min(opts.minimizer_length, opts.k);
+
+            mmers.clear();
+            for_each_kmer(seq,
+                          {.k = m, .canonical = opts.canonical},
+                          [&](size_t const pos, uint64_t const code) { mmers.emplace_back(pos, mix64(code)); });
+
+            size_t next = 0;
+            window.clear();
+            for_each_kmer(seq,
+                          {.k = opts.k, .canonical = opts.canonical},
+                          [&](size_t const pos, uint64_t const code)
+                          {
+                              // the m-mers of the k-mer are at [pos, pos + k - m]
+                              for (; next < mmers.size() && mmers[next].first <= pos + opts.k - m; ++next)
+                              {
+                                  while (!window.empty() && mmers[window.back()].second >= mmers[next].second)
+                                      window.pop_back();
+                                  window.push_back(next);
+                              }
+                              while (mmers[window.front()].first < pos)
+                                  window.pop_front();
+
+                              size_t const p = detail::multiply_high(mmers[window.front()].second, buffers.size());
+                              buffers[p].push_back(code);
+                              if (buffers[p].size() >= counter->buffer_capacity)
+                                  flush(p);
+                          });
+        }
+
+        //!\brief Write the buffer of a partition.
+        void flush(size_t const p)
+        {
+            if (buffers[p].empty())
+                return;
+
+            std::lock_guard const lock{counter->spill_mutexes[p]};
+            std::ofstream &       file = counter->spill_files[p];
+            file.write(reinterpret_cast<char const *>(buffers[p].data()), buffers[p].size() * sizeof(uint64_t));
+            if (!file)
+                throw std::runtime_error{"Could not write to the temporary files of the k-mer counter."};
+            buffers[p].clear();
+        }
+
+        //!\brief Write all buffers.
+        void flush()
+        {
+            for (size_t p = 0; p < buffers.size(); ++p)
+                flush(p);
+        }
+    };
+
+    //!\brief The options.
+    kmer_counter_options       opts;
+    //!\brief The directory of the temporary files.
+    std::filesystem::path      directory;
+    //!\brief The number of codes buffered per partition and thread.
+    size_t                     buffer_capacity = 0;
+    //!\brief The partition files.
+    std::vector<std::ofstream> spill_files;
+    //!\brief Serialise the writes to the partition files.
+    std::vector<std::mutex>    spill_mutexes;
+    //!\brief The buffers of #add().
+    std::optional<spiller>     own_spiller;
+
+    //!\brief The path of a temporary file.
+    std::filesystem::path file(size_t const p, char const * const suffix) const
+    {
+        return directory / (std::to_string(p) + suffix);
+    }
+
+    //!\brief Count the k-mers of a partition and write them (sorted) to its counts file.
+    void count_partition(size_t const p, std::vector<uint64_t> & codes, std::vector<uint64_t> & scratch) const
+    {
+        codes.resize(std::filesystem::file_size(file(p, ".kmers")) / sizeof(uint64_t));
+        std::ifstream in{file(p, ".kmers"), std::ios::binary};
+        if (!in.read(reinterpret_cast<char *>(codes.data()), codes.size() * sizeof(uint64_t)))
+            throw std::runtime_error{"Could not read the temporary files of the k-mer counter."};
+
+        detail::radix_sort(codes, scratch, 2 * opts.k);
+
+        std::ofstream out{file(p, ".counts"), std::ios::binary};
+        for (size_t i = 0; i < codes.size();)
+        {
+            size_t j = i + 1;
+            while (j < codes.size() && codes[j] == codes[i])
+                ++j;
+            kmer_count const record{codes[i], j - i};
+            if (record.count >= opts.min_count)
+                out.write(reinterpret_cast<char const *>(&record), sizeof(record));
+            i = j;
+        }
+        if (!out)
+            throw std::runtime_error{"Could not write to the temporary files of the k-mer counter."};
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    kmer_counter()                                 = delete; //!< Deleted.
+    kmer_counter(kmer_counter const &)             = delete; //!< Deleted.
+    kmer_counter(kmer_counter &&)                  = delete; //!< Deleted.
+    kmer_counter & operator=(kmer_counter const &) = delete; //!< Deleted.
+    kmer_counter & operator=(kmer_counter &&)      = delete; //!< Deleted.
+
+    /*!\brief Construct with options; creates a directory for the temporary files.
+     * \throws std::invalid_argument If `k` is not between 1 and 32, or the minimizer length, the number of
+     *                               partitions or the memory budget is 0.
+     * \throws std::filesystem::filesystem_error If the directory cannot be created.
+     * \throws std::runtime_error If the temporary files cannot be created.
+     */
+    explicit kmer_counter(kmer_counter_options options) : opts{std::move(options)}
+    {
+        detail::check_k(opts.k);
+        if (opts.minimizer_length == 0 || opts.partitions == 0 || opts.memory_budget == 0)
+            throw std::invalid_argument{"The minimizer length, the number of partitions and the memory budget must "
+                                        "not be 0."};
+        opts.threads = std::max<size_t>(opts.threads, 1);
+
+        std::random_device rd;
+        do
+            directory = opts.temporary_directory / ("bio_kmer_counter_" + std::to_string(rd()) + std::to_string(rd()));
+        while (!std::filesystem::create_directories(directory));
+
+        try
+        {
+            buffer_capacity = std::max<size_t>(opts.memory_budget / 2 / opts.partitions / (opts.threads + 1) / 8, 512);
+            spill_mutexes   = std::vector<std::mutex>(opts.partitions);
+            for (size_t p = 0; p < opts.partitions; ++p)
+            {
+                spill_files.emplace_back(file(p, ".kmers"), std::ios::binary);
+                if (!spill_files.back())
+                    throw std::runtime_error{"Could not create the temporary files of the k-mer counter."};
+            }
+        }
+        catch (...)
+        {
+            // the destructor is not called if the constructor throws
+            spill_files.clear();
+            std::error_code ec;
+            std::filesystem::remove_all(directory, ec);
+            throw;
+        }
+    }
+
+    //!\brief Removes the temporary files.
+    ~kmer_counter()
+    {
+        spill_files.clear();
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+    //!\}
+
+    //!\brief The options.
+    kmer_counter_options const & options() const noexcept { return opts; }
+
+    /*!\brief Add the k-mers of a sequence.
+     * \param[in] seq The sequence, a forward range over a bio::kmer::kmer_alphabet.
+     * \throws std::runtime_error If writing the temporary files fails.
+     * \details
+     *
+     * The k-mers are buffered and written to the temporary files in blocks. Not thread-safe; use #add_all() to
+     * partition many sequences in parallel.
+     */
+    template <std::ranges::forward_range rng_t>
+        //!\cond
+        requires kmer_alphabet<std::ranges::range_value_t<rng_t>>
+    //!\endcond
+    void add(rng_t && seq)
+    {
+        if (!own_spiller)
+            own_spiller.emplace(*this);
+        own_spiller->add(seq);
+    }
+
+    /*!\brief Add the k-mers of many sequences, possibly in parallel.
+     * \param[in] sequences The sequences, e.g. a bio::ranges::concatenated_sequences of bio::alphabet::dna5 (reads).
+     * \throws std::runtime_error If writing the temporary files fails.
+     * \details
+     *
+     * With bio::kmer::kmer_counter_options::threads greater than one, the sequences are split into contiguous blocks
+     * that are partitioned by separate threads with their own buffers.
+     */
+    template <std::ranges::random_access_range seqs_t>
+        //!\cond
+        requires(std::ranges::sized_range<seqs_t> &&
+                 kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<seqs_t>>>)
+    //!\endcond
+    void add_all(seqs_t && sequences)
+    {
+        size_t const n       = std::ranges::size(sequences);
+        size_t const threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n, 1));
+
+        std::vector<std::exception_ptr> errors(threads);
+        auto                            work = [&](size_t const t)
+        {
+            try
+            {
+                spiller s{*this};
+                for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+                    s.add(sequences[i]);
+                s.flush();
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (std::thread & w : workers)
+            w.join();
+
+        for (std::exception_ptr const & e : errors)
+            if (e)
+                std::rethrow_exception(e);
+    }
+
+    /*!\brief Count the k-mers added so far and call a function for each, in ascending order of the codes.
+     * \param[in] fn Called with a bio::kmer::kmer_count for every k-mer that occurs at least
+     *               bio::kmer::kmer_counter_options::min_count times.
+     * \throws std::runtime_error If reading or writing the temporary files fails.
+     * \details
+     *
+     * More k-mers can be added afterwards; a later call counts all k-mers added so far.
+     *
+     * ### Complexity
+     *
+     * Linear in the number of k-mers (and logarithmic in the number of partitions).
+     */
+    template <typename fn_t>
+    void for_each_count(fn_t && fn)
+    {
+        if (own_spiller)
+            own_spiller->flush();
+        for (std::ofstream & f : spill_files)
+            if (!f.flush())
+                throw std::runtime_error{"Could not write to the temporary files of the k-mer counter."};
+
+        // phase 2: count the partitions, largest first, as many at a time as the memory budget allows
+        std::vector<size_t> order(opts.partitions);
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<size_t> sizes(opts.partitions);
+        for (size_t p = 0; p < opts.partitions; ++p)
+            sizes[p] = std::filesystem::file_size(file(p, ".kmers"));
+        std::ranges::sort(order, std::greater<>{}, [&](size_t const p) { return sizes[p]; });
+
+        std::atomic<size_t>             next{0};
+        std::mutex                      budget_mutex;
+        std::condition_variable         budget_released;
+        size_t                          budget_used = 0;
+        std::vector<std::exception_ptr> errors(opts.threads);
+
+        auto release = [&](size_t const need)
+        {
+            {
+                std::lock_guard lock{budget_mutex};
+                budget_used -= need;
+            }
+            budget_released.notify_all();
+        };
+
+        auto work = [&](size_t const t)
+        {
+            std::vector<uint64_t> codes;
+            std::vector<uint64_t> scratch;
+            try
+            {
+                for (size_t i = next++; i < order.size(); i = next++)
+                {
+                    size_t const p    = order[i];
+                    size_t const need = 2 * sizes[p];
+                    {
+                        std::unique_lock lock{budget_mutex};
+                        budget_released.wait(lock,
+                                             [&]
+                                             { return budget_used == 0 || budget_used + need <= opts.memory_budget; });
+                        budget_used += need;
+                    }
+
+                    try
+                    {
+                        count_partition(p, codes, scratch);
+                    }
+                    catch (...)
+                    {
+                        release(need); // or the other threads wait for the budget forever
+                        throw;
+                    }
+                    codes   = {};
+                    scratch = {};
+                    release(need);
+                }
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+                next      = order.size();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < opts.threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (std::thread & w : workers)
+            w.join();
+        for (std::exception_ptr const & e : errors)
+            if (e)
+                std::rethrow_exception(e);
+
+        // merge the sorted counts of the partitions
+        std::vector<std::ifstream> counts;
+        using entry_t = std::pair<kmer_count, size_t>;
+        auto greater  = [](entry_t const & lhs, entry_t const & rhs) { return lhs.first.kmer > rhs.first.kmer; };
+        std::priority_queue<entry_t, std::vector<entry_t>, decltype(greater)> heap{greater};
+
+        auto read = [&](size_t const p)
+        {
+            kmer_count record;
+            if (counts[p].read(reinterpret_cast<char *>(&record), sizeof(record)))
+                heap.emplace(record, p);
+        };
+
+        for (size_t p = 0; p < opts.partitions; ++p)
+        {
+            counts.emplace_back(file(p, ".counts"), std::ios::binary);
+            read(p);
+        }
+
+        while (!heap.empty())
+        {
+            auto const [record, p] = heap.top();
+            heap.pop();
+            fn(record);
+            read(p);
+        }
+
+        counts.clear();
+        for (size_t p = 0; p < opts.partitions; ++p)
+            std::filesystem::remove(file(p, ".counts"));
+    }
+
+    /*!\brief Count the k-mers added so far and return them in ascending order of their codes.
+     * \details
+     *
+     * See #for_each_count(); the result has to fit into memory.
+     */
+    std::vector<kmer_count> counts()
+    {
+        std::vector<kmer_count> ret;
+        for_each_count([&](kmer_count const & c) { ret.push_back(c); });
+        return ret;
+    }
+
+    /*!\brief Count the k-mers added so far and write them to a stream, in ascending order of their codes.
+     * \throws std::runtime_error If writing fails.
+     * \details
+     *
+     * Every k-mer is written as a binary bio::kmer::kmer_count (16 bytes, native byte order).
+     */
+    void write(std::ostream & stream)
+    {
+        for_each_count([&](kmer_count const & c) { stream.write(reinterpret_cast<char const *>(&c), sizeof(c)); });
+        if (!stream)
+            throw std::runtime_error{"Could not write the k-mer counts."};
+    }
+};
+
+} // namespace bio::kmer
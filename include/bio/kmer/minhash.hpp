@@ -0,0 +1,440 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::kmer::minhash_sketch, bio::kmer::minhash_sketcher and the Jaccard/containment estimators.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bio/kmer/hash.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+
+namespace bio::kmer
+{
+
+/*!\brief Options for bio::kmer::minhash_sketcher.
+ * \ingroup kmer
+ * \details
+ *
+ * A sketch holds the smallest (distinct) hash values of the k-mers of its input. With `scaled == 1`, it holds the
+ * #sketch_size smallest values ("bottom-k", as in Mash); with `sketch_size == 0` and `scaled > 1`, it holds all
+ * values below `2^64 / scaled` ("FracMinHash", as in sourmash). Both limits can be combined.
+ */
+struct minhash_options
+{
+    //!\brief The length of the k-mers (1 to 32).
+    uint8_t  k           = 21;
+    //!\brief Whether canonical k-mers are hashed, i.e. whether a sequence and its reverse complement are the same.
+    bool     canonical   = true;
+    //!\brief The maximum number of hash values (`0` for no limit).
+    size_t   sketch_size = 1000;
+    //!\brief Only hash values below `2^64 / scaled` are kept (`1` for no threshold).
+    uint64_t scaled      = 1;
+    //!\brief The number of threads used by bio::kmer::sketch_all() and bio::kmer::sketch_each().
+    size_t   threads     = 1;
+};
+
+/*!\brief A MinHash sketch: the smallest hash values of the k-mers of a sequence or a set of sequences.
+ * \ingroup kmer
+ * \details
+ *
+ * Sketches are created by bio::kmer::minhash_sketcher (or bio::kmer::sketch_all() and bio::kmer::sketch_each())
+ * and are immutable except for #merge(). The hash values are sorted and distinct. Sketches can be compared with
+ * bio::kmer::jaccard() and bio::kmer::containment() if they were created with the same k, canonicalisation and
+ * scaling.
+ */
+class minhash_sketch
+{
+private:
+    //!\brief The options.
+    minhash_options       opts{};
+    //!\brief The hash values (sorted, distinct).
+    std::vector<uint64_t> values;
+
+    //!\brief bio::kmer::minhash_sketcher creates the sketches.
+    friend class minhash_sketcher;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    minhash_sketch()                                   = default; //!< Defaulted.
+    minhash_sketch(minhash_sketch const &)             = default; //!< Defaulted.
+    minhash_sketch(minhash_sketch &&)                  = default; //!< Defaulted.
+    minhash_sketch & operator=(minhash_sketch const &) = default; //!< Defaulted.
+    minhash_sketch & operator=(minhash_sketch &&)      = default; //!< Defaulted.
+    ~minhash_sketch()                                  = default; //!< Defaulted.
+
+    //!\brief Construct an empty sketch.
+    explicit minhash_sketch(minhash_options const options) : opts{options} {}
+    //!\}
+
+    //!\brief The options.
+    minhash_options const & options() const noexcept { return opts; }
+
+    //!\brief The hash values (sorted, distinct).
+    std::vector<uint64_t> const & hashes() const noexcept { return values; }
+
+    //!\brief The number of hash values.
+    size_t size() const noexcept { return values.size(); }
+
+    //!\brief Whether the sketch is empty.
+    bool empty() const noexcept { return values.empty(); }
+
+    //!\brief The largest hash value that can be part of the sketch.
+    uint64_t max_hash() const noexcept
+    {
+        return opts.scaled <= 1 ? std::numeric_limits<uint64_t>::max()
+                                : std::numeric_limits<uint64_t>::max() / opts.scaled;
+    }
+
+    //!\brief Whether the sketch holds bio::kmer::minhash_options::sketch_size values (always false without limit).
+    bool full() const noexcept { return opts.sketch_size > 0 && values.size() >= opts.sketch_size; }
+
+    /*!\brief Whether two sketches can be compared and merged, i.e. were created with the same k, canonicalisation,
+     * sketch size and scaling.
+     */
+    bool compatible(minhash_sketch const & other) const noexcept
+    {
+        return opts.k == other.opts.k && opts.canonical == other.opts.canonical &&
+               opts.sketch_size == other.opts.sketch_size && opts.scaled == other.opts.scaled;
+    }
+
+    /*!\brief Add the hash values of another sketch, i.e. sketch the union of both inputs.
+     * \throws std::invalid_argument If the sketches are not #compatible().
+     */
+    void merge(minhash_sketch const & other)
+    {
+        if (!compatible(other))
+            throw std::invalid_argument{"Only sketches with the same k, sketch size and scaling can be merged."};
+
+        std::vector<uint64_t> merged;
+        merged.reserve(values.size() + other.values.size());
+        std::ranges::set_union(values, other.values, std::back_inserter(merged));
+        if (opts.sketch_size > 0 && merged.size() > opts.sketch_size)
+            merged.resize(opts.sketch_size);
+        values.swap(merged);
+    }
+
+    //!\brief Sketches are equal if they have the same options (except for the threads) and hash values.
+    friend bool operator==(minhash_sketch const & lhs, minhash_sketch const & rhs) noexcept
+    {
+        return lhs.compatible(rhs) && lhs.values == rhs.values;
+    }
+};
+
+/*!\brief Computes a bio::kmer::minhash_sketch from sequences.
+ * \ingroup kmer
+ * \details
+ *
+ * The k-mer codes of every sequence are extracted into a buffer (bio::kmer::kmer_codes()), hashed in bulk with
+ * bio::kmer::mix64() and filtered against a threshold: values above bio::kmer::minhash_sketch::max_hash() or, once
+ * the sketch is full, above its largest value, are discarded right away. The remaining candidates are collected and
+ * merged into the sorted sketch (discarding duplicates and lowering the threshold) whenever there are as many as
+ * the sketch holds, so the amortised cost per k-mer is a hash and a comparison.
+ *
+ * The sketcher keeps state between calls, so use one per thread; partial sketches are combined with
+ * bio::kmer::minhash_sketch::merge().
+ *
+ * ### Example
+ *
+ * \include test/snippet/kmer/minhash.cpp
+ */
+class minhash_sketcher
+{
+private:
+    //!\brief The sketch (without the candidates).
+    minhash_sketch        current{};
+    //!\brief The largest hash value that is accepted as a candidate.
+    uint64_t              limit = std::numeric_limits<uint64_t>::max();
+    //!\brief Hash values that pass the threshold but have not been merged into the sketch.
+    std::vector<uint64_t> candidates;
+    //!\brief The hash values of the current sequence.
+    std::vector<uint64_t> buffer;
+
+    //!\brief Merge the candidates into the sketch and lower the threshold.
+    void compact()
+    {
+        std::ranges::sort(candidates);
+        auto const [first, last] = std::ranges::unique(candidates);
+        candidates.erase(first, last);
+
+        std::vector<uint64_t> merged;
+        merged.reserve(current.values.size() + candidates.size());
+        std::ranges::set_union(current.values, candidates, std::back_inserter(merged));
+        if (current.opts.sketch_size > 0 && merged.size() >= current.opts.sketch_size)
+        {
+            merged.resize(current.opts.sketch_size);
+            limit = merged.back();
+        }
+
+        current.values.swap(merged);
+        candidates.clear();
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    minhash_sketcher()                                     = default; //!< Defaulted.
+    minhash_sketcher(minhash_sketcher const &)             = default; //!< Defaulted.
+    minhash_sketcher(minhash_sketcher &&)                  = default; //!< Defaulted.
+    minhash_sketcher & operator=(minhash_sketcher const &) = default; //!< Defaulted.
+    minhash_sketcher & operator=(minhash_sketcher &&)      = default; //!< Defaulted.
+    ~minhash_sketcher()                                    = default; //!< Defaulted.
+
+    /*!\brief Construct with options.
+     * \throws std::invalid_argument If `k` is not between 1 and 32 or `scaled` is 0.
+     */
+    explicit minhash_sketcher(minhash_options const options) : current{options}, limit{current.max_hash()}
+    {
+        detail::check_k(options.k);
+        if (options.scaled == 0)
+            throw std::invalid_argument{"The scaling factor must not be 0."};
+    }
+    //!\}
+
+    //!\brief The options.
+    minhash_options const & options() const noexcept { return current.options(); }
+
+    /*!\brief Add the k-mers of a sequence.
+     * \param[in] seq The sequence, a range over a bio::kmer::kmer_alphabet.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the length of the sequence (amortised).
+     */
+    template <std::ranges::input_range rng_t>
+        //!\cond
+        requires kmer_alphabet<std::ranges::range_value_t<rng_t>>
+    //!\endcond
+    void add(rng_t && seq)
+    {
+        buffer.clear();
+        kmer_codes(seq, kmer_options{.k = current.opts.k, .canonical = current.opts.canonical}, buffer);
+        mix64(buffer, buffer);
+        add_hashes(buffer);
+    }
+
+    //!\brief Add hash values directly (e.g. from another source of k-mers); they are not hashed again.
+    void add_hashes(std::span<uint64_t const> const hashes)
+    {
+        size_t const batch = std::max<size_t>(current.values.size(), 1024);
+        for (uint64_t const h : hashes)
+        {
+            if (h > limit)
+                continue;
+
+            candidates.push_back(h);
+            if (candidates.size() >= batch)
+                compact();
+        }
+    }
+
+    //!\brief Returns the sketch of all sequences added so far.
+    minhash_sketch sketch() const
+    {
+        minhash_sketch ret = current;
+        if (!candidates.empty())
+        {
+            minhash_sketch pending{current.opts};
+            pending.values = candidates;
+            std::ranges::sort(pending.values);
+            auto const [first, last] = std::ranges::unique(pending.values);
+            pending.values.erase(first, last);
+            ret.merge(pending);
+        }
+        return ret;
+    }
+
+    //!\brief Discard all sequences added so far.
+    void clear() noexcept
+    {
+        current.values.clear();
+        candidates.clear();
+        limit = current.max_hash();
+    }
+};
+
+/*!\brief Compute one sketch of many sequences, possibly in parallel.
+ * \ingroup kmer
+ * \param[in] sequences The sequences, e.g. a bio::ranges::concatenated_sequences of bio::alphabet::dna5 (reads).
+ * \param[in] options   The options.
+ * \throws std::invalid_argument See bio::kmer::minhash_sketcher::minhash_sketcher().
+ * \details
+ *
+ * With bio::kmer::minhash_options::threads greater than one, the sequences are split into contiguous blocks that
+ * are sketched by separate threads; the partial sketches are merged at the end.
+ */
+template <std::ranges::random_access_range seqs_t>
+    //!\cond
+    requires(std::ranges::sized_range<seqs_t> &&
+             kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<seqs_t>>>)
+//!\endcond
+minhash_sketch sketch_all(seqs_t && sequences, minhash_options const options)
+{
+    size_t const n       = std::ranges::size(sequences);
+    size_t const threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+
+    std::vector<minhash_sketcher> sketchers(threads, minhash_sketcher{options});
+    auto work = [&](size_t const t)
+    {
+        for (size_t i = n * t / threads; i < n * (t + 1) / threads; ++i)
+            sketchers[t].add(sequences[i]);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work, t);
+    work(0);
+    for (std::thread & w : workers)
+        w.join();
+
+    minhash_sketch ret = sketchers[0].sketch();
+    for (size_t t = 1; t < threads; ++t)
+        ret.merge(sketchers[t].sketch());
+    return ret;
+}
+
+/*!\brief Compute a sketch of every sequence, possibly in parallel.
+ * \ingroup kmer
+ * \param[in] sequences The sequences, e.g. a bio::ranges::concatenated_sequences of bio::alphabet::dna5 (genomes).
+ * \param[in] options   The options.
+ * \returns One sketch per sequence.
+ * \throws std::invalid_argument See bio::kmer::minhash_sketcher::minhash_sketcher().
+ * \details
+ *
+ * With bio::kmer::minhash_options::threads greater than one, the threads take the next unsketched sequence until
+ * all are done.
+ */
+template <std::ranges::random_access_range seqs_t>
+    //!\cond
+    requires(std::ranges::sized_range<seqs_t> &&
+             kmer_alphabet<std::ranges::range_value_t<std::ranges::range_reference_t<seqs_t>>>)
+//!\endcond
+std::vector<minhash_sketch> sketch_each(seqs_t && sequences, minhash_options const options)
+{
+    size_t const                n = std::ranges::size(sequences);
+    std::vector<minhash_sketch> ret(n);
+    minhash_sketcher const      proto{options};
+    std::atomic<size_t>         next{0};
+
+    auto work = [&]()
+    {
+        minhash_sketcher sketcher = proto;
+        for (size_t i = next++; i < n; i = next++)
+        {
+            sketcher.clear();
+            sketcher.add(sequences[i]);
+            ret[i] = sketcher.sketch();
+        }
+    };
+
+    size_t const             threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(n, 1));
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+    for (std::thread & w : workers)
+        w.join();
+
+    return ret;
+}
+
+/*!\brief Estimate the Jaccard index of the inputs of two sketches.
+ * \ingroup kmer
+ * \param[in] lhs A sketch.
+ * \param[in] rhs Another sketch.
+ * \returns The estimate; `0` if both sketches are empty.
+ * \throws std::invalid_argument If the sketches are not bio::kmer::minhash_sketch::compatible().
+ * \details
+ *
+ * The sorted hash values are merged until the sketch size is reached (all values without a size limit); the
+ * estimate is the fraction of values that occur in both sketches. This is the estimator of Mash for bottom-k
+ * sketches and `|A ∩ B| / |A ∪ B|` for FracMinHash sketches.
+ *
+ * ### Complexity
+ *
+ * Linear in the sizes of the sketches.
+ */
+inline double jaccard(minhash_sketch const & lhs, minhash_sketch const & rhs)
+{
+    if (!lhs.compatible(rhs))
+        throw std::invalid_argument{"Only sketches with the same k, sketch size and scaling can be compared."};
+
+    std::vector<uint64_t> const & a = lhs.hashes();
+    std::vector<uint64_t> const & b = rhs.hashes();
+    size_t const limit = lhs.options().sketch_size > 0 ? lhs.options().sketch_size : a.size() + b.size();
+
+    size_t i = 0, j = 0, total = 0, shared = 0;
+    for (; total < limit && (i < a.size() || j < b.size()); ++total)
+    {
+        if (j == b.size() || (i < a.size() && a[i] < b[j]))
+        {
+            ++i;
+        }
+        else if (i == a.size() || b[j] < a[i])
+        {
+            ++j;
+        }
+        else
+        {
+            ++shared;
+            ++i;
+            ++j;
+        }
+    }
+
+    return total == 0 ? 0.0 : static_cast<double>(shared) / total;
+}
+
+/*!\brief Estimate the fraction of the k-mers of one input that are contained in another.
+ * \ingroup kmer
+ * \param[in] query  The sketch of the contained input (e.g. a read set or a plasmid).
+ * \param[in] target The sketch of the containing input (e.g. a genome).
+ * \returns The estimate of `|Q ∩ T| / |Q|`; `0` if the query sketch is empty.
+ * \throws std::invalid_argument If the sketches are not bio::kmer::minhash_sketch::compatible().
+ * \details
+ *
+ * Only the hash values of the query that are in the range covered by the target sketch are considered, i.e. if
+ * the target sketch is full, those not greater than its largest value. The estimate is accurate for FracMinHash
+ * sketches; for bottom-k sketches of inputs of very different size, few query values may be in range.
+ */
+inline double containment(minhash_sketch const & query, minhash_sketch const & target)
+{
+    if (!query.compatible(target))
+        throw std::invalid_argument{"Only sketches with the same k, sketch size and scaling can be compared."};
+
+    std::vector<uint64_t> const & q     = query.hashes();
+    std::vector<uint64_t> const & t     = target.hashes();
+    uint64_t const                bound = target.full() ? t.back() : target.max_hash();
+
+    size_t considered = 0, shared = 0;
+    for (size_t i = 0, j = 0; i < q.size() && q[i] <= bound; ++i)
+    {
+        ++considered;
+        while (j < t.size() && t[j] < q[i])
+            ++j;
+        shared += j < t.size() && t[j] == q[i];
+    }
+
+    return considered == 0 ? 0.0 : static_cast<double>(shared) / considered;
+}
+
+} // namespace bio::kmer
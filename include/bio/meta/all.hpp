@@ -17,6 +17,7 @@
 #include <bio/core.hpp>
 #include <bio/meta/concept/all.hpp>
 #include <bio/meta/detail/all.hpp>
+#include <bio/meta/instrumentation.hpp>
 #include <bio/meta/pod_tuple.hpp>
 #include <bio/meta/tuple_utility.hpp>
 #include <bio/meta/type_list/type_list.hpp>
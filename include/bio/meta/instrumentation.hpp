@@ -0,0 +1,377 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides opt-in instrumentation counters for hot paths in views and containers.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+#if __has_include(<fmt/format.h>)
+#    include <fmt/format.h>
+#endif
+
+#include <bio/core.hpp>
+
+/*!\brief Set to `1` to enable the instrumentation counters, to `2` to additionally record cycle timings.
+ * \ingroup meta
+ * \details
+ *
+ * Instrumentation is disabled by default (`0`), in which case all hooks compile to nothing.
+ * The macro needs to be set consistently for all translation units of a program (e.g. via `-DBIOCPP_INSTRUMENTATION=1`).
+ * \sa bio::meta::instrumentation_counter
+ */
+#ifndef BIOCPP_INSTRUMENTATION
+#    define BIOCPP_INSTRUMENTATION 0
+#endif
+
+namespace bio::meta
+{
+
+//!\brief Whether instrumentation counters are recorded; see #BIOCPP_INSTRUMENTATION.
+//!\ingroup meta
+inline constexpr bool instrumentation_enabled = BIOCPP_INSTRUMENTATION >= 1;
+
+//!\brief Whether cycle timings are recorded; see #BIOCPP_INSTRUMENTATION.
+//!\ingroup meta
+inline constexpr bool instrumentation_timings_enabled = BIOCPP_INSTRUMENTATION >= 2;
+
+/*!\brief The events recorded when #BIOCPP_INSTRUMENTATION is set.
+ * \ingroup meta
+ */
+enum class instrumentation_counter : uint8_t
+{
+    //!\brief Characters validated by bio::views::char_strictly_to (and bio::views::validate_char_for).
+    char_strictly_to_elements,
+    //!\brief Reallocations of the storage of a bio::ranges::concatenated_sequences (values or delimiters).
+    concatenated_sequences_reallocations,
+    //!\brief Writes through the reference proxy of a bio::ranges::bitcompressed_vector.
+    bitcompressed_vector_proxy_writes,
+};
+
+//!\brief The number of different bio::meta::instrumentation_counter values.
+//!\ingroup meta
+inline constexpr size_t instrumentation_counter_count = 3;
+
+//!\brief Returns the name of the counter.
+//!\ingroup meta
+constexpr std::string_view instrumentation_counter_name(instrumentation_counter const c) noexcept
+{
+    switch (c)
+    {
+        case instrumentation_counter::char_strictly_to_elements:
+            return "char_strictly_to_elements";
+        case instrumentation_counter::concatenated_sequences_reallocations:
+            return "concatenated_sequences_reallocations";
+        case instrumentation_counter::bitcompressed_vector_proxy_writes:
+            return "bitcompressed_vector_proxy_writes";
+    }
+    return "";
+}
+
+/*!\brief The aggregated counters (and cycles) of all threads at one point in time.
+ * \ingroup meta
+ * \details
+ *
+ * Obtained via bio::meta::take_instrumentation_snapshot(). Two snapshots can be subtracted to get the numbers for a
+ * section of code. The cycles are only recorded if #BIOCPP_INSTRUMENTATION is `2`; they are measured with the
+ * time-stamp counter on x86 and in std::chrono::steady_clock ticks elsewhere.
+ */
+struct instrumentation_snapshot
+{
+    //!\brief The number of events per counter.
+    std::array<uint64_t, instrumentation_counter_count> counts{};
+    //!\brief The cycles spent per counter (only filled for some counters).
+    std::array<uint64_t, instrumentation_counter_count> cycles{};
+
+    //!\brief Returns the number of events for the counter.
+    constexpr uint64_t operator[](instrumentation_counter const c) const noexcept
+    {
+        return counts[static_cast<size_t>(c)];
+    }
+
+    //!\brief Returns the difference between two snapshots.
+    constexpr friend instrumentation_snapshot operator-(instrumentation_snapshot const & lhs,
+                                                       instrumentation_snapshot const & rhs) noexcept
+    {
+        instrumentation_snapshot ret;
+        for (size_t i = 0; i < instrumentation_counter_count; ++i)
+        {
+            ret.counts[i] = lhs.counts[i] - rhs.counts[i];
+            ret.cycles[i] = lhs.cycles[i] - rhs.cycles[i];
+        }
+        return ret;
+    }
+
+    //!\brief Defaulted.
+    constexpr friend bool operator==(instrumentation_snapshot const &, instrumentation_snapshot const &) = default;
+};
+
+} // namespace bio::meta
+
+namespace bio::meta::detail
+{
+
+//!\brief The counters of one thread; only the owning thread writes to them.
+struct instrumentation_block
+{
+    //!\brief The number of events per counter.
+    std::array<std::atomic<uint64_t>, instrumentation_counter_count> counts{};
+    //!\brief The cycles spent per counter.
+    std::array<std::atomic<uint64_t>, instrumentation_counter_count> cycles{};
+};
+
+//!\brief Keeps track of the blocks of all threads and accumulates the blocks of threads that have finished.
+class instrumentation_registry
+{
+public:
+    //!\brief The global registry.
+    static instrumentation_registry & instance()
+    {
+        static instrumentation_registry registry;
+        return registry;
+    }
+
+    //!\brief Register the block of a new thread.
+    void attach(instrumentation_block * const block)
+    {
+        std::lock_guard lock{mutex};
+        blocks.push_back(block);
+    }
+
+    //!\brief Unregister the block of a finishing thread and keep its numbers.
+    void detach(instrumentation_block * const block)
+    {
+        std::lock_guard lock{mutex};
+        std::erase(blocks, block);
+        for (size_t i = 0; i < instrumentation_counter_count; ++i)
+        {
+            retired.counts[i] += block->counts[i].load(std::memory_order_relaxed);
+            retired.cycles[i] += block->cycles[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    //!\brief Sum the numbers of all threads.
+    instrumentation_snapshot collect()
+    {
+        std::lock_guard          lock{mutex};
+        instrumentation_snapshot ret = retired;
+        for (instrumentation_block const * const block : blocks)
+        {
+            for (size_t i = 0; i < instrumentation_counter_count; ++i)
+            {
+                ret.counts[i] += block->counts[i].load(std::memory_order_relaxed);
+                ret.cycles[i] += block->cycles[i].load(std::memory_order_relaxed);
+            }
+        }
+        return ret;
+    }
+
+    //!\brief Set all numbers to zero.
+    void reset()
+    {
+        std::lock_guard lock{mutex};
+        retired = instrumentation_snapshot{};
+        for (instrumentation_block * const block : blocks)
+        {
+            for (size_t i = 0; i < instrumentation_counter_count; ++i)
+            {
+                block->counts[i].store(0, std::memory_order_relaxed);
+                block->cycles[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    //!\brief Protects the other members.
+    std::mutex                           mutex;
+    //!\brief The blocks of the running threads.
+    std::vector<instrumentation_block *> blocks;
+    //!\brief The sum of the blocks of finished threads.
+    instrumentation_snapshot             retired;
+};
+
+//!\brief A block that registers itself with the registry for its lifetime.
+struct registered_instrumentation_block : instrumentation_block
+{
+    //!\brief Attach to the registry.
+    registered_instrumentation_block() { instrumentation_registry::instance().attach(this); }
+    //!\brief Detach from the registry.
+    ~registered_instrumentation_block() { instrumentation_registry::instance().detach(this); }
+};
+
+//!\brief Returns the block of the calling thread.
+inline instrumentation_block & thread_instrumentation_block()
+{
+    thread_local registered_instrumentation_block block;
+    return block;
+}
+
+//!\brief Add to a counter of the calling thread (plain load and store, because there is only one writer).
+inline void instrumentation_increment(std::atomic<uint64_t> & slot, uint64_t const n) noexcept
+{
+    slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+//!\brief Returns the current value of the cycle counter.
+inline uint64_t instrumentation_ticks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/*!\brief Record `n` events for counter `c` (no-op unless #BIOCPP_INSTRUMENTATION is set).
+ * \details This can be called from constexpr functions; nothing is recorded during constant evaluation.
+ */
+constexpr void instrumentation_count(instrumentation_counter const c, uint64_t const n = 1) noexcept
+{
+    if constexpr (instrumentation_enabled)
+    {
+        if (!std::is_constant_evaluated())
+            instrumentation_increment(thread_instrumentation_block().counts[static_cast<size_t>(c)], n);
+    }
+}
+
+/*!\brief Record cycles for counter `c` (no-op unless #BIOCPP_INSTRUMENTATION is `2`).
+ * \details This can be called from constexpr functions; nothing is recorded during constant evaluation.
+ */
+constexpr void instrumentation_add_cycles(instrumentation_counter const c, uint64_t const cycles) noexcept
+{
+    if constexpr (instrumentation_timings_enabled)
+    {
+        if (!std::is_constant_evaluated())
+            instrumentation_increment(thread_instrumentation_block().cycles[static_cast<size_t>(c)], cycles);
+    }
+}
+
+} // namespace bio::meta::detail
+
+namespace bio::meta
+{
+
+/*!\brief Returns the counters of all threads (including finished ones) summed up.
+ * \ingroup meta
+ * \details
+ *
+ * If instrumentation is disabled, the returned snapshot contains only zeros.
+ *
+ * ### Example
+ *
+ * ```cpp
+ * #define BIOCPP_INSTRUMENTATION 1
+ * #include <bio/meta/instrumentation.hpp>
+ *
+ * auto before = bio::meta::take_instrumentation_snapshot();
+ * // ... run the program
+ * fmt::print("{}\n", bio::meta::take_instrumentation_snapshot() - before);
+ * ```
+ *
+ * ### Thread safety
+ *
+ * Thread-safe; counters of running threads are read while they may be updated, so the numbers reflect an arbitrary
+ * point during the call.
+ */
+inline instrumentation_snapshot take_instrumentation_snapshot()
+{
+    if constexpr (instrumentation_enabled)
+        return detail::instrumentation_registry::instance().collect();
+    else
+        return {};
+}
+
+/*!\brief Set all counters to zero.
+ * \ingroup meta
+ * \details
+ *
+ * ### Thread safety
+ *
+ * Thread-safe, but events recorded concurrently by other threads may or may not be reset.
+ */
+inline void reset_instrumentation()
+{
+    if constexpr (instrumentation_enabled)
+        detail::instrumentation_registry::instance().reset();
+}
+
+/*!\brief Adds the cycles spent in its lifetime to a counter (no-op unless #BIOCPP_INSTRUMENTATION is `2`).
+ * \ingroup meta
+ */
+class instrumentation_timer
+{
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    instrumentation_timer()                                          = delete; //!< Deleted.
+    instrumentation_timer(instrumentation_timer const &)             = delete; //!< Deleted.
+    instrumentation_timer(instrumentation_timer &&)                  = delete; //!< Deleted.
+    instrumentation_timer & operator=(instrumentation_timer const &) = delete; //!< Deleted.
+    instrumentation_timer & operator=(instrumentation_timer &&)      = delete; //!< Deleted.
+
+    //!\brief Start the timer for the given counter.
+    explicit instrumentation_timer(instrumentation_counter const c) noexcept : counter{c}
+    {
+        if constexpr (instrumentation_timings_enabled)
+            start = detail::instrumentation_ticks();
+    }
+
+    //!\brief Stop the timer and record the cycles.
+    ~instrumentation_timer() noexcept
+    {
+        if constexpr (instrumentation_timings_enabled)
+            detail::instrumentation_add_cycles(counter, detail::instrumentation_ticks() - start);
+    }
+    //!\}
+
+private:
+    //!\brief The counter the cycles are attributed to.
+    instrumentation_counter counter;
+    //!\brief The value of the cycle counter at construction.
+    uint64_t                start = 0;
+};
+
+} // namespace bio::meta
+
+#if __has_include(<fmt/format.h>)
+
+//!\brief Prints one line per counter (and the cycles, if they were recorded).
+template <>
+struct fmt::formatter<bio::meta::instrumentation_snapshot> : fmt::formatter<std::string_view>
+{
+    //!\brief Format the snapshot.
+    auto format(bio::meta::instrumentation_snapshot const & s, auto & ctx) const
+    {
+        auto out = ctx.out();
+        for (size_t i = 0; i < bio::meta::instrumentation_counter_count; ++i)
+        {
+            auto const c = static_cast<bio::meta::instrumentation_counter>(i);
+            out          = fmt::format_to(out, "{:<40}{:>16}", bio::meta::instrumentation_counter_name(c), s.counts[i]);
+            if (s.cycles[i] != 0)
+                out = fmt::format_to(out, "  ({} cycles)", s.cycles[i]);
+            if (i + 1 < bio::meta::instrumentation_counter_count)
+                out = fmt::format_to(out, "\n");
+        }
+        return out;
+    }
+};
+
+#endif
@@ -0,0 +1,25 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Meta-header for the \link preprocessing preprocessing module \endlink.
+ */
+
+#pragma once
+
+#include <bio/preprocessing/demultiplexer.hpp>
+#include <bio/preprocessing/packed_dna4.hpp>
+#include <bio/preprocessing/pair_merger.hpp>
+#include <bio/preprocessing/trimmer.hpp>
+#include <bio/preprocessing/umi_grouper.hpp>
+
+/*!\defgroup preprocessing Preprocessing
+ * \brief The preprocessing module provides batch kernels for the typical steps between sequencing and analysis.
+ *
+ * The kernels operate on reads over bio::alphabet::dna5 (or bio::alphabet::qualified thereof) and usually accept
+ * a bio::ranges::concatenated_sequences of reads to process whole batches at once. They hold reusable buffers and
+ * are intended to be copied once per thread.
+ */
@@ -0,0 +1,337 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::demultiplexer.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/preprocessing/packed_dna4.hpp>
+
+namespace bio::preprocessing
+{
+
+/*!\brief Options for bio::preprocessing::demultiplexer.
+ * \ingroup preprocessing
+ */
+struct demux_options
+{
+    //!\brief The maximum number of mismatches between a read and its barcode.
+    size_t max_mismatches = 1;
+    //!\brief The position of the barcode in the read.
+    size_t offset         = 0;
+};
+
+/*!\brief The barcode assigned to a read by bio::preprocessing::demultiplexer.
+ * \ingroup preprocessing
+ */
+struct demux_result
+{
+    //!\brief No barcode is within the allowed number of mismatches (or the read is too short).
+    static constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+    //!\brief Several barcodes have the smallest number of mismatches.
+    static constexpr uint32_t ambiguous  = std::numeric_limits<uint32_t>::max() - 1;
+
+    //!\brief The index of the barcode or one of #unassigned and #ambiguous.
+    uint32_t barcode    = unassigned;
+    //!\brief The number of mismatches (`N` counts as mismatch); only meaningful if a barcode was assigned.
+    uint8_t  mismatches = 0;
+
+    //!\brief Defaulted.
+    friend constexpr bool operator==(demux_result const &, demux_result const &) = default;
+};
+
+/*!\brief Assigns reads to barcodes, allowing mismatches.
+ * \ingroup preprocessing
+ * \details
+ *
+ * All barcodes must have the same length (at most 32) and consist of `A`, `C`, `G` and `T`. They are packed into
+ * 2-bit codes (see bio::preprocessing::pack_dna4). A read is assigned to the barcode with the fewest mismatches in
+ * the read's letters `[offset, offset + length)`; if several barcodes share the fewest, the read is ambiguous.
+ *
+ * For up to 2 mismatches, all codes within that distance of any barcode are enumerated with bit operations when
+ * the demultiplexer is constructed, and the best barcode (or "ambiguous") is stored for each of them in a sorted
+ * table with a directory over the leading bits. A read is then assigned with a single lookup. Reads that contain
+ * `N` (and all reads if more than 2 mismatches are allowed) are compared with every barcode instead, using
+ * bio::preprocessing::hamming_distances.
+ *
+ * The table holds `O(b * (3 * l)^k)` entries for `b` barcodes of length `l` and `k` mismatches, e.g. about 1.1
+ * million for 1000 barcodes of length 16 with 2 mismatches.
+ *
+ * Reads are ranges over bio::alphabet::dna5 or bio::alphabet::dna4, or over bio::alphabet::qualified thereof. The
+ * demultiplexer holds a buffer for the distances; use one copy per thread.
+ *
+ * ### Example
+ *
+ * \include test/snippet/preprocessing/demultiplexer.cpp
+ */
+class demultiplexer
+{
+private:
+    //!\brief The options.
+    demux_options             opts{};
+    //!\brief The length of the barcodes.
+    size_t                    length = 0;
+    //!\brief The packed barcodes.
+    std::vector<uint64_t>     codes;
+    //!\brief The sorted codes of the table.
+    std::vector<uint64_t>     keys;
+    //!\brief The results for #keys.
+    std::vector<demux_result> values;
+    //!\brief `directory[h]` is the first index into #keys whose leading bits are `h`.
+    std::vector<uint32_t>     directory;
+    //!\brief The leading bits of a code are `code >> directory_shift`.
+    size_t                    directory_shift = 0;
+    //!\brief Distances for the linear scan.
+    std::vector<uint8_t>      distances;
+
+    //!\brief Fill #keys, #values and #directory.
+    void build_table()
+    {
+        struct entry
+        {
+            uint64_t code;
+            uint32_t barcode;
+            uint8_t  distance;
+        };
+
+        std::vector<entry> entries;
+        for (uint32_t i = 0; i < codes.size(); ++i)
+        {
+            uint64_t const c = codes[i];
+            entries.push_back({c, i, 0});
+            for (size_t j = 0; opts.max_mismatches >= 1 && j < length; ++j)
+            {
+                for (uint64_t x = 1; x < 4; ++x)
+                {
+                    uint64_t const n1 = c ^ (x << (2 * j));
+                    entries.push_back({n1, i, 1});
+                    for (size_t k = j + 1; opts.max_mismatches >= 2 && k < length; ++k)
+                        for (uint64_t y = 1; y < 4; ++y)
+                            entries.push_back({n1 ^ (y << (2 * k)), i, 2});
+                }
+            }
+        }
+
+        std::ranges::sort(entries, [](entry const & l, entry const & r)
+                          { return l.code != r.code ? l.code < r.code : l.distance < r.distance; });
+
+        keys.clear();
+        values.clear();
+        for (size_t i = 0; i < entries.size();)
+        {
+            size_t j = i + 1;
+            while (j < entries.size() && entries[j].code == entries[i].code)
+                ++j;
+
+            bool const tie = j > i + 1 && entries[i + 1].distance == entries[i].distance;
+            keys.push_back(entries[i].code);
+            values.push_back({tie ? demux_result::ambiguous : entries[i].barcode, entries[i].distance});
+            i = j;
+        }
+
+        size_t const bits = std::min<size_t>({2 * length, std::bit_width(keys.size()), 24});
+        directory_shift   = 2 * length - bits;
+        directory.assign((size_t{1} << bits) + 1, 0);
+        for (uint64_t const k : keys)
+            ++directory[(k >> directory_shift) + 1];
+        for (size_t h = 1; h < directory.size(); ++h)
+            directory[h] += directory[h - 1];
+    }
+
+    //!\brief Look up a code in the table.
+    demux_result lookup(uint64_t const code) const noexcept
+    {
+        size_t const h     = code >> directory_shift;
+        auto const   first = keys.begin() + directory[h];
+        auto const   last  = keys.begin() + directory[h + 1];
+        auto const   it    = std::lower_bound(first, last, code);
+        if (it == last || *it != code)
+            return {};
+        return values[it - keys.begin()];
+    }
+
+    //!\brief Compare with every barcode; `mask` excludes positions with `N` which are counted in `n_count`.
+    demux_result scan(uint64_t const code, uint64_t const mask, size_t const n_count) noexcept
+    {
+        if (n_count > opts.max_mismatches)
+            return {};
+
+        distances.resize(codes.size());
+        hamming_distances(code, codes, distances, mask);
+
+        demux_result ret{};
+        size_t       best = opts.max_mismatches - n_count + 1;
+        for (uint32_t i = 0; i < distances.size(); ++i)
+        {
+            if (distances[i] < best)
+            {
+                best = distances[i];
+                ret  = {i, static_cast<uint8_t>(distances[i] + n_count)};
+            }
+            else if (distances[i] == best && ret.barcode != demux_result::unassigned)
+            {
+                ret.barcode = demux_result::ambiguous;
+            }
+        }
+        return ret;
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    demultiplexer()                                  = default; //!< Defaulted.
+    demultiplexer(demultiplexer const &)             = default; //!< Defaulted.
+    demultiplexer(demultiplexer &&)                  = default; //!< Defaulted.
+    demultiplexer & operator=(demultiplexer const &) = default; //!< Defaulted.
+    demultiplexer & operator=(demultiplexer &&)      = default; //!< Defaulted.
+    ~demultiplexer()                                 = default; //!< Defaulted.
+
+    /*!\brief Construct from barcodes and options.
+     * \param[in] barcodes The barcodes; their position is the index reported by bio::preprocessing::demux_result.
+     * \param[in] options  The options.
+     * \throws std::invalid_argument If there are no barcodes, they have different lengths, are longer than 32,
+     * contain `N` or are not unique.
+     */
+    template <std::ranges::input_range barcodes_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<barcodes_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<barcodes_t>>>)
+    //!\endcond
+    explicit demultiplexer(barcodes_t && barcodes, demux_options const options = {}) : opts{options}
+    {
+        for (auto && barcode : barcodes)
+        {
+            size_t const l = std::ranges::distance(barcode);
+            if (codes.empty())
+                length = l;
+
+            if (l != length || l == 0 || l > packed_dna4_max_size)
+                throw std::invalid_argument{"All barcodes must have the same length between 1 and 32."};
+
+            std::optional<uint64_t> const code = pack_dna4(barcode);
+            if (!code)
+                throw std::invalid_argument{"Barcodes must not contain N."};
+            codes.push_back(*code);
+        }
+
+        if (codes.empty())
+            throw std::invalid_argument{"At least one barcode is required."};
+
+        std::vector<uint64_t> sorted = codes;
+        std::ranges::sort(sorted);
+        if (std::ranges::adjacent_find(sorted) != sorted.end())
+            throw std::invalid_argument{"Barcodes must be unique."};
+
+        if (opts.max_mismatches <= 2)
+            build_table();
+    }
+    //!\}
+
+    //!\brief The options.
+    demux_options const & options() const noexcept { return opts; }
+
+    //!\brief The length of the barcodes.
+    size_t barcode_size() const noexcept { return length; }
+
+    //!\brief The number of codes in the lookup table (`0` if more than 2 mismatches are allowed).
+    size_t table_size() const noexcept { return keys.size(); }
+
+    /*!\brief Assign a read to a barcode.
+     * \param[in] read The read.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Logarithmic in the number of table entries per directory bucket (usually constant) for reads without `N`;
+     * linear in the number of barcodes otherwise.
+     */
+    template <std::ranges::input_range read_t>
+        //!\cond
+        requires detail::dna5_compatible<std::ranges::range_value_t<read_t>>
+    //!\endcond
+    demux_result barcode_of(read_t && read)
+    {
+        // dna5 rank -> dna4 rank; N is marked by bit 2
+        constexpr std::array<uint8_t, 5> to_dna4{0, 1, 2, 4, 3};
+
+        uint64_t code    = 0;
+        uint64_t n_mask  = 0;
+        size_t   n_count = 0;
+        size_t   i       = 0;
+        auto     it      = std::ranges::begin(read);
+        for (; it != std::ranges::end(read) && i < opts.offset + length; ++it, ++i)
+        {
+            if (i < opts.offset)
+                continue;
+
+            std::ranges::range_value_t<read_t> const v = *it;
+            uint8_t const                            r = to_dna4[detail::to_dna5_rank(v)];
+            code    = (code << 2) | (r & 0b11);
+            n_mask  = (n_mask << 2) | (r >> 2);
+            n_count += r >> 2;
+        }
+
+        if (i < opts.offset + length) // read too short
+            return {};
+
+        if (n_count == 0 && !keys.empty())
+            return lookup(code);
+
+        return scan(code, ~n_mask, n_count);
+    }
+
+    /*!\brief Assign many reads to barcodes.
+     * \param[in]  reads The reads, e.g. a bio::ranges::concatenated_sequences.
+     * \param[out] out   The results; must be at least as large as `reads`.
+     */
+    template <std::ranges::input_range reads_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<reads_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>>)
+    //!\endcond
+    void barcodes_of(reads_t && reads, std::span<demux_result> const out)
+    {
+        size_t i = 0;
+        for (auto && read : reads)
+        {
+            assert(i < out.size());
+            out[i++] = barcode_of(read);
+        }
+    }
+
+    //!\overload
+    template <std::ranges::input_range reads_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<reads_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>>)
+    //!\endcond
+    std::vector<demux_result> barcodes_of(reads_t && reads)
+    {
+        std::vector<demux_result> ret;
+        if constexpr (std::ranges::sized_range<reads_t>)
+            ret.reserve(std::ranges::size(reads));
+        for (auto && read : reads)
+            ret.push_back(barcode_of(read));
+        return ret;
+    }
+};
+
+} // namespace bio::preprocessing
@@ -0,0 +1,160 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::detail::dna5_planes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/meta/concept/core_language.hpp>
+
+namespace bio::preprocessing::detail
+{
+
+/*!\brief Whether the type is bio::alphabet::dna4 or bio::alphabet::dna5 or a bio::alphabet::qualified thereof.
+ * \ingroup preprocessing
+ */
+template <typename t>
+concept dna5_compatible =
+  meta::one_of<t, alphabet::dna4, alphabet::dna5> ||
+  (alphabet::quality_alphabet<t> && requires(t const l) {
+      requires meta::one_of<std::remove_cvref_t<decltype(get<0>(l))>, alphabet::dna4, alphabet::dna5>;
+  });
+
+/*!\brief Returns the bio::alphabet::dna5 rank of a letter that models bio::preprocessing::detail::dna5_compatible.
+ * \ingroup preprocessing
+ */
+template <dna5_compatible alph_t>
+constexpr uint8_t to_dna5_rank(alph_t const l) noexcept
+{
+    if constexpr (std::same_as<alph_t, alphabet::dna5>)
+    {
+        return alphabet::to_rank(l);
+    }
+    else if constexpr (std::same_as<alph_t, alphabet::dna4>)
+    {
+        uint8_t const r = alphabet::to_rank(l);
+        return r == 3 ? 4 : r; // dna5 has N between G and T
+    }
+    else
+    {
+        return to_dna5_rank(std::remove_cvref_t<decltype(get<0>(l))>{get<0>(l)});
+    }
+}
+
+//!\brief The rank of `N` in bio::alphabet::dna5.
+inline constexpr uint8_t dna5_rank_n = 3;
+
+/*!\brief Bit-planes of a nucleotide sequence.
+ * \ingroup preprocessing
+ * \details
+ *
+ * Bit `i % 64` of `words[(i / 64) * 3 + j]` is bit `j` of the bio::alphabet::dna5 rank of the letter at position
+ * `i`. One block of zero words is appended so that windows starting at any position can be read without bounds
+ * checks. The storage is reused between calls to #assign().
+ */
+struct dna5_planes
+{
+    //!\brief The plane words, interleaved.
+    std::vector<uint64_t> words;
+    //!\brief The length of the sequence.
+    size_t                size = 0;
+
+    //!\brief Recompute the planes from a sequence.
+    template <std::ranges::input_range rng_t>
+    void assign(rng_t && seq)
+    {
+        if constexpr (std::ranges::random_access_range<rng_t> && std::ranges::sized_range<rng_t>)
+        {
+            size = std::ranges::size(seq);
+            words.assign((size / 64 + 2) * 3, 0ull);
+
+            auto it = std::ranges::begin(seq);
+            for (size_t w = 0; w * 64 < size; ++w) // counted inner loop, so the compiler can unroll/vectorise it
+                assign_word(w, it + w * 64, std::min<size_t>(64, size - w * 64));
+        }
+        else
+        {
+            words.clear();
+            size = 0;
+            for (auto && l : seq)
+            {
+                if (size % 64 == 0)
+                    words.insert(words.end(), {0ull, 0ull, 0ull});
+                std::ranges::range_value_t<rng_t> const v = l;
+                set(size++, to_dna5_rank(v));
+            }
+            words.resize((size / 64 + 2) * 3, 0ull);
+        }
+    }
+
+    //!\brief The 64 bits of plane `j` that start at position `i`.
+    uint64_t window(size_t const j, size_t const i) const noexcept
+    {
+        size_t const s = i % 64;
+        return shift(words[(i / 64) * 3 + j], words[(i / 64 + 1) * 3 + j], s);
+    }
+
+    //!\brief Bit `k` is set iff the letter at position `i + k` has rank `r` (or lies beyond the end if `r == 0`).
+    uint64_t equal_to(uint8_t const r, size_t const i) const noexcept
+    {
+        return ~((window(0, i) ^ -uint64_t{r & 1u}) | (window(1, i) ^ -uint64_t{(r >> 1) & 1u}) |
+                 (window(2, i) ^ -uint64_t{(r >> 2) & 1u}));
+    }
+
+    //!\brief Bit `k` is set iff bit `k` of the planes encodes `N`.
+    static constexpr uint64_t n_bits(uint64_t const p0, uint64_t const p1, uint64_t const p2) noexcept
+    {
+        static_assert(dna5_rank_n == 0b011);
+        return p0 & p1 & ~p2;
+    }
+
+    //!\brief Set position `i` to rank `r` (the position must still be empty).
+    void set(size_t const i, uint64_t const r) noexcept
+    {
+        uint64_t * const w = words.data() + (i / 64) * 3;
+        w[0] |= (r & 1) << (i % 64);
+        w[1] |= ((r >> 1) & 1) << (i % 64);
+        w[2] |= (r >> 2) << (i % 64);
+    }
+
+    //!\brief Fill word `w` with `n` letters starting at `it`.
+    template <std::random_access_iterator it_t>
+    void assign_word(size_t const w, it_t const it, size_t const n) noexcept
+    {
+        uint64_t p0 = 0;
+        uint64_t p1 = 0;
+        uint64_t p2 = 0;
+        for (size_t b = 0; b < n; ++b)
+        {
+            uint64_t const r = to_dna5_rank(std::iter_value_t<it_t>{it[b]});
+            p0 |= (r & 1) << b;
+            p1 |= ((r >> 1) & 1) << b;
+            p2 |= (r >> 2) << b;
+        }
+        words[w * 3]     = p0;
+        words[w * 3 + 1] = p1;
+        words[w * 3 + 2] = p2;
+    }
+
+    //!\brief The 64 bits starting at bit `s` of the 128-bit number `hi:lo`.
+    static constexpr uint64_t shift(uint64_t const lo, uint64_t const hi, size_t const s) noexcept
+    {
+        return (lo >> s) | ((hi << 1) << (63 - s)); // two shifts, because shifting by 64 is undefined
+    }
+};
+
+} // namespace bio::preprocessing::detail
@@ -0,0 +1,147 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::pack_dna4 and Hamming distance kernels for packed codes.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
+
+#include <bio/preprocessing/detail/dna5_planes.hpp>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+namespace bio::preprocessing
+{
+
+/*!\name Packed dna4 codes
+ * \ingroup preprocessing
+ * \brief Short nucleotide sequences as 2-bit codes in a single `uint64_t`.
+ * \details
+ *
+ * A sequence of up to 32 letters is packed with the first letter in the most significant position, i.e. codes
+ * of equal length compare like the sequences. Letters are bio::alphabet::dna4 ranks (`A=0, C=1, G=2, T=3`);
+ * sequences over bio::alphabet::dna5 (or bio::alphabet::qualified thereof) can be packed if they contain no `N`.
+ * \{
+ */
+
+//!\brief The maximum number of letters in a packed code.
+inline constexpr size_t packed_dna4_max_size = 32;
+
+/*!\brief Pack a sequence.
+ * \param[in] seq The sequence (at most 32 letters).
+ * \returns The code or std::nullopt if the sequence contains `N`.
+ */
+template <std::ranges::input_range rng_t>
+    //!\cond
+    requires detail::dna5_compatible<std::ranges::range_value_t<rng_t>>
+//!\endcond
+constexpr std::optional<uint64_t> pack_dna4(rng_t && seq) noexcept
+{
+    // dna5 rank -> dna4 rank; N is marked by bit 2
+    constexpr std::array<uint8_t, 5> to_dna4{0, 1, 2, 4, 3};
+
+    uint64_t code    = 0;
+    uint8_t  invalid = 0;
+    size_t   n       = 0;
+    for (auto && l : seq)
+    {
+        std::ranges::range_value_t<rng_t> const v = l;
+        uint8_t const                           r = to_dna4[detail::to_dna5_rank(v)];
+        invalid |= r;
+        code = (code << 2) | (r & 0b11);
+        ++n;
+    }
+    assert(n <= packed_dna4_max_size);
+
+    if (invalid & 0b100)
+        return std::nullopt;
+    return code;
+}
+
+/*!\brief The number of positions at which two packed codes differ.
+ * \param[in] lhs  A code.
+ * \param[in] rhs  Another code.
+ * \param[in] mask Only positions whose (lower) bit is set in the mask are considered.
+ */
+constexpr size_t hamming_distance(uint64_t const lhs, uint64_t const rhs, uint64_t const mask = ~0ull) noexcept
+{
+    uint64_t const x = lhs ^ rhs;
+    return std::popcount((x | (x >> 1)) & 0x5555'5555'5555'5555ull & mask);
+}
+
+/*!\brief Compute the Hamming distances of one code to many codes.
+ * \param[in]  query The code.
+ * \param[in]  codes The codes to compare with.
+ * \param[out] out   The distances; must be at least as large as `codes`.
+ * \param[in]  mask  Only positions whose (lower) bit is set in the mask are considered.
+ * \details
+ *
+ * Four codes are compared at a time with AVX2 (the population count is computed with a nibble lookup table and
+ * summed per code via `vpsadbw`); otherwise every code is compared with bio::preprocessing::hamming_distance.
+ */
+inline void hamming_distances(uint64_t const                  query,
+                              std::span<uint64_t const> const codes,
+                              std::span<uint8_t> const        out,
+                              uint64_t const                  mask = ~0ull) noexcept
+{
+    assert(out.size() >= codes.size());
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i const q    = _mm256_set1_epi64x(static_cast<int64_t>(query));
+    __m256i const m    = _mm256_set1_epi64x(static_cast<int64_t>(0x5555'5555'5555'5555ull & mask));
+    __m256i const low  = _mm256_set1_epi8(0x0F);
+    __m256i const lut  = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    __m256i const zero = _mm256_setzero_si256();
+
+    for (; i + 4 <= codes.size(); i += 4)
+    {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(codes.data() + i)), q);
+        x         = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi64(x, 1)), m);
+
+        __m256i const lo     = _mm256_shuffle_epi8(lut, _mm256_and_si256(x, low));
+        __m256i const hi     = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low));
+        __m256i const counts = _mm256_add_epi8(lo, hi);
+        __m256i const sums   = _mm256_sad_epu8(counts, zero); // one sum per 64-bit lane
+
+        out[i]     = static_cast<uint8_t>(_mm256_extract_epi64(sums, 0));
+        out[i + 1] = static_cast<uint8_t>(_mm256_extract_epi64(sums, 1));
+        out[i + 2] = static_cast<uint8_t>(_mm256_extract_epi64(sums, 2));
+        out[i + 3] = static_cast<uint8_t>(_mm256_extract_epi64(sums, 3));
+    }
+#endif
+
+    for (; i < codes.size(); ++i)
+        out[i] = static_cast<uint8_t>(hamming_distance(query, codes[i], mask));
+}
+
+/*!\brief Call a function for every code that differs from `code` at exactly one of the first `length` positions.
+ * \param[in] code   The code.
+ * \param[in] length The number of letters in the code.
+ * \param[in] fn     Called with every neighbour (`3 * length` times).
+ */
+template <typename fn_t>
+constexpr void for_each_neighbour(uint64_t const code, size_t const length, fn_t && fn)
+{
+    for (size_t j = 0; j < length; ++j)
+        for (uint64_t x = 1; x < 4; ++x)
+            fn(code ^ (x << (2 * j)));
+}
+//!\}
+
+} // namespace bio::preprocessing
@@ -0,0 +1,420 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::pair_merger.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+#include <bio/alphabet/quality/concept.hpp>
+#include <bio/preprocessing/detail/dna5_planes.hpp>
+#include <bio/ranges/views/complement.hpp>
+
+namespace bio::preprocessing::detail
+{
+
+/*!\brief The posterior qualities of two letters at the same position of a merged read.
+ * \ingroup preprocessing
+ * \details
+ *
+ * Both tables are indexed by two phred scores (clamped to `[0, 63]`). For equal letters, `match[q1][q2]` is the
+ * quality of the letter; for different letters, `mismatch[q_high][q_low]` is the quality of the letter with the
+ * higher score. With error probabilities `e1` and `e2` the posterior error probabilities are:
+ *
+ *   * match: `(e1 * e2 / 3) / (1 - e1 - e2 + 4 * e1 * e2 / 3)`
+ *   * mismatch: `e1 * (1 - e2 / 3) / (e1 + e2 - 4 * e1 * e2 / 3)`
+ *
+ * See Edgar & Flyvbjerg (2015), "Error filtering, pair assembly and error correction for next-generation
+ * sequencing reads".
+ */
+struct merge_quality_tables
+{
+    //!\brief The largest phred score in the tables.
+    static constexpr size_t max_phred = 63;
+
+    //!\brief Qualities for equal letters.
+    std::array<std::array<uint8_t, max_phred + 1>, max_phred + 1> match{};
+    //!\brief Qualities for different letters.
+    std::array<std::array<uint8_t, max_phred + 1>, max_phred + 1> mismatch{};
+
+    //!\brief Compute the tables.
+    merge_quality_tables()
+    {
+        auto to_error = [](size_t const q) { return std::pow(10.0, -static_cast<double>(q) / 10.0); };
+        auto to_phred = [](double const e)
+        {
+            double const q = std::round(-10.0 * std::log10(std::max(e, 1e-30)));
+            return static_cast<uint8_t>(std::clamp(q, 0.0, static_cast<double>(max_phred)));
+        };
+
+        for (size_t q1 = 0; q1 <= max_phred; ++q1)
+        {
+            for (size_t q2 = 0; q2 <= max_phred; ++q2)
+            {
+                double const e1 = to_error(q1);
+                double const e2 = to_error(q2);
+                match[q1][q2]    = to_phred((e1 * e2 / 3) / (1 - e1 - e2 + 4 * e1 * e2 / 3));
+                mismatch[q1][q2] = to_phred(e1 * (1 - e2 / 3) / (e1 + e2 - 4 * e1 * e2 / 3));
+            }
+        }
+    }
+
+    //!\brief The tables (computed on first use).
+    static merge_quality_tables const & get()
+    {
+        static merge_quality_tables const tables{};
+        return tables;
+    }
+};
+
+} // namespace bio::preprocessing::detail
+
+namespace bio::preprocessing
+{
+
+/*!\brief Options for bio::preprocessing::pair_merger.
+ * \ingroup preprocessing
+ */
+struct merge_options
+{
+    //!\brief The minimum number of overlapping letters.
+    size_t min_overlap    = 10;
+    //!\brief The maximum fraction of mismatches in the overlap (the allowed number is rounded down).
+    float  max_error_rate = 0.1f;
+};
+
+/*!\brief The overlap of a read pair as determined by bio::preprocessing::pair_merger.
+ * \ingroup preprocessing
+ */
+struct merge_result
+{
+    //!\brief Whether an acceptable overlap was found (all other members are only meaningful if so).
+    bool      merged     = false;
+    //!\brief The position of the first letter of the reverse-complemented read 2 relative to read 1.
+    ptrdiff_t offset     = 0;
+    //!\brief The number of overlapping letters.
+    size_t    overlap    = 0;
+    //!\brief The number of mismatches in the overlap (letters opposite an `N` are not counted).
+    size_t    mismatches = 0;
+    //!\brief The length of the merged read (`offset + size of read 2`).
+    size_t    length     = 0;
+
+    //!\brief Defaulted.
+    friend constexpr bool operator==(merge_result const &, merge_result const &) = default;
+};
+
+/*!\brief Merges overlapping read pairs into single reads.
+ * \ingroup preprocessing
+ * \details
+ *
+ * Read 2 is reverse-complemented and every offset relative to read 1 is tested; negative offsets correspond to
+ * fragments shorter than the reads ("dovetailing", the overhanging ends are adapter and are dropped). An offset is
+ * acceptable if the overlap has at least merge_options::min_overlap letters and at most
+ * `floor(overlap * max_error_rate)` mismatches. Of the acceptable offsets, the one with the lowest fraction of
+ * mismatches is chosen (ties are broken in favour of the longer overlap).
+ *
+ * Both reads are converted to bit-planes of their ranks (read 2 after reverse-complementing), so that 64 letters
+ * are compared with three XORs and one `popcount`; all offsets are tested in `O((n1 + n2)^2 / 64)`.
+ *
+ * In the merged read, overlapping positions with equal letters receive the posterior quality of both; for
+ * different letters the one with the higher quality is chosen and its quality reduced. Both are looked up in
+ * precomputed tables (see bio::preprocessing::detail::merge_quality_tables). `N` is replaced by the other letter.
+ *
+ * Sequences are ranges over bio::alphabet::dna5 or bio::alphabet::dna4 (or bio::alphabet::qualified thereof for
+ * bio::preprocessing::pair_merger::find_overlap). Like bio::preprocessing::trimmer, the merger holds reusable
+ * buffers; use one copy per thread.
+ *
+ * ### Example
+ *
+ * \include test/snippet/preprocessing/pair_merger.cpp
+ */
+class pair_merger
+{
+private:
+    //!\brief The options.
+    merge_options       opts{};
+    //!\brief The planes of read 1.
+    detail::dna5_planes planes1;
+    //!\brief The planes of the reverse complement of read 2.
+    detail::dna5_planes planes2;
+
+    //!\brief Count the mismatches of an overlap; stops early once `limit` is exceeded.
+    size_t count_mismatches(size_t const begin1, size_t const begin2, size_t const length, size_t const limit)
+      const noexcept
+    {
+        size_t mismatches = 0;
+        for (size_t k = 0; k < length && mismatches <= limit; k += 64)
+        {
+            uint64_t const a0 = planes1.window(0, begin1 + k);
+            uint64_t const a1 = planes1.window(1, begin1 + k);
+            uint64_t const a2 = planes1.window(2, begin1 + k);
+            uint64_t const b0 = planes2.window(0, begin2 + k);
+            uint64_t const b1 = planes2.window(1, begin2 + k);
+            uint64_t const b2 = planes2.window(2, begin2 + k);
+
+            uint64_t const differ = (a0 ^ b0) | (a1 ^ b1) | (a2 ^ b2);
+            uint64_t const ignore = detail::dna5_planes::n_bits(a0, a1, a2) | detail::dna5_planes::n_bits(b0, b1, b2);
+            uint64_t const valid  = ~0ull >> (64 - std::min<size_t>(64, length - k));
+            mismatches += std::popcount(differ & ~ignore & valid);
+        }
+        return mismatches;
+    }
+
+    //!\brief Find the best overlap of the current planes.
+    merge_result find_overlap_impl() const noexcept
+    {
+        ptrdiff_t const n1          = static_cast<ptrdiff_t>(planes1.size);
+        ptrdiff_t const n2          = static_cast<ptrdiff_t>(planes2.size);
+        ptrdiff_t const min_overlap = static_cast<ptrdiff_t>(std::max<size_t>(opts.min_overlap, 1));
+        float const     rate        = std::max(opts.max_error_rate, 0.0f);
+
+        merge_result best{};
+        for (ptrdiff_t d = min_overlap - n2; d <= n1 - min_overlap; ++d)
+        {
+            size_t const begin1  = static_cast<size_t>(std::max<ptrdiff_t>(d, 0));
+            size_t const begin2  = static_cast<size_t>(std::max<ptrdiff_t>(-d, 0));
+            size_t const overlap = static_cast<size_t>(std::min(n1, d + n2)) - begin1;
+            size_t const allowed = static_cast<size_t>(rate * static_cast<float>(overlap));
+
+            // if there is a best already, only count as far as needed to beat it
+            size_t const limit =
+              best.merged ? std::min(allowed, best.mismatches * overlap / best.overlap) : allowed;
+            size_t const mismatches = count_mismatches(begin1, begin2, overlap, limit);
+            if (mismatches > allowed)
+                continue;
+
+            // lower fraction of mismatches or same fraction and longer overlap
+            size_t const lhs = mismatches * best.overlap;
+            size_t const rhs = best.mismatches * overlap;
+            if (!best.merged || lhs < rhs || (lhs == rhs && overlap > best.overlap))
+                best = merge_result{true, d, overlap, mismatches, static_cast<size_t>(d + n2)};
+        }
+
+        return best;
+    }
+
+    //!\brief Merge based on an overlap and pass every letter and phred score of the merged read to `emit`.
+    template <typename seq1_t, typename qual1_t, typename seq2_t, typename qual2_t, typename emit_t>
+    static void merge_impl(merge_result const & res,
+                           seq1_t const &       seq1,
+                           qual1_t const &      qual1,
+                           seq2_t const &       seq2,
+                           qual2_t const &      qual2,
+                           emit_t &&            emit)
+    {
+        using letter_t   = std::ranges::range_value_t<seq1_t>;
+        auto const & tab = detail::merge_quality_tables::get();
+
+        auto phred = [](auto const q)
+        {
+            return static_cast<size_t>(
+              std::clamp<ptrdiff_t>(alphabet::to_phred(q), 0, detail::merge_quality_tables::max_phred));
+        };
+
+        ptrdiff_t const n1 = static_cast<ptrdiff_t>(std::ranges::size(seq1));
+        ptrdiff_t const n2 = static_cast<ptrdiff_t>(std::ranges::size(seq2));
+        for (ptrdiff_t p = 0; p < static_cast<ptrdiff_t>(res.length); ++p)
+        {
+            ptrdiff_t const k   = p - res.offset; // position in the reverse complement of read 2
+            bool const      in1 = p < n1;
+            bool const      in2 = k >= 0;
+
+            if (!in2)
+            {
+                emit(letter_t{seq1[p]}, phred(qual1[p]));
+                continue;
+            }
+
+            letter_t const l2 = alphabet::complement(letter_t{seq2[n2 - 1 - k]});
+            size_t const   q2 = phred(qual2[n2 - 1 - k]);
+            if (!in1)
+            {
+                emit(l2, q2);
+                continue;
+            }
+
+            letter_t const l1 = seq1[p];
+            size_t const   q1 = phred(qual1[p]);
+            if (l1 == l2)
+                emit(l1, tab.match[q1][q2]);
+            else if (detail::to_dna5_rank(l2) == detail::dna5_rank_n)
+                emit(l1, q1);
+            else if (detail::to_dna5_rank(l1) == detail::dna5_rank_n)
+                emit(l2, q2);
+            else if (q1 >= q2)
+                emit(l1, tab.mismatch[q1][q2]);
+            else
+                emit(l2, tab.mismatch[q2][q1]);
+        }
+    }
+
+    //!\brief The sequence component of a range over bio::alphabet::qualified.
+    static constexpr auto sequence_of = std::views::transform([](auto const l) { return get<0>(l); });
+    //!\brief The quality component of a range over bio::alphabet::qualified.
+    static constexpr auto quality_of  = std::views::transform([](auto const l) { return get<1>(l); });
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    pair_merger()                                = default; //!< Defaulted.
+    pair_merger(pair_merger const &)             = default; //!< Defaulted.
+    pair_merger(pair_merger &&)                  = default; //!< Defaulted.
+    pair_merger & operator=(pair_merger const &) = default; //!< Defaulted.
+    pair_merger & operator=(pair_merger &&)      = default; //!< Defaulted.
+    ~pair_merger()                               = default; //!< Defaulted.
+
+    //!\brief Construct with options.
+    explicit pair_merger(merge_options const options) : opts{options} {}
+    //!\}
+
+    //!\brief The options.
+    merge_options const & options() const noexcept { return opts; }
+
+    /*!\brief Find the best overlap of a read pair.
+     * \param[in] seq1 The sequence of read 1.
+     * \param[in] seq2 The sequence of read 2 (as sequenced, i.e. not reverse-complemented).
+     * \details
+     *
+     * ### Complexity
+     *
+     * `O((n1 + n2)^2 / 64)`.
+     */
+    template <std::ranges::bidirectional_range seq1_t, std::ranges::bidirectional_range seq2_t>
+        //!\cond
+        requires(detail::dna5_compatible<std::ranges::range_value_t<seq1_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<seq2_t>>)
+    //!\endcond
+    merge_result find_overlap(seq1_t && seq1, seq2_t && seq2)
+    {
+        planes1.assign(seq1);
+        planes2.assign(seq2 | std::views::reverse | views::complement);
+        return find_overlap_impl();
+    }
+
+    /*!\brief Merge a read pair given as separate sequences and qualities.
+     * \param[in]  seq1     The sequence of read 1.
+     * \param[in]  qual1    The qualities of read 1.
+     * \param[in]  seq2     The sequence of read 2 (as sequenced, i.e. not reverse-complemented).
+     * \param[in]  qual2    The qualities of read 2.
+     * \param[out] out_seq  The merged sequence is appended here.
+     * \param[out] out_qual The merged qualities are appended here.
+     * \returns The overlap; nothing is appended if merge_result::merged is `false`.
+     */
+    template <std::ranges::random_access_range seq1_t,
+              std::ranges::random_access_range qual1_t,
+              std::ranges::random_access_range seq2_t,
+              std::ranges::random_access_range qual2_t,
+              typename out_seq_t,
+              typename out_qual_t>
+        //!\cond
+        requires(meta::one_of<std::ranges::range_value_t<seq1_t>, alphabet::dna4, alphabet::dna5> &&
+                 std::same_as<std::ranges::range_value_t<seq1_t>, std::ranges::range_value_t<seq2_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<qual1_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<qual2_t>>)
+    //!\endcond
+    merge_result merge(seq1_t &&    seq1,
+                       qual1_t &&   qual1,
+                       seq2_t &&    seq2,
+                       qual2_t &&   qual2,
+                       out_seq_t &  out_seq,
+                       out_qual_t & out_qual)
+    {
+        merge_result const res = find_overlap(seq1, seq2);
+        if (res.merged)
+        {
+            merge_impl(res,
+                       seq1,
+                       qual1,
+                       seq2,
+                       qual2,
+                       [&](auto const l, size_t const q)
+                       {
+                           out_seq.push_back(l);
+                           out_qual.push_back(std::ranges::range_value_t<out_qual_t>{}.assign_phred(q));
+                       });
+        }
+        return res;
+    }
+
+    /*!\brief Merge a read pair over bio::alphabet::qualified.
+     * \param[in]  read1 Read 1.
+     * \param[in]  read2 Read 2 (as sequenced, i.e. not reverse-complemented).
+     * \param[out] out   The merged read is appended here.
+     * \returns The overlap; nothing is appended if merge_result::merged is `false`.
+     */
+    template <std::ranges::random_access_range read1_t, std::ranges::random_access_range read2_t, typename out_t>
+        //!\cond
+        requires(std::same_as<std::ranges::range_value_t<read1_t>, std::ranges::range_value_t<read2_t>> &&
+                 alphabet::quality_alphabet<std::ranges::range_value_t<read1_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<read1_t>>)
+    //!\endcond
+    merge_result merge(read1_t && read1, read2_t && read2, out_t & out)
+    {
+        using value_t = std::ranges::range_value_t<read1_t>;
+
+        auto const         seq1 = read1 | sequence_of;
+        auto const         seq2 = read2 | sequence_of;
+        merge_result const res  = find_overlap(seq1, seq2);
+        if (res.merged)
+        {
+            merge_impl(res,
+                       seq1,
+                       read1 | quality_of,
+                       seq2,
+                       read2 | quality_of,
+                       [&](auto const l, size_t const q)
+                       {
+                           value_t v{};
+                           get<0>(v) = l;
+                           alphabet::assign_phred_to(q, get<1>(v));
+                           out.push_back(v);
+                       });
+        }
+        return res;
+    }
+
+    /*!\brief Merge many read pairs over bio::alphabet::qualified.
+     * \param[in]  reads1 Reads 1, e.g. a bio::ranges::concatenated_sequences.
+     * \param[in]  reads2 Reads 2; the same number as `reads1`.
+     * \param[out] out    One read is appended per pair (an empty one for pairs that could not be merged).
+     * \returns The overlap of every pair.
+     */
+    template <std::ranges::input_range reads1_t, std::ranges::input_range reads2_t, typename out_t>
+        //!\cond
+        requires(std::ranges::random_access_range<std::ranges::range_reference_t<reads1_t>> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<reads2_t>>)
+    //!\endcond
+    std::vector<merge_result> merge_pairs(reads1_t && reads1, reads2_t && reads2, out_t & out)
+    {
+        std::vector<merge_result> ret;
+        if constexpr (std::ranges::sized_range<reads1_t>)
+            ret.reserve(std::ranges::size(reads1));
+
+        std::vector<std::ranges::range_value_t<std::ranges::range_value_t<out_t>>> buffer;
+
+        auto it2 = std::ranges::begin(reads2);
+        for (auto && read1 : reads1)
+        {
+            buffer.clear();
+            ret.push_back(merge(read1, *it2, buffer));
+            out.push_back(buffer);
+            ++it2;
+        }
+        return ret;
+    }
+};
+
+} // namespace bio::preprocessing
@@ -0,0 +1,374 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::trimmer and bio::preprocessing::trim_options.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/detail/dna5_planes.hpp>
+
+namespace bio::preprocessing::detail
+{
+
+/*!\brief Precomputed suffix scores of 8 letters for poly-X trimming.
+ * \ingroup preprocessing
+ * \details
+ *
+ * For a byte whose bit `k` indicates whether the letter at position `k` is X, the letters are scored from position
+ * 7 down to 0 with `+1` for X and `-2` otherwise. #delta is the total, #gain the highest intermediate score and
+ * #offset the (highest) position at which it is reached.
+ */
+struct poly_x_step
+{
+    int8_t  delta  = 0; //!< The score of all 8 letters.
+    int8_t  gain   = 0; //!< The best score of a suffix.
+    uint8_t offset = 0; //!< The start of the best suffix.
+};
+
+//!\brief The table of bio::preprocessing::detail::poly_x_step for every byte.
+//!\ingroup preprocessing
+inline constexpr std::array<poly_x_step, 256> poly_x_steps = []() constexpr
+{
+    std::array<poly_x_step, 256> ret{};
+    for (size_t byte = 0; byte < 256; ++byte)
+    {
+        int8_t score = 0;
+        int8_t gain  = -100;
+        for (size_t k = 8; k-- > 0;)
+        {
+            score += (byte >> k) & 1 ? 1 : -2;
+            if (score > gain)
+            {
+                gain             = score;
+                ret[byte].offset = static_cast<uint8_t>(k);
+            }
+        }
+        ret[byte].delta = score;
+        ret[byte].gain  = gain;
+    }
+    return ret;
+}();
+
+} // namespace bio::preprocessing::detail
+
+namespace bio::preprocessing
+{
+
+/*!\brief Options for bio::preprocessing::trimmer.
+ * \ingroup preprocessing
+ */
+struct trim_options
+{
+    //!\brief The maximum fraction of mismatches in an adapter match (the allowed number is rounded down).
+    float                       max_error_rate    = 0.1f;
+    //!\brief The minimum length of a partial adapter match at the end of a read.
+    size_t                      min_overlap       = 3;
+    //!\brief Letters whose tails are removed, e.g. `{'G'_dna5}` for two-colour chemistry or `{'A'_dna5}`.
+    std::vector<alphabet::dna5> poly_x{};
+    //!\brief The minimum length of a poly-X tail.
+    size_t                      min_poly_x_length = 10;
+};
+
+/*!\brief Finds 3' adapters and poly-X tails in nucleotide reads.
+ * \ingroup preprocessing
+ * \details
+ *
+ * Reads are ranges over bio::alphabet::dna5 or bio::alphabet::dna4, or over bio::alphabet::qualified thereof (only
+ * the sequence component is used). All member functions return a position; the read should be truncated there.
+ *
+ * ### Adapters
+ *
+ * The adapter is searched semi-globally, i.e. it may start at any position of the read and may continue beyond the
+ * end of the read (partial match). Only mismatches are allowed, not insertions or deletions. An occurrence at
+ * position `i` that overlaps the read by `L` letters is accepted if `L >= min_overlap` and it has at most
+ * `floor(L * max_error_rate)` mismatches. The leftmost accepted occurrence is reported.
+ * `N` in the adapter matches every letter, `N` in the read only matches `N` in the adapter.
+ * Only the first 64 letters of the adapter are considered.
+ *
+ * The ranks of the read are split into three bit-planes. For every candidate position, all mismatching letters are
+ * then determined at once by shifting the planes and XOR-ing them with those of the adapter, followed by a
+ * `popcount`, so the search is linear in the length of the read and independent of the length of the adapter.
+ *
+ * ### Poly-X tails
+ *
+ * Tails are found by scoring every suffix of the read with `+1` per letter X and `-2` per other letter; the suffix
+ * with the highest score (if it is at least #trim_options::min_poly_x_length long) is removed. The read is scanned
+ * from the end eight letters at a time using a table of precomputed scores; the scan stops once the remaining
+ * prefix cannot improve the score.
+ *
+ * bio::preprocessing::trimmer::trim_position removes poly-X tails first (e.g. poly-G from dark cycles), then the
+ * adapter and then poly-X tails again (e.g. poly-A before the adapter).
+ *
+ * ### Thread safety
+ *
+ * The trimmer holds a buffer that is reused between reads, so the member functions are not `const`. Use one copy
+ * of the trimmer per thread.
+ *
+ * ### Example
+ *
+ * \include test/snippet/preprocessing/trimmer.cpp
+ */
+class trimmer
+{
+private:
+    //!\brief Adapter letters after this are ignored.
+    static constexpr size_t max_adapter_size = 64;
+
+    //!\brief The options.
+    trim_options                              opts{};
+    //!\brief Bit `k` of `adapter_planes[j]` is bit `j` of the rank of the adapter letter at position `k`.
+    std::array<uint64_t, 3>                   adapter_planes{};
+    //!\brief Bit `k` is set iff the adapter letter at position `k` is `N`.
+    uint64_t                                  adapter_wildcards = 0;
+    //!\brief The number of adapter letters considered.
+    size_t                                    adapter_size      = 0;
+    //!\brief The number of mismatches allowed for every overlap length.
+    std::array<uint8_t, max_adapter_size + 1> max_mismatches{};
+    //!\brief The planes of the current read.
+    detail::dna5_planes                       planes;
+
+    //!\brief The adapter position in the current read, considering only the first `end` letters.
+    size_t adapter_position_impl(size_t const end) const noexcept
+    {
+        if (adapter_size == 0) // before the clamp, whose bounds would be reversed
+            return end;
+        size_t const min_overlap = std::clamp<size_t>(opts.min_overlap, 1, adapter_size);
+        if (end < min_overlap)
+            return end;
+
+        size_t const   last      = end - min_overlap; // the last candidate position
+        uint64_t const full_mask = ~adapter_wildcards & (~0ull >> (64 - adapter_size));
+
+        for (size_t w = 0; w * 64 <= last; ++w)
+        {
+            // all windows starting in this word are shifted out of the same two words per plane
+            uint64_t const * const lo = planes.words.data() + w * 3;
+            uint64_t const * const hi = lo + 3;
+            size_t const           n  = std::min<size_t>(64, last - w * 64 + 1);
+
+            for (size_t s = 0; s < n; ++s)
+            {
+                size_t const   i        = w * 64 + s;
+                bool const     full     = i + adapter_size <= end;
+                size_t const   overlap  = full ? adapter_size : end - i;
+                uint64_t const relevant = full ? full_mask : full_mask & (~0ull >> (64 - overlap));
+                size_t const   allowed  = max_mismatches[overlap];
+
+                // the differences in one plane are a lower bound and usually suffice to reject a position
+                uint64_t differ = (detail::dna5_planes::shift(lo[0], hi[0], s) ^ adapter_planes[0]) & relevant;
+                if (static_cast<size_t>(std::popcount(differ)) > allowed)
+                    continue;
+
+                differ |= ((detail::dna5_planes::shift(lo[1], hi[1], s) ^ adapter_planes[1]) |
+                           (detail::dna5_planes::shift(lo[2], hi[2], s) ^ adapter_planes[2])) &
+                          relevant;
+                if (static_cast<size_t>(std::popcount(differ)) <= allowed)
+                    return i;
+            }
+        }
+
+        return end;
+    }
+
+    //!\brief The start of the poly-X tail of rank `r` in the current read, considering only the first `end` letters.
+    size_t poly_x_position_impl(uint8_t const r, size_t const end) const noexcept
+    {
+        ptrdiff_t pos        = static_cast<ptrdiff_t>(end);
+        ptrdiff_t best       = pos;
+        ptrdiff_t score      = 0;
+        ptrdiff_t best_score = 0;
+
+        while (pos > 0) // eight letters at a time
+        {
+            ptrdiff_t const q = pos - 8;
+            // positions before the start of the read are shifted in as zeros, i.e. other letters
+            uint64_t const  x = q >= 0 ? planes.equal_to(r, q) : planes.equal_to(r, 0) << -q;
+
+            detail::poly_x_step const step = detail::poly_x_steps[x & 0xFF];
+            if (score + step.gain > best_score)
+            {
+                best_score = score + step.gain;
+                best       = q + step.offset;
+            }
+
+            score += step.delta;
+            pos = q;
+            if (score + std::max<ptrdiff_t>(pos, 0) <= best_score) // cannot become better
+                break;
+        }
+
+        size_t const ret = static_cast<size_t>(best);
+        return end - ret >= opts.min_poly_x_length ? ret : end;
+    }
+
+    //!\brief Apply all poly-X steps to the current read.
+    size_t poly_x_position_impl(size_t end) const noexcept
+    {
+        for (alphabet::dna5 const x : opts.poly_x)
+            end = poly_x_position_impl(alphabet::to_rank(x), end);
+        return end;
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    trimmer()                            = default; //!< Defaulted; no adapter, no poly-X.
+    trimmer(trimmer const &)             = default; //!< Defaulted.
+    trimmer(trimmer &&)                  = default; //!< Defaulted.
+    trimmer & operator=(trimmer const &) = default; //!< Defaulted.
+    trimmer & operator=(trimmer &&)      = default; //!< Defaulted.
+    ~trimmer()                           = default; //!< Defaulted.
+
+    /*!\brief Construct from an adapter and options.
+     * \param[in] adapter The adapter sequence (may be empty to only trim poly-X tails).
+     * \param[in] options The options.
+     */
+    template <std::ranges::input_range adapter_t>
+        //!\cond
+        requires detail::dna5_compatible<std::ranges::range_value_t<adapter_t>>
+    //!\endcond
+    explicit trimmer(adapter_t && adapter, trim_options options = {}) : opts{std::move(options)}
+    {
+        for (auto && l : adapter)
+        {
+            if (adapter_size == max_adapter_size)
+                break;
+
+            std::ranges::range_value_t<adapter_t> const v = l;
+            uint64_t const                              r = detail::to_dna5_rank(v);
+            adapter_planes[0] |= (r & 1) << adapter_size;
+            adapter_planes[1] |= ((r >> 1) & 1) << adapter_size;
+            adapter_planes[2] |= (r >> 2) << adapter_size;
+            adapter_wildcards |= uint64_t{r == detail::dna5_rank_n} << adapter_size;
+            ++adapter_size;
+        }
+
+        for (size_t l = 0; l <= max_adapter_size; ++l)
+            max_mismatches[l] = static_cast<uint8_t>(std::max(opts.max_error_rate, 0.0f) * static_cast<float>(l));
+    }
+    //!\}
+
+    //!\brief The options.
+    trim_options const & options() const noexcept { return opts; }
+
+    /*!\name Single reads
+     * \{
+     */
+    /*!\brief The position of the adapter in the read (or the size of the read if there is none).
+     * \param[in] read The read.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the size of the read.
+     */
+    template <std::ranges::input_range read_t>
+        //!\cond
+        requires detail::dna5_compatible<std::ranges::range_value_t<read_t>>
+    //!\endcond
+    size_t adapter_position(read_t && read)
+    {
+        planes.assign(read);
+        return adapter_position_impl(planes.size);
+    }
+
+    /*!\brief The start of the poly-X tails in the read (or the size of the read if there are none).
+     * \param[in] read The read.
+     * \details
+     *
+     * The letters in trim_options::poly_x are processed in order; each scan begins where the previous one ended.
+     *
+     * ### Complexity
+     *
+     * Linear in the size of the read; usually only the tail is inspected after the bit-planes have been created.
+     */
+    template <std::ranges::input_range read_t>
+        //!\cond
+        requires detail::dna5_compatible<std::ranges::range_value_t<read_t>>
+    //!\endcond
+    size_t poly_x_position(read_t && read)
+    {
+        planes.assign(read);
+        return poly_x_position_impl(planes.size);
+    }
+
+    /*!\brief The position where the read should be truncated after removing poly-X tails and the adapter.
+     * \param[in] read The read.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the size of the read.
+     */
+    template <std::ranges::input_range read_t>
+        //!\cond
+        requires detail::dna5_compatible<std::ranges::range_value_t<read_t>>
+    //!\endcond
+    size_t trim_position(read_t && read)
+    {
+        planes.assign(read);
+        size_t end = poly_x_position_impl(planes.size);
+        size_t const adapter = adapter_position_impl(end);
+        if (adapter != end)
+            end = poly_x_position_impl(adapter);
+        return end;
+    }
+    //!\}
+
+    /*!\name Batches of reads
+     * \{
+     */
+    /*!\brief Compute bio::preprocessing::trimmer::trim_position for many reads.
+     * \param[in]  reads The reads, e.g. a bio::ranges::concatenated_sequences.
+     * \param[out] out   The positions; must be at least as large as `reads`.
+     */
+    template <std::ranges::input_range reads_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<reads_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>>)
+    //!\endcond
+    void trim_positions(reads_t && reads, std::span<size_t> const out)
+    {
+        size_t i = 0;
+        for (auto && read : reads)
+        {
+            assert(i < out.size());
+            out[i++] = trim_position(read);
+        }
+    }
+
+    //!\overload
+    template <std::ranges::input_range reads_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<reads_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<reads_t>>>)
+    //!\endcond
+    std::vector<size_t> trim_positions(reads_t && reads)
+    {
+        std::vector<size_t> ret;
+        if constexpr (std::ranges::sized_range<reads_t>)
+            ret.reserve(std::ranges::size(reads));
+        for (auto && read : reads)
+            ret.push_back(trim_position(read));
+        return ret;
+    }
+    //!\}
+};
+
+} // namespace bio::preprocessing
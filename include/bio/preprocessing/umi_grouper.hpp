@@ -0,0 +1,316 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::preprocessing::umi_grouper.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bio/preprocessing/packed_dna4.hpp>
+
+namespace bio::preprocessing
+{
+
+/*!\brief Options for bio::preprocessing::umi_grouper.
+ * \ingroup preprocessing
+ */
+struct umi_options
+{
+    //!\brief The number of threads that cluster the UMIs of different positions.
+    size_t threads = 1;
+};
+
+/*!\brief Groups reads that are PCR duplicates by their position and UMI.
+ * \ingroup preprocessing
+ * \details
+ *
+ * Reads are first grouped by a position key chosen by the caller (e.g. reference, 5' position and strand packed
+ * into a `uint64_t`). Within a position, the distinct UMIs are clustered with the *directional* method of
+ * UMI-tools (Smith et al., 2017): there is an edge from UMI `a` to UMI `b` if they differ at exactly one position
+ * and `count(a) >= 2 * count(b) - 1`. Starting with the most frequent unclustered UMI, every UMI reachable via
+ * edges joins its cluster. All reads in a cluster form one group.
+ *
+ * UMIs are packed into 2-bit codes (see bio::preprocessing::pack_dna4); the neighbours of a UMI are enumerated by
+ * flipping the bits of one letter (bio::preprocessing::for_each_neighbour) and looked up among the sorted codes
+ * of the position. UMIs are never converted to strings. A UMI that contains `N` is not clustered, i.e. its read is
+ * a group of its own.
+ *
+ * Groups are numbered consecutively by position key and, within a position, by decreasing UMI count. The numbering
+ * does not depend on the number of threads.
+ *
+ * ### Example
+ *
+ * \include test/snippet/preprocessing/umi_grouper.cpp
+ */
+class umi_grouper
+{
+private:
+    //!\brief A read, sorted by position and UMI.
+    struct entry
+    {
+        uint64_t position;
+        uint64_t code;
+        uint32_t read;
+        bool     has_n;
+
+        //!\brief Order by position, then UMIs with `N` last, then code and read.
+        friend bool operator<(entry const & l, entry const & r) noexcept
+        {
+            if (l.position != r.position)
+                return l.position < r.position;
+            if (l.has_n != r.has_n)
+                return r.has_n;
+            if (l.code != r.code)
+                return l.code < r.code;
+            return l.read < r.read;
+        }
+    };
+
+    //!\brief A distinct UMI of a position.
+    struct node
+    {
+        uint64_t code;
+        uint32_t count;
+        uint32_t first; // index of the first entry
+    };
+
+    //!\brief Marks nodes that are not yet clustered.
+    static constexpr uint32_t unclustered = std::numeric_limits<uint32_t>::max();
+
+    //!\brief The options.
+    umi_options           opts{};
+    //!\brief The length of the UMIs.
+    size_t                umi_size = 0;
+    //!\brief The reads.
+    std::vector<entry>    entries;
+    //!\brief The cluster of every entry, relative to its position.
+    std::vector<uint32_t> local_cluster;
+    //!\brief The first entry of every position, plus one past the end.
+    std::vector<uint32_t> position_begin;
+    //!\brief The number of clusters at every position.
+    std::vector<uint32_t> position_clusters;
+
+    //!\brief Cluster the entries of the positions `[first, last)`.
+    void cluster_positions(size_t const first, size_t const last)
+    {
+        std::vector<node>     nodes;
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> cluster;
+        std::vector<uint32_t> stack;
+
+        for (size_t p = first; p < last; ++p)
+        {
+            size_t const begin = position_begin[p];
+            size_t const end   = position_begin[p + 1];
+
+            // distinct UMIs without N (they are sorted before the ones with N)
+            nodes.clear();
+            size_t e = begin;
+            for (; e < end && !entries[e].has_n; ++e)
+            {
+                if (nodes.empty() || nodes.back().code != entries[e].code)
+                    nodes.push_back({entries[e].code, 0, static_cast<uint32_t>(e)});
+                ++nodes.back().count;
+            }
+
+            order.resize(nodes.size());
+            for (uint32_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::ranges::sort(order,
+                              [&](uint32_t const l, uint32_t const r)
+                              {
+                                  return nodes[l].count != nodes[r].count ? nodes[l].count > nodes[r].count
+                                                                          : nodes[l].code < nodes[r].code;
+                              });
+
+            // directional clustering
+            uint32_t n_clusters = 0;
+            cluster.assign(nodes.size(), unclustered);
+            for (uint32_t const root : order)
+            {
+                if (cluster[root] != unclustered)
+                    continue;
+
+                cluster[root] = n_clusters;
+                stack.assign(1, root);
+                while (!stack.empty())
+                {
+                    uint32_t const u = stack.back();
+                    stack.pop_back();
+                    for_each_neighbour(nodes[u].code,
+                                       umi_size,
+                                       [&](uint64_t const code)
+                                       {
+                                           auto const it =
+                                             std::ranges::lower_bound(nodes, code, std::ranges::less{}, &node::code);
+                                           if (it == nodes.end() || it->code != code)
+                                               return;
+
+                                           uint32_t const v = it - nodes.begin();
+                                           if (cluster[v] == unclustered &&
+                                               nodes[u].count >= 2 * nodes[v].count - 1)
+                                           {
+                                               cluster[v] = n_clusters;
+                                               stack.push_back(v);
+                                           }
+                                       });
+                }
+                ++n_clusters;
+            }
+
+            for (uint32_t i = 0; i < nodes.size(); ++i)
+                for (size_t k = nodes[i].first; k < nodes[i].first + nodes[i].count; ++k)
+                    local_cluster[k] = cluster[i];
+
+            // every UMI with N is a cluster of its own
+            for (; e < end; ++e)
+                local_cluster[e] = n_clusters++;
+
+            position_clusters[p] = n_clusters;
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    umi_grouper()                                = default; //!< Defaulted.
+    umi_grouper(umi_grouper const &)             = default; //!< Defaulted.
+    umi_grouper(umi_grouper &&)                  = default; //!< Defaulted.
+    umi_grouper & operator=(umi_grouper const &) = default; //!< Defaulted.
+    umi_grouper & operator=(umi_grouper &&)      = default; //!< Defaulted.
+    ~umi_grouper()                               = default; //!< Defaulted.
+
+    //!\brief Construct with options.
+    explicit umi_grouper(umi_options const options) : opts{options} {}
+    //!\}
+
+    //!\brief The options.
+    umi_options const & options() const noexcept { return opts; }
+
+    /*!\brief Assign every read to a group of duplicates.
+     * \param[in]  positions The position key of every read.
+     * \param[in]  umis      The UMI of every read, e.g. a bio::ranges::concatenated_sequences.
+     * \param[out] out       The group of every read; must be at least as large as `positions`.
+     * \returns The number of groups.
+     * \throws std::invalid_argument If `positions` and `umis` have different sizes or the UMIs have different
+     * lengths or are longer than 32.
+     * \details
+     *
+     * ### Complexity
+     *
+     * `O(n log n)` for sorting `n` reads plus `O(u * l * log u)` for `u` distinct UMIs of length `l` per position.
+     */
+    template <std::ranges::random_access_range positions_t, std::ranges::input_range umis_t>
+        //!\cond
+        requires(std::ranges::sized_range<positions_t> &&
+                 std::convertible_to<std::ranges::range_reference_t<positions_t>, uint64_t> &&
+                 std::ranges::input_range<std::ranges::range_reference_t<umis_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<umis_t>>>)
+    //!\endcond
+    size_t group(positions_t && positions, umis_t && umis, std::span<uint32_t> const out)
+    {
+        size_t const n = std::ranges::size(positions);
+        assert(out.size() >= n);
+
+        entries.clear();
+        entries.reserve(n);
+        umi_size = 0;
+        for (auto && umi : umis)
+        {
+            if (entries.size() == n)
+                throw std::invalid_argument{"There must be one UMI per position."};
+
+            size_t const l = std::ranges::distance(umi);
+            if (entries.empty())
+                umi_size = l;
+            if (l != umi_size || l > packed_dna4_max_size)
+                throw std::invalid_argument{"All UMIs must have the same length of at most 32."};
+
+            std::optional<uint64_t> const code = pack_dna4(umi);
+            uint32_t const                i    = entries.size();
+            entries.push_back({static_cast<uint64_t>(positions[i]), code.value_or(0), i, !code.has_value()});
+        }
+        if (entries.size() != n)
+            throw std::invalid_argument{"There must be one UMI per position."};
+
+        std::sort(entries.begin(), entries.end());
+
+        position_begin.clear();
+        for (uint32_t e = 0; e < n; ++e)
+            if (e == 0 || entries[e].position != entries[e - 1].position)
+                position_begin.push_back(e);
+        size_t const n_positions = position_begin.size();
+        position_begin.push_back(n);
+
+        local_cluster.resize(n);
+        position_clusters.resize(n_positions);
+
+        // split the positions into chunks of about the same number of reads
+        size_t const threads = std::clamp<size_t>(opts.threads, 1, std::max<size_t>(n_positions, 1));
+        if (threads == 1)
+        {
+            cluster_positions(0, n_positions);
+        }
+        else
+        {
+            std::vector<std::thread> workers;
+            size_t                   first = 0;
+            for (size_t t = 1; t <= threads; ++t)
+            {
+                size_t last = first;
+                while (last < n_positions && position_begin[last] < n * t / threads)
+                    ++last;
+                if (t == threads)
+                    last = n_positions;
+
+                workers.emplace_back([this, first, last]() { cluster_positions(first, last); });
+                first = last;
+            }
+            for (std::thread & w : workers)
+                w.join();
+        }
+
+        uint32_t n_groups = 0;
+        for (size_t p = 0; p < n_positions; ++p)
+        {
+            for (size_t e = position_begin[p]; e < position_begin[p + 1]; ++e)
+                out[entries[e].read] = n_groups + local_cluster[e];
+            n_groups += position_clusters[p];
+        }
+        return n_groups;
+    }
+
+    //!\overload
+    template <std::ranges::random_access_range positions_t, std::ranges::input_range umis_t>
+        //!\cond
+        requires(std::ranges::sized_range<positions_t> &&
+                 std::convertible_to<std::ranges::range_reference_t<positions_t>, uint64_t> &&
+                 std::ranges::input_range<std::ranges::range_reference_t<umis_t>> &&
+                 detail::dna5_compatible<std::ranges::range_value_t<std::ranges::range_reference_t<umis_t>>>)
+    //!\endcond
+    std::vector<uint32_t> group(positions_t && positions, umis_t && umis)
+    {
+        std::vector<uint32_t> ret(std::ranges::size(positions));
+        group(positions, umis, ret);
+        return ret;
+    }
+};
+
+} // namespace bio::preprocessing
@@ -15,8 +15,12 @@
 
 #include <bio/ranges/container/aligned_allocator.hpp>
 #include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/bitvector.hpp>
+#include <bio/ranges/container/chunked_sequences.hpp>
 #include <bio/ranges/container/concatenated_sequences.hpp>
 #include <bio/ranges/container/concept.hpp>
+#include <bio/ranges/container/growth_policy.hpp>
+#include <bio/ranges/container/run_length_sequence.hpp>
 #include <bio/ranges/container/small_string.hpp>
 #include <bio/ranges/container/small_vector.hpp>
 
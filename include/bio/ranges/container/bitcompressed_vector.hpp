@@ -20,6 +20,7 @@
 #include <type_traits>
 
 #include <bio/alphabet/proxy_base.hpp>
+#include <bio/meta/instrumentation.hpp>
 #include <bio/ranges/detail/random_access_iterator.hpp>
 #include <bio/ranges/views/convert.hpp>
 #include <bio/ranges/views/repeat_n.hpp>
@@ -165,6 +166,7 @@ private:
         //!\brief Update the compressed representation.
         constexpr reference_proxy_type & assign_rank(alphabet::rank_t<alphabet_type> const r) noexcept
         {
+            meta::detail::instrumentation_count(meta::instrumentation_counter::bitcompressed_vector_proxy_writes);
             set_rank(*data_ptr, index, r);
             return *this;
         }
@@ -172,6 +174,7 @@ private:
         //!\brief Update the compressed representation (also works on `const` objects).
         constexpr reference_proxy_type const & assign_rank(alphabet::rank_t<alphabet_type> const r) const noexcept
         {
+            meta::detail::instrumentation_count(meta::instrumentation_counter::bitcompressed_vector_proxy_writes);
             set_rank(*data_ptr, index, r);
             return *this;
         }
@@ -0,0 +1,1169 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::bitvector.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+#include <bio/ranges/detail/random_access_iterator.hpp>
+#include <bio/ranges/views/interleave.hpp>
+#include <bio/ranges/views/repeat_n.hpp>
+
+namespace bio::ranges::detail
+{
+
+//!\brief Proxy data type returned by bio::ranges::bitvector as reference to the bit.
+class bitvector_reference_proxy
+{
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    constexpr bitvector_reference_proxy() noexcept                                  = default; //!< Defaulted.
+    constexpr bitvector_reference_proxy(bitvector_reference_proxy const &) noexcept = default; //!< Defaulted.
+    constexpr bitvector_reference_proxy(bitvector_reference_proxy &&) noexcept      = default; //!< Defaulted.
+
+    //!\brief Assign the value of the bit.
+    constexpr bitvector_reference_proxy & operator=(bitvector_reference_proxy const rhs) noexcept
+    {
+        rhs ? set() : reset();
+        return *this;
+    }
+
+    //!\brief Sets the referenced bit to `value`.
+    constexpr bitvector_reference_proxy & operator=(bool const value) noexcept
+    {
+        value ? set() : reset();
+        return *this;
+    }
+
+    ~bitvector_reference_proxy() noexcept = default; //!< Defaulted.
+    //!\}
+
+    //!\brief Initialise from a word of bio::ranges::bitvector's underlying data and a bit position in that word.
+    constexpr bitvector_reference_proxy(uint64_t & word_, size_t const pos) noexcept : word{&word_}, mask{1ULL << pos}
+    {}
+
+    //!\brief Returns the value of the referenced bit.
+    constexpr operator bool() const noexcept { return static_cast<bool>(*word & mask); }
+
+    //!\brief Returns the inverted value of the referenced bit.
+    constexpr bool operator~() const noexcept { return !static_cast<bool>(*word & mask); }
+
+    //!\brief Sets the referenced bit to the result of a binary OR with `value`.
+    constexpr bitvector_reference_proxy & operator|=(bool const value)
+    {
+        if (value)
+            set();
+
+        return *this;
+    }
+
+    //!\brief Sets the referenced bit to the result of a binary AND with `value`.
+    constexpr bitvector_reference_proxy & operator&=(bool const value)
+    {
+        if (!value)
+            reset();
+
+        return *this;
+    }
+
+    //!\brief Sets the referenced bit to the result of a binary XOR with `value`.
+    constexpr bitvector_reference_proxy & operator^=(bool const value)
+    {
+        operator bool() != value ? set() : reset();
+        return *this;
+    }
+
+private:
+    //!\brief Pointer to the word that contains the bit.
+    uint64_t * word = nullptr;
+    //!\brief Bitmask to access one specific bit.
+    uint64_t   mask = 0;
+
+    //!\brief Sets the referenced bit to `1`.
+    constexpr void set() noexcept { *word |= mask; }
+
+    //!\brief Sets the referenced bit to `0`.
+    constexpr void reset() noexcept { *word &= ~mask; }
+};
+
+/*!\name Word-wise kernels of bio::ranges::bitvector
+ * \brief These operate on `n` words and use AVX2 for the bulk of the data if available.
+ * \{
+ */
+//!\brief `lhs[i] &= rhs[i]` for all i in [0, n).
+inline void bitvector_and(uint64_t * lhs, uint64_t const * rhs, size_t const n) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i const l = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + i));
+        __m256i const r = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lhs + i), _mm256_and_si256(l, r));
+    }
+#endif
+    for (; i < n; ++i)
+        lhs[i] &= rhs[i];
+}
+
+//!\brief `lhs[i] |= rhs[i]` for all i in [0, n).
+inline void bitvector_or(uint64_t * lhs, uint64_t const * rhs, size_t const n) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i const l = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + i));
+        __m256i const r = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lhs + i), _mm256_or_si256(l, r));
+    }
+#endif
+    for (; i < n; ++i)
+        lhs[i] |= rhs[i];
+}
+
+//!\brief `lhs[i] ^= rhs[i]` for all i in [0, n).
+inline void bitvector_xor(uint64_t * lhs, uint64_t const * rhs, size_t const n) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i const l = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(lhs + i));
+        __m256i const r = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lhs + i), _mm256_xor_si256(l, r));
+    }
+#endif
+    for (; i < n; ++i)
+        lhs[i] ^= rhs[i];
+}
+
+//!\brief `data[i] = ~data[i]` for all i in [0, n).
+inline void bitvector_not(uint64_t * data, size_t const n) noexcept
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i const ones = _mm256_set1_epi64x(-1);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i const d = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(d, ones));
+    }
+#endif
+    for (; i < n; ++i)
+        data[i] = ~data[i];
+}
+
+/*!\brief Returns the number of set bits in [data, data + n).
+ * \details
+ *
+ * The AVX2 path implements the nibble-lookup popcount by Muła et al. ("Faster Population Counts Using AVX2
+ * Instructions", 2016) which outperforms the scalar `popcnt` instruction on long inputs.
+ */
+inline size_t bitvector_popcount(uint64_t const * data, size_t const n) noexcept
+{
+    size_t ret = 0;
+    size_t i   = 0;
+#if defined(__AVX2__)
+    __m256i const lookup   = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    __m256i const low_mask = _mm256_set1_epi8(0x0f);
+    __m256i       acc      = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i const v   = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+        __m256i const lo  = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+        __m256i const hi  = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        // sum bytes per 64bit lane; cannot overflow as every lane holds at most 64
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    ret += static_cast<size_t>(_mm256_extract_epi64(acc, 0)) + static_cast<size_t>(_mm256_extract_epi64(acc, 1)) +
+           static_cast<size_t>(_mm256_extract_epi64(acc, 2)) + static_cast<size_t>(_mm256_extract_epi64(acc, 3));
+#endif
+    for (; i < n; ++i)
+        ret += std::popcount(data[i]);
+    return ret;
+}
+//!\}
+
+} // namespace bio::ranges::detail
+
+namespace bio::ranges
+{
+
+/*!\brief A bitvector with heap storage and dynamic size.
+ * \implements bio::ranges::detail::reservible_container
+ * \implements bio::cerealisable
+ * \ingroup container
+ *
+ * \details
+ *
+ * This container provides the same interface as bio::ranges::dynamic_bitset, but it has no upper bound on its
+ * size. The bits are stored in a `std::vector<uint64_t>`, bit `i` is at position `i % 64` of word `i / 64`.
+ * All bitwise operations, bit counting and searching are performed word-at-a-time and the bulk operations
+ * (`&`, `|`, `^`, `~`, `count()`) make use of AVX2 if the code is compiled with support for it (e.g. via
+ * `-mavx2` or `-march=native`).
+ *
+ * This makes it suitable for large masks, e.g. to mark covered or ambiguous positions on a chromosome.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/container/bitvector.cpp
+ *
+ * ### Thread safety
+ *
+ * This container provides no thread-safety beyond the promise given also by the STL that all
+ * calls to `const` member functions are safe from multiple threads (as long as no thread calls
+ * a non-`const` member function at the same time).
+ *
+ * Similar to bio::ranges::bitcompressed_vector, writing to two different positions from different threads
+ * **is not safe** if these positions are stored in the same 64bit-word.
+ */
+class bitvector
+{
+private:
+    //!\brief The element type of the underlying storage vector.
+    using word_type                     = uint64_t;
+    //!\brief Size in bits of the word_type.
+    static constexpr size_t word_size   = sizeof(word_type) * CHAR_BIT;
+    //!\brief Type of the underlying storage.
+    using data_type                     = std::vector<word_type>;
+
+    //!\brief The number of bits.
+    size_t    size_ = 0;
+    //!\brief The data storage.
+    data_type data;
+
+    //!\brief The number of words needed to store `count` bits.
+    static constexpr size_t words_for(size_t const count) noexcept { return (count + word_size - 1) / word_size; }
+
+    //!\brief Zeros out the bits behind the last element in the last word.
+    constexpr void clear_unused_bits_in_last_word() noexcept
+    {
+        if (size_ % word_size != 0)
+            data.back() &= (1ULL << (size_ % word_size)) - 1ULL;
+    }
+
+public:
+    /*!\name Associated types
+     * \{
+     */
+    //!\brief Equals `bool`.
+    using value_type      = bool;
+    //!\brief A proxy type that enables assignment.
+    using reference       = detail::bitvector_reference_proxy;
+    //!\brief Equals the value_type.
+    using const_reference = bool;
+    //!\brief The iterator type of this container (a random access iterator).
+    using iterator        = detail::random_access_iterator<bitvector>;
+    //!\brief The `const_iterator` type of this container (a random access iterator).
+    using const_iterator  = detail::random_access_iterator<bitvector const>;
+    //!\brief A `std::ptrdiff_t`.
+    using difference_type = ptrdiff_t;
+    //!\brief A `std::size_t`.
+    using size_type       = size_t;
+    //!\}
+
+    //!\cond
+    // this signals to range-v3 that something is a container :|
+    using allocator_type = void;
+    //!\endcond
+
+    //!\brief Returned by #find_first() and #find_next() if no bit is set.
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    bitvector()                              = default; //!< Defaulted.
+    bitvector(bitvector const &)             = default; //!< Defaulted.
+    bitvector(bitvector &&)                  = default; //!< Defaulted.
+    bitvector & operator=(bitvector const &) = default; //!< Defaulted.
+    bitvector & operator=(bitvector &&)      = default; //!< Defaulted.
+    ~bitvector()                             = default; //!< Defaulted.
+
+    /*!\brief Construct from two iterators.
+     * \tparam begin_it_type Must model std::forward_iterator and `value_type` must be constructible from
+     *                       the reference type of `begin_it_type`.
+     * \tparam end_it_type   Must model std::sentinel_for.
+     * \param[in] begin_it Begin of range to construct/assign from.
+     * \param[in] end_it   End of range to construct/assign from.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the distance between `begin_it` and `end_it`.
+     */
+    template <std::forward_iterator begin_it_type, typename end_it_type>
+        //!\cond
+        requires(std::sentinel_for<end_it_type, begin_it_type> &&
+                   std::constructible_from<value_type, std::iter_reference_t<begin_it_type>>)
+    //!\endcond
+    bitvector(begin_it_type begin_it, end_it_type end_it)
+    {
+        assign(begin_it, end_it);
+    }
+
+    /*!\brief Construct from a different range.
+     * \tparam other_range_t The type of range to be inserted; must satisfy std::ranges::input_range and `value_type`
+     *                       must be constructible from `std::ranges::range_reference_t<other_range_t>`.
+     * \param[in] range The sequence to construct/assign from.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the size of `range`.
+     */
+    template <std::ranges::input_range other_range_t>
+        //!\cond
+        requires(!std::same_as<std::remove_cvref_t<other_range_t>, bitvector> &&
+                 std::constructible_from<value_type, std::ranges::range_reference_t<other_range_t>>)
+    //!\endcond
+    explicit bitvector(other_range_t && range)
+    {
+        assign(std::forward<other_range_t>(range));
+    }
+
+    /*!\brief Construct with `n` times `value`.
+     * \param[in] n     Number of elements.
+     * \param[in] value The initial value to be assigned.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in `n`.
+     */
+    bitvector(size_type const n, value_type const value) { assign(n, value); }
+
+    /*!\brief Construction from literal.
+     * \param[in] lit The literal to construct the string for. May only contain <code>'0'</code> and <code>'1'</code>.
+     * \throws std::invalid_argument if any character is not <code>'0'</code> or <code>'1'</code>.
+     *
+     * \details
+     *
+     * As with bio::ranges::dynamic_bitset, the last character of the literal denotes the bit at position `0`.
+     *
+     * ### Complexity
+     *
+     * Linear in the size of `lit`.
+     */
+    template <size_t N>
+    bitvector(char const (&lit)[N])
+    {
+        assign(lit);
+    }
+
+    //!\brief Assign from `std::initializer_list`.
+    bitvector & operator=(std::initializer_list<value_type> const ilist)
+    {
+        assign(ilist);
+        return *this;
+    }
+
+    //!\brief Assign from literal. \copydetails bitvector(char const (&lit)[N])
+    template <size_t N>
+    void assign(char const (&lit)[N])
+    {
+        assert(lit[N - 1] == '\0');
+        clear();
+        resize(N - 1);
+
+        for (size_t i = 0; i != N - 1; ++i)
+        {
+            if (lit[i] == '1')
+                (*this)[N - 2 - i] = true;
+            else if (lit[i] != '0')
+                throw std::invalid_argument{"The string to construct a bitvector from may only contain 0 and 1."};
+        }
+    }
+
+    //!\brief Assign from `std::initializer_list`.
+    void assign(std::initializer_list<value_type> const ilist)
+    {
+        assign(std::ranges::begin(ilist), std::ranges::end(ilist));
+    }
+
+    /*!\brief Assign with `count` times `value`.
+     * \param[in] count Number of elements.
+     * \param[in] value The initial value to be assigned.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in `count / 64`.
+     */
+    void assign(size_type const count, value_type const value)
+    {
+        clear();
+        resize(count, value);
+    }
+
+    //!\brief Assign from a different range.
+    template <std::ranges::input_range other_range_t>
+        //!\cond
+        requires std::constructible_from<value_type, std::ranges::range_reference_t<other_range_t>>
+    //!\endcond
+    void assign(other_range_t && range)
+    {
+        clear();
+        if constexpr (std::ranges::sized_range<other_range_t>)
+            reserve(std::ranges::size(range));
+
+        for (auto && v : range)
+            push_back(static_cast<value_type>(v));
+    }
+
+    //!\brief Assign from pair of iterators.
+    template <std::forward_iterator begin_it_type, typename end_it_type>
+        //!\cond
+        requires(std::sentinel_for<end_it_type, begin_it_type> &&
+                   std::constructible_from<value_type, std::iter_reference_t<begin_it_type>>)
+    //!\endcond
+    void assign(begin_it_type begin_it, end_it_type end_it)
+    {
+        assign(std::ranges::subrange<begin_it_type, end_it_type>{begin_it, end_it});
+    }
+    //!\}
+
+    /*!\name Iterators
+     * \{
+     */
+    //!\brief Returns the begin to the `bitvector`.
+    iterator begin() noexcept { return iterator{*this}; }
+
+    //!\copydoc begin()
+    const_iterator begin() const noexcept { return const_iterator{*this}; }
+
+    //!\copydoc begin()
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    //!\brief Returns iterator past the end of the `bitvector`.
+    iterator end() noexcept { return iterator{*this, size()}; }
+
+    //!\copydoc end()
+    const_iterator end() const noexcept { return const_iterator{*this, size()}; }
+
+    //!\copydoc end()
+    const_iterator cend() const noexcept { return end(); }
+    //!\}
+
+    /*!\name Bit manipulation
+     * \{
+     */
+    /*!\brief Sets the bits to the result of binary AND on corresponding pairs of bits of `*this` and `rhs`.
+     * \param[in] rhs bitvector to perform binary AND with.
+     * \returns *this
+     *
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    bitvector & operator&=(bitvector const & rhs) noexcept
+    {
+        assert(size() == rhs.size());
+        detail::bitvector_and(data.data(), rhs.data.data(), data.size());
+        return *this;
+    }
+
+    /*!\brief Sets the bits to the result of binary OR on corresponding pairs of bits of `*this` and `rhs`.
+     * \param[in] rhs bitvector to perform binary OR with.
+     * \returns *this
+     *
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    bitvector & operator|=(bitvector const & rhs) noexcept
+    {
+        assert(size() == rhs.size());
+        detail::bitvector_or(data.data(), rhs.data.data(), data.size());
+        return *this;
+    }
+
+    /*!\brief Sets the bits to the result of binary XOR on corresponding pairs of bits of `*this` and `rhs`.
+     * \param[in] rhs bitvector to perform binary XOR with.
+     * \returns *this
+     *
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    bitvector & operator^=(bitvector const & rhs) noexcept
+    {
+        assert(size() == rhs.size());
+        detail::bitvector_xor(data.data(), rhs.data.data(), data.size());
+        return *this;
+    }
+
+    //!\brief Returns a temporary copy of `*this` with all bits flipped (binary NOT).
+    bitvector operator~() const
+    {
+        bitvector tmp{*this};
+        tmp.flip();
+        return tmp;
+    }
+
+    /*!\brief Performs binary shift left on the current object, i.e. bit `i` is moved to position `i + count`.
+     * \param[in] count Amount to shift to the left.
+     * \returns *this
+     *
+     * \details
+     *
+     * Bits shifted past `size()` are discarded, the size does not change. In contrast to bio::ranges::dynamic_bitset,
+     * `count` may be `0` or larger than `size()`.
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    bitvector & operator<<=(size_t const count) noexcept
+    {
+        if (count >= size())
+            return reset();
+
+        size_t const n           = data.size();
+        size_t const word_shift  = count / word_size;
+        size_t const inner_shift = count % word_size;
+
+        if (inner_shift == 0)
+        {
+            std::copy_backward(data.begin(), data.end() - word_shift, data.end());
+        }
+        else
+        {
+            for (size_t i = n - 1; i > word_shift; --i)
+                data[i] = (data[i - word_shift] << inner_shift) | (data[i - word_shift - 1] >> (word_size - inner_shift));
+            data[word_shift] = data[0] << inner_shift;
+        }
+        std::fill_n(data.begin(), word_shift, 0ULL);
+
+        clear_unused_bits_in_last_word();
+        return *this;
+    }
+
+    /*!\brief Performs binary shift right on the current object, i.e. bit `i + count` is moved to position `i`.
+     * \param[in] count Amount to shift to the right.
+     * \returns *this
+     *
+     * \details
+     *
+     * The size does not change; the upper `count` bits are set to `0`.
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    bitvector & operator>>=(size_t const count) noexcept
+    {
+        if (count >= size())
+            return reset();
+
+        size_t const n           = data.size();
+        size_t const word_shift  = count / word_size;
+        size_t const inner_shift = count % word_size;
+
+        if (inner_shift == 0)
+        {
+            std::copy(data.begin() + word_shift, data.end(), data.begin());
+        }
+        else
+        {
+            for (size_t i = 0; i + word_shift + 1 < n; ++i)
+                data[i] = (data[i + word_shift] >> inner_shift) | (data[i + word_shift + 1] << (word_size - inner_shift));
+            data[n - word_shift - 1] = data[n - 1] >> inner_shift;
+        }
+        std::fill(data.end() - word_shift, data.end(), 0ULL);
+
+        return *this;
+    }
+
+    //!\brief Performs binary shift right. \copydetails operator>>=()
+    bitvector operator>>(size_t const count) const
+    {
+        bitvector tmp{*this};
+        tmp >>= count;
+        return tmp;
+    }
+
+    //!\brief Performs binary shift left. \copydetails operator<<=()
+    bitvector operator<<(size_t const count) const
+    {
+        bitvector tmp{*this};
+        tmp <<= count;
+        return tmp;
+    }
+
+    //!\brief Sets all bits to `1`.
+    bitvector & set() noexcept
+    {
+        std::ranges::fill(data, ~0ULL);
+        clear_unused_bits_in_last_word();
+        return *this;
+    }
+
+    /*!\brief Sets the i'th bit to `value`.
+     * \param[in] i     Index of the bit to set.
+     * \param[in] value Value to set. Default true.
+     * \throws std::out_of_range if you access an element behind the last.
+     * \returns *this
+     */
+    bitvector & set(size_t const i, bool const value = true)
+    {
+        at(i) = value;
+        return *this;
+    }
+
+    /*!\brief Sets all bits to `0`.
+     * \returns *this
+     *
+     * \details
+     *
+     * \attention
+     * In contrast to `clear()`, this method does not modify the size.
+     */
+    bitvector & reset() noexcept
+    {
+        std::ranges::fill(data, 0ULL);
+        return *this;
+    }
+
+    /*!\brief Sets the i'th bit to false.
+     * \param[in] i Index of the bit to reset.
+     * \throws std::out_of_range if you access an element behind the last.
+     * \returns *this
+     */
+    bitvector & reset(size_t const i)
+    {
+        set(i, false);
+        return *this;
+    }
+
+    //!\brief Flips all bits (binary NOT).
+    bitvector & flip() noexcept
+    {
+        detail::bitvector_not(data.data(), data.size());
+        clear_unused_bits_in_last_word();
+        return *this;
+    }
+
+    /*!\brief Flips the i'th bit (binary NOT).
+     * \param[in] i Index of the bit to flip.
+     * \throws std::out_of_range if you access an element behind the last.
+     * \returns *this
+     */
+    bitvector & flip(size_t const i)
+    {
+        at(i) ^= true;
+        return *this;
+    }
+    //!\}
+
+    /*!\name Element Access
+     * \{
+     */
+    //!\brief Checks if all bit are set; returns `true` if the bitvector is empty.
+    bool all() const noexcept { return count() == size(); }
+
+    //!\brief Checks if any bit is set.
+    bool any() const noexcept
+    {
+        return std::ranges::any_of(data, [](word_type const w) { return w != 0; });
+    }
+
+    //!\brief Checks if no bit is set.
+    bool none() const noexcept { return !any(); }
+
+    /*!\brief Returns the number of set bits.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    size_type count() const noexcept { return detail::bitvector_popcount(data.data(), data.size()); }
+
+    /*!\brief Returns the position of the first set bit or #npos if there is none.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in `size() / 64`.
+     */
+    size_type find_first() const noexcept { return find_from_word(0); }
+
+    /*!\brief Returns the position of the first set bit after `pos` or #npos if there is none.
+     * \param[in] pos The position after which to search.
+     *
+     * \details
+     *
+     * Iterate over all set bits like this:
+     *
+     * ```cpp
+     * for (size_t i = vec.find_first(); i != bio::ranges::bitvector::npos; i = vec.find_next(i))
+     *     // ...
+     * ```
+     *
+     * ### Complexity
+     *
+     * Linear in the distance to the next set bit divided by 64.
+     */
+    size_type find_next(size_type const pos) const noexcept
+    {
+        size_type const next = pos + 1;
+        if (next >= size())
+            return npos;
+
+        size_t const   w    = next / word_size;
+        word_type const rest = data[w] >> (next % word_size);
+        if (rest != 0)
+            return next + std::countr_zero(rest);
+
+        return find_from_word(w + 1);
+    }
+
+    /*!\brief Returns the i-th element.
+     * \param[in] i Index of the element to retrieve.
+     * \throws std::out_of_range If you access an element behind the last.
+     * \returns A reference to the value at position `i`.
+     */
+    reference at(size_t const i)
+    {
+        if (i >= size()) // [[unlikely]]
+            throw std::out_of_range{"Trying to access position " + std::to_string(i) +
+                                    " in a bio::ranges::bitvector of size " + std::to_string(size()) + "."};
+        return (*this)[i];
+    }
+
+    //!\copydoc at()
+    const_reference at(size_t const i) const
+    {
+        if (i >= size()) // [[unlikely]]
+            throw std::out_of_range{"Trying to access position " + std::to_string(i) +
+                                    " in a bio::ranges::bitvector of size " + std::to_string(size()) + "."};
+        return (*this)[i];
+    }
+
+    //!\copydoc at()
+    const_reference test(size_t const i) const { return at(i); }
+
+    /*!\brief Returns the i-th element.
+     * \param[in] i The element to retrieve.
+     * \returns A reference to the value at position `i`.
+     *
+     * \details
+     *
+     * Accessing an element behind the last causes undefined behaviour. In debug mode an assertion checks the size of
+     * the container.
+     */
+    reference operator[](size_t const i) noexcept
+    {
+        assert(i < size());
+        return {data[i / word_size], i % word_size};
+    }
+
+    //!\copydoc operator[]()
+    const_reference operator[](size_t const i) const noexcept
+    {
+        assert(i < size());
+        return (data[i / word_size] >> (i % word_size)) & 1ULL;
+    }
+
+    //!\brief Returns the first element.
+    reference front() noexcept
+    {
+        assert(size() > 0);
+        return (*this)[0];
+    }
+
+    //!\copydoc front()
+    const_reference front() const noexcept
+    {
+        assert(size() > 0);
+        return (*this)[0];
+    }
+
+    //!\brief Returns the last element.
+    reference back() noexcept
+    {
+        assert(size() > 0);
+        return (*this)[size() - 1];
+    }
+
+    //!\copydoc back()
+    const_reference back() const noexcept
+    {
+        assert(size() > 0);
+        return (*this)[size() - 1];
+    }
+
+    /*!\brief Direct access to the underlying words.
+     * \details
+     *
+     * Bits behind `size()` in the last word are always `0`; if you modify the words directly, you need to
+     * preserve this invariant.
+     */
+    data_type & raw_data() noexcept { return data; }
+
+    //!\copydoc raw_data()
+    data_type const & raw_data() const noexcept { return data; }
+    //!\}
+
+    /*!\name Capacity
+     * \{
+     */
+    //!\brief Checks whether the container is empty.
+    bool empty() const noexcept { return size() == 0; }
+
+    //!\brief Returns the number of elements in the container.
+    size_type size() const noexcept { return size_; }
+
+    //!\brief Returns the maximum number of elements the container is able to hold.
+    size_type max_size() const noexcept
+    {
+        // this protects against underflow in the multiplication
+        return std::max<size_type>(data.max_size(), data.max_size() * word_size);
+    }
+
+    //!\brief Returns the number of elements that the container is able to hold without reallocation.
+    size_type capacity() const noexcept { return data.capacity() * word_size; }
+
+    //!\brief Increase the capacity to a value that's greater or equal to `new_cap`.
+    void reserve(size_type const new_cap) { data.reserve(words_for(new_cap)); }
+
+    //!\brief Requests the removal of unused capacity.
+    void shrink_to_fit() { data.shrink_to_fit(); }
+    //!\}
+
+    /*!\name Modifiers
+     * \{
+     */
+    /*!\brief Removes all elements from the container.
+     *
+     * \details
+     *
+     * \attention
+     * In contrast to `reset()`, this method also sets the size to 0.
+     */
+    void clear() noexcept
+    {
+        data.clear();
+        size_ = 0;
+    }
+
+    //!\brief Inserts `value` before `pos` in the container.
+    iterator insert(const_iterator pos, value_type const value) { return insert(pos, 1, value); }
+
+    //!\brief Inserts `count` copies of `value` before position in the container.
+    iterator insert(const_iterator pos, size_type const count, value_type const value)
+    {
+        auto tmp = views::repeat_n(value, count);
+        return insert(pos, std::ranges::begin(tmp), std::ranges::end(tmp));
+    }
+
+    /*!\brief Inserts elements from range `[begin_it, end_it)` before `pos` in the container.
+     * \tparam begin_it_type Must model std::forward_iterator and the `value_type` must be constructible from
+     *                       the reference type of begin_it_type.
+     * \tparam end_it_type   Must model std::sentinel_for.
+     * \param[in] pos      Iterator before which the content will be inserted. `pos` may be the `end()` iterator.
+     * \param[in] begin_it Begin of range to construct/assign from.
+     * \param[in] end_it   End of range to construct/assign from.
+     * \returns Iterator pointing to the first element inserted, or `pos` if `begin_it==end_it`.
+     *
+     * \details
+     *
+     * The behaviour is undefined if `begin_it` and `end_it` are iterators into `*this`.
+     *
+     * ### Complexity
+     *
+     * Worst-case linear in `size()`.
+     */
+    template <std::forward_iterator begin_it_type, typename end_it_type>
+        //!\cond
+        requires(std::sentinel_for<end_it_type, begin_it_type> &&
+                   std::constructible_from<value_type, std::iter_reference_t<begin_it_type>>)
+    //!\endcond
+    iterator insert(const_iterator pos, begin_it_type begin_it, end_it_type end_it)
+    {
+        size_t const pos_as_num = std::ranges::distance(cbegin(), pos);
+        size_t const length     = std::ranges::distance(begin_it, end_it);
+
+        if (length == 0)
+            return begin() + pos_as_num; // nothing to insert
+
+        size_t const old_size = size();
+        resize(old_size + length);
+
+        for (size_t i = old_size; i > pos_as_num; --i)
+            (*this)[i - 1 + length] = (*this)[i - 1];
+
+        for (size_t i = pos_as_num; begin_it != end_it; ++i, ++begin_it)
+            (*this)[i] = static_cast<value_type>(*begin_it);
+
+        return begin() + pos_as_num;
+    }
+
+    //!\brief Inserts elements from initializer list before `pos` in the container.
+    iterator insert(const_iterator pos, std::initializer_list<value_type> const & ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    /*!\brief Removes specified elements from the container.
+     * \param[in] begin_it Begin of range to erase.
+     * \param[in] end_it   Behind the end of range to erase.
+     * \returns Iterator following the last element removed.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in `size()`.
+     */
+    iterator erase(const_iterator begin_it, const_iterator end_it)
+    {
+        size_t const first = std::ranges::distance(cbegin(), begin_it);
+        size_t const last  = std::ranges::distance(cbegin(), end_it);
+
+        if (first >= last) // [[unlikely]]
+            return begin() + last;
+
+        for (size_t i = last; i < size(); ++i)
+            (*this)[first + i - last] = (*this)[i];
+
+        resize(size() - (last - first));
+        return begin() + first;
+    }
+
+    //!\brief Removes the element at `pos`.
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    /*!\brief Appends the given element `value` to the end of the container.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Amortised constant.
+     */
+    void push_back(value_type const value)
+    {
+        if (size_ % word_size == 0)
+            data.push_back(0ULL);
+        data.back() |= static_cast<word_type>(value) << (size_ % word_size);
+        ++size_;
+    }
+
+    //!\brief Removes the last element of the container.
+    void pop_back()
+    {
+        assert(size() > 0);
+        resize(size() - 1);
+    }
+
+    /*!\brief Resizes the container to contain count elements.
+     * \param[in] count The new size.
+     * \param[in] value Append copies of `value` when resizing, default = `false`.
+     *
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the difference between `size()` and `count`, divided by 64.
+     */
+    void resize(size_type const count, value_type const value = false)
+    {
+        size_t const old_size = size_;
+        data.resize(words_for(count), value ? ~0ULL : 0ULL);
+
+        if (value && count > old_size && old_size % word_size != 0) // fill rest of previous last word
+            data[old_size / word_size] |= ~0ULL << (old_size % word_size);
+
+        size_ = count;
+        clear_unused_bits_in_last_word();
+    }
+
+    //!\brief Swap contents with another instance.
+    void swap(bitvector & rhs) noexcept
+    {
+        std::swap(size_, rhs.size_);
+        std::swap(data, rhs.data);
+    }
+
+    //!\overload
+    void swap(bitvector && rhs) noexcept { swap(rhs); }
+
+    //!\brief Swap contents with another instance.
+    friend void swap(bitvector & lhs, bitvector & rhs) noexcept { lhs.swap(rhs); }
+    //!\}
+
+    /*!\name Binary operators
+     * \{
+     */
+    /*!\brief Returns bitvector containing the result of binary AND on corresponding pairs of bits of `lhs` and `rhs`.
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     */
+    friend bitvector operator&(bitvector const & lhs, bitvector const & rhs)
+    {
+        bitvector tmp{lhs};
+        tmp &= rhs;
+        return tmp;
+    }
+
+    /*!\brief Returns bitvector containing the result of binary XOR on corresponding pairs of bits of `lhs` and `rhs`.
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     */
+    friend bitvector operator^(bitvector const & lhs, bitvector const & rhs)
+    {
+        bitvector tmp{lhs};
+        tmp ^= rhs;
+        return tmp;
+    }
+
+    /*!\brief Returns bitvector containing the result of binary OR on corresponding pairs of bits of `lhs` and `rhs`.
+     * \details
+     *
+     * \attention
+     * Both bitvectors must have the same size. In debug mode an assertion checks this constraint.
+     */
+    friend bitvector operator|(bitvector const & lhs, bitvector const & rhs)
+    {
+        bitvector tmp{lhs};
+        tmp |= rhs;
+        return tmp;
+    }
+    //!\}
+
+    //!\brief Comparison operators (compares size first, then the words).
+    friend auto operator<=>(bitvector const & lhs, bitvector const & rhs) noexcept = default;
+
+    //!\cond DEV
+    /*!\brief Serialisation support function.
+     * \tparam archive_t Type of `archive`; must satisfy bio::typename.
+     * \param[in] archive The archive being serialised from/to.
+     *
+     * \details
+     *
+     * \attention
+     * These functions are never called directly, see \ref howto_use_cereal for more details.
+     */
+    template <typename archive_t>
+    void serialize(archive_t & archive)
+    {
+        archive(size_);
+        archive(data);
+    }
+    //!\endcond
+
+private:
+    //!\brief Returns the position of the first set bit in the words starting from `w`.
+    size_type find_from_word(size_t w) const noexcept
+    {
+        for (; w < data.size(); ++w)
+            if (data[w] != 0)
+                return w * word_size + std::countr_zero(data[w]);
+        return npos;
+    }
+};
+
+} // namespace bio::ranges
+
+namespace std
+{
+
+/*!\brief Struct for hashing a bio::ranges::bitvector.
+ * \ingroup container
+ */
+template <>
+struct hash<bio::ranges::bitvector>
+{
+    //!\brief Compute the hash for a bio::ranges::bitvector.
+    size_t operator()(bio::ranges::bitvector const & arg) const noexcept
+    {
+        size_t result = arg.size();
+        for (uint64_t const word : arg.raw_data())
+            result ^= hash<uint64_t>{}(word) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+        return result;
+    }
+};
+
+} //namespace std
+
+#if __has_include(<fmt/format.h>)
+
+#    include <fmt/ranges.h>
+
+template <>
+struct fmt::formatter<bio::ranges::detail::bitvector_reference_proxy> : fmt::formatter<bool>
+{
+    constexpr auto format(bio::ranges::detail::bitvector_reference_proxy const a, auto & ctx) const
+    {
+        return fmt::formatter<bool>::format(static_cast<bool>(a), ctx);
+    }
+};
+
+template <>
+struct fmt::is_range<bio::ranges::bitvector, char> : std::false_type
+{};
+
+template <>
+struct fmt::formatter<bio::ranges::bitvector> : fmt::formatter<std::string>
+{
+    constexpr auto format(bio::ranges::bitvector const & s, auto & ctx) const
+    {
+        std::string str{"0b"};
+        str.reserve(2 + s.size() + s.size() / 4);
+        auto v = s | std::views::transform([](bool const bit) { return bit ? '1' : '0'; }) |
+                 bio::ranges::views::interleave(4, std::string_view{"'"}) | std::views::reverse;
+        std::ranges::copy(v, std::back_inserter(str));
+        return fmt::formatter<std::string>::format(str, ctx);
+    }
+};
+
+#endif
@@ -0,0 +1,523 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::chunked_sequences.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <initializer_list>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <bio/ranges/container/concept.hpp>
+#include <bio/ranges/detail/random_access_iterator.hpp>
+#include <bio/ranges/views/slice.hpp>
+
+namespace bio::ranges
+{
+
+/*!\brief Container that stores sequences in fixed-size chunks that are never relocated.
+ * \tparam underlying_container_type Type of the chunks. Must satisfy bio::ranges::detail::reservible_container.
+ * \ingroup container
+ *
+ * This is an append-only variant of bio::ranges::concatenated_sequences for very large collections (e.g.
+ * hundreds of millions of reads). Instead of a single concatenation, the sequences are stored in a list of chunks
+ * ("rope") each of which holds many complete sequences. When the current chunk is full, a new chunk is allocated
+ * and the existing data stays where it is. Compared to bio::ranges::concatenated_sequences this means:
+ *
+ * * No data is copied when the container grows and the peak memory usage is only one chunk above the actual data
+ * (instead of twice the data when a single buffer is reallocated).
+ * * Views on existing elements remain valid when elements are appended (except when the last element is
+ * extended with push_back_inner() or append_inner()).
+ * * Every element is still contiguous, i.e. `operator[]` returns the same type as for
+ * bio::ranges::concatenated_sequences (e.g. a std::span). Sequences longer than the chunk size get a chunk of
+ * their own.
+ * * There is no concat(), because the concatenation is not stored contiguously.
+ * * Element access is logarithmic in the number of chunks (and constant for elements in the last chunk).
+ * * Only appending and removing from the end is supported.
+ *
+ * The delimiters (one integer per sequence) are stored in a std::vector that grows as usual.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/container/chunked_sequences.cpp
+ *
+ * ### Thread safety
+ *
+ * This container provides no thread-safety beyond the promise given also by the STL that all
+ * calls to `const` member function are safe from multiple threads (as long as no thread calls
+ * a non-`const` member function at the same time).
+ */
+template <typename underlying_container_type>
+    //!\cond
+    requires detail::reservible_container<std::remove_reference_t<underlying_container_type>>
+//!\endcond
+class chunked_sequences
+{
+protected:
+    //!\privatesection
+    //!\brief The type of a chunk.
+    using chunk_type = std::decay_t<underlying_container_type>;
+
+public:
+    //!\publicsection
+    /*!\name Member types
+     * \{
+     */
+    //!\brief A views::slice that represents "one element", typically a std::span.
+    //!\hideinitializer
+    using value_type = decltype(std::declval<chunk_type &>() | views::slice(0, 1));
+
+    //!\brief A proxy of type views::slice that represents the range in a chunk.
+    //!\hideinitializer
+    using reference = value_type;
+
+    //!\brief An immutable proxy of type views::slice that represents the range in a chunk.
+    //!\hideinitializer
+    using const_reference = decltype(std::declval<chunk_type const &>() | views::slice(0, 1));
+
+    //!\brief The iterator type of this container (a random access iterator).
+    //!\hideinitializer
+    using iterator = detail::random_access_iterator<chunked_sequences>;
+
+    //!\brief The const iterator type of this container (a random access iterator).
+    //!\hideinitializer
+    using const_iterator = detail::random_access_iterator<chunked_sequences const>;
+
+    //!\brief A signed integer type (usually std::ptrdiff_t)
+    //!\hideinitializer
+    using difference_type = std::ranges::range_difference_t<chunk_type>;
+
+    //!\brief An unsigned integer type (usually std::size_t)
+    //!\hideinitializer
+    using size_type = std::ranges::range_size_t<chunk_type>;
+    //!\}
+
+    //!\brief The chunk size that is used if none is given (number of elements-of-elements).
+    static constexpr size_type default_chunk_size = size_type{1} << 22;
+
+protected:
+    //!\privatesection
+    //!\brief The chunks (a deque never moves its elements, which matters for containers with small buffers).
+    std::deque<chunk_type> data_chunks;
+    //!\brief For every chunk, the index of the first sequence stored in it.
+    std::vector<size_type> data_chunk_begins;
+    //!\brief Begin/end positions of the sequences in the (virtual) concatenation; has size of size() + 1.
+    std::vector<size_type> data_delimiters{0};
+    //!\brief The capacity of newly allocated chunks.
+    size_type              chunk_cap = default_chunk_size;
+
+    //!\brief Whether a range can be stored as an element of this container.
+    template <typename rng_t>
+    static constexpr bool is_compatible_with_value_type =
+      std::ranges::forward_range<rng_t> && std::ranges::sized_range<rng_t> &&
+      std::convertible_to<std::ranges::range_reference_t<rng_t>, std::ranges::range_value_t<chunk_type>>;
+
+    //!\brief The index of the chunk that holds the i-th sequence.
+    size_t chunk_of(size_type const i) const noexcept
+    {
+        assert(!data_chunk_begins.empty());
+        if (i >= data_chunk_begins.back()) // fast path for appending and for the most recent data
+            return data_chunk_begins.size() - 1;
+        return std::ranges::upper_bound(data_chunk_begins, i) - data_chunk_begins.begin() - 1;
+    }
+
+    //!\brief Start a new chunk that can hold at least `n` elements; its first sequence is `first_seq`.
+    void new_chunk(size_type const n, size_type const first_seq)
+    {
+        chunk_type chunk;
+        chunk.reserve(std::max(n, chunk_cap));
+        data_chunk_begins.reserve(data_chunk_begins.size() + 1);
+        data_chunks.push_back(std::move(chunk));
+        data_chunk_begins.push_back(first_seq);
+    }
+
+    //!\brief Make sure that a new sequence of length `n` fits into the last chunk.
+    void make_room(size_type const n)
+    {
+        if (data_chunks.empty() || data_chunks.back().capacity() - data_chunks.back().size() < n)
+            new_chunk(n, size());
+    }
+
+    //!\brief Make sure that the last sequence can be extended by `n` in the last chunk.
+    void make_room_inner(size_type const n)
+    {
+        assert(size() > 0);
+        chunk_type & last = data_chunks.back();
+        if (last.capacity() - last.size() >= n)
+            return;
+
+        size_type const back_len = data_delimiters[size()] - data_delimiters[size() - 1];
+        if (data_chunk_begins.back() == size() - 1) // the chunk only holds the last sequence; grow it geometrically
+        {
+            last.reserve(std::max({chunk_cap, back_len + n, last.capacity() * 2}));
+        }
+        else // move the last sequence to a new chunk (the only data that is ever copied)
+        {
+            chunk_type chunk;
+            chunk.reserve(std::max(chunk_cap, back_len + n));
+            chunk.insert(chunk.end(), last.end() - back_len, last.end());
+            data_chunk_begins.reserve(data_chunk_begins.size() + 1);
+            data_chunks.push_back(std::move(chunk));
+            data_chunks[data_chunks.size() - 2].resize(data_chunks[data_chunks.size() - 2].size() - back_len);
+            data_chunk_begins.push_back(size() - 1);
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    chunked_sequences()                                      = default; //!< Defaulted.
+    chunked_sequences(chunked_sequences const &)             = default; //!< Defaulted.
+    chunked_sequences(chunked_sequences &&)                  = default; //!< Defaulted.
+    chunked_sequences & operator=(chunked_sequences const &) = default; //!< Defaulted.
+    chunked_sequences & operator=(chunked_sequences &&)      = default; //!< Defaulted.
+    ~chunked_sequences()                                     = default; //!< Defaulted.
+
+    /*!\brief Construct with a custom chunk size.
+     * \param chunk_size The capacity of newly allocated chunks (number of elements-of-elements); must be > 0.
+     */
+    explicit chunked_sequences(size_type const chunk_size) : chunk_cap{chunk_size} { assert(chunk_size > 0); }
+
+    /*!\brief Construct from a range of sequences.
+     * \tparam rng_of_rng_type The type of range to be inserted; its reference type must be a sized forward range
+     *         whose elements are convertible to the elements of `underlying_container_type`.
+     * \param rng_of_rng The sequences to construct from.
+     * \param chunk_size The capacity of newly allocated chunks (number of elements-of-elements); must be > 0.
+     *
+     * ### Complexity
+     *
+     * Linear in the cumulative size of `rng_of_rng`.
+     */
+    template <std::ranges::input_range rng_of_rng_type>
+        //!\cond
+        requires is_compatible_with_value_type<std::ranges::range_reference_t<rng_of_rng_type>>
+    //!\endcond
+    explicit chunked_sequences(rng_of_rng_type && rng_of_rng, size_type const chunk_size = default_chunk_size) :
+      chunk_cap{chunk_size}
+    {
+        assert(chunk_size > 0);
+        if constexpr (std::ranges::sized_range<rng_of_rng_type>)
+            data_delimiters.reserve(std::ranges::size(rng_of_rng) + 1);
+
+        for (auto && val : rng_of_rng)
+            push_back(val);
+    }
+
+    /*!\brief Construct from `std::initializer_list`.
+     * \tparam value_type_t The type of range to be inserted.
+     * \param ilist an `std::initializer_list` of `value_type_t`.
+     */
+    template <std::ranges::forward_range value_type_t = value_type>
+        //!\cond
+        requires is_compatible_with_value_type<value_type_t>
+    //!\endcond
+    chunked_sequences(std::initializer_list<value_type_t> ilist)
+    {
+        data_delimiters.reserve(ilist.size() + 1);
+        for (auto && val : ilist)
+            push_back(val);
+    }
+    //!\}
+
+    /*!\name Iterators
+     * \{
+     */
+    //!\brief Returns an iterator to the first element of the container.
+    iterator       begin() noexcept { return iterator{*this}; }
+    //!\copydoc begin()
+    const_iterator begin() const noexcept { return const_iterator{*this}; }
+    //!\copydoc begin()
+    const_iterator cbegin() const noexcept { return const_iterator{*this}; }
+
+    //!\brief Returns an iterator to the element following the last element of the container.
+    iterator       end() noexcept { return iterator{*this, size()}; }
+    //!\copydoc end()
+    const_iterator end() const noexcept { return const_iterator{*this, size()}; }
+    //!\copydoc end()
+    const_iterator cend() const noexcept { return const_iterator{*this, size()}; }
+    //!\}
+
+    /*!\name Element access
+     * \{
+     */
+    /*!\brief Return the i-th element as a view.
+     * \param i The element to retrieve.
+     * \throws std::out_of_range If you access an element behind the last.
+     * \returns A view on the chunk that acts as a proxy for the element.
+     */
+    reference at(size_type const i)
+    {
+        if (i >= size())
+            throw std::out_of_range{"Trying to access element behind the last in chunked_sequences."};
+        return (*this)[i];
+    }
+
+    //!\copydoc at()
+    const_reference at(size_type const i) const
+    {
+        if (i >= size())
+            throw std::out_of_range{"Trying to access element behind the last in chunked_sequences."};
+        return (*this)[i];
+    }
+
+    /*!\brief Return the i-th element as a view.
+     * \param i The element to retrieve.
+     * \returns A view on the chunk that acts as a proxy for the element.
+     *
+     * Accessing an element behind the last causes undefined behaviour. In debug mode an assertion checks the size of
+     * the container.
+     *
+     * ### Complexity
+     *
+     * Logarithmic in the number of chunks; constant for elements in the last chunk.
+     *
+     * ### Exceptions
+     *
+     * No-throw guarantee.
+     */
+    reference operator[](size_type const i)
+    {
+        assert(i < size());
+        size_t const    c      = chunk_of(i);
+        size_type const offset = data_delimiters[data_chunk_begins[c]];
+        return data_chunks[c] | views::slice(data_delimiters[i] - offset, data_delimiters[i + 1] - offset);
+    }
+
+    //!\copydoc operator[]()
+    const_reference operator[](size_type const i) const
+    {
+        assert(i < size());
+        size_t const    c      = chunk_of(i);
+        size_type const offset = data_delimiters[data_chunk_begins[c]];
+        return data_chunks[c] | views::slice(data_delimiters[i] - offset, data_delimiters[i + 1] - offset);
+    }
+
+    //!\brief Return the first element as a view. Calling front on an empty container is undefined.
+    reference front()
+    {
+        assert(size() > 0);
+        return (*this)[0];
+    }
+
+    //!\copydoc front()
+    const_reference front() const
+    {
+        assert(size() > 0);
+        return (*this)[0];
+    }
+
+    //!\brief Return the last element as a view. Calling back on an empty container is undefined.
+    reference back()
+    {
+        assert(size() > 0);
+        return (*this)[size() - 1];
+    }
+
+    //!\copydoc back()
+    const_reference back() const
+    {
+        assert(size() > 0);
+        return (*this)[size() - 1];
+    }
+    //!\}
+
+    /*!\name Capacity
+     * \{
+     */
+    //!\brief Checks whether the container is empty.
+    bool empty() const noexcept { return size() == 0; }
+
+    //!\brief Returns the number of elements (sequences) in the container.
+    size_type size() const noexcept { return data_delimiters.size() - 1; }
+
+    //!\brief Returns the maximum number of elements the container is able to hold.
+    size_type max_size() const noexcept { return data_delimiters.max_size() - 1; }
+
+    //!\brief Returns the number of elements that the container has currently allocated space for.
+    size_type capacity() const noexcept { return data_delimiters.capacity() - 1; }
+
+    /*!\brief Increase the capacity() to a value that's greater or equal to new_cap.
+     * \param new_cap The new capacity.
+     *
+     * This only affects the storage of the delimiters; chunks are always allocated on demand.
+     */
+    void reserve(size_type const new_cap) { data_delimiters.reserve(new_cap + 1); }
+
+    //!\brief Returns the cumulative size of all elements in the container.
+    size_type concat_size() const noexcept { return data_delimiters.back(); }
+
+    /*!\brief Returns the cumulative capacity of all chunks.
+     *
+     * ### Complexity
+     *
+     * Linear in the number of chunks.
+     */
+    size_type concat_capacity() const noexcept
+    {
+        size_type ret = 0;
+        for (chunk_type const & c : data_chunks)
+            ret += c.capacity();
+        return ret;
+    }
+
+    //!\brief The capacity of newly allocated chunks.
+    size_type chunk_size() const noexcept { return chunk_cap; }
+
+    //!\brief The number of chunks currently allocated.
+    size_t chunk_count() const noexcept { return data_chunks.size(); }
+    //!\}
+
+    /*!\name Modifiers
+     * \{
+     */
+    /*!\brief Removes all elements from the container.
+     *
+     * The first chunk is kept (with its capacity), all other chunks are freed.
+     */
+    void clear() noexcept
+    {
+        if (!data_chunks.empty())
+        {
+            data_chunks.erase(data_chunks.begin() + 1, data_chunks.end());
+            data_chunks.front().clear();
+            data_chunk_begins.resize(1);
+        }
+        data_delimiters.clear();
+        data_delimiters.push_back(0);
+    }
+
+    /*!\brief Appends the given element value to the end of the container.
+     * \tparam rng_type The type of range to be inserted.
+     * \param value The value to append.
+     *
+     * No iterators or references are invalidated, except for the past-the-end iterator.
+     *
+     * ### Complexity
+     *
+     * Linear in the size of value.
+     *
+     * ### Exceptions
+     *
+     * Basic exception guarantee.
+     */
+    template <std::ranges::forward_range rng_type>
+        //!\cond
+        requires is_compatible_with_value_type<rng_type>
+    //!\endcond
+    void push_back(rng_type && value)
+    {
+        size_type const n = std::ranges::size(value);
+        make_room(n);
+        data_chunks.back().insert(data_chunks.back().end(), std::ranges::begin(value), std::ranges::end(value));
+        data_delimiters.push_back(data_delimiters.back() + n);
+    }
+
+    //!\brief Appends an empty element to the end of the container.
+    void push_back()
+    {
+        make_room(0);
+        data_delimiters.push_back(data_delimiters.back());
+    }
+
+    /*!\brief Appends the given element-of-element value to the last element.
+     * \param value The value to append.
+     *
+     * If the last chunk is full, the last element is moved to a new chunk and views on it are invalidated.
+     */
+    void push_back_inner(std::ranges::range_value_t<chunk_type> const value)
+    {
+        make_room_inner(1);
+        data_chunks.back().push_back(value);
+        ++data_delimiters.back();
+    }
+
+    /*!\brief Appends the given elements to the last element.
+     * \tparam rng_type The type of range to be inserted.
+     * \param value The value to append.
+     *
+     * If the last chunk is full, the last element is moved to a new chunk and views on it are invalidated.
+     */
+    template <std::ranges::forward_range rng_type>
+        //!\cond
+        requires is_compatible_with_value_type<rng_type>
+    //!\endcond
+    void append_inner(rng_type && value)
+    {
+        size_type const n = std::ranges::size(value);
+        make_room_inner(n);
+        data_chunks.back().insert(data_chunks.back().end(), std::ranges::begin(value), std::ranges::end(value));
+        data_delimiters.back() += n;
+    }
+
+    /*!\brief Removes the last element of the container.
+     *
+     * Calling pop_back on an empty container is undefined. A chunk that no longer holds any element is freed.
+     */
+    void pop_back()
+    {
+        assert(size() > 0);
+        size_type const back_length = data_delimiters[size()] - data_delimiters[size() - 1];
+        data_chunks.back().resize(data_chunks.back().size() - back_length);
+        data_delimiters.pop_back();
+
+        if (data_chunk_begins.size() > 1 && data_chunk_begins.back() == size())
+        {
+            data_chunks.pop_back();
+            data_chunk_begins.pop_back();
+        }
+    }
+
+    //!\brief Swap contents with another instance.
+    void swap(chunked_sequences & rhs) noexcept
+    {
+        std::swap(data_chunks, rhs.data_chunks);
+        std::swap(data_chunk_begins, rhs.data_chunk_begins);
+        std::swap(data_delimiters, rhs.data_delimiters);
+        std::swap(chunk_cap, rhs.chunk_cap);
+    }
+    //!\}
+
+    /*!\name Comparison operators
+     * \{
+     */
+    //!\brief Checks whether `*this` is equal to `rhs` (element-wise, independent of the chunking).
+    bool operator==(chunked_sequences const & rhs) const noexcept
+    {
+        if (data_delimiters != rhs.data_delimiters)
+            return false;
+        for (size_type i = 0; i < size(); ++i)
+            if (!std::ranges::equal((*this)[i], rhs[i]))
+                return false;
+        return true;
+    }
+    //!\}
+
+    /*!\cond DEV
+     * \brief Serialisation support function.
+     * \tparam archive_t Type of `archive`; must satisfy bio::typename.
+     * \param archive The archive being serialised from/to.
+     *
+     * \attention These functions are never called directly, see \ref howto_use_cereal for more details.
+     */
+    template <typename archive_t>
+    void serialize(archive_t & archive)
+    {
+        archive(data_chunks, data_chunk_begins, data_delimiters, chunk_cap);
+    }
+    //!\endcond
+};
+
+} // namespace bio::ranges
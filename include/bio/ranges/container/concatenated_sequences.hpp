@@ -19,7 +19,9 @@
 #include <utility>
 #include <vector>
 
+#include <bio/meta/instrumentation.hpp>
 #include <bio/ranges/container/concept.hpp>
+#include <bio/ranges/container/growth_policy.hpp>
 #include <bio/ranges/detail/random_access_iterator.hpp>
 #include <bio/ranges/views/repeat_n.hpp>
 #include <bio/ranges/views/slice.hpp>
@@ -58,6 +60,14 @@ namespace bio::ranges
  * * Modifying elements is limited to operations on elements of that element, i.e. you can change a character,
  * but you can't assign a new member sequence to an existing position.
  *
+ * ### Memory
+ *
+ * Both underlying containers grow according to a bio::ranges::growth_policy that can be changed via
+ * #set_growth_policy(). If the number of sequences and their total length are known (or can be estimated), call
+ * #reserve(size_type, size_type) to allocate both buffers once. Note that growing the concatenation
+ * temporarily requires memory for the old and the new buffer; if this is a problem (e.g. for hundreds of millions
+ * of reads), consider bio::ranges::chunked_sequences which never relocates existing sequences.
+ *
  * ### Example
  *
  * \include test/snippet/ranges/container/concatenated_sequences.cpp
@@ -91,6 +101,68 @@ protected:
     std::decay_t<underlying_container_type> data_values;
     //!\brief Where the delimiters are stored; begins with 0, has size of size() + 1.
     data_delimiters_type                    data_delimiters{0};
+    //!\brief How the capacities of #data_values and #data_delimiters are increased.
+    ranges::growth_policy                   growth{};
+
+    /*!\brief Make room for `n_values` more values and `n_delimiters` more delimiters (applies the growth policy).
+     * \details
+     *
+     * Is called before every operation that appends to the underlying containers, so that these never grow by their
+     * own (implementation-defined) strategy.
+     */
+    void grow(size_t const n_values, size_t const n_delimiters)
+    {
+        if (size_t const required = data_values.size() + n_values; required > data_values.capacity())
+            data_values.reserve(growth(data_values.capacity(), required));
+        if (size_t const required = data_delimiters.size() + n_delimiters; required > data_delimiters.capacity())
+            data_delimiters.reserve(growth(data_delimiters.capacity(), required));
+    }
+
+    /*!\brief Records reallocations of the member containers in its lifetime (see bio::meta::instrumentation_counter).
+     * \details Does nothing unless #BIOCPP_INSTRUMENTATION is set.
+     */
+    class reallocation_probe
+    {
+    private:
+        //!\brief The container being observed.
+        concatenated_sequences const * host           = nullptr;
+        //!\brief The capacity of the values at construction.
+        size_t                         values_cap     = 0;
+        //!\brief The capacity of the delimiters at construction.
+        size_t                         delimiters_cap = 0;
+        //!\brief The cycle counter at construction.
+        uint64_t                       start          = 0;
+
+    public:
+        //!\brief Remember the current capacities of `_host`.
+        explicit reallocation_probe([[maybe_unused]] concatenated_sequences const & _host) noexcept
+        {
+            if constexpr (meta::instrumentation_enabled)
+            {
+                host           = &_host;
+                values_cap     = _host.data_values.capacity();
+                delimiters_cap = _host.data_delimiters.capacity();
+                start          = meta::instrumentation_timings_enabled ? meta::detail::instrumentation_ticks() : 0;
+            }
+        }
+
+        //!\brief Record the number of member containers whose capacity has changed.
+        ~reallocation_probe() noexcept
+        {
+            if constexpr (meta::instrumentation_enabled)
+            {
+                uint64_t const n = (host->data_values.capacity() != values_cap) +
+                                   (host->data_delimiters.capacity() != delimiters_cap);
+                if (n > 0)
+                {
+                    constexpr auto counter = meta::instrumentation_counter::concatenated_sequences_reallocations;
+                    meta::detail::instrumentation_count(counter, n);
+                    if constexpr (meta::instrumentation_timings_enabled)
+                        meta::detail::instrumentation_add_cycles(counter, meta::detail::instrumentation_ticks() - start);
+                }
+            }
+        }
+    };
 
 public:
     //!\publicsection
@@ -209,11 +281,14 @@ public:
       requires range_value_t_is_compatible_with_value_type<rng_of_rng_type>
     //!\endcond
     {
+        [[maybe_unused]] reallocation_probe probe{*this};
+
         if constexpr (std::ranges::sized_range<rng_of_rng_type>)
             data_delimiters.reserve(std::ranges::size(rng_of_rng) + 1);
 
         for (auto && val : rng_of_rng)
         {
+            grow(val.size(), 1);
             data_values.insert(data_values.end(), val.begin(), val.end());
             data_delimiters.push_back(data_delimiters.back() + val.size());
         }
@@ -333,6 +408,7 @@ public:
     //!\endcond
     {
         concatenated_sequences rhs{std::forward<rng_of_rng_type>(rng_of_rng)};
+        rhs.growth = growth;
         swap(rhs);
     }
 
@@ -356,6 +432,7 @@ public:
     //!\endcond
     {
         concatenated_sequences rhs{count, value};
+        rhs.growth = growth;
         swap(rhs);
     }
 
@@ -382,6 +459,7 @@ public:
     //!\endcond
     {
         concatenated_sequences rhs{begin_it, end_it};
+        rhs.growth = growth;
         swap(rhs);
     }
 
@@ -686,7 +764,64 @@ public:
      *
      * Strong exception guarantee (no data is modified in case an exception is thrown).
      */
-    void reserve(size_type const new_cap) { data_delimiters.reserve(new_cap + 1); }
+    void reserve(size_type const new_cap)
+    {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        data_delimiters.reserve(new_cap + 1);
+    }
+
+    /*!\brief Increase the capacity() and the concat_capacity() at once.
+     * \param new_cap The new capacity (number of sequences).
+     * \param new_concat_cap The new concat capacity (total length of all sequences).
+     * \throws std::length_error If new_cap > max_size().
+     * \throws std::exception Any exception thrown by `Allocator::allocate()` (typically `std::bad_alloc`).
+     *
+     * Equivalent to calling `reserve(new_cap)` and `concat_reserve(new_concat_cap)`. This is the recommended way
+     * of preparing the container for a known (or estimated) amount of data, e.g. from the size of an index or of
+     * a file, because it avoids all reallocations while the container is filled.
+     *
+     * ### Complexity
+     *
+     * At most linear in the size() and concat_size() of the container.
+     *
+     * ### Exceptions
+     *
+     * Strong exception guarantee (no data is modified in case an exception is thrown).
+     */
+    void reserve(size_type const new_cap, size_type const new_concat_cap)
+    {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        data_delimiters.reserve(new_cap + 1);
+        data_values.reserve(new_concat_cap);
+    }
+
+    /*!\brief Returns the policy according to which the underlying containers grow.
+     *
+     * ### Complexity
+     *
+     * Constant.
+     *
+     * ### Exceptions
+     *
+     * No-throw guarantee.
+     */
+    ranges::growth_policy get_growth_policy() const noexcept { return growth; }
+
+    /*!\brief Sets the policy according to which the underlying containers grow.
+     * \param policy The new policy.
+     *
+     * The policy is applied whenever an operation needs more capacity than is available; it does not change
+     * the current capacity. Assigning new content via assign() does not change the policy.
+     *
+     * ### Complexity
+     *
+     * Constant.
+     *
+     * ### Exceptions
+     *
+     * No-throw guarantee.
+     */
+    void set_growth_policy(ranges::growth_policy const policy) noexcept { growth = policy; }
 
     /*!\brief Requests the removal of unused capacity.
      *
@@ -709,6 +844,7 @@ public:
      */
     void shrink_to_fit()
     {
+        [[maybe_unused]] reallocation_probe probe{*this};
         data_values.shrink_to_fit();
         data_delimiters.shrink_to_fit();
     }
@@ -761,7 +897,11 @@ public:
      *
      * Strong exception guarantee (no data is modified in case an exception is thrown).
      */
-    void concat_reserve(size_type const new_cap) { data_values.reserve(new_cap); }
+    void concat_reserve(size_type const new_cap)
+    {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        data_values.reserve(new_cap);
+    }
     //!\}
 
     /*!\name Modifiers
@@ -853,6 +993,8 @@ public:
         if (count == 0)
             return begin() + pos_as_num;
 
+        [[maybe_unused]] reallocation_probe probe{*this};
+
         /* TODO implement views::flat_repeat_n that is like
          *  views::repeat_n(value, count) | views::join | ranges::views::bounded;
          * but preserves random access and size.
@@ -868,7 +1010,7 @@ public:
         else
             value_len = std::distance(std::ranges::begin(value), std::ranges::end(value));
 
-        data_values.reserve(data_values.size() + count * value_len);
+        grow(count * value_len, count);
         auto placeholder =
           views::repeat_n(std::ranges::range_value_t<rng_type>{}, count * value_len) | std::views::common;
         // insert placeholder so the tail is moved once:
@@ -882,7 +1024,6 @@ public:
             for (auto && v : value)
                 data_values[i++] = v;
 
-        data_delimiters.reserve(data_values.size() + count);
         data_delimiters.insert(data_delimiters.begin() + pos_as_num, count, *(data_delimiters.begin() + pos_as_num));
 
         // adapt delimiters of inserted
@@ -934,12 +1075,14 @@ public:
         if (last - first == 0)
             return begin() + pos_as_num;
 
+        [[maybe_unused]] reallocation_probe probe{*this};
+
         auto const ilist =
           std::ranges::subrange<begin_iterator_type, end_iterator_type>(first,
                                                                         last,
                                                                         std::ranges::distance(first, last));
 
-        data_delimiters.reserve(data_values.size() + ilist.size());
+        grow(0, ilist.size());
         data_delimiters.insert(data_delimiters.begin() + pos_as_num,
                                ilist.size(),
                                *(data_delimiters.begin() + pos_as_num));
@@ -953,6 +1096,7 @@ public:
         }
 
         // adapt values of inserted region
+        grow(full_len, 0);
         auto placeholder = views::repeat_n(std::ranges::range_value_t<value_type>{}, full_len) | std::views::common;
         // insert placeholder so the tail is moved only once:
         data_values.insert(data_values.begin() + data_delimiters[pos_as_num],
@@ -1091,6 +1235,8 @@ public:
       requires is_compatible_with_value_type<rng_type>
     //!\endcond
     {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        grow(std::ranges::size(value), 1);
         data_values.insert(data_values.end(), std::ranges::begin(value), std::ranges::end(value));
         data_delimiters.push_back(data_delimiters.back() + std::ranges::size(value));
     }
@@ -1112,7 +1258,12 @@ public:
      * an exception is thrown.
      *
      */
-    void push_back() { data_delimiters.push_back(data_delimiters.back()); }
+    void push_back()
+    {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        grow(0, 1);
+        data_delimiters.push_back(data_delimiters.back());
+    }
 
     /*!\brief Appends the given element-of-element value to the end of the underlying container.
      * \param value The value to append.
@@ -1135,6 +1286,8 @@ public:
      */
     void push_back_inner(std::ranges::range_value_t<underlying_container_type> const value)
     {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        grow(1, 0);
         data_values.push_back(value);
         ++data_delimiters.back();
     }
@@ -1165,6 +1318,8 @@ public:
       requires is_compatible_with_value_type<rng_type>
     //!\endcond
     {
+        [[maybe_unused]] reallocation_probe probe{*this};
+        grow(std::ranges::size(value), 0);
         data_values.insert(data_values.end(), std::ranges::begin(value), std::ranges::end(value));
         data_delimiters.back() += std::ranges::size(value);
     }
@@ -1222,6 +1377,9 @@ public:
     void resize(size_type const count)
     {
         assert(count < max_size());
+        [[maybe_unused]] reallocation_probe probe{*this};
+        if (count > size())
+            grow(0, count - size());
         data_delimiters.resize(count + 1, data_delimiters.back());
         data_values.resize(data_delimiters.back());
     }
@@ -1261,6 +1419,7 @@ public:
     {
         std::swap(data_values, rhs.data_values);
         std::swap(data_delimiters, rhs.data_delimiters);
+        std::swap(growth, rhs.growth);
     }
 
     //!\copydoc swap()
@@ -1268,6 +1427,7 @@ public:
     {
         std::swap(data_values, rhs.data_values);
         std::swap(data_delimiters, rhs.data_delimiters);
+        std::swap(growth, rhs.growth);
     }
     //!\}
 
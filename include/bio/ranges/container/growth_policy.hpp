@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::growth_policy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <bio/core.hpp>
+
+namespace bio::ranges
+{
+
+/*!\brief Describes how a container's capacity is increased when it runs out of space.
+ * \ingroup container
+ * \details
+ *
+ * When an append operation requires `required` elements of capacity and only `capacity` are available, the new
+ * capacity is `max(required, min(capacity * factor, capacity + max_step))` (the second term of the `min` is ignored
+ * if #max_step is `0`).
+ *
+ * The default corresponds to the doubling that std::vector performs. A smaller #factor reduces the amount of memory
+ * that is reserved but not used; a #max_step turns exponential growth into linear growth beyond a certain size.
+ * Note that both increase the number of reallocations.
+ *
+ * ### Example
+ *
+ * ```cpp
+ * bio::ranges::concatenated_sequences<std::string> seqs;
+ * seqs.set_growth_policy({.factor = 1.5, .max_step = 1ull << 30});
+ * ```
+ */
+struct growth_policy
+{
+    //!\brief The current capacity is multiplied by this (values smaller than `1` are treated as `1`).
+    double factor   = 2.0;
+    //!\brief The maximum number of elements added to the capacity in one step (`0` means no limit).
+    size_t max_step = 0;
+
+    /*!\brief Compute the new capacity.
+     * \param[in] capacity The current capacity.
+     * \param[in] required The capacity that is at least required.
+     * \returns The new capacity (never smaller than `required`).
+     */
+    constexpr size_t operator()(size_t const capacity, size_t const required) const noexcept
+    {
+        size_t grown = factor > 1.0 ? static_cast<size_t>(static_cast<double>(capacity) * factor) : capacity;
+        if (max_step != 0)
+            grown = std::min(grown, capacity + max_step);
+        return std::max(grown, required);
+    }
+
+    //!\brief Defaulted.
+    friend constexpr bool operator==(growth_policy const &, growth_policy const &) = default;
+};
+
+} // namespace bio::ranges
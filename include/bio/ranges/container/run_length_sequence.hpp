@@ -0,0 +1,197 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::run_length_sequence.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <ranges>
+#include <vector>
+
+#include <bio/ranges/run_starts.hpp>
+
+namespace bio::ranges
+{
+
+/*!\brief A run-length encoded sequence with rank-based mapping to the original positions.
+ * \ingroup container
+ * \tparam value_t The element type, e.g. a bio::alphabet::nucleotide_alphabet; must model std::regular.
+ * \details
+ *
+ * Every run of equal elements is stored as its element and the (exclusive) original position of its end.
+ * #letters() is the homopolymer-compressed sequence, and original positions are mapped to runs (#run_of(),
+ * a binary search over the run ends) and back (#run_begin(), #run_end()). Accessing an element by its original
+ * position costs a binary search, too.
+ *
+ * Construction from a sized random-access range locates all runs at once with bio::ranges::run_starts,
+ * i.e. with SIMD instructions for alphabets and with packed-word comparisons for bio::ranges::bitcompressed_vector.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/container/run_length_sequence.cpp
+ */
+template <std::regular value_t>
+class run_length_sequence
+{
+private:
+    //!\brief The element of every run.
+    std::vector<value_t> run_letters;
+    //!\brief The original position after the end of every run (ascending).
+    std::vector<size_t>  run_ends;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    run_length_sequence()                                        = default; //!< Defaulted.
+    run_length_sequence(run_length_sequence const &)             = default; //!< Defaulted.
+    run_length_sequence(run_length_sequence &&)                  = default; //!< Defaulted.
+    run_length_sequence & operator=(run_length_sequence const &) = default; //!< Defaulted.
+    run_length_sequence & operator=(run_length_sequence &&)      = default; //!< Defaulted.
+    ~run_length_sequence()                                       = default; //!< Defaulted.
+
+    /*!\brief Encode a range.
+     * \param[in] range The elements.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the size of the range.
+     */
+    template <std::ranges::input_range rng_t>
+        //!\cond
+        requires(!std::same_as<std::remove_cvref_t<rng_t>, run_length_sequence> &&
+                 std::convertible_to<std::ranges::range_reference_t<rng_t>, value_t>)
+    //!\endcond
+    explicit run_length_sequence(rng_t && range)
+    {
+        if constexpr (std::ranges::sized_range<rng_t> && std::ranges::random_access_range<rng_t> &&
+                      std::same_as<std::ranges::range_value_t<rng_t>, value_t>)
+        {
+            std::vector<size_t> const starts = run_starts(range);
+            size_t const              size   = std::ranges::size(range);
+            auto const                it     = std::ranges::begin(range);
+
+            run_letters.resize(starts.size());
+            run_ends.resize(starts.size());
+            for (size_t r = 0; r < starts.size(); ++r)
+            {
+                run_letters[r] = it[starts[r]];
+                run_ends[r]    = r + 1 < starts.size() ? starts[r + 1] : size;
+            }
+        }
+        else
+        {
+            for (auto && v : range)
+                push_back(v);
+        }
+    }
+    //!\}
+
+    //!\brief The length of the original sequence.
+    size_t size() const noexcept { return run_ends.empty() ? 0 : run_ends.back(); }
+
+    //!\brief Whether the sequence is empty.
+    bool empty() const noexcept { return run_ends.empty(); }
+
+    //!\brief The number of runs.
+    size_t run_count() const noexcept { return run_ends.size(); }
+
+    /*!\brief The index of the run that contains an original position (rank).
+     * \details
+     *
+     * ### Complexity
+     *
+     * Logarithmic in the number of runs.
+     */
+    size_t run_of(size_t const position) const noexcept
+    {
+        assert(position < size());
+        return std::ranges::upper_bound(run_ends, position) - run_ends.begin();
+    }
+
+    //!\brief The original position of the first element of a run (select).
+    size_t run_begin(size_t const run) const noexcept
+    {
+        assert(run < run_count());
+        return run == 0 ? 0 : run_ends[run - 1];
+    }
+
+    //!\brief The original position after the last element of a run.
+    size_t run_end(size_t const run) const noexcept
+    {
+        assert(run < run_count());
+        return run_ends[run];
+    }
+
+    //!\brief The number of elements in a run.
+    size_t run_length(size_t const run) const noexcept { return run_end(run) - run_begin(run); }
+
+    //!\brief The element of a run.
+    value_t run_letter(size_t const run) const noexcept
+    {
+        assert(run < run_count());
+        return run_letters[run];
+    }
+
+    //!\brief The element at an original position (see #run_of()).
+    value_t operator[](size_t const position) const noexcept { return run_letters[run_of(position)]; }
+
+    //!\brief The element of every run, i.e. the homopolymer-compressed sequence.
+    std::vector<value_t> const & letters() const noexcept { return run_letters; }
+
+    //!\brief The original position after the end of every run.
+    std::vector<size_t> const & ends() const noexcept { return run_ends; }
+
+    /*!\brief Append elements.
+     * \param[in] value The element.
+     * \param[in] count The number of times it is appended.
+     * \details
+     *
+     * The last run is extended if it has the same element.
+     */
+    void push_back(value_t const & value, size_t const count = 1)
+    {
+        if (count == 0)
+            return;
+
+        if (!run_letters.empty() && run_letters.back() == value)
+        {
+            run_ends.back() += count;
+        }
+        else
+        {
+            run_letters.push_back(value);
+            run_ends.push_back(size() + count);
+        }
+    }
+
+    //!\brief Remove all elements.
+    void clear() noexcept
+    {
+        run_letters.clear();
+        run_ends.clear();
+    }
+
+    //!\brief Defaulted.
+    friend bool operator==(run_length_sequence const &, run_length_sequence const &) = default;
+};
+
+/*!\name Deduction guides
+ * \relates bio::ranges::run_length_sequence
+ * \{
+ */
+//!\brief Deduce the element type from a range.
+template <std::ranges::input_range rng_t>
+run_length_sequence(rng_t &&) -> run_length_sequence<std::ranges::range_value_t<rng_t>>;
+//!\}
+
+} // namespace bio::ranges
@@ -0,0 +1,272 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::char_set and bio::ranges::find_any_of.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+namespace bio::ranges
+{
+
+// ============================================================================
+//  char_set
+// ============================================================================
+
+/*!\brief A small, constexpr set of characters that can be used as a predicate.
+ * \ingroup range
+ *
+ * \details
+ *
+ * Membership is stored as a 256-bit table, so testing a character is a single lookup. Additionally, the first
+ * #max_vectorised_size distinct characters are stored in insertion order; they are used by bio::ranges::find_any_of
+ * to compare 16 or 32 characters of input at once.
+ *
+ * Objects of this type are implicitly constructible from a single `char`, a string literal and std::string_view:
+ *
+ * ```cpp
+ * bio::ranges::char_set line_end{"\r\n"};
+ * line_end('\n'); // true
+ * ```
+ */
+class char_set
+{
+public:
+    //!\brief The number of distinct characters up to which the vectorised search is used.
+    static constexpr size_t max_vectorised_size = 16;
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    constexpr char_set() noexcept                             = default; //!< Defaulted.
+    constexpr char_set(char_set const &) noexcept             = default; //!< Defaulted.
+    constexpr char_set(char_set &&) noexcept                  = default; //!< Defaulted.
+    constexpr char_set & operator=(char_set const &) noexcept = default; //!< Defaulted.
+    constexpr char_set & operator=(char_set &&) noexcept      = default; //!< Defaulted.
+    ~char_set() noexcept                                      = default; //!< Defaulted.
+
+    //!\brief Construct from a single character.
+    constexpr char_set(char const c) noexcept { insert(c); }
+
+    //!\brief Construct from a sequence of characters (duplicates are ignored).
+    constexpr char_set(std::string_view const chars) noexcept
+    {
+        for (char const c : chars)
+            insert(c);
+    }
+
+    //!\brief Construct from a string literal (the terminating null character is not part of the set).
+    template <size_t N>
+    constexpr char_set(char const (&chars)[N]) noexcept : char_set{std::string_view{chars, N - 1}}
+    {}
+    //!\}
+
+    //!\brief Whether the character is part of the set.
+    constexpr bool operator()(char const c) const noexcept
+    {
+        uint8_t const r = static_cast<uint8_t>(c);
+        return (table[r / 64] >> (r % 64)) & 1ull;
+    }
+
+    //!\brief The number of distinct characters in the set.
+    constexpr size_t size() const noexcept { return count; }
+
+    //!\brief Whether the set is empty.
+    constexpr bool empty() const noexcept { return count == 0; }
+
+    /*!\brief The characters in the set (in insertion order).
+     * \details
+     *
+     * Only the first #max_vectorised_size characters are stored in this form, i.e. this is complete only if
+     * `size() <= max_vectorised_size`.
+     */
+    constexpr std::string_view chars() const noexcept
+    {
+        return std::string_view{list.data(), std::min(count, max_vectorised_size)};
+    }
+
+    //!\brief Two sets are equal if they contain the same characters.
+    constexpr friend bool operator==(char_set const & lhs, char_set const & rhs) noexcept
+    {
+        return lhs.table == rhs.table;
+    }
+
+private:
+    //!\brief Add a character to the set.
+    constexpr void insert(char const c) noexcept
+    {
+        if ((*this)(c))
+            return;
+
+        uint8_t const r = static_cast<uint8_t>(c);
+        table[r / 64] |= 1ull << (r % 64);
+        if (count < max_vectorised_size)
+            list[count] = c;
+        ++count;
+    }
+
+    //!\brief Membership bit for every possible character.
+    std::array<uint64_t, 4>               table{};
+    //!\brief The first #max_vectorised_size characters.
+    std::array<char, max_vectorised_size> list{};
+    //!\brief The number of distinct characters.
+    size_t                                count = 0;
+};
+
+} // namespace bio::ranges
+
+namespace bio::ranges::detail
+{
+
+/*!\brief Returns a pointer to the first character in `[b, e)` that is part of `set` (or `e` if there is none).
+ * \ingroup range
+ * \details
+ *
+ * A single character is searched for with std::memchr. Up to bio::ranges::char_set::max_vectorised_size
+ * characters are searched for by comparing blocks of 32 (AVX2) or 16 (SSE2) characters against every character in
+ * the set and extracting the position of the first hit from the movemask. Larger sets and the remainder of the
+ * input are handled by the table lookup.
+ */
+inline char const * find_any_of_contiguous(char const * b, char const * const e, char_set const & set) noexcept
+{
+    if (set.empty() || b == e)
+        return e;
+
+    if (set.size() == 1)
+    {
+        void const * const p = std::memchr(b, set.chars()[0], e - b);
+        return p == nullptr ? e : static_cast<char const *>(p);
+    }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (set.size() <= char_set::max_vectorised_size)
+    {
+        std::string_view const chars = set.chars();
+        size_t const           n     = chars.size();
+
+#    if defined(__AVX2__)
+        __m256i needles[char_set::max_vectorised_size];
+        for (size_t i = 0; i < n; ++i)
+            needles[i] = _mm256_set1_epi8(chars[i]);
+
+        for (; e - b >= 32; b += 32)
+        {
+            __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b));
+            __m256i       hits  = _mm256_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < n; ++i)
+                hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[i]));
+
+            if (uint32_t const mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)); mask != 0)
+                return b + std::countr_zero(mask);
+        }
+#    else
+        __m128i needles[char_set::max_vectorised_size];
+        for (size_t i = 0; i < n; ++i)
+            needles[i] = _mm_set1_epi8(chars[i]);
+
+        for (; e - b >= 16; b += 16)
+        {
+            __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(b));
+            __m128i       hits  = _mm_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < n; ++i)
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[i]));
+
+            if (uint32_t const mask = static_cast<uint32_t>(_mm_movemask_epi8(hits)); mask != 0)
+                return b + std::countr_zero(mask);
+        }
+#    endif
+    }
+#endif
+
+    for (; b != e; ++b)
+        if (set(*b))
+            return b;
+
+    return e;
+}
+
+} // namespace bio::ranges::detail
+
+namespace bio::ranges
+{
+
+// ============================================================================
+//  find_any_of
+// ============================================================================
+
+/*!\brief Returns an iterator to the first character in the range that is part of the given set.
+ * \tparam rng_t      Type of the range; must model std::ranges::input_range over `char`.
+ * \param[in] range   The range being searched.
+ * \param[in] set     The characters to search for; can also be given as a `char` or a string literal.
+ * \returns An iterator to the first matching character, or the end of the range if there is none.
+ * std::ranges::dangling is returned for non-borrowed temporaries.
+ * \ingroup range
+ *
+ * \details
+ *
+ * This is the equivalent of `std::ranges::find_if(range, set)`, but for contiguous, sized ranges of `char` (like
+ * std::string, std::string_view and std::span<char const>), the search is performed in bulk:
+ * a single character is searched with std::memchr; sets of up to bio::ranges::char_set::max_vectorised_size
+ * characters are searched with SSE2/AVX2 compare-and-movemask operations if the code is compiled with support for
+ * those instructions. This makes it suitable as the building block for locating line breaks or field delimiters in
+ * file parsers.
+ *
+ * ### Complexity
+ *
+ * Linear in the distance to the first match.
+ *
+ * ### Exceptions
+ *
+ * Throws if iterating over the range throws.
+ *
+ * ### Example
+ *
+ * ```cpp
+ * std::string_view buffer{"@read1\nACGT\n+\nIIII\n"};
+ * auto it = bio::ranges::find_any_of(buffer, "\r\n"); // points to the first '\n'
+ * ```
+ */
+template <std::ranges::input_range rng_t>
+    //!\cond
+    requires std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<rng_t>>, char>
+//!\endcond
+constexpr std::ranges::borrowed_iterator_t<rng_t> find_any_of(rng_t && range, char_set const & set)
+{
+    if constexpr (std::ranges::contiguous_range<rng_t> && std::ranges::sized_range<rng_t>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            char const * const b = std::ranges::data(range);
+            char const * const e = b + std::ranges::size(range);
+            auto const         d = detail::find_any_of_contiguous(b, e, set) - b;
+
+            if constexpr (std::ranges::borrowed_range<rng_t>)
+                return std::ranges::begin(range) + d;
+            else
+                return std::ranges::dangling{};
+        }
+    }
+
+    return std::ranges::find_if(std::forward<rng_t>(range), set);
+}
+
+} // namespace bio::ranges
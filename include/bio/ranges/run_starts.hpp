@@ -0,0 +1,240 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::ranges::run_starts.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+#include <bio/alphabet/concept.hpp>
+#include <bio/meta/type_traits/template_inspection.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+
+namespace bio::ranges::detail
+{
+
+/*!\brief Append the positions `offset + i - 1` for which `ranks[i] != ranks[i - 1]` (`1 <= i < n`).
+ * \ingroup range
+ * \details
+ *
+ * `ranks[0]` is the rank preceding the block, i.e. `ranks[i]` is the rank at position `offset + i - 1`.
+ *
+ * Compares blocks of 32 (AVX2) or 16 (SSE2) ranks with the same block shifted by one position and extracts the
+ * differing positions from the inverted movemask; the remainder is compared one by one.
+ */
+inline void run_starts_bytes(uint8_t const * const ranks,
+                             size_t const          n,
+                             size_t const          offset,
+                             std::vector<size_t> & out)
+{
+    size_t i = 1;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i const cur  = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ranks + i));
+        __m256i const prev = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(ranks + i - 1));
+        for (uint32_t m = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(cur, prev))); m != 0;
+             m &= m - 1)
+            out.push_back(offset + i - 1 + std::countr_zero(m));
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i const cur  = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ranks + i));
+        __m128i const prev = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ranks + i - 1));
+        for (uint32_t m = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(cur, prev))) & 0xFFFFu; m != 0;
+             m &= m - 1)
+            out.push_back(offset + i - 1 + std::countr_zero(m));
+    }
+#endif
+
+    for (; i < n; ++i)
+        if (ranks[i] != ranks[i - 1])
+            out.push_back(offset + i - 1);
+}
+
+/*!\brief Append the run starts of a bio::ranges::bitcompressed_vector by comparing its packed words.
+ * \ingroup range
+ * \details
+ *
+ * Every word is XOR-ed with itself shifted by one letter (the vacated letter is the last one of the previous word),
+ * the bits of every letter are OR-ed into its lowest bit and the set bits are extracted with std::countr_zero.
+ * This mirrors the storage layout of bio::ranges::bitcompressed_vector: letter `i` occupies the bits
+ * `[(i % letters_per_word) * bits_per_letter, …)` of word `i / letters_per_word`.
+ */
+template <typename alph_t>
+void run_starts_packed(bitcompressed_vector<alph_t> const & vec, std::vector<size_t> & out)
+{
+    constexpr size_t   bits             = std::bit_width(alphabet::size<alph_t>);
+    constexpr size_t   letters_per_word = 64 / bits;
+    constexpr uint64_t letter_mask      = (1ull << bits) - 1ull;
+    constexpr uint64_t low_bits         = []()
+    {
+        uint64_t ret = 0;
+        for (size_t i = 0; i < letters_per_word; ++i)
+            ret |= 1ull << (i * bits);
+        return ret;
+    }();
+
+    std::vector<uint64_t> const & words = vec.raw_data();
+    size_t const                  n     = vec.size();
+    uint64_t                      prev  = words[0] & letter_mask; // the first letter never differs
+    for (size_t w = 0; w * letters_per_word < n; ++w)
+    {
+        uint64_t const word = words[w];
+        uint64_t const diff = word ^ ((word << bits) | prev);
+        uint64_t       bit  = 0;
+        for (size_t b = 0; b < bits; ++b)
+            bit |= diff >> b;
+        bit &= low_bits;
+
+        if (size_t const rest = n - w * letters_per_word; rest < letters_per_word)
+            bit &= (1ull << (rest * bits)) - 1ull;
+
+        for (; bit != 0; bit &= bit - 1)
+            out.push_back(w * letters_per_word + std::countr_zero(bit) / bits);
+
+        prev = (word >> ((letters_per_word - 1) * bits)) & letter_mask;
+    }
+}
+
+} // namespace bio::ranges::detail
+
+namespace bio::ranges
+{
+
+/*!\brief Returns the positions at which a new run of equal elements starts.
+ * \ingroup range
+ * \tparam rng_t    Type of the range; must model std::ranges::input_range over a std::equality_comparable type.
+ * \param[in] range The range.
+ * \returns The (ascending) positions `i` with `i == 0` or `range[i] != range[i - 1]`; empty for an empty range.
+ *
+ * \details
+ *
+ * This is the eager, bulk counterpart of bio::views::rle: run `r` spans the positions `[starts[r], starts[r + 1])`.
+ *
+ * Ranges over bio::alphabet::semialphabet types with at most 256 letters are converted to ranks in blocks, and
+ * every block is compared with itself shifted by one position using SSE2/AVX2 compare-and-movemask operations if the
+ * code is compiled with support for those instructions. For bio::ranges::bitcompressed_vector, the packed words are
+ * compared directly (XOR with the word shifted by one letter), so no letter is unpacked. All other ranges are
+ * compared element by element.
+ *
+ * ### Complexity
+ *
+ * Linear in the size of the range.
+ *
+ * ### Example
+ *
+ * ```cpp
+ * using namespace bio::alphabet::literals;
+ * std::vector<size_t> starts = bio::ranges::run_starts("AAACGGT"_dna4); // [0, 3, 4, 6]
+ * ```
+ */
+template <std::ranges::input_range rng_t>
+    //!\cond
+    requires std::equality_comparable<std::ranges::range_value_t<rng_t>>
+//!\endcond
+std::vector<size_t> run_starts(rng_t && range)
+{
+    using value_t = std::ranges::range_value_t<rng_t>;
+
+    constexpr bool byte_ranks = []()
+    {
+        if constexpr (alphabet::semialphabet<value_t>)
+            return alphabet::size<value_t> <= 256;
+        else
+            return false;
+    }();
+
+    std::vector<size_t> out;
+    if constexpr (std::ranges::sized_range<rng_t>)
+        out.reserve(std::ranges::size(range) / 8);
+
+    if constexpr (meta::is_type_specialisation_of_v<std::remove_cvref_t<rng_t>, bitcompressed_vector>)
+    {
+        if (!std::ranges::empty(range))
+        {
+            out.push_back(0);
+            detail::run_starts_packed(range, out);
+        }
+    }
+    else if constexpr (byte_ranks)
+    {
+        // block of ranks; slot 0 holds the last rank of the previous block
+        constexpr size_t                    block_size = 16384;
+        std::array<uint8_t, block_size + 1> ranks;
+        size_t                              offset = 0;
+
+        auto       it = std::ranges::begin(range);
+        auto const e  = std::ranges::end(range);
+        if (it == e)
+            return out;
+        out.push_back(0);
+        ranks[0] = alphabet::to_rank(*it);
+
+        while (it != e)
+        {
+            size_t n = 1;
+            if constexpr (std::ranges::sized_range<rng_t> && std::ranges::random_access_range<rng_t>)
+            {
+                size_t const count = std::min<size_t>(block_size, std::ranges::size(range) - offset);
+                for (size_t i = 0; i < count; ++i)
+                    ranks[i + 1] = alphabet::to_rank(it[i]);
+                it += count;
+                n += count;
+            }
+            else
+            {
+                for (; n <= block_size && it != e; ++n, ++it)
+                    ranks[n] = alphabet::to_rank(*it);
+            }
+
+            detail::run_starts_bytes(ranks.data(), n, offset, out);
+            offset += n - 1;
+            ranks[0] = ranks[n - 1];
+        }
+    }
+    else
+    {
+        size_t i  = 0;
+        auto   it = std::ranges::begin(range);
+        auto   e  = std::ranges::end(range);
+        if (it == e)
+            return out;
+
+        value_t prev = *it;
+        out.push_back(0);
+        for (++it, ++i; it != e; ++it, ++i)
+        {
+            if (!(*it == prev))
+            {
+                prev = *it;
+                out.push_back(i);
+            }
+        }
+    }
+
+    return out;
+}
+
+} // namespace bio::ranges
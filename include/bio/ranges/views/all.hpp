@@ -23,8 +23,10 @@
 #include <bio/ranges/views/pairwise_combine.hpp>
 #include <bio/ranges/views/persist.hpp>
 #include <bio/ranges/views/rank_to.hpp>
+#include <bio/ranges/views/rle.hpp>
 #include <bio/ranges/views/single_pass_input.hpp>
 #include <bio/ranges/views/take_exactly.hpp>
+#include <bio/ranges/views/take_until.hpp>
 #include <bio/ranges/views/to_char.hpp>
 #include <bio/ranges/views/to_rank.hpp>
 #include <bio/ranges/views/translate.hpp>
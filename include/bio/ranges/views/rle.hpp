@@ -0,0 +1,297 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::views::rle and bio::views::homopolymer_compress.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+#include <bio/ranges/concept.hpp>
+#include <bio/ranges/views/detail.hpp>
+
+namespace bio::ranges::detail
+{
+
+// ============================================================================
+//  view_rle
+// ============================================================================
+
+/*!\brief The type returned by bio::views::rle.
+ * \tparam urng_t The type of the underlying range, must model std::ranges::view and std::ranges::forward_range.
+ * \implements std::ranges::view
+ * \ingroup views
+ *
+ * \details
+ *
+ * Note that most members of this class are generated by ranges::view_interface which is not yet documented here.
+ */
+template <std::ranges::view urng_t>
+    //!\cond
+    requires(std::ranges::forward_range<urng_t> && std::equality_comparable<std::ranges::range_value_t<urng_t>>)
+//!\endcond
+class view_rle : public std::ranges::view_interface<view_rle<urng_t>>
+{
+private:
+    //!\brief The underlying range.
+    urng_t urange;
+
+    //!\brief The forward declared iterator type.
+    template <typename rng_t>
+    class basic_iterator;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    view_rle()                             = default; //!< Defaulted.
+    view_rle(view_rle const &)             = default; //!< Defaulted.
+    view_rle(view_rle &&)                  = default; //!< Defaulted.
+    view_rle & operator=(view_rle const &) = default; //!< Defaulted.
+    view_rle & operator=(view_rle &&)      = default; //!< Defaulted.
+    ~view_rle()                            = default; //!< Defaulted.
+
+    //!\brief Construct from another view.
+    constexpr explicit view_rle(urng_t _urange) : urange{std::move(_urange)} {}
+
+    /*!\brief Construct from another viewable_range.
+     * \tparam rng_t      Type of the passed range; `urng_t` must be constructible from this.
+     * \param[in] _urange The underlying range.
+     */
+    template <std::ranges::viewable_range rng_t>
+        //!\cond
+        requires(!std::same_as<std::remove_cvref_t<rng_t>, view_rle> &&
+                 std::constructible_from<urng_t, std::views::all_t<rng_t>>)
+    //!\endcond
+    constexpr explicit view_rle(rng_t && _urange) : view_rle{std::views::all(std::forward<rng_t>(_urange))}
+    {}
+    //!\}
+
+    /*!\name Iterators
+     * \{
+     */
+    /*!\brief Returns an iterator to the first run.
+     * \details
+     *
+     * ### Complexity
+     *
+     * Linear in the length of the first run.
+     */
+    constexpr basic_iterator<urng_t> begin()
+    {
+        return basic_iterator<urng_t>{std::ranges::begin(urange), std::ranges::end(urange)};
+    }
+
+    //!\copydoc begin()
+    constexpr basic_iterator<urng_t const> begin() const requires const_iterable_range<urng_t>
+    {
+        return basic_iterator<urng_t const>{std::ranges::begin(urange), std::ranges::end(urange)};
+    }
+
+    //!\brief Returns the sentinel.
+    constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+    //!\}
+};
+
+//!\brief Template argument type deduction guide that strips references.
+//!\relates bio::ranges::detail::view_rle
+template <typename urng_t>
+view_rle(urng_t &&) -> view_rle<std::views::all_t<urng_t>>;
+
+/*!\brief The iterator of bio::ranges::detail::view_rle.
+ * \tparam rng_t Should be `urng_t` for defining the iterator and `urng_t const` for defining the const iterator.
+ */
+template <std::ranges::view urng_t>
+    //!\cond
+    requires(std::ranges::forward_range<urng_t> && std::equality_comparable<std::ranges::range_value_t<urng_t>>)
+//!\endcond
+template <typename rng_t>
+class view_rle<urng_t>::basic_iterator
+{
+private:
+    //!\brief The iterator type of the underlying range.
+    using base_base_t = std::ranges::iterator_t<rng_t>;
+
+    //!\brief The first element of the current run.
+    base_base_t                    current{};
+    //!\brief The first element of the next run.
+    base_base_t                    next{};
+    //!\brief The end of the underlying range.
+    std::ranges::sentinel_t<rng_t> urange_end{};
+    //!\brief The length of the current run.
+    size_t                         length = 0;
+
+    //!\brief Find the end of the run that starts at #current.
+    constexpr void find_next()
+    {
+        next   = current;
+        length = 0;
+        if (current == urange_end)
+            return;
+
+        for (++next, ++length; next != urange_end && *next == *current; ++next)
+            ++length;
+    }
+
+public:
+    /*!\name Associated types
+     * \{
+     */
+    //!\brief The value type: the letter and the length of the run.
+    using value_type       = std::pair<std::ranges::range_value_t<rng_t>, size_t>;
+    //!\brief The reference type (a prvalue).
+    using reference        = value_type;
+    //!\brief The difference type.
+    using difference_type  = std::ranges::range_difference_t<rng_t>;
+    //!\brief The iterator concept tag.
+    using iterator_concept = std::forward_iterator_tag;
+    //!\}
+
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    basic_iterator()                                   = default; //!< Defaulted.
+    basic_iterator(basic_iterator const &)             = default; //!< Defaulted.
+    basic_iterator(basic_iterator &&)                  = default; //!< Defaulted.
+    basic_iterator & operator=(basic_iterator const &) = default; //!< Defaulted.
+    basic_iterator & operator=(basic_iterator &&)      = default; //!< Defaulted.
+    ~basic_iterator()                                  = default; //!< Defaulted.
+
+    //!\brief Construct from begin and end of the underlying range.
+    constexpr basic_iterator(base_base_t it, std::ranges::sentinel_t<rng_t> e) :
+      current{std::move(it)},
+      urange_end{std::move(e)}
+    {
+        find_next();
+    }
+    //!\}
+
+    //!\brief Returns the letter and the length of the current run.
+    constexpr reference operator*() const { return {*current, length}; }
+
+    //!\brief Returns an iterator to the first element of the current run in the underlying range.
+    constexpr base_base_t const & base() const noexcept { return current; }
+
+    //!\brief Move to the next run.
+    constexpr basic_iterator & operator++()
+    {
+        current = next;
+        find_next();
+        return *this;
+    }
+
+    //!\brief Move to the next run and return the previous iterator.
+    constexpr basic_iterator operator++(int)
+    {
+        basic_iterator cpy{*this};
+        ++(*this);
+        return cpy;
+    }
+
+    //!\brief Checks whether two iterators point to the same run.
+    constexpr friend bool operator==(basic_iterator const & lhs, basic_iterator const & rhs)
+    {
+        return lhs.current == rhs.current;
+    }
+
+    //!\brief Checks whether the iterator is at the end.
+    constexpr friend bool operator==(basic_iterator const & lhs, std::default_sentinel_t)
+    {
+        return lhs.current == lhs.urange_end;
+    }
+};
+
+} // namespace bio::ranges::detail
+
+// ============================================================================
+//  views::rle and views::homopolymer_compress
+// ============================================================================
+
+namespace bio::ranges::views
+{
+
+/*!\name General purpose views
+ * \{
+ */
+
+/*!\brief               A view adaptor that run-length encodes the underlying range.
+ * \tparam urng_t       The type of the range being processed. See below for requirements. [template parameter is
+ *                      omitted in pipe notation]
+ * \param[in] urange    The range being processed. [parameter is omitted in pipe notation]
+ * \returns             A range of `std::pair<letter, length>`, one per run of equal elements.
+ * \ingroup views
+ *
+ * \details
+ *
+ * \header_file{bio/ranges/views/rle.hpp}
+ *
+ * Consecutive equal elements are combined into a single pair of the element and the number of repetitions, e.g.
+ * `"AAACGG"_dna4` becomes `(A,3) (C,1) (G,2)`. The runs are determined lazily while iterating; to locate all runs
+ * of a sequence at once (using SIMD instructions), use bio::ranges::run_starts or bio::ranges::run_length_sequence.
+ *
+ * ### View properties
+ *
+ * | Concepts and traits              | `urng_t` (underlying range type)      | `rrng_t` (returned range type)                     |
+ * |----------------------------------|:-------------------------------------:|:--------------------------------------------------:|
+ * | std::ranges::input_range         | *required*                            | *preserved*                                        |
+ * | std::ranges::forward_range       | *required*                            | *preserved*                                        |
+ * | std::ranges::bidirectional_range |                                       | *lost*                                             |
+ * | std::ranges::random_access_range |                                       | *lost*                                             |
+ * | std::ranges::contiguous_range    |                                       | *lost*                                             |
+ * |                                  |                                       |                                                    |
+ * | std::ranges::viewable_range      | *required*                            | *guaranteed*                                       |
+ * | std::ranges::view                |                                       | *guaranteed*                                       |
+ * | std::ranges::sized_range         |                                       | *lost*                                             |
+ * | std::ranges::common_range        |                                       | *lost*                                             |
+ * | std::ranges::output_range        |                                       | *lost*                                             |
+ * | bio::ranges::const_iterable_range|                                       | *preserved*                                        |
+ * |                                  |                                       |                                                    |
+ * | std::ranges::range_reference_t   |                                       | std::pair<range_value_t<urng_t>, size_t>           |
+ *
+ * The value type of the underlying range must model std::equality_comparable.
+ *
+ * See the \link views views submodule documentation \endlink for detailed descriptions of the view properties.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/views/rle.cpp
+ *
+ * \hideinitializer
+ */
+inline constexpr auto rle = detail::adaptor_for_view_without_args<detail::view_rle>{};
+
+/*!\brief               A view adaptor that collapses every run of equal elements into a single element.
+ * \tparam urng_t       The type of the range being processed. See below for requirements. [template parameter is
+ *                      omitted in pipe notation]
+ * \param[in] urange    The range being processed. [parameter is omitted in pipe notation]
+ * \returns             The first element of every run of equal elements.
+ * \ingroup views
+ *
+ * \details
+ *
+ * \header_file{bio/ranges/views/rle.hpp}
+ *
+ * Homopolymer compression, e.g. `"AAACGGT"_dna4` becomes `"ACGT"`; this is commonly applied to long reads
+ * before k-mer indexing, because homopolymer lengths are their dominant error. The view is
+ * `bio::views::rle | std::views::transform(…)` and has the same view properties as bio::views::rle, except that the
+ * reference type is `std::ranges::range_value_t<urng_t>`.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/views/homopolymer_compress.cpp
+ *
+ * \hideinitializer
+ */
+inline auto const homopolymer_compress = rle | std::views::transform([](auto const & run) { return run.first; });
+
+//!\}
+
+} // namespace bio::ranges::views
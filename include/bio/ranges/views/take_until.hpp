@@ -0,0 +1,590 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::views::take_until, bio::views::take_line and their `_or_throw` variants.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include <bio/meta/type_traits/template_inspection.hpp>
+#include <bio/ranges/concept.hpp>
+#include <bio/ranges/detail/inherited_iterator_base.hpp>
+#include <bio/ranges/find_any_of.hpp>
+#include <bio/ranges/type_traits.hpp>
+#include <bio/ranges/views/detail.hpp>
+
+namespace bio::ranges::detail
+{
+
+// ============================================================================
+//  view_take_until
+// ============================================================================
+
+/*!\brief The type returned by bio::views::take_until, bio::views::take_line and their `_or_throw` variants.
+ * \tparam urng_t      The type of the underlying range, must model std::ranges::view.
+ * \tparam fun_t       The type of the predicate.
+ * \tparam or_throw    Whether to throw an exception when the input is exhausted before the delimiter is reached.
+ * \tparam and_consume Whether to consume the delimiter (a `'\n'` following a `'\r'` is consumed, too) on
+ *                     single-pass input.
+ * \implements std::ranges::view
+ * \ingroup views
+ *
+ * \details
+ *
+ * Note that most members of this class are generated by ranges::view_interface which is not yet documented here.
+ */
+template <std::ranges::view urng_t, typename fun_t, bool or_throw, bool and_consume>
+class view_take_until : public std::ranges::view_interface<view_take_until<urng_t, fun_t, or_throw, and_consume>>
+{
+private:
+    static_assert(std::predicate<fun_t const &, std::ranges::range_reference_t<urng_t>>,
+                  "The predicate passed to views::take_until must be callable with the range's elements and "
+                  "return something convertible to bool.");
+
+    //!\brief The underlying range.
+    urng_t               urange;
+    //!\brief The delimiter predicate.
+    std::optional<fun_t> fun;
+
+    //!\brief The forward declared iterator type.
+    template <typename rng_t>
+    class basic_iterator;
+
+    //!\brief The sentinel type; wraps the underlying sentinel so that it is not comparable with other iterators.
+    template <typename rng_t>
+    class basic_sentinel
+    {
+    private:
+        //!\brief The sentinel of the underlying range.
+        std::ranges::sentinel_t<rng_t> urange_end{};
+
+    public:
+        /*!\name Constructors, destructor and assignment
+         * \{
+         */
+        basic_sentinel()                                       = default; //!< Defaulted.
+        basic_sentinel(basic_sentinel const & rhs)             = default; //!< Defaulted.
+        basic_sentinel(basic_sentinel && rhs)                  = default; //!< Defaulted.
+        basic_sentinel & operator=(basic_sentinel const & rhs) = default; //!< Defaulted.
+        basic_sentinel & operator=(basic_sentinel && rhs)      = default; //!< Defaulted.
+        ~basic_sentinel()                                      = default; //!< Defaulted.
+
+        //!\brief Construct from the sentinel of the underlying range.
+        constexpr explicit basic_sentinel(std::ranges::sentinel_t<rng_t> _urange_end) :
+          urange_end{std::move(_urange_end)}
+        {}
+        //!\}
+
+        //!\brief Returns the sentinel of the underlying range.
+        constexpr std::ranges::sentinel_t<rng_t> const & base() const noexcept { return urange_end; }
+    };
+
+    /*!\name Associated types
+     * \{
+     */
+    //!\brief The iterator type of this view.
+    using iterator       = basic_iterator<urng_t>;
+    //!\brief The const_iterator type of this view (only instantiated if the underlying range is const-iterable).
+    using const_iterator = basic_iterator<urng_t const>;
+    //!\}
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    view_take_until()                                        = default; //!< Defaulted.
+    view_take_until(view_take_until const & rhs)             = default; //!< Defaulted.
+    view_take_until(view_take_until && rhs)                  = default; //!< Defaulted.
+    view_take_until & operator=(view_take_until const & rhs) = default; //!< Defaulted.
+    view_take_until & operator=(view_take_until && rhs)      = default; //!< Defaulted.
+    ~view_take_until()                                       = default; //!< Defaulted.
+
+    /*!\brief Construct from another view.
+     * \param[in] _urange The underlying range.
+     * \param[in] _fun    The predicate that identifies the delimiter.
+     */
+    constexpr view_take_until(urng_t _urange, fun_t _fun) : urange{std::move(_urange)}, fun{std::move(_fun)} {}
+
+    /*!\brief Construct from another viewable_range.
+     * \tparam rng_t      Type of the passed range; `urng_t` must be constructible from this.
+     * \param[in] _urange The underlying range.
+     * \param[in] _fun    The predicate that identifies the delimiter.
+     */
+    template <std::ranges::viewable_range rng_t>
+        //!\cond
+        requires std::constructible_from<urng_t, std::views::all_t<rng_t>>
+    //!\endcond
+    constexpr view_take_until(rng_t && _urange, fun_t _fun) :
+      view_take_until{std::views::all(std::forward<rng_t>(_urange)), std::move(_fun)}
+    {}
+    //!\}
+
+    /*!\name Iterators
+     * \{
+     */
+    /*!\brief Returns an iterator to the first element of the range.
+     * \returns Iterator to the first element.
+     *
+     * If the range is empty (or begins with the delimiter), the returned iterator will be equal to end().
+     *
+     * ### Complexity
+     *
+     * Constant.
+     *
+     * ### Exceptions
+     *
+     * No-throw guarantee.
+     */
+    constexpr iterator begin() noexcept { return iterator{std::ranges::begin(urange), &*fun}; }
+
+    //!\copydoc begin()
+    constexpr const_iterator begin() const noexcept requires const_iterable_range<urng_t>
+    {
+        return const_iterator{std::ranges::begin(urange), &*fun};
+    }
+
+    /*!\brief Returns a sentinel for the range.
+     * \returns A sentinel that wraps the sentinel of the underlying range.
+     *
+     * The iterators of this view compare equal to the sentinel when they point to the delimiter (or are at the end of
+     * the underlying range).
+     *
+     * ### Complexity
+     *
+     * Constant.
+     *
+     * ### Exceptions
+     *
+     * No-throw guarantee.
+     */
+    constexpr auto end() noexcept { return basic_sentinel<urng_t>{std::ranges::end(urange)}; }
+
+    //!\copydoc end()
+    constexpr auto end() const noexcept requires const_iterable_range<urng_t>
+    {
+        return basic_sentinel<urng_t const>{std::ranges::end(urange)};
+    }
+    //!\}
+};
+
+//!\brief Template argument type deduction guide that strips references.
+//!\relates bio::ranges::detail::view_take_until
+template <typename urng_t, typename fun_t, bool or_throw = false, bool and_consume = false>
+view_take_until(urng_t &&, fun_t) -> view_take_until<std::views::all_t<urng_t>, fun_t, or_throw, and_consume>;
+
+//!\brief The iterator for the view_take_until. It inherits from the underlying type, but overwrites comparison.
+//!\tparam rng_t Should be `urng_t` for defining #iterator and `urng_t const` for defining #const_iterator.
+template <std::ranges::view urng_t, typename fun_t, bool or_throw, bool and_consume>
+template <typename rng_t>
+class view_take_until<urng_t, fun_t, or_throw, and_consume>::basic_iterator :
+  public inherited_iterator_base<basic_iterator<rng_t>, std::ranges::iterator_t<rng_t>>
+{
+private:
+    //!\brief The iterator type of the underlying range.
+    using base_base_t   = std::ranges::iterator_t<rng_t>;
+    //!\brief The CRTP wrapper type.
+    using base_t        = inherited_iterator_base<basic_iterator, std::ranges::iterator_t<rng_t>>;
+    //!\brief The sentinel type of the view.
+    using sentinel_type = basic_sentinel<rng_t>;
+
+    //!\brief Whether the delimiter is consumed from the underlying range.
+    static constexpr bool consume = and_consume && !std::forward_iterator<base_base_t>;
+
+    //!\brief Pointer to the predicate stored in the view.
+    fun_t const * fun_ptr = nullptr;
+
+    //!\brief Whether the delimiter has already been found and consumed.
+    [[no_unique_address]] mutable std::conditional_t<consume, bool, meta::ignore_t> at_end{};
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \brief Exceptions specification is implicitly inherited.
+     * \{
+     */
+    basic_iterator()                                       = default; //!< Defaulted.
+    basic_iterator(basic_iterator const & rhs)             = default; //!< Defaulted.
+    basic_iterator(basic_iterator && rhs)                  = default; //!< Defaulted.
+    basic_iterator & operator=(basic_iterator const & rhs) = default; //!< Defaulted.
+    basic_iterator & operator=(basic_iterator && rhs)      = default; //!< Defaulted.
+    ~basic_iterator()                                      = default; //!< Defaulted.
+
+    //!\brief Constructor that delegates to the CRTP layer and initialises the members.
+    constexpr basic_iterator(base_base_t it, fun_t const * const _fun_ptr) noexcept(noexcept(base_t{it})) :
+      base_t{std::move(it)}, fun_ptr{_fun_ptr}
+    {}
+    //!\}
+
+    /*!\name Associated types
+     * \brief All are derived from the base_base_t.
+     * \{
+     */
+
+    //!\brief The difference type.
+    using difference_type   = std::iter_difference_t<base_base_t>;
+    //!\brief The value type.
+    using value_type        = std::iter_value_t<base_base_t>;
+    //!\brief The reference type.
+    using reference         = std::iter_reference_t<base_base_t>;
+    //!\brief The pointer type.
+    using pointer           = detail::iter_pointer_t<base_base_t>;
+    //!\brief The iterator category tag.
+    using iterator_category = detail::iterator_category_tag_t<base_base_t>;
+    //!\brief The iterator concept tag.
+    using iterator_concept  = detail::iterator_concept_tag_t<base_base_t>;
+    //!\}
+
+    /*!\name Arithmetic operators
+     * \brief bio::ranges::detail::inherited_iterator_base operators are used unless specialised here.
+     * \details The operators returning a new iterator are specialised so that the predicate pointer is retained.
+     * \{
+     */
+
+    //!\brief Increments the iterator by one.
+    constexpr basic_iterator & operator++() noexcept(noexcept(++std::declval<base_t &>()))
+    {
+        base_t::operator++();
+        return *this;
+    }
+
+    //!\brief Returns an iterator incremented by one.
+    constexpr basic_iterator operator++(int) noexcept(noexcept(++std::declval<basic_iterator &>()) &&
+                                                      std::is_nothrow_copy_constructible_v<basic_iterator>)
+    {
+        basic_iterator cpy{*this};
+        ++(*this);
+        return cpy;
+    }
+
+    //!\brief Decrements the iterator by one.
+    constexpr basic_iterator & operator--() noexcept(noexcept(--std::declval<base_t &>()))
+      //!\cond
+      requires std::bidirectional_iterator<base_base_t>
+    //!\endcond
+    {
+        base_t::operator--();
+        return *this;
+    }
+
+    //!\brief Returns an iterator decremented by one.
+    constexpr basic_iterator operator--(int) noexcept(noexcept(--std::declval<basic_iterator &>()) &&
+                                                      std::is_nothrow_copy_constructible_v<basic_iterator>)
+      //!\cond
+      requires std::bidirectional_iterator<base_base_t>
+    //!\endcond
+    {
+        basic_iterator cpy{*this};
+        --(*this);
+        return cpy;
+    }
+
+    //!\brief Returns an iterator advanced by `skip` positions.
+    constexpr basic_iterator operator+(difference_type const skip) const
+      noexcept(noexcept(std::declval<basic_iterator &>() += skip))
+      //!\cond
+      requires std::random_access_iterator<base_base_t>
+    //!\endcond
+    {
+        basic_iterator cpy{*this};
+        cpy += skip;
+        return cpy;
+    }
+
+    //!\brief Returns an iterator advanced by `skip` positions.
+    constexpr friend basic_iterator operator+(difference_type const skip, basic_iterator const & it) noexcept(
+      noexcept(it + skip))
+      //!\cond
+      requires std::random_access_iterator<base_base_t>
+    //!\endcond
+    {
+        return it + skip;
+    }
+
+    //!\brief Returns an iterator advanced by `-skip` positions.
+    constexpr basic_iterator operator-(difference_type const skip) const
+      noexcept(noexcept(std::declval<basic_iterator &>() -= skip))
+      //!\cond
+      requires std::random_access_iterator<base_base_t>
+    //!\endcond
+    {
+        basic_iterator cpy{*this};
+        cpy -= skip;
+        return cpy;
+    }
+
+    //!\brief Returns the distance between two iterators.
+    constexpr difference_type operator-(basic_iterator const & rhs) const
+      noexcept(noexcept(std::declval<base_base_t const &>() - std::declval<base_base_t const &>()))
+      //!\cond
+      requires std::sized_sentinel_for<base_base_t, base_base_t>
+    //!\endcond
+    {
+        return *base_t::this_to_base() - *rhs.this_to_base();
+    }
+    //!\}
+
+    /*!\name Comparison operators
+     * \brief We define comparison against self and against the sentinel.
+     * \{
+     */
+
+    //!\brief Checks whether `*this` is equal to `rhs`.
+    constexpr bool operator==(basic_iterator const & rhs) const
+      noexcept(noexcept(std::declval<base_base_t &>() == std::declval<base_base_t &>()))
+      //!\cond
+      requires std::forward_iterator<base_base_t>
+    //!\endcond
+    {
+        return *base_t::this_to_base() == *rhs.this_to_base();
+    }
+
+    /*!\brief Checks whether `*this` is at the delimiter or at the end of the underlying range.
+     * \throws std::runtime_error If `or_throw` is set and the end of the underlying range is reached.
+     */
+    constexpr bool operator==(sentinel_type const & rhs) const
+    {
+        if constexpr (consume)
+        {
+            if (at_end)
+                return true;
+        }
+
+        base_base_t const & it = *base_t::this_to_base();
+
+        if (it == rhs.base())
+        {
+            if constexpr (or_throw)
+                throw std::runtime_error{"Reached end of input before designated delimiter."};
+
+            return true;
+        }
+
+        if (!(*fun_ptr)(*it))
+            return false;
+
+        if constexpr (consume)
+        {
+            // iterators over single-pass input share their state, so advancing this one consumes the delimiter
+            base_base_t & mutable_it = const_cast<base_base_t &>(it);
+            bool const    was_cr     = *mutable_it == '\r';
+            ++mutable_it;
+            if (was_cr && !(mutable_it == rhs.base()) && *mutable_it == '\n')
+                ++mutable_it;
+
+            at_end = true;
+        }
+
+        return true;
+    }
+
+    //!\brief Checks whether `lhs` is equal to `rhs`.
+    constexpr friend bool operator==(sentinel_type const & lhs, basic_iterator const & rhs) { return rhs == lhs; }
+    //!\}
+};
+
+// ============================================================================
+//  take_until_fn (adaptor definition)
+// ============================================================================
+
+/*!\brief The predicate type stored for a given argument type: characters and strings are converted to
+ *        bio::ranges::char_set, everything else is stored as is.
+ */
+template <typename fun_t>
+using take_until_pred_t = std::conditional_t<std::same_as<std::remove_cvref_t<fun_t>, char> ||
+                                               std::convertible_to<fun_t, std::string_view>,
+                                             char_set,
+                                             std::remove_cvref_t<fun_t>>;
+
+/*!\brief View adaptor definition for views::take_until, views::take_line and their `_or_throw` variants.
+ * \tparam or_throw    Whether to throw an exception when the input is exhausted before the delimiter is reached.
+ * \tparam and_consume Whether to consume the delimiter on single-pass input.
+ */
+template <bool or_throw, bool and_consume>
+struct take_until_fn
+{
+    //!\brief Store the argument and return a range adaptor closure object.
+    template <typename fun_t>
+    constexpr auto operator()(fun_t && fun) const
+    {
+        return adaptor_from_functor{*this, take_until_pred_t<fun_t>{std::forward<fun_t>(fun)}};
+    }
+
+    /*!\brief Search the delimiter eagerly if possible and return view_take_until if not.
+     * \returns An instance of std::basic_string_view, std::span or bio::ranges::detail::view_take_until.
+     */
+    template <std::ranges::range urng_t, typename fun_t>
+    constexpr auto operator()(urng_t && urange, fun_t && fun) const
+    {
+        static_assert(std::ranges::viewable_range<urng_t>,
+                      "The views::take_until adaptor can only be passed viewable_ranges, i.e. Views or "
+                      "&-to-non-View.");
+
+        using pred_t = take_until_pred_t<fun_t>;
+
+        constexpr bool is_string_view =
+          meta::is_type_specialisation_of_v<std::remove_cvref_t<urng_t>, std::basic_string_view>;
+        // only lvalues: a string_view into a const string temporary would dangle
+        constexpr bool is_const_string =
+          meta::is_type_specialisation_of_v<std::remove_cvref_t<urng_t>, std::basic_string> &&
+          std::is_lvalue_reference_v<urng_t> && std::is_const_v<std::remove_reference_t<urng_t>>;
+
+        // bulk search on contiguous char ranges
+        if constexpr (std::same_as<pred_t, char_set> &&
+                      std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<urng_t>>, char> &&
+                      std::ranges::contiguous_range<urng_t> && std::ranges::sized_range<urng_t> &&
+                      (is_string_view || is_const_string || std::ranges::borrowed_range<urng_t>))
+        {
+            auto const   it   = find_any_of(urange, pred_t{fun});
+            size_t const size = it - std::ranges::begin(urange);
+
+            if constexpr (or_throw)
+            {
+                if (size == std::ranges::size(urange))
+                    throw std::runtime_error{"Reached end of input before designated delimiter."};
+            }
+
+            if constexpr (is_string_view || is_const_string)
+                return std::basic_string_view{std::ranges::data(urange), size};
+            else
+                return std::span{std::ranges::data(urange), size};
+        }
+        // our type
+        else
+        {
+            return view_take_until<std::views::all_t<urng_t>, pred_t, or_throw, and_consume>{
+              std::forward<urng_t>(urange),
+              pred_t{std::forward<fun_t>(fun)}};
+        }
+    }
+};
+
+} // namespace bio::ranges::detail
+
+// ============================================================================
+//  views::take_until
+// ============================================================================
+
+namespace bio::ranges::views
+{
+
+/*!\name General purpose views
+ * \{
+ */
+
+/*!\brief               A view adaptor that returns elements from the underlying range until the predicate evaluates
+ *                      to true (or the end of the underlying range is reached).
+ * \tparam urng_t       The type of the range being processed. See below for requirements. [template parameter is
+ *                      omitted in pipe notation]
+ * \tparam fun_t        The type of the predicate; a `char` or a bio::ranges::char_set is also accepted.
+ * \param[in] urange    The range being processed. [parameter is omitted in pipe notation]
+ * \param[in] fun       The predicate that identifies the delimiter.
+ * \returns             All elements of the underlying range up to (but excluding) the first element for which the
+ *                      predicate is true.
+ * \ingroup views
+ *
+ * \details
+ *
+ * \header_file{bio/ranges/views/take_until.hpp}
+ *
+ * ### View properties
+ *
+ * For most ranges, this view behaves like `std::views::take_while(std::not_fn(fun))`.
+ *
+ * If the underlying range is a contiguous, sized range over `char` that is either a borrowed range or a
+ * `std::string const &`, and if the delimiter is given as `char` or bio::ranges::char_set, the delimiter is searched
+ * for eagerly via bio::ranges::find_any_of (which uses std::memchr or SSE2/AVX2 instructions) and the result
+ * is returned as std::string_view or std::span, i.e. it is contiguous, sized and common.
+ *
+ * | Concepts and traits              | `urng_t` (underlying range type)      | `rrng_t` (returned range type)                     |
+ * |----------------------------------|:-------------------------------------:|:--------------------------------------------------:|
+ * | std::ranges::input_range         | *required*                            | *preserved*                                        |
+ * | std::ranges::forward_range       |                                       | *preserved*                                        |
+ * | std::ranges::bidirectional_range |                                       | *preserved*                                        |
+ * | std::ranges::random_access_range |                                       | *preserved*                                        |
+ * | std::ranges::contiguous_range    |                                       | *preserved*                                        |
+ * |                                  |                                       |                                                    |
+ * | std::ranges::viewable_range      | *required*                            | *guaranteed*                                       |
+ * | std::ranges::view                |                                       | *guaranteed*                                       |
+ * | std::ranges::sized_range         |                                       | *lost* (except in the eager case above)            |
+ * | std::ranges::common_range        |                                       | *lost* (except in the eager case above)            |
+ * | std::ranges::output_range        |                                       | *preserved* except in the eager case above         |
+ * | bio::ranges::const_iterable_range|                                       | *preserved*                                        |
+ * |                                  |                                       |                                                    |
+ * | std::ranges::range_reference_t   |                                       | std::ranges::range_reference_t<urng_t>             |
+ *
+ * See the \link views views submodule documentation \endlink for detailed descriptions of the view properties.
+ *
+ * bio::views::take_until_or_throw behaves the same, except that it throws std::runtime_error if the end of the
+ * underlying range is reached before the delimiter.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/views/take_until.cpp
+ *
+ * \hideinitializer
+ */
+inline constexpr auto take_until = detail::take_until_fn<false, false>{};
+
+/*!\brief A view adaptor that returns elements from the underlying range until the predicate evaluates to true
+ * (throws if the end of input is reached before).
+ * \throws std::runtime_error If the end of the underlying range is reached before the delimiter.
+ * \copydetails bio::ranges::views::take_until
+ * \hideinitializer
+ */
+inline constexpr auto take_until_or_throw = detail::take_until_fn<true, false>{};
+
+// ============================================================================
+//  views::take_line
+// ============================================================================
+
+/*!\brief               A view adaptor that returns a single line from the underlying range.
+ * \tparam urng_t       The type of the range being processed. See below for requirements. [template parameter is
+ *                      omitted in pipe notation]
+ * \param[in] urange    The range being processed. [parameter is omitted in pipe notation]
+ * \returns             All elements of the underlying range up to (but excluding) the first `'\r'` or `'\n'`.
+ * \ingroup views
+ *
+ * \details
+ *
+ * \header_file{bio/ranges/views/take_until.hpp}
+ *
+ * This is bio::views::take_until with `"\r\n"` as delimiter set and the same view properties, i.e. lines are
+ * located via bio::ranges::find_any_of on contiguous input.
+ *
+ * If the underlying range is a single-pass input range (e.g. bio::views::single_pass_input over a stream),
+ * the end-of-line marker (`'\n'` or `"\r\n"`) is consumed when the end of the returned view is reached, i.e.
+ * the underlying range is positioned at the beginning of the next line.
+ *
+ * bio::views::take_line_or_throw behaves the same, except that it throws std::runtime_error if the end of the
+ * underlying range is reached before an end-of-line marker.
+ *
+ * ### Example
+ *
+ * \include test/snippet/ranges/views/take_line.cpp
+ *
+ * \hideinitializer
+ */
+inline constexpr auto take_line = detail::take_until_fn<false, true>{}(char_set{"\r\n"});
+
+/*!\brief A view adaptor that returns a single line from the underlying range (throws if there is no end-of-line).
+ * \throws std::runtime_error If the end of the underlying range is reached before an end-of-line marker.
+ * \copydetails bio::ranges::views::take_line
+ * \hideinitializer
+ */
+inline constexpr auto take_line_or_throw = detail::take_until_fn<true, true>{}(char_set{"\r\n"});
+
+//!\}
+
+} // namespace bio::ranges::views
@@ -16,6 +16,7 @@
 #include <ranges>
 
 #include <bio/alphabet/concept.hpp>
+#include <bio/meta/instrumentation.hpp>
 #include <bio/meta/type_traits/basic.hpp>
 #include <bio/ranges/views/deep.hpp>
 
@@ -80,6 +81,8 @@ inline auto const validate_char_for = deep{std::views::transform(
       static_assert(std::common_reference_with<char_t, alphabet::char_t<alphabet_type>>,
                     "The innermost value type must have a common reference to underlying char type of alphabet_type.");
 
+      meta::detail::instrumentation_count(meta::instrumentation_counter::char_strictly_to_elements);
+
       if (!alphabet::char_is_valid_for<alphabet_type>(in))
       {
           throw alphabet::invalid_char_assignment{"alphabet_type", in};
@@ -0,0 +1,358 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::search::aho_corasick.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/alphabet/concept.hpp>
+
+namespace bio::search
+{
+
+/*!\brief An occurrence found by bio::search::aho_corasick.
+ * \ingroup search
+ */
+struct aho_corasick_hit
+{
+    //!\brief The start position in the text.
+    uint64_t position = 0;
+    //!\brief The index of the pattern.
+    uint32_t pattern  = 0;
+
+    //!\brief Defaulted.
+    friend constexpr bool operator==(aho_corasick_hit const &, aho_corasick_hit const &) = default;
+};
+
+/*!\brief The position of a scan in a text that arrives in pieces; see bio::search::aho_corasick::find().
+ * \ingroup search
+ */
+struct aho_corasick_cursor
+{
+    //!\brief The state of the automaton.
+    uint32_t state    = 0;
+    //!\brief The number of letters scanned so far.
+    uint64_t position = 0;
+};
+
+/*!\brief Finds all occurrences of many patterns at once with an Aho-Corasick automaton.
+ * \ingroup search
+ * \tparam alph_t The alphabet of patterns and text.
+ * \details
+ *
+ * The patterns are stored in a trie whose failure links (Aho and Corasick, 1975) are resolved into full DFA
+ * transitions, so every text letter costs exactly one table lookup. The transition table is dense over the ranks
+ * of `alph_t` (e.g. 4 or 5 columns for nucleotides) and stored in a single flat array with the states numbered in
+ * breadth-first order, which keeps the frequently visited shallow states close together. The highest bit of every
+ * transition marks target states at which a pattern ends, so only those states are inspected for outputs.
+ *
+ * Texts can be any input range over `alph_t`; a text that arrives in pieces (e.g. a stream) can be scanned with a
+ * bio::search::aho_corasick_cursor. Many short texts (e.g. the reads in a bio::ranges::concatenated_sequences) are
+ * best scanned with #find_each(), which interleaves several texts to overlap the table lookups.
+ *
+ * Hits are reported in order of their end position; for the same end position, longer patterns come first.
+ *
+ * ### Complexity
+ *
+ * Construction is linear in the total length of the patterns times the size of the alphabet. Searching is linear in
+ * the length of the text plus the number of hits.
+ *
+ * ### Example
+ *
+ * \include test/snippet/search/aho_corasick.cpp
+ */
+template <alphabet::semialphabet alph_t>
+class aho_corasick
+{
+private:
+    //!\brief The number of columns of the transition table.
+    static constexpr size_t   sigma            = alphabet::size<alph_t>;
+    //!\brief Marks transitions into states with outputs.
+    static constexpr uint32_t output_flag      = uint32_t{1} << 31;
+    //!\brief The number of texts that #find_each() scans at once.
+    static constexpr size_t   lanes            = 8;
+    //!\brief #find_each() only interleaves texts if the transition table has more bytes (about the L1 cache).
+    static constexpr size_t   interleave_bytes = 32768;
+
+    //!\brief `transitions[s * sigma + r]` is the state after reading rank `r` in state `s` (plus #output_flag).
+    std::vector<uint32_t> transitions;
+    //!\brief The patterns that end in a state are `outputs[output_begin[s]]` to `outputs[output_begin[s + 1] - 1]`.
+    std::vector<uint32_t> output_begin;
+    //!\brief The patterns, grouped by the state in which they end.
+    std::vector<uint32_t> outputs;
+    //!\brief The nearest state on the failure path that has outputs of its own (`0` if none).
+    std::vector<uint32_t> output_link;
+    //!\brief The length of every pattern.
+    std::vector<uint32_t> lengths;
+
+    //!\brief Report all patterns that end in `state` at text position `i`.
+    template <typename on_hit_t>
+    void report(uint32_t state, uint64_t const i, on_hit_t & on_hit) const
+    {
+        if (output_begin[state] == output_begin[state + 1])
+            state = output_link[state];
+
+        while (state != 0)
+        {
+            for (uint32_t o = output_begin[state]; o < output_begin[state + 1]; ++o)
+                on_hit(aho_corasick_hit{i + 1 - lengths[outputs[o]], outputs[o]});
+            state = output_link[state];
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    aho_corasick()                                 = default; //!< Defaulted.
+    aho_corasick(aho_corasick const &)             = default; //!< Defaulted.
+    aho_corasick(aho_corasick &&)                  = default; //!< Defaulted.
+    aho_corasick & operator=(aho_corasick const &) = default; //!< Defaulted.
+    aho_corasick & operator=(aho_corasick &&)      = default; //!< Defaulted.
+    ~aho_corasick()                                = default; //!< Defaulted.
+
+    /*!\brief Construct from patterns.
+     * \param[in] patterns The patterns, e.g. a bio::ranges::concatenated_sequences; their position is the index
+     *                     reported by bio::search::aho_corasick_hit. Duplicates are reported once per copy.
+     * \throws std::invalid_argument If there are no patterns, a pattern is empty or there are more than `2^31`
+     * states.
+     */
+    template <std::ranges::input_range patterns_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<patterns_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<patterns_t>>, alph_t>)
+    //!\endcond
+    explicit aho_corasick(patterns_t && patterns)
+    {
+        constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        // the trie, numbered in insertion order
+        std::vector<uint32_t> trie(sigma, none);
+        std::vector<uint32_t> ends; // the state of every pattern
+        for (auto && pattern : patterns)
+        {
+            uint32_t state  = 0;
+            uint32_t length = 0;
+            for (alph_t const letter : pattern)
+            {
+                size_t const edge = state * sigma + alphabet::to_rank(letter);
+                if (trie[edge] == none)
+                {
+                    if (trie.size() / sigma >= output_flag)
+                        throw std::invalid_argument{"The automaton would have more than 2^31 states."};
+                    trie[edge] = trie.size() / sigma;
+                    trie.resize(trie.size() + sigma, none);
+                }
+                state = trie[edge];
+                ++length;
+            }
+            if (length == 0)
+                throw std::invalid_argument{"Patterns must not be empty."};
+
+            ends.push_back(state);
+            lengths.push_back(length);
+        }
+        if (lengths.empty())
+            throw std::invalid_argument{"At least one pattern is required."};
+
+        // renumber the states in breadth-first order
+        size_t const          n_states = trie.size() / sigma;
+        std::vector<uint32_t> order{0};
+        std::vector<uint32_t> new_id(n_states);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            new_id[order[i]] = i;
+            for (size_t r = 0; r < sigma; ++r)
+                if (trie[order[i] * sigma + r] != none)
+                    order.push_back(trie[order[i] * sigma + r]);
+        }
+
+        transitions.assign(n_states * sigma, none);
+        for (size_t s = 0; s < n_states; ++s)
+            for (size_t r = 0; r < sigma; ++r)
+                if (trie[s * sigma + r] != none)
+                    transitions[new_id[s] * sigma + r] = new_id[trie[s * sigma + r]];
+
+        output_begin.assign(n_states + 1, 0);
+        for (uint32_t const s : ends)
+            ++output_begin[new_id[s] + 1];
+        for (size_t s = 0; s < n_states; ++s)
+            output_begin[s + 1] += output_begin[s];
+        outputs.resize(lengths.size());
+        std::vector<uint32_t> fill(output_begin.begin(), output_begin.end() - 1);
+        for (uint32_t p = 0; p < ends.size(); ++p)
+            outputs[fill[new_id[ends[p]]]++] = p;
+
+        // failure links, resolved into transitions; in breadth-first order, the failure target of a state (which is
+        // shallower) is always complete before the state itself
+        std::vector<uint32_t> fail(n_states, 0);
+        output_link.assign(n_states, 0);
+        for (uint32_t s = 0; s < n_states; ++s)
+        {
+            for (size_t r = 0; r < sigma; ++r)
+            {
+                uint32_t & next = transitions[s * sigma + r];
+                if (next == none)
+                {
+                    next = s == 0 ? 0 : transitions[fail[s] * sigma + r];
+                }
+                else
+                {
+                    uint32_t const f = s == 0 ? 0 : transitions[fail[s] * sigma + r];
+                    fail[next]        = f;
+                    output_link[next] = output_begin[f] != output_begin[f + 1] ? f : output_link[f];
+                }
+            }
+        }
+
+        for (uint32_t & next : transitions)
+            if (output_begin[next] != output_begin[next + 1] || output_link[next] != 0)
+                next |= output_flag;
+    }
+    //!\}
+
+    //!\brief The number of patterns.
+    size_t size() const noexcept { return lengths.size(); }
+
+    //!\brief The number of states of the automaton.
+    size_t states() const noexcept { return output_link.size(); }
+
+    /*!\brief Continue scanning a text that arrives in pieces.
+     * \param[in]     text   The next piece of the text; a single pass is made over it.
+     * \param[in,out] cursor The position reached so far; start with a default-constructed cursor.
+     * \param[in]     on_hit Called with a bio::search::aho_corasick_hit for every occurrence that ends in this piece;
+     *                       positions are relative to the start of the whole text.
+     */
+    template <std::ranges::input_range text_t, typename on_hit_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<text_t>, alph_t>
+    //!\endcond
+    void find(text_t && text, aho_corasick_cursor & cursor, on_hit_t && on_hit) const
+    {
+        uint32_t const * const table = transitions.data();
+        uint32_t               state = cursor.state;
+        uint64_t               i     = cursor.position;
+        for (alph_t const letter : text)
+        {
+            state = table[(state & ~output_flag) * sigma + alphabet::to_rank(letter)];
+            if (state & output_flag) [[unlikely]]
+                report(state & ~output_flag, i, on_hit);
+            ++i;
+        }
+        cursor = {state & ~output_flag, i};
+    }
+
+    /*!\brief Find all occurrences in a text.
+     * \param[in] text   The text; a single pass is made over it.
+     * \param[in] on_hit Called with a bio::search::aho_corasick_hit for every occurrence.
+     */
+    template <std::ranges::input_range text_t, typename on_hit_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<text_t>, alph_t>
+    //!\endcond
+    void find(text_t && text, on_hit_t && on_hit) const
+    {
+        aho_corasick_cursor cursor{};
+        find(text, cursor, on_hit);
+    }
+
+    //!\overload
+    template <std::ranges::input_range text_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<text_t>, alph_t>
+    //!\endcond
+    std::vector<aho_corasick_hit> find(text_t && text) const
+    {
+        std::vector<aho_corasick_hit> ret;
+        find(text, [&](aho_corasick_hit const & hit) { ret.push_back(hit); });
+        return ret;
+    }
+
+    /*!\brief Find all occurrences in each of many texts.
+     * \param[in] texts  The texts, e.g. a bio::ranges::concatenated_sequences.
+     * \param[in] on_hit Called with the index of the text and a bio::search::aho_corasick_hit for every occurrence;
+     *                   the hits of each text are in order, but hits of different texts are interleaved.
+     * \details
+     *
+     * If the transition table does not fit in the L1 cache, several texts are scanned in lockstep, so the table
+     * lookups of different texts are independent and their latencies overlap. Otherwise, the texts are scanned one
+     * after another.
+     */
+    template <std::ranges::random_access_range texts_t, typename on_hit_t>
+        //!\cond
+        requires(std::ranges::sized_range<texts_t> &&
+                 std::ranges::random_access_range<std::ranges::range_reference_t<texts_t>> &&
+                 std::ranges::sized_range<std::ranges::range_reference_t<texts_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<texts_t>>, alph_t>)
+    //!\endcond
+    void find_each(texts_t && texts, on_hit_t && on_hit) const
+    {
+        uint32_t const * const table   = transitions.data();
+        size_t const           n_texts = std::ranges::size(texts);
+        if (transitions.size() * sizeof(uint32_t) <= interleave_bytes)
+        {
+            for (size_t t = 0; t < n_texts; ++t)
+                find(texts[t], [&](aho_corasick_hit const & hit) { on_hit(t, hit); });
+            return;
+        }
+
+        for (size_t first = 0; first < n_texts; first += lanes)
+        {
+            size_t const                n = std::min(lanes, n_texts - first);
+            std::array<uint32_t, lanes> state{};
+            std::array<size_t, lanes>   length{};
+            size_t                      common = std::numeric_limits<size_t>::max();
+            for (size_t l = 0; l < n; ++l)
+            {
+                length[l] = std::ranges::size(texts[first + l]);
+                common    = std::min(common, length[l]);
+            }
+
+            // all lanes up to the shortest text, then each remaining lane on its own
+            for (size_t i = 0; i < common; ++i)
+            {
+                for (size_t l = 0; l < n; ++l)
+                {
+                    state[l] = table[(state[l] & ~output_flag) * sigma + alphabet::to_rank(texts[first + l][i])];
+                    if (state[l] & output_flag) [[unlikely]]
+                    {
+                        auto on_lane_hit = [&](aho_corasick_hit const & hit) { on_hit(first + l, hit); };
+                        report(state[l] & ~output_flag, i, on_lane_hit);
+                    }
+                }
+            }
+
+            for (size_t l = 0; l < n; ++l)
+            {
+                aho_corasick_cursor cursor{state[l] & ~output_flag, common};
+                find(texts[first + l] | std::views::drop(common),
+                     cursor,
+                     [&](aho_corasick_hit const & hit) { on_hit(first + l, hit); });
+            }
+        }
+    }
+};
+
+/*!\name Deduction guides
+ * \relates bio::search::aho_corasick
+ * \{
+ */
+//!\brief Deduce the alphabet from the patterns.
+template <std::ranges::input_range patterns_t>
+aho_corasick(patterns_t &&) -> aho_corasick<std::ranges::range_value_t<std::ranges::range_reference_t<patterns_t>>>;
+//!\}
+
+} // namespace bio::search
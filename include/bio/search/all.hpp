@@ -0,0 +1,23 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Meta-header for the \link search search module \endlink.
+ */
+
+#pragma once
+
+#include <bio/search/aho_corasick.hpp>
+#include <bio/search/iupac.hpp>
+#include <bio/search/pwm.hpp>
+#include <bio/search/shift_and.hpp>
+
+/*!\defgroup search Search
+ * \brief The search module provides kernels that find patterns in sequences.
+ *
+ * Patterns and texts are ranges over the alphabets of the alphabet module; the kernels operate on the ranks of
+ * the letters.
+ */
@@ -0,0 +1,335 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::search::base_set, bio::search::iupac_finder and bio::search::find_iupac.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <bio/alphabet/concept.hpp>
+#include <bio/alphabet/nucleotide/concept.hpp>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSSE3__)
+#    include <tmmintrin.h>
+#endif
+
+namespace bio::search
+{
+
+/*!\brief A nucleotide alphabet whose letters can be represented as bio::search::base_set.
+ * \ingroup search
+ * \details
+ *
+ * Satisfied by all nucleotide alphabets of at most 16 letters, e.g. bio::alphabet::dna4, bio::alphabet::dna5,
+ * bio::alphabet::dna15 and bio::alphabet::dna16sam (and their RNA counterparts).
+ */
+template <typename alph_t>
+concept iupac_alphabet = alphabet::nucleotide_alphabet<alph_t> && alphabet::semialphabet<alph_t> &&
+                         (alphabet::size<alph_t> <= 16);
+
+/*!\brief The set of bases (`A = 1`, `C = 2`, `G = 4`, `T`/`U = 8`) that every rank of an alphabet stands for.
+ * \ingroup search
+ * \tparam alph_t The alphabet; must satisfy bio::search::iupac_alphabet.
+ * \details
+ *
+ * The sets follow the IUPAC ambiguity codes, e.g. `R` is `A | G` and `N` is `A | C | G | T`. Letters that do not
+ * stand for a base (e.g. `=` of bio::alphabet::dna16sam) are the empty set.
+ */
+template <iupac_alphabet alph_t>
+inline constexpr std::array<uint8_t, alphabet::size<alph_t>> base_set_table = []() constexpr
+{
+    std::array<uint8_t, 256> by_char{};
+    constexpr std::pair<char, uint8_t> codes[]{
+      {'A', 0b0001}, {'C', 0b0010}, {'G', 0b0100}, {'T', 0b1000}, {'U', 0b1000}, {'R', 0b0101},
+      {'Y', 0b1010}, {'S', 0b0110}, {'W', 0b1001}, {'K', 0b1100}, {'M', 0b0011}, {'B', 0b1110},
+      {'D', 0b1101}, {'H', 0b1011}, {'V', 0b0111}, {'N', 0b1111}};
+    for (auto const & [c, set] : codes)
+        by_char[static_cast<uint8_t>(c)] = set;
+
+    std::array<uint8_t, alphabet::size<alph_t>> ret{};
+    for (size_t r = 0; r < alphabet::size<alph_t>; ++r)
+        ret[r] = by_char[static_cast<uint8_t>(alphabet::to_char(alphabet::assign_rank_to(r, alph_t{})))];
+    return ret;
+}
+();
+
+/*!\brief The set of bases a letter stands for (see bio::search::base_set_table).
+ * \ingroup search
+ */
+template <iupac_alphabet alph_t>
+constexpr uint8_t base_set(alph_t const letter) noexcept
+{
+    return base_set_table<alph_t>[alphabet::to_rank(letter)];
+}
+
+/*!\brief Options for bio::search::iupac_finder.
+ * \ingroup search
+ */
+struct iupac_options
+{
+    /*!\brief How ambiguous letters in the text are matched.
+     * \details
+     *
+     * If `false`, a text letter matches a pattern letter if their base sets overlap, so `N` in the text matches
+     * every pattern letter. If `true`, every base of the text letter must be allowed by the pattern letter, so
+     * `N` in the text only matches `N` in the pattern; use this to avoid hits in runs of `N` in a genome.
+     */
+    bool strict_text = false;
+};
+
+/*!\brief Finds all occurrences of a pattern with IUPAC ambiguity codes.
+ * \ingroup search
+ * \details
+ *
+ * Pattern and text letters are mapped to their bio::search::base_set; a pattern letter matches a text letter iff
+ * the sets overlap (or, with bio::search::iupac_options::strict_text, iff the text set is a non-empty subset of
+ * the pattern set). Pattern and text may have different alphabets, e.g. a bio::alphabet::dna15 primer can be
+ * searched in a bio::alphabet::dna5 genome.
+ *
+ * For every pattern position, a 16-entry table states which ranks of the text alphabet it matches. The text is
+ * copied to a buffer of ranks chunk by chunk; for 32 (AVX2) or 16 (SSSE3) consecutive start positions at once,
+ * every pattern position is then a single byte shuffle of its table with the shifted ranks, and the results are
+ * combined with bitwise AND. A block is abandoned as soon as none of its start positions can match, which for
+ * a typical primer happens after a few letters.
+ *
+ * To search both strands, search the reverse complement of the pattern as well (e.g. via
+ * bio::ranges::views::complement and std::views::reverse). The finder holds buffers; use one copy per thread.
+ *
+ * ### Example
+ *
+ * \include test/snippet/search/iupac.cpp
+ */
+class iupac_finder
+{
+private:
+    //!\brief The number of text letters converted at once.
+    static constexpr size_t  chunk_size    = 16384;
+    //!\brief The padding behind the ranks of a chunk; covers one vector of start positions.
+    static constexpr size_t  padding       = 32;
+    //!\brief The value of the padding; a byte shuffle returns `0` for indexes with the high bit set.
+    static constexpr uint8_t padding_value = 0x80;
+
+    //!\brief The options.
+    iupac_options                        opts{};
+    //!\brief The base sets of the pattern.
+    std::vector<uint8_t>                 pattern_sets;
+    //!\brief `tables[j][r]` is non-zero iff pattern position `j` matches a text letter of rank `r`.
+    std::vector<std::array<uint8_t, 16>> tables;
+    //!\brief The ranks of the current chunk of the text.
+    std::vector<uint8_t>                 buffer;
+
+    //!\brief Call `on_hit(offset + s)` for every start position `s < n_starts` in #buffer that matches.
+    template <typename on_hit_t>
+    void scan(size_t const n_starts, uint64_t const offset, on_hit_t & on_hit) const
+    {
+        size_t const    m   = tables.size();
+        uint8_t const * buf = buffer.data();
+        size_t          s   = 0;
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#    if defined(__AVX2__)
+        using vec_t            = __m256i;
+        constexpr size_t width = 32;
+
+        auto load_table = [](uint8_t const * ptr)
+        { return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr))); };
+        auto load     = [](uint8_t const * ptr) { return _mm256_loadu_si256(reinterpret_cast<vec_t const *>(ptr)); };
+        auto ones     = []() { return _mm256_set1_epi8(-1); };
+        auto shuffle  = [](vec_t const tbl, vec_t const idx) { return _mm256_shuffle_epi8(tbl, idx); };
+        auto and_     = [](vec_t const a, vec_t const b) { return _mm256_and_si256(a, b); };
+        auto movemask = [](vec_t const a) { return static_cast<uint32_t>(_mm256_movemask_epi8(a)); };
+#    else
+        using vec_t            = __m128i;
+        constexpr size_t width = 16;
+
+        auto load_table = [](uint8_t const * ptr) { return _mm_loadu_si128(reinterpret_cast<vec_t const *>(ptr)); };
+        auto load       = [](uint8_t const * ptr) { return _mm_loadu_si128(reinterpret_cast<vec_t const *>(ptr)); };
+        auto ones       = []() { return _mm_set1_epi8(-1); };
+        auto shuffle    = [](vec_t const tbl, vec_t const idx) { return _mm_shuffle_epi8(tbl, idx); };
+        auto and_       = [](vec_t const a, vec_t const b) { return _mm_and_si128(a, b); };
+        auto movemask   = [](vec_t const a) { return static_cast<uint32_t>(_mm_movemask_epi8(a)); };
+#    endif
+        static_assert(width <= padding);
+
+        // start positions whose window reaches into the padding never match, so whole vectors can be tested
+        for (; s < n_starts; s += width)
+        {
+            vec_t acc = ones();
+            for (size_t j = 0; j < m; ++j)
+            {
+                acc = and_(acc, shuffle(load_table(tables[j].data()), load(buf + s + j)));
+                if ((j & 0b11) == 0b11 && movemask(acc) == 0)
+                    break;
+            }
+
+            for (uint32_t hits = movemask(acc); hits != 0; hits &= hits - 1)
+                on_hit(offset + s + std::countr_zero(hits));
+        }
+#endif
+
+        for (; s < n_starts; ++s)
+        {
+            size_t j = 0;
+            while (j < m && tables[j][buf[s + j]] != 0)
+                ++j;
+            if (j == m)
+                on_hit(offset + s);
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    iupac_finder()                                 = default; //!< Defaulted.
+    iupac_finder(iupac_finder const &)             = default; //!< Defaulted.
+    iupac_finder(iupac_finder &&)                  = default; //!< Defaulted.
+    iupac_finder & operator=(iupac_finder const &) = default; //!< Defaulted.
+    iupac_finder & operator=(iupac_finder &&)      = default; //!< Defaulted.
+    ~iupac_finder()                                = default; //!< Defaulted.
+
+    /*!\brief Construct from a pattern and options.
+     * \param[in] pattern The pattern.
+     * \param[in] options The options.
+     * \throws std::invalid_argument If the pattern is empty.
+     */
+    template <std::ranges::input_range pattern_t>
+        //!\cond
+        requires iupac_alphabet<std::ranges::range_value_t<pattern_t>>
+    //!\endcond
+    explicit iupac_finder(pattern_t && pattern, iupac_options const options = {}) : opts{options}
+    {
+        for (auto const letter : pattern)
+            pattern_sets.push_back(base_set(letter));
+
+        if (pattern_sets.empty())
+            throw std::invalid_argument{"The pattern must not be empty."};
+    }
+    //!\}
+
+    //!\brief The options.
+    iupac_options const & options() const noexcept { return opts; }
+
+    //!\brief The length of the pattern.
+    size_t size() const noexcept { return pattern_sets.size(); }
+
+    /*!\brief Find all occurrences in a text.
+     * \param[in] text   The text; a single pass is made over it.
+     * \param[in] on_hit Called with the start position of every occurrence, in increasing order.
+     * \details
+     *
+     * ### Complexity
+     *
+     * `O(n * m / w)` in the worst case for a text of length `n`, a pattern of length `m` and vectors of `w` bytes;
+     * close to `O(n / w)` for patterns that rarely match.
+     */
+    template <std::ranges::input_range text_t, typename on_hit_t>
+        //!\cond
+        requires iupac_alphabet<std::ranges::range_value_t<text_t>>
+    //!\endcond
+    void find(text_t && text, on_hit_t && on_hit)
+    {
+        using text_alph_t        = std::ranges::range_value_t<text_t>;
+        constexpr auto & set_of  = base_set_table<text_alph_t>;
+        size_t const     overlap = size() - 1;
+
+        tables.assign(size(), {});
+        for (size_t j = 0; j < size(); ++j)
+        {
+            for (size_t r = 0; r < set_of.size(); ++r)
+            {
+                uint8_t const p = pattern_sets[j];
+                uint8_t const t = set_of[r]; // the empty set never matches
+                tables[j][r]    = t != 0 && (opts.strict_text ? (t & ~p) == 0 : (t & p) != 0) ? 0xFF : 0;
+            }
+        }
+
+        buffer.resize(chunk_size + overlap + padding);
+        uint64_t offset = 0; // text position of buffer[0]
+        size_t   filled = 0;
+        auto     it     = std::ranges::begin(text);
+        auto     end    = std::ranges::end(text);
+        while (true)
+        {
+            if constexpr (std::ranges::random_access_range<text_t> &&
+                          std::sized_sentinel_for<std::ranges::sentinel_t<text_t>, std::ranges::iterator_t<text_t>>)
+            {
+                size_t const n = std::min<size_t>(chunk_size + overlap - filled, end - it);
+                for (size_t k = 0; k < n; ++k) // vectorises for contiguous texts
+                    buffer[filled + k] = alphabet::to_rank(it[k]);
+                filled += n;
+                it += n;
+            }
+            else
+            {
+                for (; filled < chunk_size + overlap && it != end; ++it)
+                    buffer[filled++] = alphabet::to_rank(*it);
+            }
+
+            if (filled > overlap)
+            {
+                std::fill_n(buffer.begin() + filled, padding, padding_value);
+                scan(filled - overlap, offset, on_hit);
+            }
+
+            if (it == end)
+                break;
+
+            std::memmove(buffer.data(), buffer.data() + filled - overlap, overlap);
+            offset += filled - overlap;
+            filled = overlap;
+        }
+    }
+
+    //!\overload
+    template <std::ranges::input_range text_t>
+        //!\cond
+        requires iupac_alphabet<std::ranges::range_value_t<text_t>>
+    //!\endcond
+    std::vector<size_t> find(text_t && text)
+    {
+        std::vector<size_t> ret;
+        find(text, [&](size_t const position) { ret.push_back(position); });
+        return ret;
+    }
+};
+
+/*!\brief Find all occurrences of a pattern with IUPAC ambiguity codes in a text.
+ * \ingroup search
+ * \param[in] pattern The pattern.
+ * \param[in] text    The text.
+ * \param[in] options The options.
+ * \returns The start positions of all occurrences, in increasing order.
+ * \throws std::invalid_argument If the pattern is empty.
+ * \details
+ *
+ * Shortcut for bio::search::iupac_finder::find(); construct a bio::search::iupac_finder to search several texts.
+ */
+template <std::ranges::input_range pattern_t, std::ranges::input_range text_t>
+    //!\cond
+    requires(iupac_alphabet<std::ranges::range_value_t<pattern_t>> &&
+             iupac_alphabet<std::ranges::range_value_t<text_t>>)
+//!\endcond
+std::vector<size_t> find_iupac(pattern_t && pattern, text_t && text, iupac_options const options = {})
+{
+    return iupac_finder{pattern, options}.find(text);
+}
+
+} // namespace bio::search
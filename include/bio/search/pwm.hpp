@@ -0,0 +1,435 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::search::position_weight_matrix, bio::search::pwm_scanner and bio::search::scan_pwm.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/search/iupac.hpp>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#endif
+
+namespace bio::search
+{
+
+/*!\brief A position weight matrix (PWM) and the score that a window must reach to be reported.
+ * \ingroup search
+ * \details
+ *
+ * `scores[j][r]` is the score (usually the log-odds of the motif against the background) of the letter of
+ * bio::alphabet::dna4 rank `r` (`A`, `C`, `G`, `T`) at position `j` of the motif. The score of a window is the sum
+ * of the scores of its letters.
+ */
+struct position_weight_matrix
+{
+    //!\brief The scores of the letters at every position of the motif.
+    std::vector<std::array<float, 4>> scores;
+    //!\brief Windows with at least this score are reported.
+    float                             threshold = 0.0f;
+
+    //!\brief Defaulted.
+    friend bool operator==(position_weight_matrix const &, position_weight_matrix const &) = default;
+};
+
+/*!\brief Options for bio::search::pwm_scanner.
+ * \ingroup search
+ */
+struct pwm_options
+{
+    //!\brief Whether the reverse complement strand is scanned, too.
+    bool both_strands = true;
+};
+
+/*!\brief A window whose score reaches the threshold of a bio::search::position_weight_matrix.
+ * \ingroup search
+ */
+struct pwm_hit
+{
+    //!\brief The start position of the window in the text (also for hits on the reverse strand).
+    size_t   position = 0;
+    //!\brief The index of the matrix.
+    uint32_t motif    = 0;
+    //!\brief Whether the hit is on the reverse complement strand.
+    bool     reverse  = false;
+    //!\brief The score of the window.
+    float    score    = 0.0f;
+
+    //!\brief Defaulted.
+    friend bool operator==(pwm_hit const &, pwm_hit const &) = default;
+};
+
+/*!\brief Scores all windows of a text with many position weight matrices and reports those above a threshold.
+ * \ingroup search
+ * \details
+ *
+ * Text letters are mapped to the four bases via their bio::search::base_set; ambiguous letters (e.g. `N`) have a
+ * score of minus infinity, so windows that contain them are never reported.
+ *
+ * Every matrix is compiled into tables over pairs of letters (a superalphabet of 5 × 5 symbols, including the
+ * ambiguous one), so a window of length `m` is scored with `⌈m / 2⌉` lookups. The reverse strand is scanned
+ * with a second set of tables for the reverse complement of the matrix (reversed columns with complemented ranks),
+ * so the text is only read forwards.
+ *
+ * The text is copied to a buffer of ranks chunk by chunk, and every chunk is scanned with all matrices before the
+ * next is read, so the text is only traversed once for any number of matrices. With AVX2, eight consecutive windows
+ * are scored at once by gathering their pair scores from the table. Every four pairs, the windows are abandoned if
+ * none of them can reach the threshold with the best scores of the remaining positions.
+ *
+ * The scanner holds buffers; use one copy per thread.
+ *
+ * ### Example
+ *
+ * \include test/snippet/search/pwm.cpp
+ */
+class pwm_scanner
+{
+private:
+    //!\brief The number of text letters converted at once.
+    static constexpr size_t  chunk_size = 8192;
+    //!\brief The padding behind the ranks of a chunk; covers one vector of windows and the odd column.
+    static constexpr size_t  padding    = 16;
+    //!\brief The rank of letters that are not a single base.
+    static constexpr uint8_t ambiguous  = 4;
+    //!\brief The number of pairs of ranks (including the ambiguous one).
+    static constexpr size_t  pair_count = 25;
+
+    //!\brief A matrix (or its reverse complement) compiled for scanning.
+    struct compiled_matrix
+    {
+        //!\brief The index of the matrix.
+        uint32_t           motif     = 0;
+        //!\brief Whether this is the reverse complement.
+        bool               reverse   = false;
+        //!\brief The length of the motif.
+        size_t             length    = 0;
+        //!\brief The threshold.
+        float              threshold = 0.0f;
+        //!\brief `tables[j * 25 + 5 * a + b]` is the score of the letters `a` and `b` at positions `2j` and `2j + 1`.
+        std::vector<float> tables;
+        //!\brief Windows whose score after `j + 1` pairs is below `bounds[j]` cannot reach the threshold.
+        std::vector<float> bounds;
+    };
+
+    //!\brief The options.
+    pwm_options                  opts{};
+    //!\brief The number of matrices.
+    size_t                       n_motifs   = 0;
+    //!\brief The length of the longest matrix.
+    size_t                       max_length = 0;
+    //!\brief The compiled matrices; the reverse complement follows the forward matrix.
+    std::vector<compiled_matrix> matrices;
+    //!\brief The ranks of the current chunk of the text.
+    std::vector<uint8_t>         ranks;
+    //!\brief `pairs[i] = 5 * ranks[i] + ranks[i + 1]`.
+    std::vector<int32_t>         pairs;
+
+    //!\brief Compile the scores of a motif (already reverse complemented if need be).
+    static compiled_matrix compile(std::vector<std::array<float, 4>> const & scores, float const threshold)
+    {
+        constexpr float lowest = -std::numeric_limits<float>::infinity();
+
+        size_t const    n_pairs = (scores.size() + 1) / 2;
+        compiled_matrix ret;
+        ret.length    = scores.size();
+        ret.threshold = threshold;
+        ret.tables.assign(n_pairs * pair_count, lowest);
+        for (size_t j = 0; j < n_pairs; ++j)
+        {
+            for (size_t a = 0; a < 4; ++a)
+            {
+                for (size_t b = 0; b < 5; ++b)
+                {
+                    if (2 * j + 1 == scores.size()) // the second letter is behind the motif
+                        ret.tables[j * pair_count + 5 * a + b] = scores[2 * j][a];
+                    else if (b < 4)
+                        ret.tables[j * pair_count + 5 * a + b] = scores[2 * j][a] + scores[2 * j + 1][b];
+                }
+            }
+        }
+
+        // the best score of the remaining positions, with a margin for the rounding of the partial sums
+        double magnitude = 1.0;
+        for (std::array<float, 4> const & column : scores)
+            magnitude += std::abs(std::ranges::max(column, {}, [](float const s) { return std::abs(s); }));
+
+        std::vector<double> best_rest(n_pairs + 1, 0.0);
+        for (size_t j = n_pairs; j-- > 0;)
+        {
+            auto const first = ret.tables.begin() + j * pair_count;
+            best_rest[j]     = best_rest[j + 1] + *std::ranges::max_element(first, first + pair_count);
+        }
+        for (size_t j = 0; j < n_pairs; ++j)
+            ret.bounds.push_back(static_cast<float>(threshold - best_rest[j + 1] - 1e-4 * magnitude));
+        return ret;
+    }
+
+    //!\brief Call `on_hit` for every window `s < n_starts` in #ranks that reaches the threshold of `mat`.
+    template <typename on_hit_t>
+    void scan(compiled_matrix const & mat, size_t const n_starts, uint64_t const offset, on_hit_t & on_hit) const
+    {
+        size_t const    n_pairs = mat.bounds.size();
+        float const *   table   = mat.tables.data();
+        float const *   bound   = mat.bounds.data();
+        int32_t const * idx     = pairs.data();
+        size_t          s       = 0;
+
+        auto report = [&](size_t const start, float const score)
+        { on_hit(pwm_hit{offset + start, mat.motif, mat.reverse, score}); };
+
+#if defined(__AVX2__)
+        constexpr size_t width = 8;
+        static_assert(width + 1 <= padding);
+
+        // windows that reach into the padding score minus infinity, so whole vectors can be scored
+        __m256 const threshold = _mm256_set1_ps(mat.threshold);
+        for (; s < n_starts; s += width)
+        {
+            __m256 acc = _mm256_setzero_ps();
+            size_t j   = 0;
+            for (; j < n_pairs; ++j)
+            {
+                __m256i const pair = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(idx + s + 2 * j));
+                acc                = _mm256_add_ps(acc, _mm256_i32gather_ps(table + j * pair_count, pair, 4));
+                if ((j & 0b11) == 0b11 &&
+                    _mm256_movemask_ps(_mm256_cmp_ps(acc, _mm256_set1_ps(bound[j]), _CMP_GE_OQ)) == 0)
+                    break;
+            }
+            if (j < n_pairs)
+                continue;
+
+            alignas(32) std::array<float, width> scores;
+            _mm256_store_ps(scores.data(), acc);
+            for (uint32_t hits = _mm256_movemask_ps(_mm256_cmp_ps(acc, threshold, _CMP_GE_OQ)); hits != 0;
+                 hits &= hits - 1)
+            {
+                size_t const lane = std::countr_zero(hits);
+                if (s + lane >= n_starts)
+                    break;
+                report(s + lane, scores[lane]);
+            }
+        }
+#endif
+
+        for (; s < n_starts; ++s)
+        {
+            float  acc = 0.0f;
+            size_t j   = 0;
+            for (; j < n_pairs; ++j)
+            {
+                acc += table[j * pair_count + idx[s + 2 * j]];
+                if ((j & 0b11) == 0b11 && !(acc >= bound[j]))
+                    break;
+            }
+            if (j == n_pairs && acc >= mat.threshold)
+                report(s, acc);
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    pwm_scanner()                                = default; //!< Defaulted.
+    pwm_scanner(pwm_scanner const &)             = default; //!< Defaulted.
+    pwm_scanner(pwm_scanner &&)                  = default; //!< Defaulted.
+    pwm_scanner & operator=(pwm_scanner const &) = default; //!< Defaulted.
+    pwm_scanner & operator=(pwm_scanner &&)      = default; //!< Defaulted.
+    ~pwm_scanner()                               = default; //!< Defaulted.
+
+    /*!\brief Construct from matrices and options.
+     * \param[in] motifs  The matrices; hits report their index in this range.
+     * \param[in] options The options.
+     * \throws std::invalid_argument If a matrix is empty or has a score that is not finite.
+     */
+    template <std::ranges::input_range motifs_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<motifs_t>, position_weight_matrix>
+    //!\endcond
+    explicit pwm_scanner(motifs_t && motifs, pwm_options const options = {}) : opts{options}
+    {
+        for (position_weight_matrix const & motif : motifs)
+        {
+            if (motif.scores.empty())
+                throw std::invalid_argument{"Position weight matrices must not be empty."};
+            for (std::array<float, 4> const & column : motif.scores)
+                if (!std::ranges::all_of(column, [](float const s) { return std::isfinite(s); }))
+                    throw std::invalid_argument{"The scores of position weight matrices must be finite."};
+
+            matrices.push_back(compile(motif.scores, motif.threshold));
+            matrices.back().motif = n_motifs;
+
+            if (opts.both_strands)
+            {
+                // reverse the columns and complement the ranks
+                std::vector<std::array<float, 4>> rc(motif.scores.rbegin(), motif.scores.rend());
+                for (std::array<float, 4> & column : rc)
+                {
+                    std::array<float, 4> const forward = column;
+                    for (uint8_t r = 0; r < 4; ++r)
+                    {
+                        alphabet::dna4 const base = alphabet::assign_rank_to(r, alphabet::dna4{});
+                        column[r]                 = forward[alphabet::to_rank(alphabet::complement(base))];
+                    }
+                }
+
+                matrices.push_back(compile(rc, motif.threshold));
+                matrices.back().motif   = n_motifs;
+                matrices.back().reverse = true;
+            }
+
+            max_length = std::max(max_length, motif.scores.size());
+            ++n_motifs;
+        }
+    }
+    //!\}
+
+    //!\brief The options.
+    pwm_options const & options() const noexcept { return opts; }
+
+    //!\brief The number of matrices.
+    size_t size() const noexcept { return n_motifs; }
+
+    /*!\brief Scan a text with all matrices.
+     * \param[in] text   The text; a single pass is made over it.
+     * \param[in] on_hit Called with a bio::search::pwm_hit for every window that reaches the threshold of a matrix.
+     * \details
+     *
+     * The hits are reported chunk by chunk; within a chunk, by matrix (forward strand first) and position.
+     *
+     * ### Complexity
+     *
+     * `O(n * Σ m / 2)` in the worst case for a text of length `n` and matrices of length `m`, divided by the
+     * vector width with AVX2; much less if most windows are abandoned early, i.e. for high thresholds.
+     */
+    template <std::ranges::input_range text_t, typename on_hit_t>
+        //!\cond
+        requires iupac_alphabet<std::ranges::range_value_t<text_t>>
+    //!\endcond
+    void scan(text_t && text, on_hit_t && on_hit)
+    {
+        using text_alph_t = std::ranges::range_value_t<text_t>;
+
+        constexpr auto rank_of = []() constexpr
+        {
+            std::array<uint8_t, alphabet::size<text_alph_t>> ret{};
+            for (size_t r = 0; r < ret.size(); ++r)
+            {
+                uint8_t const set = base_set_table<text_alph_t>[r];
+                ret[r]            = std::has_single_bit(set) ? static_cast<uint8_t>(std::countr_zero(set)) : ambiguous;
+            }
+            return ret;
+        }();
+
+        if (matrices.empty())
+            return;
+
+        size_t const overlap = max_length - 1;
+        ranks.resize(chunk_size + overlap + padding);
+        pairs.resize(chunk_size + overlap + padding);
+
+        uint64_t offset = 0; // text position of ranks[0]
+        size_t   filled = 0;
+        auto     it     = std::ranges::begin(text);
+        auto     end    = std::ranges::end(text);
+        while (true)
+        {
+            if constexpr (std::ranges::random_access_range<text_t> &&
+                          std::sized_sentinel_for<std::ranges::sentinel_t<text_t>, std::ranges::iterator_t<text_t>>)
+            {
+                size_t const n = std::min<size_t>(chunk_size + overlap - filled, end - it);
+                for (size_t k = 0; k < n; ++k)
+                    ranks[filled + k] = rank_of[alphabet::to_rank(it[k])];
+                filled += n;
+                it += n;
+            }
+            else
+            {
+                for (; filled < chunk_size + overlap && it != end; ++it)
+                    ranks[filled++] = rank_of[alphabet::to_rank(*it)];
+            }
+            bool const last = it == end;
+
+            std::fill_n(ranks.begin() + filled, padding, ambiguous);
+            for (size_t i = 0; i + 1 < filled + padding; ++i)
+                pairs[i] = 5 * ranks[i] + ranks[i + 1];
+
+            // windows that start behind the overlap are scanned with the next chunk, unless this is the last one
+            for (compiled_matrix const & mat : matrices)
+            {
+                size_t const reach    = last ? mat.length - 1 : overlap;
+                size_t const n_starts = filled > reach ? filled - reach : 0;
+                scan(mat, n_starts, offset, on_hit);
+            }
+
+            if (last)
+                break;
+
+            std::memmove(ranks.data(), ranks.data() + filled - overlap, overlap);
+            offset += filled - overlap;
+            filled = overlap;
+        }
+    }
+
+    /*!\overload
+     * \returns The hits, sorted by position, matrix and strand.
+     */
+    template <std::ranges::input_range text_t>
+        //!\cond
+        requires iupac_alphabet<std::ranges::range_value_t<text_t>>
+    //!\endcond
+    std::vector<pwm_hit> scan(text_t && text)
+    {
+        std::vector<pwm_hit> ret;
+        scan(text, [&](pwm_hit const & hit) { ret.push_back(hit); });
+        std::ranges::sort(ret,
+                          [](pwm_hit const & l, pwm_hit const & r)
+                          {
+                              return l.position < r.position || (l.position == r.position && l.motif < r.motif) ||
+                                     (l.position == r.position && l.motif == r.motif && l.reverse < r.reverse);
+                          });
+        return ret;
+    }
+};
+
+/*!\brief Scan a text with position weight matrices.
+ * \ingroup search
+ * \param[in] motifs  The matrices.
+ * \param[in] text    The text.
+ * \param[in] options The options.
+ * \returns The hits, sorted by position, matrix and strand.
+ * \throws std::invalid_argument See bio::search::pwm_scanner::pwm_scanner().
+ * \details
+ *
+ * Shortcut for bio::search::pwm_scanner::scan(); construct a bio::search::pwm_scanner to scan several texts.
+ */
+template <std::ranges::input_range motifs_t, std::ranges::input_range text_t>
+    //!\cond
+    requires(std::same_as<std::ranges::range_value_t<motifs_t>, position_weight_matrix> &&
+             iupac_alphabet<std::ranges::range_value_t<text_t>>)
+//!\endcond
+std::vector<pwm_hit> scan_pwm(motifs_t && motifs, text_t && text, pwm_options const options = {})
+{
+    return pwm_scanner{motifs, options}.scan(text);
+}
+
+} // namespace bio::search
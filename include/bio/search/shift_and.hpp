@@ -0,0 +1,325 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+/*!\file
+ * \brief Provides bio::search::shift_and and bio::search::find_shift_and.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <bio/alphabet/concept.hpp>
+
+namespace bio::search
+{
+
+/*!\brief Options for bio::search::shift_and.
+ * \ingroup search
+ */
+struct shift_and_options
+{
+    //!\brief The maximum number of mismatches (substitutions) between a pattern and the text.
+    size_t max_mismatches = 0;
+};
+
+/*!\brief An occurrence found by bio::search::shift_and.
+ * \ingroup search
+ */
+struct shift_and_hit
+{
+    //!\brief The start position in the text.
+    uint64_t position   = 0;
+    //!\brief The index of the pattern.
+    uint32_t pattern    = 0;
+    //!\brief The number of mismatches.
+    uint8_t  mismatches = 0;
+
+    //!\brief Defaulted.
+    friend constexpr bool operator==(shift_and_hit const &, shift_and_hit const &) = default;
+};
+
+/*!\brief Finds all occurrences of one or more patterns with up to `k` mismatches, bit-parallel.
+ * \ingroup search
+ * \tparam alph_t The alphabet of patterns and text.
+ * \details
+ *
+ * Implements the Shift-And algorithm (Baeza-Yates and Gonnet, 1992) with the mismatch extension of Wu and Manber
+ * (1992). Every pattern letter is one bit of a state vector; for every rank of the alphabet, a mask marks the
+ * pattern positions that hold this rank. Each text letter then updates the state with a shift, an OR and an AND
+ * per machine word and per allowed mismatch, independent of the pattern length.
+ *
+ * Several patterns are packed into the same state vector one after another: the first bit of every pattern is
+ * set on every shift, so no separator bits are needed and a single pass over the text searches all patterns at
+ * once. A pattern of up to 64 letters fits in one machine word (with the fastest code path if it is the only
+ * pattern); longer patterns and batches span several words, with carries between them.
+ *
+ * The text can be any input range over `alph_t`, including bio::ranges::bitcompressed_vector and views; only the
+ * ranks of its letters are used. Hits are reported in order of their end position, then by pattern.
+ *
+ * ### Complexity
+ *
+ * `O(n * (k + 1) * ceil(M / 64))` for a text of length `n`, `k` mismatches and patterns of total length `M`.
+ *
+ * ### Example
+ *
+ * \include test/snippet/search/shift_and.cpp
+ */
+template <alphabet::semialphabet alph_t>
+class shift_and
+{
+private:
+    //!\brief The options.
+    shift_and_options     opts{};
+    //!\brief The number of machine words per state vector.
+    size_t                words = 0;
+    //!\brief The length of every pattern.
+    std::vector<uint32_t> lengths;
+    //!\brief `masks[r * words + w]` marks the pattern positions with rank `r` in word `w`.
+    std::vector<uint64_t> masks;
+    //!\brief The first bit of every pattern.
+    std::vector<uint64_t> starts;
+    //!\brief The last bit of every pattern.
+    std::vector<uint64_t> accepts;
+    //!\brief The pattern whose last bit is at a bit position.
+    std::vector<uint32_t> pattern_of_bit;
+    //!\brief The states for #find(), one vector per number of mismatches.
+    std::vector<uint64_t> states;
+
+    //!\brief Report the hits whose last letter is at `i` in the text; `state(d)` points to the words of `d`.
+    template <typename state_t, typename on_hit_t>
+    void report(uint64_t const i, state_t && state, on_hit_t & on_hit) const
+    {
+        size_t const k = opts.max_mismatches;
+        for (size_t w = 0; w < words; ++w)
+        {
+            for (uint64_t bits = state(k)[w] & accepts[w]; bits != 0; bits &= bits - 1)
+            {
+                uint64_t const bit = bits & -bits;
+                size_t         d   = 0;
+                while ((state(d)[w] & bit) == 0)
+                    ++d;
+
+                uint32_t const p = pattern_of_bit[w * 64 + std::countr_zero(bits)];
+                on_hit(shift_and_hit{i + 1 - lengths[p], p, static_cast<uint8_t>(d)});
+            }
+        }
+    }
+
+    //!\brief #find() for a single state word and `k` mismatches, with the states in registers.
+    template <size_t k, typename text_t, typename on_hit_t>
+    void find_single_word(text_t && text, on_hit_t & on_hit) const
+    {
+        std::array<uint64_t, k + 1> state{};
+        auto                        state_of = [&](size_t const d) { return state.data() + d; };
+        uint64_t const              start    = starts[0];
+        uint64_t const              accept   = accepts[0];
+
+        uint64_t i = 0;
+        for (alph_t const letter : text)
+        {
+            uint64_t const mask = masks[alphabet::to_rank(letter)];
+            // from k down so that state[d - 1] is still the previous one
+            for (size_t d = k; d > 0; --d)
+                state[d] = (((state[d] << 1) | start) & mask) | (state[d - 1] << 1) | start;
+            state[0] = ((state[0] << 1) | start) & mask;
+
+            if ((state[k] & accept) != 0) [[unlikely]]
+                report(i, state_of, on_hit);
+            ++i;
+        }
+    }
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    shift_and()                              = default; //!< Defaulted.
+    shift_and(shift_and const &)             = default; //!< Defaulted.
+    shift_and(shift_and &&)                  = default; //!< Defaulted.
+    shift_and & operator=(shift_and const &) = default; //!< Defaulted.
+    shift_and & operator=(shift_and &&)      = default; //!< Defaulted.
+    ~shift_and()                             = default; //!< Defaulted.
+
+    /*!\brief Construct from patterns and options.
+     * \param[in] patterns The patterns, e.g. a bio::ranges::concatenated_sequences; their position is the index
+     *                     reported by bio::search::shift_and_hit.
+     * \param[in] options  The options.
+     * \throws std::invalid_argument If there are no patterns, a pattern is empty or allows more than 255 mismatches.
+     */
+    template <std::ranges::input_range patterns_t>
+        //!\cond
+        requires(std::ranges::input_range<std::ranges::range_reference_t<patterns_t>> &&
+                 std::same_as<std::ranges::range_value_t<std::ranges::range_reference_t<patterns_t>>, alph_t>)
+    //!\endcond
+    explicit shift_and(patterns_t && patterns, shift_and_options const options = {}) : opts{options}
+    {
+        if (opts.max_mismatches > 255)
+            throw std::invalid_argument{"At most 255 mismatches are supported."};
+
+        std::vector<alphabet::rank_t<alph_t>> ranks;
+        for (auto && pattern : patterns)
+        {
+            size_t const first = ranks.size();
+            for (alph_t const letter : pattern)
+                ranks.push_back(alphabet::to_rank(letter));
+            if (ranks.size() == first)
+                throw std::invalid_argument{"Patterns must not be empty."};
+            lengths.push_back(ranks.size() - first);
+        }
+        if (lengths.empty())
+            throw std::invalid_argument{"At least one pattern is required."};
+
+        words = (ranks.size() + 63) / 64;
+        masks.assign(alphabet::size<alph_t> * words, 0);
+        starts.assign(words, 0);
+        accepts.assign(words, 0);
+        pattern_of_bit.assign(words * 64, 0);
+
+        size_t bit = 0;
+        for (uint32_t p = 0; p < lengths.size(); ++p)
+        {
+            starts[bit / 64] |= uint64_t{1} << (bit % 64);
+            for (size_t j = 0; j < lengths[p]; ++j, ++bit)
+                masks[ranks[bit] * words + bit / 64] |= uint64_t{1} << (bit % 64);
+            accepts[(bit - 1) / 64] |= uint64_t{1} << ((bit - 1) % 64);
+            pattern_of_bit[bit - 1] = p;
+        }
+    }
+    //!\}
+
+    //!\brief The options.
+    shift_and_options const & options() const noexcept { return opts; }
+
+    //!\brief The number of patterns.
+    size_t size() const noexcept { return lengths.size(); }
+
+    //!\brief The number of machine words per state vector.
+    size_t state_words() const noexcept { return words; }
+
+    /*!\brief Find all occurrences in a text.
+     * \param[in] text   The text; a single pass is made over it.
+     * \param[in] on_hit Called with a bio::search::shift_and_hit for every occurrence.
+     */
+    template <std::ranges::input_range text_t, typename on_hit_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<text_t>, alph_t>
+    //!\endcond
+    void find(text_t && text, on_hit_t && on_hit)
+    {
+        if (words == 1)
+        {
+            switch (opts.max_mismatches)
+            {
+                case 0:
+                    return find_single_word<0>(text, on_hit);
+                case 1:
+                    return find_single_word<1>(text, on_hit);
+                case 2:
+                    return find_single_word<2>(text, on_hit);
+                case 3:
+                    return find_single_word<3>(text, on_hit);
+                default:
+                    break;
+            }
+        }
+
+        // local copies: stores to the states could otherwise alias the (equally typed) members
+        size_t const           k        = opts.max_mismatches;
+        size_t const           n        = words;
+        uint64_t const * const start    = starts.data();
+        uint64_t const * const accept   = accepts.data();
+        states.assign((k + 1) * n, 0);
+        uint64_t * const       state    = states.data();
+        auto                   state_of = [&](size_t const d) { return state + d * n; };
+
+        uint64_t i = 0;
+        for (alph_t const letter : text)
+        {
+            uint64_t const * const mask = masks.data() + alphabet::to_rank(letter) * n;
+            // from k down so that the state of d - 1 is still the previous one, and from the last word down so that
+            // the carry comes from the previous state of the lower word
+            for (size_t d = k; d > 0; --d)
+            {
+                uint64_t * const       cur  = state_of(d);
+                uint64_t const * const prev = state_of(d - 1);
+                for (size_t w = n - 1; w > 0; --w)
+                {
+                    cur[w] = (((cur[w] << 1) | (cur[w - 1] >> 63) | start[w]) & mask[w]) | (prev[w] << 1) |
+                             (prev[w - 1] >> 63) | start[w];
+                }
+                cur[0] = (((cur[0] << 1) | start[0]) & mask[0]) | (prev[0] << 1) | start[0];
+            }
+            for (size_t w = n - 1; w > 0; --w)
+                state[w] = ((state[w] << 1) | (state[w - 1] >> 63) | start[w]) & mask[w];
+            state[0] = ((state[0] << 1) | start[0]) & mask[0];
+
+            uint64_t any = 0;
+            for (size_t w = 0; w < n; ++w)
+                any |= state_of(k)[w] & accept[w];
+            if (any != 0) [[unlikely]]
+                report(i, state_of, on_hit);
+            ++i;
+        }
+    }
+
+    //!\overload
+    template <std::ranges::input_range text_t>
+        //!\cond
+        requires std::same_as<std::ranges::range_value_t<text_t>, alph_t>
+    //!\endcond
+    std::vector<shift_and_hit> find(text_t && text)
+    {
+        std::vector<shift_and_hit> ret;
+        find(text, [&](shift_and_hit const & hit) { ret.push_back(hit); });
+        return ret;
+    }
+};
+
+/*!\name Deduction guides
+ * \relates bio::search::shift_and
+ * \{
+ */
+//!\brief Deduce the alphabet from the patterns.
+template <std::ranges::input_range patterns_t>
+shift_and(patterns_t &&, shift_and_options = {})
+  -> shift_and<std::ranges::range_value_t<std::ranges::range_reference_t<patterns_t>>>;
+//!\}
+
+/*!\brief Find all occurrences of a pattern with up to `k` mismatches in a text.
+ * \ingroup search
+ * \param[in] pattern The pattern.
+ * \param[in] text    The text.
+ * \param[in] options The options.
+ * \returns The occurrences, in order of their end position.
+ * \throws std::invalid_argument If the pattern is empty.
+ * \details
+ *
+ * Shortcut for bio::search::shift_and::find() with a single pattern; construct a bio::search::shift_and to search
+ * several patterns at once or several texts.
+ */
+template <std::ranges::forward_range pattern_t, std::ranges::input_range text_t>
+    //!\cond
+    requires(alphabet::semialphabet<std::ranges::range_value_t<pattern_t>> &&
+             std::same_as<std::ranges::range_value_t<text_t>, std::ranges::range_value_t<pattern_t>>)
+//!\endcond
+std::vector<shift_and_hit> find_shift_and(pattern_t && pattern, text_t && text, shift_and_options const options = {})
+{
+    using alph_t = std::ranges::range_value_t<pattern_t>;
+
+    std::vector<std::vector<alph_t>> patterns(1);
+    std::ranges::copy(pattern, std::back_inserter(patterns[0]));
+    return shift_and{patterns, options}.find(text);
+}
+
+} // namespace bio::search
@@ -0,0 +1,127 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alignment/chain.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using bio::alignment::anchor;
+
+// ============================================================================
+//  data
+// ============================================================================
+
+// the anchors of a long read: a colinear run with small indels and uniformly distributed noise
+std::vector<anchor> make_anchors(size_t const colinear, size_t const noise, uint64_t const seed)
+{
+    std::mt19937_64     gen{seed};
+    std::vector<anchor> ret;
+    uint32_t            q = 0;
+    uint32_t            t = 1'000'000;
+    for (size_t i = 0; i < colinear; ++i)
+    {
+        ret.push_back({q, t, 15});
+        uint32_t const step = 5 + gen() % 10;
+        q += step;
+        t += step + (i % 20 == 19 ? 3 : 0);
+    }
+    uint32_t const span = q + 1;
+    for (size_t i = 0; i < noise; ++i)
+        ret.push_back({static_cast<uint32_t>(gen() % span), static_cast<uint32_t>(1'000'000 + gen() % span), 15});
+    std::ranges::shuffle(ret, gen);
+    return ret;
+}
+
+// ============================================================================
+//  single read
+// ============================================================================
+
+// the textbook DP over all predecessors, with log2 computed in the inner loop
+void naive(benchmark::State & state)
+{
+    size_t const                           n       = state.range(0);
+    std::vector<anchor>                    anchors = make_anchors(n * 3 / 4, n / 4, 1);
+    bio::alignment::chaining_options const o{};
+    std::ranges::sort(anchors,
+                      [](anchor const & l, anchor const & r)
+                      { return l.target < r.target || (l.target == r.target && l.query < r.query); });
+
+    std::vector<int32_t> f(n);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            anchor const & a = anchors[i];
+            f[i]             = a.length;
+            for (size_t j = 0; j < i; ++j)
+            {
+                anchor const & b = anchors[j];
+                if (b.target >= a.target || b.query >= a.query)
+                    continue;
+                int64_t const dt = a.target - b.target, dq = a.query - b.query;
+                int64_t const l  = std::abs(dq - dt);
+                if (dt > o.max_distance || dq > o.max_distance || l > o.max_skew)
+                    continue;
+                int32_t const cost = l == 0 ? 0 : static_cast<int32_t>(o.gap_cost * l / 100.0 + 0.5 * std::log2(l));
+                int32_t const gain = static_cast<int32_t>(std::min<int64_t>({dq, dt, a.length}));
+                f[i]               = std::max(f[i], f[j] + gain - cost);
+            }
+        }
+        benchmark::DoNotOptimize(f.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(naive)->Arg(1'000)->Arg(10'000);
+
+template <bio::alignment::chaining_mode mode>
+void chainer(benchmark::State & state)
+{
+    size_t const              n       = state.range(0);
+    std::vector<anchor> const anchors = make_anchors(n * 3 / 4, n / 4, 1);
+    bio::alignment::chainer   c{{.mode = mode}};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(c.run(anchors).data());
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(chainer, bio::alignment::chaining_mode::lookback)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK_TEMPLATE(chainer, bio::alignment::chaining_mode::range_max)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+
+// ============================================================================
+//  many reads
+// ============================================================================
+
+void chain_all(benchmark::State & state)
+{
+    size_t const threads = state.range(0);
+
+    bio::ranges::concatenated_sequences<std::vector<anchor>> lists;
+    for (size_t i = 0; i < 1'000; ++i)
+        lists.push_back(make_anchors(1'500, 500, i));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bio::alignment::chain_all(lists, {.threads = threads}));
+
+    state.SetItemsProcessed(state.iterations() * lists.concat_size());
+}
+
+BENCHMARK(chain_all)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alignment/coverage.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+static constexpr size_t ref_len  = 10'000'000;
+static constexpr size_t n_reads  = 1'000'000;
+static constexpr size_t read_len = 150;
+
+struct alignments
+{
+    std::vector<uint64_t>                                                  positions;
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::cigar>> cigars;
+};
+
+// 150bp reads at 15x coverage; every tenth read has a deletion, every twentieth is spliced
+static alignments const & data()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                          gen{42};
+        std::uniform_int_distribution<size_t> position{0, ref_len - 1};
+
+        alignments ret;
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            ret.positions.push_back(position(gen));
+            if (i % 20 == 0)
+                ret.cigars.push_back(std::vector<bio::alphabet::cigar>{{70, 'M'_cigar_op},
+                                                                       {500, 'N'_cigar_op},
+                                                                       {80, 'M'_cigar_op}});
+            else if (i % 10 == 0)
+                ret.cigars.push_back(std::vector<bio::alphabet::cigar>{{5, 'S'_cigar_op},
+                                                                       {60, 'M'_cigar_op},
+                                                                       {2, 'D'_cigar_op},
+                                                                       {85, 'M'_cigar_op}});
+            else
+                ret.cigars.push_back(std::vector<bio::alphabet::cigar>{{read_len, 'M'_cigar_op}});
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+void coverage(benchmark::State & state)
+{
+    data();
+    bio::alignment::coverage cov{ref_len, {.threads = static_cast<size_t>(state.range(0))}};
+
+    for (auto _ : state)
+    {
+        cov.clear();
+        cov.add_all(data().positions, data().cigars);
+        bio::alignment::coverage_track const track = cov.track();
+        benchmark::DoNotOptimize(track.max_depth());
+    }
+
+    state.counters["alignments/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(coverage)->Arg(1)->Arg(4);
+
+// increment every covered position
+void naive_coverage(benchmark::State & state)
+{
+    data();
+    std::vector<uint32_t> depths(ref_len);
+
+    for (auto _ : state)
+    {
+        std::ranges::fill(depths, 0);
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            uint64_t ref = data().positions[i];
+            for (auto const c : data().cigars[i])
+            {
+                char const op = get<1>(c).to_char();
+                if (op == 'M' || op == 'D')
+                    for (uint32_t j = 0; j < get<0>(c) && ref + j < ref_len; ++j)
+                        ++depths[ref + j];
+                if (op == 'M' || op == 'D' || op == 'N')
+                    ref += get<0>(c);
+            }
+        }
+        benchmark::DoNotOptimize(std::ranges::max(depths));
+    }
+
+    state.counters["alignments/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive_coverage);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alignment/msa_profile.hpp>
+#include <bio/alphabet/gap/gapped.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using gapped_dna5 = bio::alphabet::gapped<bio::alphabet::dna5>;
+using msa_t       = bio::ranges::concatenated_sequences<std::vector<gapped_dna5>>;
+
+static constexpr size_t n_rows = 1'000;
+static constexpr size_t n_cols = 10'000;
+
+static msa_t const & msa()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                       gen{42};
+        std::uniform_int_distribution<int> rank{0, 5};
+
+        msa_t                    ret;
+        std::vector<gapped_dna5> row(n_cols);
+        for (size_t i = 0; i < n_rows; ++i)
+        {
+            for (auto & l : row)
+                l.assign_rank(rank(gen));
+            ret.push_back(row);
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+void msa_profile(benchmark::State & state)
+{
+    for (auto _ : state)
+    {
+        bio::alignment::msa_profile profile{msa(), {.threads = static_cast<size_t>(state.range(0))}};
+        benchmark::DoNotOptimize(profile.counts(0).data());
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(n_rows * n_cols, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(msa_profile)->Arg(1)->Arg(2)->UseRealTime();
+
+// column by column, row by row
+void naive_column_counts(benchmark::State & state)
+{
+    std::vector<uint32_t> counts(n_cols * 6);
+
+    for (auto _ : state)
+    {
+        std::ranges::fill(counts, 0);
+        for (size_t c = 0; c < n_cols; ++c)
+            for (size_t r = 0; r < n_rows; ++r)
+                ++counts[c * 6 + msa()[r][c].to_rank()];
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(n_rows * n_cols, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive_column_counts);
+
+// row by row, incrementing the counts of every column
+void row_major_counts(benchmark::State & state)
+{
+    std::vector<uint32_t> counts(n_cols * 6);
+
+    for (auto _ : state)
+    {
+        std::ranges::fill(counts, 0);
+        for (size_t r = 0; r < n_rows; ++r)
+        {
+            auto const row = msa()[r];
+            for (size_t c = 0; c < n_cols; ++c)
+                ++counts[c * 6 + row[c].to_rank()];
+        }
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(n_rows * n_cols, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(row_major_counts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alignment/pileup.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+
+using namespace bio::alphabet::literals;
+
+using record_t = bio::alignment::pileup_record<std::vector<bio::alphabet::cigar>,
+                                               std::vector<bio::alphabet::dna5>,
+                                               std::vector<bio::alphabet::phred42>>;
+
+static constexpr size_t n_reads  = 100'000;
+static constexpr size_t read_len = 150;
+
+// 150bp reads at 30x coverage; every tenth read has a deletion and an insertion
+static std::vector<record_t> const & records()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                       gen{42};
+        std::uniform_int_distribution<int> letter{0, 3};
+        std::uniform_int_distribution<int> phred{2, 41};
+
+        std::vector<record_t> ret;
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            record_t r{i * read_len / 30};
+            if (i % 10 == 0)
+                r.cigar = {{60, 'M'_cigar_op},
+                           {2, 'D'_cigar_op},
+                           {50, 'M'_cigar_op},
+                           {3, 'I'_cigar_op},
+                           {37, 'M'_cigar_op}};
+            else
+                r.cigar = {{read_len, 'M'_cigar_op}};
+            for (size_t j = 0; j < read_len; ++j)
+            {
+                r.sequence.push_back(bio::alphabet::dna5{}.assign_rank(letter(gen) == 3 ? 4 : letter(gen)));
+                r.qualities.push_back(bio::alphabet::phred42{}.assign_phred(phred(gen)));
+            }
+            ret.push_back(std::move(r));
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+void pileup(benchmark::State & state)
+{
+    records();
+    bio::alignment::pileup p{{.min_quality = 10}};
+    uint64_t               depth = 0;
+    auto                   emit  = [&](bio::alignment::pileup_column const & col) { depth += col.depth(); };
+
+    for (auto _ : state)
+    {
+        for (record_t const & r : records())
+            p.add(r, emit);
+        p.finish(emit);
+        benchmark::DoNotOptimize(depth);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(pileup);
+
+// an ordered map of columns, emitted when passed
+void map_pileup(benchmark::State & state)
+{
+    records();
+    uint64_t depth = 0;
+
+    for (auto _ : state)
+    {
+        std::map<uint64_t, bio::alignment::pileup_column> columns;
+        for (record_t const & r : records())
+        {
+            while (!columns.empty() && columns.begin()->first < r.position)
+            {
+                depth += columns.begin()->second.depth();
+                columns.erase(columns.begin());
+            }
+
+            uint64_t ref = r.position;
+            size_t   q   = 0;
+            for (auto const c : r.cigar)
+            {
+                char const op = get<1>(c).to_char();
+                if (op == 'I')
+                {
+                    ++columns[ref].insertions;
+                    q += get<0>(c);
+                    continue;
+                }
+                for (uint32_t i = 0; i < get<0>(c); ++i, ++ref)
+                {
+                    auto & col = columns[ref];
+                    if (op == 'D')
+                    {
+                        ++col.deletions;
+                    }
+                    else if (r.qualities[q].to_phred() >= 10)
+                    {
+                        ++col.counts[r.sequence[q].to_rank()];
+                        col.quality_sums[r.sequence[q].to_rank()] += r.qualities[q].to_phred();
+                        ++q;
+                    }
+                    else
+                    {
+                        ++q;
+                    }
+                }
+            }
+        }
+        for (auto const & [p, col] : columns)
+            depth += col.depth();
+        benchmark::DoNotOptimize(depth);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(map_pileup);
+
+BENCHMARK_MAIN();
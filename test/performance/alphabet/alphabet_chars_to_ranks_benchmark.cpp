@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/all.hpp>
+#include <bio/alphabet/lookup_tables.hpp>
+
+static constexpr size_t seq_len = 1'000'000;
+
+template <typename alphabet_t>
+std::string random_valid_chars()
+{
+    std::string valid;
+    for (size_t i = 0; i < 256; ++i)
+        if (bio::alphabet::char_is_valid_for<alphabet_t>(static_cast<char>(i)))
+            valid.push_back(static_cast<char>(i));
+
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<size_t> dis{0, valid.size() - 1};
+    std::string                           ret(seq_len, ' ');
+    for (char & c : ret)
+        c = valid[dis(gen)];
+    return ret;
+}
+
+// scalar: validate and convert every character on its own
+template <typename alphabet_t>
+void assign_char_strictly(benchmark::State & state)
+{
+    std::string const       in = random_valid_chars<alphabet_t>();
+    std::vector<alphabet_t> out(in.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < in.size(); ++i)
+            bio::alphabet::assign_char_strictly_to(in[i], out[i]);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["bytes_per_second"] = benchmark::Counter(in.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// bulk: bio::alphabet::chars_to_ranks
+template <typename alphabet_t>
+void chars_to_ranks(benchmark::State & state)
+{
+    std::string const    in = random_valid_chars<alphabet_t>();
+    std::vector<uint8_t> out(in.size());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bio::alphabet::chars_to_ranks<alphabet_t>(in, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["bytes_per_second"] = benchmark::Counter(in.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(assign_char_strictly, bio::alphabet::dna4);
+BENCHMARK_TEMPLATE(chars_to_ranks, bio::alphabet::dna4);
+BENCHMARK_TEMPLATE(assign_char_strictly, bio::alphabet::dna15);
+BENCHMARK_TEMPLATE(chars_to_ranks, bio::alphabet::dna15);
+BENCHMARK_TEMPLATE(assign_char_strictly, bio::alphabet::aa27);
+BENCHMARK_TEMPLATE(chars_to_ranks, bio::alphabet::aa27);
+BENCHMARK_TEMPLATE(assign_char_strictly, bio::alphabet::phred42);
+BENCHMARK_TEMPLATE(chars_to_ranks, bio::alphabet::phred42);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/de_bruijn_graph.hpp>
+
+// ============================================================================
+//  data
+// ============================================================================
+
+// the canonical 31-mers of a random genome of 2 Mbp
+std::vector<uint64_t> const & kmers()
+{
+    static std::vector<uint64_t> const ret = []()
+    {
+        std::mt19937_64            gen{42};
+        bio::alphabet::dna4_vector genome(2'000'000);
+        for (auto & l : genome)
+            l.assign_rank(gen() % 4);
+
+        std::vector<uint64_t> codes;
+        bio::kmer::kmer_codes(genome, {.k = 31}, codes);
+        std::ranges::shuffle(codes, gen);
+        return codes;
+    }();
+    return ret;
+}
+
+// ============================================================================
+//  construction and compaction
+// ============================================================================
+
+void construction(benchmark::State & state)
+{
+    size_t const threads = state.range(0);
+    for (auto _ : state)
+    {
+        bio::kmer::de_bruijn_graph const graph{kmers(), {.k = 31, .threads = threads}};
+        benchmark::DoNotOptimize(graph.edge_masks().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * kmers().size());
+}
+
+BENCHMARK(construction)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+void unitigs(benchmark::State & state)
+{
+    size_t const                     threads = state.range(0);
+    bio::kmer::de_bruijn_graph const graph{kmers(), {.k = 31, .threads = threads}};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(graph.unitigs());
+
+    state.SetItemsProcessed(state.iterations() * graph.size());
+}
+
+BENCHMARK(unitigs)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// ============================================================================
+//  lookup
+// ============================================================================
+
+enum class tag
+{
+    unordered_set,
+    sorted_array,
+    de_bruijn_graph
+};
+
+template <tag t>
+void lookup(benchmark::State & state)
+{
+    std::vector<uint64_t> const & codes = kmers();
+
+    // half of the queries are in the graph
+    std::mt19937_64       gen{7};
+    std::vector<uint64_t> queries(1 << 16);
+    for (size_t i = 0; i < queries.size(); ++i)
+        queries[i] = i % 2 ? codes[gen() % codes.size()] : bio::kmer::canonical(gen() >> 2, 31);
+
+    std::unordered_set<uint64_t> const set{codes.begin(), codes.end()};
+    std::vector<uint64_t>              sorted = codes;
+    std::ranges::sort(sorted);
+    bio::kmer::de_bruijn_graph const graph{codes, {.k = 31}};
+
+    size_t found = 0;
+    for (auto _ : state)
+    {
+        for (uint64_t const q : queries)
+        {
+            if constexpr (t == tag::unordered_set)
+                found += set.contains(q);
+            else if constexpr (t == tag::sorted_array)
+                found += std::ranges::binary_search(sorted, q);
+            else
+                found += graph.contains(q);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_TEMPLATE(lookup, tag::unordered_set);
+BENCHMARK_TEMPLATE(lookup, tag::sorted_array);
+BENCHMARK_TEMPLATE(lookup, tag::de_bruijn_graph);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/kmer/distance_matrix.hpp>
+#include <bio/ranges/views/pairwise_combine.hpp>
+
+// ============================================================================
+//  data
+// ============================================================================
+
+// 300 bottom-k sketches of size 1000 that share between 0 and 100% of their hash values
+std::vector<bio::kmer::minhash_sketch> const & sketches()
+{
+    static std::vector<bio::kmer::minhash_sketch> const ret = []()
+    {
+        std::mt19937_64       gen{42};
+        std::vector<uint64_t> common(10'000);
+        for (uint64_t & h : common)
+            h = gen();
+
+        std::vector<bio::kmer::minhash_sketch> sketches;
+        for (size_t i = 0; i < 300; ++i)
+        {
+            bio::kmer::minhash_sketcher sketcher{{.k = 21, .sketch_size = 1'000}};
+            std::vector<uint64_t>       hashes = common;
+            for (uint64_t & h : hashes)
+                if (gen() % 300 < i)
+                    h = gen();
+            sketcher.add_hashes(hashes);
+            sketches.push_back(sketcher.sketch());
+        }
+        return sketches;
+    }();
+    return ret;
+}
+
+// ============================================================================
+//  all pairs
+// ============================================================================
+
+void pairwise_combine(benchmark::State & state)
+{
+    auto const &       input = sketches();
+    std::vector<float> out;
+    for (auto _ : state)
+    {
+        out.clear();
+        for (auto && [lhs, rhs] : input | bio::views::pairwise_combine)
+            out.push_back(static_cast<float>(bio::kmer::mash_distance(lhs, rhs)));
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+BENCHMARK(pairwise_combine);
+
+void all_vs_all(benchmark::State & state)
+{
+    auto const & input   = sketches();
+    size_t const threads = state.range(0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bio::kmer::all_vs_all(input, {.threads = threads}));
+
+    state.SetItemsProcessed(state.iterations() * input.size() * (input.size() - 1) / 2);
+}
+
+BENCHMARK(all_vs_all)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+void all_vs_all_sparse(benchmark::State & state)
+{
+    auto const & input = sketches();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(bio::kmer::all_vs_all_sparse(input, {.max_distance = 0.05}));
+
+    state.SetItemsProcessed(state.iterations() * input.size() * (input.size() - 1) / 2);
+}
+
+BENCHMARK(all_vs_all_sparse);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/error_corrector.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+// ============================================================================
+//  data
+// ============================================================================
+
+constexpr uint8_t k = 25;
+
+struct data
+{
+    std::unordered_set<uint64_t>                                    solid;
+    // 10000 reads of length 150 from a genome of 200 kbp with one substitution each
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> reads;
+};
+
+data const & get_data()
+{
+    static data const ret = []()
+    {
+        std::mt19937_64            gen{42};
+        data                       d;
+        bio::alphabet::dna5_vector genome(200'000);
+        for (auto & l : genome)
+            l.assign_char("ACGT"[gen() % 4]);
+        bio::kmer::for_each_kmer(genome, {.k = k}, [&](size_t, uint64_t const code) { d.solid.insert(code); });
+
+        for (size_t i = 0; i < 10'000; ++i)
+        {
+            size_t const               start = gen() % (genome.size() - 150);
+            bio::alphabet::dna5_vector read{genome.begin() + start, genome.begin() + start + 150};
+            size_t const               p = gen() % 150;
+            read[p].assign_char(read[p].to_char() == 'A' ? 'C' : 'A');
+            d.reads.push_back(read);
+        }
+        return d;
+    }();
+    return ret;
+}
+
+// ============================================================================
+//  correction
+// ============================================================================
+
+// the naive approach: substitute every letter of the read in turn and recompute the codes of the covering k-mers
+size_t correct_by_rehashing(bio::alphabet::dna5_vector & read, std::unordered_set<uint64_t> const & solid)
+{
+    auto all_solid = [&](size_t const first, size_t const last)
+    {
+        bool ret = true;
+        bio::kmer::for_each_kmer(std::span{read}.subspan(first, last - first),
+                                 {.k = k},
+                                 [&](size_t, uint64_t const code) { ret = ret && solid.contains(code); });
+        return ret;
+    };
+
+    if (all_solid(0, read.size()))
+        return 0;
+
+    for (size_t p = 0; p < read.size(); ++p)
+    {
+        size_t const              first = p + 1 >= k ? p + 1 - k : 0;
+        size_t const              last  = std::min(p + k, read.size());
+        bio::alphabet::dna5 const old   = read[p];
+        for (char const c : {'A', 'C', 'G', 'T'})
+        {
+            read[p].assign_char(c);
+            if (read[p] != old && all_solid(first, last))
+                return 1;
+        }
+        read[p] = old;
+    }
+    return 0;
+}
+
+void rehashing(benchmark::State & state)
+{
+    auto const & d         = get_data();
+    size_t       corrected = 0;
+
+    for (auto _ : state)
+    {
+        for (auto && read : d.reads)
+        {
+            bio::alphabet::dna5_vector copy{read.begin(), read.end()};
+            corrected += correct_by_rehashing(copy, d.solid);
+        }
+        benchmark::DoNotOptimize(corrected);
+    }
+
+    state.SetItemsProcessed(state.iterations() * d.reads.size());
+}
+
+BENCHMARK(rehashing);
+
+void incremental(benchmark::State & state)
+{
+    auto const &               d = get_data();
+    bio::kmer::error_corrector corrector{d.solid, {.k = k, .threads = static_cast<size_t>(state.range(0))}};
+
+    for (auto _ : state)
+    {
+        auto reads = d.reads;
+        benchmark::DoNotOptimize(corrector.correct_all(reads));
+    }
+
+    state.SetItemsProcessed(state.iterations() * d.reads.size());
+}
+
+BENCHMARK(incremental)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/hyperloglog.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+// ============================================================================
+//  distinct k-mers of reads
+// ============================================================================
+
+enum class tag
+{
+    unordered_set,
+    sort_unique,
+    hyperloglog
+};
+
+// 20000 reads of length 150 (3 Mbp)
+bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const & reads()
+{
+    static bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const ret = []()
+    {
+        std::mt19937_64                                                  gen{42};
+        bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> seqs;
+        bio::alphabet::dna5_vector                                       read(150);
+        for (size_t i = 0; i < 20'000; ++i)
+        {
+            for (auto & l : read)
+                l = bio::alphabet::assign_rank_to(gen() % 4, bio::alphabet::dna5{});
+            seqs.push_back(read);
+        }
+        return seqs;
+    }();
+    return ret;
+}
+
+template <tag t>
+void distinct_kmers(benchmark::State & state)
+{
+    auto const & seqs     = reads();
+    double       distinct = 0;
+
+    for (auto _ : state)
+    {
+        if constexpr (t == tag::unordered_set)
+        {
+            std::unordered_set<uint64_t> codes;
+            for (auto const & read : seqs)
+                bio::kmer::for_each_kmer(read, {.k = 21}, [&](size_t, uint64_t const code) { codes.insert(code); });
+            distinct = codes.size();
+        }
+        else if constexpr (t == tag::sort_unique)
+        {
+            std::vector<uint64_t> codes;
+            for (auto const & read : seqs)
+                bio::kmer::kmer_codes(read, {.k = 21}, codes);
+            std::ranges::sort(codes);
+            distinct = std::ranges::distance(codes.begin(), std::ranges::unique(codes).begin());
+        }
+        else
+        {
+            distinct = bio::kmer::estimate_distinct_kmers(seqs, {.k = 21});
+        }
+        benchmark::DoNotOptimize(distinct);
+    }
+
+    state.SetItemsProcessed(state.iterations() * seqs.size() * (150 - 21 + 1));
+}
+
+BENCHMARK_TEMPLATE(distinct_kmers, tag::unordered_set);
+BENCHMARK_TEMPLATE(distinct_kmers, tag::sort_unique);
+BENCHMARK_TEMPLATE(distinct_kmers, tag::hyperloglog);
+
+// ============================================================================
+//  register updates
+// ============================================================================
+
+void add_hashes(benchmark::State & state)
+{
+    std::vector<uint64_t> hashes(1 << 16);
+    for (size_t i = 0; i < hashes.size(); ++i)
+        hashes[i] = bio::kmer::mix64(i);
+    bio::kmer::hyperloglog hll{{.precision = static_cast<uint8_t>(state.range(0))}};
+
+    for (auto _ : state)
+    {
+        hll.add_hashes(hashes);
+        benchmark::DoNotOptimize(hll.registers().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * hashes.size());
+}
+
+BENCHMARK(add_hashes)->Arg(10)->Arg(14)->Arg(18);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/kmer/interleaved_bloom_filter.hpp>
+
+// ============================================================================
+//  counting the k-mers of a read in many bins
+// ============================================================================
+
+enum class tag
+{
+    separate_filters,
+    interleaved
+};
+
+constexpr size_t bin_size = 1 << 20;
+
+template <tag t>
+void count(benchmark::State & state)
+{
+    size_t const    bins = state.range(0);
+    std::mt19937_64 gen{42};
+
+    // 1000 values per bin; queries are 130 values (e.g. the k-mers of a read), a third of them in bin 0
+    std::vector<uint64_t> query(130);
+    for (auto & v : query)
+        v = gen();
+    bio::kmer::interleaved_bloom_filter ibf{{.bins = bins, .bin_size = bin_size, .hash_count = 2}};
+    for (size_t b = 0; b < bins; ++b)
+        for (size_t i = 0; i < 1000; ++i)
+            ibf.emplace(gen(), b);
+    for (size_t i = 0; i < query.size(); i += 3)
+        ibf.emplace(query[i], 0);
+
+    // the same filter, one bitvector per bin
+    std::vector<bio::ranges::bitvector> separate;
+    if constexpr (t == tag::separate_filters)
+    {
+        auto const view = ibf.view();
+        separate.assign(bins, bio::ranges::bitvector(bin_size, false));
+        for (size_t p = 0; p < bin_size; ++p)
+            for (size_t b = 0; b < bins; ++b)
+                separate[b][p] = (view.raw_data()[p * view.words_per_position() + b / 64] >> (b % 64)) & 1;
+    }
+
+    auto                  agent = ibf.counting_agent();
+    std::vector<uint32_t> counts(bins);
+    for (auto _ : state)
+    {
+        if constexpr (t == tag::separate_filters)
+        {
+            auto const view = ibf.view();
+            std::ranges::fill(counts, 0);
+            for (uint64_t const v : query)
+            {
+                size_t const p0 = view.position(v, 0);
+                size_t const p1 = view.position(v, 1);
+                for (size_t b = 0; b < bins; ++b)
+                    counts[b] += separate[b][p0] && separate[b][p1];
+            }
+            benchmark::DoNotOptimize(counts.data());
+        }
+        else
+        {
+            benchmark::DoNotOptimize(agent.count(query).data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * query.size());
+}
+
+BENCHMARK_TEMPLATE(count, tag::separate_filters)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(count, tag::interleaved)->Arg(64)->Arg(1024);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/kmer_counter.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+// ============================================================================
+//  counting the 31-mers of reads
+// ============================================================================
+
+enum class tag
+{
+    unordered_map,
+    std_sort,
+    kmer_counter
+};
+
+// 40000 reads of length 150 (6 Mbp) from a genome of 1 Mbp
+bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const & reads()
+{
+    static bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const ret = []()
+    {
+        std::mt19937_64            gen{42};
+        bio::alphabet::dna5_vector genome(1'000'000);
+        for (auto & l : genome)
+            l = bio::alphabet::assign_rank_to(gen() % 4, bio::alphabet::dna5{});
+
+        bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> seqs;
+        for (size_t i = 0; i < 40'000; ++i)
+        {
+            size_t const start = gen() % (genome.size() - 150);
+            seqs.push_back(std::span{genome}.subspan(start, 150));
+        }
+        return seqs;
+    }();
+    return ret;
+}
+
+template <tag t>
+void count(benchmark::State & state)
+{
+    auto const & seqs     = reads();
+    size_t       distinct = 0;
+
+    for (auto _ : state)
+    {
+        if constexpr (t == tag::unordered_map)
+        {
+            std::unordered_map<uint64_t, uint64_t> counts;
+            for (auto const & read : seqs)
+                bio::kmer::for_each_kmer(read, {.k = 31}, [&](size_t, uint64_t const code) { ++counts[code]; });
+            distinct = counts.size();
+        }
+        else if constexpr (t == tag::std_sort)
+        {
+            std::vector<uint64_t> codes;
+            for (auto const & read : seqs)
+                bio::kmer::kmer_codes(read, {.k = 31}, codes);
+            std::ranges::sort(codes);
+            distinct = std::ranges::distance(codes.begin(), std::ranges::unique(codes).begin());
+        }
+        else
+        {
+            bio::kmer::kmer_counter counter{{.k = 31, .memory_budget = size_t{64} << 20}};
+            counter.add_all(seqs);
+            distinct = 0;
+            counter.for_each_count([&](bio::kmer::kmer_count const &) { ++distinct; });
+        }
+        benchmark::DoNotOptimize(distinct);
+    }
+
+    state.SetItemsProcessed(state.iterations() * seqs.size() * (150 - 31 + 1));
+}
+
+BENCHMARK_TEMPLATE(count, tag::unordered_map)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(count, tag::std_sort)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(count, tag::kmer_counter)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+//  sorting a partition
+// ============================================================================
+
+template <bool radix>
+void sort(benchmark::State & state)
+{
+    std::mt19937_64       gen{42};
+    std::vector<uint64_t> original(1 << 20);
+    for (uint64_t & v : original)
+        v = gen() & bio::kmer::kmer_mask(31);
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> scratch;
+
+    for (auto _ : state)
+    {
+        values = original;
+        if constexpr (radix)
+            bio::kmer::detail::radix_sort(values, scratch, 62);
+        else
+            std::ranges::sort(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * original.size());
+}
+
+BENCHMARK_TEMPLATE(sort, false);
+BENCHMARK_TEMPLATE(sort, true);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
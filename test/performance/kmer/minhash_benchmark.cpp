@@ -0,0 +1,151 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/minhash.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+// ============================================================================
+//  sketching reads
+// ============================================================================
+
+enum class tag
+{
+    std_set,
+    priority_queue,
+    sketcher
+};
+
+// 20000 reads of length 150 (3 Mbp)
+bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const & reads()
+{
+    static bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const ret = []()
+    {
+        std::mt19937_64                                                  gen{42};
+        bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> seqs;
+        bio::alphabet::dna5_vector                                       read(150);
+        for (size_t i = 0; i < 20'000; ++i)
+        {
+            for (auto & l : read)
+                l = bio::alphabet::assign_rank_to(gen() % 4, bio::alphabet::dna5{});
+            seqs.push_back(read);
+        }
+        return seqs;
+    }();
+    return ret;
+}
+
+template <tag t>
+void sketch(benchmark::State & state)
+{
+    auto const &                     seqs = reads();
+    bio::kmer::minhash_options const options{.k = 21, .sketch_size = static_cast<size_t>(state.range(0))};
+    size_t                           kmers = 0;
+
+    for (auto _ : state)
+    {
+        if constexpr (t == tag::std_set)
+        {
+            std::set<uint64_t> hashes;
+            for (auto const & read : seqs)
+            {
+                bio::kmer::for_each_kmer(read,
+                                         {.k = options.k},
+                                         [&](size_t, uint64_t const code)
+                                         {
+                                             hashes.insert(bio::kmer::mix64(code));
+                                             if (hashes.size() > options.sketch_size)
+                                                 hashes.erase(std::prev(hashes.end()));
+                                         });
+            }
+            benchmark::DoNotOptimize(hashes);
+        }
+        else if constexpr (t == tag::priority_queue)
+        {
+            std::priority_queue<uint64_t> heap;
+            std::set<uint64_t>            members;
+            for (auto const & read : seqs)
+            {
+                bio::kmer::for_each_kmer(read,
+                                         {.k = options.k},
+                                         [&](size_t, uint64_t const code)
+                                         {
+                                             uint64_t const h = bio::kmer::mix64(code);
+                                             if (heap.size() == options.sketch_size && h >= heap.top())
+                                                 return;
+                                             if (!members.insert(h).second)
+                                                 return;
+                                             heap.push(h);
+                                             if (heap.size() > options.sketch_size)
+                                             {
+                                                 members.erase(heap.top());
+                                                 heap.pop();
+                                             }
+                                         });
+            }
+            benchmark::DoNotOptimize(heap);
+        }
+        else
+        {
+            bio::kmer::minhash_sketch const s = bio::kmer::sketch_all(seqs, options);
+            benchmark::DoNotOptimize(s);
+        }
+    }
+
+    for (auto const & read : seqs)
+        kmers += read.size() - options.k + 1;
+    state.SetItemsProcessed(state.iterations() * kmers);
+}
+
+BENCHMARK_TEMPLATE(sketch, tag::std_set)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(sketch, tag::priority_queue)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(sketch, tag::sketcher)->Arg(1000)->Arg(10000);
+
+// ============================================================================
+//  hashing
+// ============================================================================
+
+template <bool bulk>
+void hash(benchmark::State & state)
+{
+    std::vector<uint64_t> codes(1 << 16);
+    std::iota(codes.begin(), codes.end(), 0);
+    std::vector<uint64_t> out(codes.size());
+
+    for (auto _ : state)
+    {
+        if constexpr (bulk)
+        {
+            bio::kmer::mix64(codes, out);
+        }
+        else
+        {
+            for (size_t i = 0; i < codes.size(); ++i)
+                out[i] = bio::kmer::mix64(codes[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * codes.size());
+}
+
+BENCHMARK_TEMPLATE(hash, false);
+BENCHMARK_TEMPLATE(hash, true);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
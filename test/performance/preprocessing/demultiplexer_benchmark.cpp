@@ -0,0 +1,130 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/demultiplexer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+using reads_t = bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>>;
+
+static constexpr size_t n_reads     = 100'000;
+static constexpr size_t read_len    = 150;
+static constexpr size_t barcode_len = 12;
+
+static std::mt19937 & gen()
+{
+    static std::mt19937 ret{42};
+    return ret;
+}
+
+static std::vector<bio::alphabet::dna5> random_seq(size_t const n)
+{
+    std::uniform_int_distribution<int> letter{0, 3};
+    std::vector<bio::alphabet::dna5>   ret(n);
+    for (auto & l : ret)
+        l.assign_char("ACGT"[letter(gen())]);
+    return ret;
+}
+
+static std::vector<std::vector<bio::alphabet::dna5>> const & barcodes()
+{
+    static auto const ret = []()
+    {
+        std::vector<std::vector<bio::alphabet::dna5>> ret;
+        for (size_t i = 0; i < 384; ++i)
+            ret.push_back(random_seq(barcode_len));
+        return ret;
+    }();
+    return ret;
+}
+
+// reads starting with a barcode; about 10% of the barcode letters are sequencing errors, 0.5% are N
+static reads_t const & reads()
+{
+    static auto const ret = []()
+    {
+        std::uniform_int_distribution<size_t> which{0, barcodes().size() - 1};
+        std::uniform_int_distribution<int>    error{0, 199};
+
+        reads_t ret;
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            auto         read = random_seq(read_len);
+            auto const & b = barcodes()[which(gen())];
+            for (size_t j = 0; j < barcode_len; ++j)
+            {
+                int const e = error(gen());
+                read[j]     = e == 0 ? 'N'_dna5 : e < 20 ? read[j] : b[j];
+            }
+            ret.push_back(read);
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+// lookup table for up to 2 mismatches, linear scan with packed codes for 3
+void demultiplexer(benchmark::State & state)
+{
+    bio::preprocessing::demultiplexer d{barcodes(), {.max_mismatches = static_cast<size_t>(state.range(0))}};
+    std::vector<bio::preprocessing::demux_result> out(n_reads);
+
+    for (auto _ : state)
+    {
+        d.barcodes_of(reads(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(demultiplexer)->Arg(1)->Arg(2)->Arg(3);
+
+// comparing the letters with every barcode
+void naive_demultiplexer(benchmark::State & state)
+{
+    size_t const          max_mismatches = state.range(0);
+    std::vector<uint32_t> out(n_reads);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            auto const read = reads()[i];
+            uint32_t   ret  = bio::preprocessing::demux_result::unassigned;
+            size_t     best = max_mismatches + 1;
+            for (uint32_t b = 0; b < barcodes().size(); ++b)
+            {
+                size_t mm = 0;
+                for (size_t j = 0; j < barcode_len; ++j)
+                    mm += read[j] != barcodes()[b][j];
+
+                if (mm < best)
+                {
+                    best = mm;
+                    ret  = b;
+                }
+                else if (mm == best)
+                {
+                    ret = bio::preprocessing::demux_result::ambiguous;
+                }
+            }
+            out[i] = ret;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive_demultiplexer)->Arg(1)->Arg(2)->Arg(3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/preprocessing/pair_merger.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/views/complement.hpp>
+
+using qualified_t = bio::alphabet::qualified<bio::alphabet::dna5, bio::alphabet::phred42>;
+using reads_t     = bio::ranges::concatenated_sequences<std::vector<qualified_t>>;
+
+static constexpr size_t n_pairs  = 20'000;
+static constexpr size_t read_len = 150;
+
+// pairs of 150bp reads from fragments of 180-350bp (so most, but not all, overlap)
+static std::pair<reads_t, reads_t> const & pairs()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                          gen{42};
+        std::uniform_int_distribution<int>    letter{0, 3};
+        std::uniform_int_distribution<size_t> frag_len{180, 350};
+
+        std::pair<reads_t, reads_t> ret;
+        std::vector<qualified_t>    fragment;
+        for (size_t i = 0; i < n_pairs; ++i)
+        {
+            fragment.resize(frag_len(gen));
+            for (auto & l : fragment)
+                l = qualified_t{bio::alphabet::dna5{}.assign_rank(letter(gen) == 3 ? 4 : letter(gen)),
+                                bio::alphabet::phred42{}.assign_phred(30)};
+
+            ret.first.push_back(fragment | std::views::take(read_len));
+            ret.second.push_back(fragment | std::views::reverse | std::views::take(read_len));
+            for (auto && l : ret.second.back())
+                l = qualified_t{bio::alphabet::complement(get<0>(qualified_t{l})), get<1>(qualified_t{l})};
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+// the bit-parallel merger
+void pair_merger(benchmark::State & state)
+{
+    bio::preprocessing::pair_merger m{};
+    reads_t                         out;
+
+    for (auto _ : state)
+    {
+        out.clear();
+        auto res = m.merge_pairs(pairs().first, pairs().second, out);
+        benchmark::DoNotOptimize(res.data());
+    }
+
+    state.counters["pairs/s"] = benchmark::Counter(n_pairs, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(pair_merger);
+
+// finding the overlap by comparing the letters of the reverse complemented view at every offset
+void naive_find_overlap(benchmark::State & state)
+{
+    std::vector<ptrdiff_t> out(n_pairs);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n_pairs; ++i)
+        {
+            auto const      r1  = pairs().first[i];
+            auto const      rc2 = pairs().second[i] | std::views::reverse | bio::views::complement;
+            ptrdiff_t const n1  = r1.size();
+            ptrdiff_t const n2  = rc2.size();
+
+            ptrdiff_t best    = n1;
+            double    best_mm = 1.0;
+            for (ptrdiff_t d = 10 - n2; d <= n1 - 10; ++d)
+            {
+                size_t overlap = 0;
+                size_t mm      = 0;
+                for (ptrdiff_t p = std::max<ptrdiff_t>(d, 0); p < std::min(n1, d + n2); ++p, ++overlap)
+                    mm += get<0>(r1[p]) != rc2[p - d];
+                if (mm <= overlap / 10 && static_cast<double>(mm) / overlap < best_mm)
+                {
+                    best    = d;
+                    best_mm = static_cast<double>(mm) / overlap;
+                }
+            }
+            out[i] = best;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["pairs/s"] = benchmark::Counter(n_pairs, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive_find_overlap);
+
+BENCHMARK_MAIN();
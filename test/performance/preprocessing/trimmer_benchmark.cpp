@@ -0,0 +1,106 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/trimmer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+static constexpr size_t n_reads  = 100'000;
+static constexpr size_t read_len = 150;
+
+static auto const adapter = "AGATCGGAAGAGCACACGTCTGAACTCCAGTCAC"_dna5;
+
+// random reads; a third contains the adapter at a random position, a tenth has a poly-G tail
+static bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> const & reads()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                          gen{42};
+        std::uniform_int_distribution<int>    letter{0, 3};
+        std::uniform_int_distribution<size_t> pos{0, read_len - 1};
+
+        bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> ret;
+        ret.reserve(n_reads, n_reads * read_len);
+
+        std::vector<bio::alphabet::dna5> read(read_len);
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            for (auto & l : read)
+                l = bio::alphabet::dna5{}.assign_char("ACGT"[letter(gen)]);
+
+            if (i % 3 == 0)
+            {
+                size_t const p = pos(gen);
+                std::ranges::copy_n(adapter.begin(), std::min(adapter.size(), read_len - p), read.begin() + p);
+            }
+            if (i % 10 == 0)
+                std::ranges::fill(read.begin() + pos(gen), read.end(), 'G'_dna5);
+
+            ret.push_back(read);
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+// the bit-parallel trimmer
+void trimmer(benchmark::State & state)
+{
+    bio::preprocessing::trimmer t{adapter, {.poly_x = {'G'_dna5}}};
+    std::vector<size_t>         out(n_reads);
+
+    for (auto _ : state)
+    {
+        t.trim_positions(reads(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(trimmer);
+
+// comparing letter by letter at every position
+void naive(benchmark::State & state)
+{
+    std::vector<size_t> out(n_reads);
+
+    for (auto _ : state)
+    {
+        for (size_t r = 0; r < n_reads; ++r)
+        {
+            auto const   read = reads()[r];
+            size_t const n    = read.size();
+            size_t       end  = n;
+            for (size_t i = 0; i + 3 <= n; ++i)
+            {
+                size_t const overlap = std::min(adapter.size(), n - i);
+                size_t       errors  = 0;
+                for (size_t j = 0; j < overlap; ++j)
+                    errors += adapter[j] != read[i + j];
+                if (errors <= overlap / 10)
+                {
+                    end = i;
+                    break;
+                }
+            }
+            out[r] = end;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/preprocessing/umi_grouper.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/to_char.hpp>
+
+using umis_t = bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna4>>;
+
+static constexpr size_t n_reads     = 500'000;
+static constexpr size_t n_positions = 20'000;
+static constexpr size_t umi_len     = 10;
+
+// 25 reads per position from 5 molecules; 1% of the UMI letters are sequencing errors
+static std::pair<std::vector<uint64_t>, umis_t> const & data()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                          gen{42};
+        std::uniform_int_distribution<int>    letter{0, 3};
+        std::uniform_int_distribution<int>    error{0, 99};
+        std::uniform_int_distribution<size_t> position{0, n_positions - 1};
+
+        std::vector<std::vector<bio::alphabet::dna4>> molecules(n_positions * 5);
+        for (auto & m : molecules)
+        {
+            m.resize(umi_len);
+            for (auto & l : m)
+                l.assign_rank(letter(gen));
+        }
+
+        std::pair<std::vector<uint64_t>, umis_t> ret;
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            uint64_t const p = position(gen);
+            auto           m = molecules[p * 5 + letter(gen) % 5];
+            for (auto & l : m)
+                if (error(gen) == 0)
+                    l.assign_rank(letter(gen));
+            ret.first.push_back(p);
+            ret.second.push_back(m);
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+void umi_grouper(benchmark::State & state)
+{
+    bio::preprocessing::umi_grouper g{{.threads = static_cast<size_t>(state.range(0))}};
+    std::vector<uint32_t>           out(n_reads);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(g.group(data().first, data().second, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(umi_grouper)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// UMIs as strings in hash maps per position, pairwise comparison of the distinct UMIs
+void string_umi_grouper(benchmark::State & state)
+{
+    std::vector<uint32_t> out(n_reads);
+
+    for (auto _ : state)
+    {
+        std::unordered_map<uint64_t, std::unordered_map<std::string, std::vector<uint32_t>>> by_position;
+        for (uint32_t i = 0; i < n_reads; ++i)
+            by_position[data().first[i]][data().second[i] | bio::views::to_char | bio::ranges::to<std::string>()]
+              .push_back(i);
+
+        uint32_t n_groups = 0;
+        for (auto & [position, by_umi] : by_position)
+        {
+            std::vector<std::pair<std::string const *, std::vector<uint32_t> const *>> nodes;
+            for (auto const & [umi, reads] : by_umi)
+                nodes.emplace_back(&umi, &reads);
+            std::ranges::sort(nodes,
+                              [](auto const & l, auto const & r) { return l.second->size() > r.second->size(); });
+
+            std::vector<bool>   done(nodes.size());
+            std::vector<size_t> stack;
+            for (size_t root = 0; root < nodes.size(); ++root)
+            {
+                if (done[root])
+                    continue;
+                done[root] = true;
+                stack.assign(1, root);
+                while (!stack.empty())
+                {
+                    size_t const v = stack.back();
+                    stack.pop_back();
+                    for (uint32_t r : *nodes[v].second)
+                        out[r] = n_groups;
+                    for (size_t w = 0; w < nodes.size(); ++w)
+                    {
+                        size_t d = 0;
+                        for (size_t j = 0; j < umi_len; ++j)
+                            d += (*nodes[v].first)[j] != (*nodes[w].first)[j];
+                        if (!done[w] && d == 1 && nodes[v].second->size() >= 2 * nodes[w].second->size() - 1)
+                        {
+                            done[w] = true;
+                            stack.push_back(w);
+                        }
+                    }
+                }
+                ++n_groups;
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.counters["reads/s"] = benchmark::Counter(n_reads, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(string_umi_grouper);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/ranges/container/chunked_sequences.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+// ============================================================================
+//  appending many short reads
+// ============================================================================
+
+static constexpr size_t n_reads  = 1'000'000;
+static constexpr size_t read_len = 150;
+
+enum class strategy
+{
+    vector_of_string,
+    concatenated,
+    concatenated_reserved,
+    concatenated_factor_1_5,
+    chunked
+};
+
+template <strategy strat>
+void push_back_reads(benchmark::State & state)
+{
+    std::string const read(read_len, 'A');
+
+    for (auto _ : state)
+    {
+        if constexpr (strat == strategy::vector_of_string)
+        {
+            std::vector<std::string> c;
+            for (size_t i = 0; i < n_reads; ++i)
+                c.push_back(read);
+            benchmark::DoNotOptimize(c.back().data());
+        }
+        else if constexpr (strat == strategy::chunked)
+        {
+            bio::ranges::chunked_sequences<std::string> c;
+            for (size_t i = 0; i < n_reads; ++i)
+                c.push_back(std::string_view{read});
+            benchmark::DoNotOptimize(c.back().data());
+        }
+        else
+        {
+            bio::ranges::concatenated_sequences<std::string> c;
+            if constexpr (strat == strategy::concatenated_reserved)
+                c.reserve(n_reads, n_reads * read_len);
+            else if constexpr (strat == strategy::concatenated_factor_1_5)
+                c.set_growth_policy({.factor = 1.5});
+
+            for (size_t i = 0; i < n_reads; ++i)
+                c.push_back(std::string_view{read});
+            benchmark::DoNotOptimize(c.back().data());
+        }
+    }
+
+    state.counters["bytes_per_second"] =
+      benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(push_back_reads, strategy::vector_of_string);
+BENCHMARK_TEMPLATE(push_back_reads, strategy::concatenated);
+BENCHMARK_TEMPLATE(push_back_reads, strategy::concatenated_reserved);
+BENCHMARK_TEMPLATE(push_back_reads, strategy::concatenated_factor_1_5);
+BENCHMARK_TEMPLATE(push_back_reads, strategy::chunked);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
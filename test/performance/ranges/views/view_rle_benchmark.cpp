@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/run_starts.hpp>
+#include <bio/ranges/views/rle.hpp>
+
+// ============================================================================
+//  run boundaries
+// ============================================================================
+
+enum class tag
+{
+    naive_loop,
+    view_rle,
+    run_starts,
+    run_starts_packed
+};
+
+// sequence whose runs have a mean length of `mean_run`
+bio::alphabet::dna4_vector make_sequence(size_t const mean_run)
+{
+    std::mt19937_64            gen{42};
+    bio::alphabet::dna4_vector seq;
+    uint8_t                    rank = 0;
+
+    for (size_t i = 0; i < 10'000'000; ++i)
+    {
+        if (gen() % mean_run == 0)
+            rank = (rank + 1 + gen() % 3) % 4;
+        seq.push_back(bio::alphabet::assign_rank_to(rank, bio::alphabet::dna4{}));
+    }
+
+    return seq;
+}
+
+template <tag t>
+void find_runs(benchmark::State & state)
+{
+    bio::alphabet::dna4_vector const                             seq = make_sequence(state.range(0));
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> const packed{seq};
+    size_t                                                       runs = 0;
+
+    for (auto _ : state)
+    {
+        if constexpr (t == tag::naive_loop)
+        {
+            std::vector<size_t> starts;
+            for (size_t i = 0; i < seq.size(); ++i)
+                if (i == 0 || seq[i] != seq[i - 1])
+                    starts.push_back(i);
+            runs = starts.size();
+        }
+        else if constexpr (t == tag::view_rle)
+        {
+            runs = std::ranges::distance(seq | bio::views::rle);
+        }
+        else if constexpr (t == tag::run_starts)
+        {
+            runs = bio::ranges::run_starts(seq).size();
+        }
+        else
+        {
+            runs = bio::ranges::run_starts(packed).size();
+        }
+        benchmark::DoNotOptimize(runs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * seq.size());
+}
+
+BENCHMARK_TEMPLATE(find_runs, tag::naive_loop)->Arg(1)->Arg(4)->Arg(32);
+BENCHMARK_TEMPLATE(find_runs, tag::view_rle)->Arg(1)->Arg(4)->Arg(32);
+BENCHMARK_TEMPLATE(find_runs, tag::run_starts)->Arg(1)->Arg(4)->Arg(32);
+BENCHMARK_TEMPLATE(find_runs, tag::run_starts_packed)->Arg(1)->Arg(4)->Arg(32);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/ranges/views/take_until.hpp>
+
+// ============================================================================
+//  line splitting
+// ============================================================================
+
+enum class tag
+{
+    std_find,
+    std_take_while,
+    take_until_lambda,
+    take_line
+};
+
+// FASTQ-like buffer with lines of the given length
+std::string make_buffer(size_t const line_length)
+{
+    std::mt19937                    gen{42};
+    std::uniform_int_distribution<> dis{0, 3};
+    std::string                     buffer;
+
+    while (buffer.size() < 10'000'000)
+    {
+        for (size_t i = 0; i < line_length; ++i)
+            buffer.push_back("ACGT"[dis(gen)]);
+        buffer.push_back('\n');
+    }
+
+    return buffer;
+}
+
+template <tag t>
+void split_lines(benchmark::State & state)
+{
+    std::string const buffer = make_buffer(state.range(0));
+    size_t            lines  = 0;
+
+    for (auto _ : state)
+    {
+        std::string_view rest{buffer};
+        while (!rest.empty())
+        {
+            size_t len = 0;
+            if constexpr (t == tag::std_find)
+            {
+                len = std::ranges::find(rest, '\n') - rest.begin();
+            }
+            else if constexpr (t == tag::std_take_while)
+            {
+                auto v = rest | std::views::take_while([](char const c) { return c != '\n' && c != '\r'; });
+                len    = std::ranges::distance(v);
+            }
+            else if constexpr (t == tag::take_until_lambda)
+            {
+                auto v = rest | bio::views::take_until([](char const c) { return c == '\n' || c == '\r'; });
+                len    = std::ranges::distance(v);
+            }
+            else
+            {
+                len = (rest | bio::views::take_line).size();
+            }
+
+            rest.remove_prefix(std::min(len + 1, rest.size()));
+            ++lines;
+        }
+    }
+
+    benchmark::DoNotOptimize(lines);
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK_TEMPLATE(split_lines, tag::std_find)->Arg(20)->Arg(150)->Arg(10'000);
+BENCHMARK_TEMPLATE(split_lines, tag::std_take_while)->Arg(20)->Arg(150)->Arg(10'000);
+BENCHMARK_TEMPLATE(split_lines, tag::take_until_lambda)->Arg(20)->Arg(150)->Arg(10'000);
+BENCHMARK_TEMPLATE(split_lines, tag::take_line)->Arg(20)->Arg(150)->Arg(10'000);
+
+// ============================================================================
+//  run
+// ============================================================================
+
+BENCHMARK_MAIN();
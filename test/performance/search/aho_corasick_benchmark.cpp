@@ -0,0 +1,110 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/search/aho_corasick.hpp>
+
+static constexpr size_t n_reads  = 100'000;
+static constexpr size_t read_len = 150;
+
+// 100k reads of 150bp
+static bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> const & reads()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                       gen{42};
+        std::uniform_int_distribution<int> letter{0, 3};
+
+        bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> ret;
+        bio::alphabet::dna5_vector                                      read(read_len);
+        for (size_t i = 0; i < n_reads; ++i)
+        {
+            for (auto & l : read)
+                l.assign_rank(std::array{0, 1, 2, 4}[letter(gen)]);
+            ret.push_back(read);
+        }
+        return ret;
+    }();
+    return ret;
+}
+
+// random contaminant sequences of length 25
+static std::vector<bio::alphabet::dna5_vector> patterns(size_t const n)
+{
+    std::mt19937                       gen{7};
+    std::uniform_int_distribution<int> letter{0, 3};
+
+    std::vector<bio::alphabet::dna5_vector> ret(n, bio::alphabet::dna5_vector(25));
+    for (auto & p : ret)
+        for (auto & l : p)
+            l.assign_rank(std::array{0, 1, 2, 4}[letter(gen)]);
+    return ret;
+}
+
+// arg: number of patterns
+void aho_corasick_find_each(benchmark::State & state)
+{
+    reads();
+    bio::search::aho_corasick const ac{patterns(state.range(0))};
+    size_t                          hits = 0;
+
+    for (auto _ : state)
+    {
+        ac.find_each(reads(), [&](size_t, bio::search::aho_corasick_hit const &) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] =
+      benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(aho_corasick_find_each)->Arg(100)->Arg(10'000);
+
+void aho_corasick_find(benchmark::State & state)
+{
+    reads();
+    bio::search::aho_corasick const ac{patterns(state.range(0))};
+    size_t                          hits = 0;
+
+    for (auto _ : state)
+    {
+        for (auto && read : reads())
+            ac.find(read, [&](bio::search::aho_corasick_hit const &) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] =
+      benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(aho_corasick_find)->Arg(100)->Arg(10'000);
+
+// one std::search per read and pattern
+void std_search(benchmark::State & state)
+{
+    reads();
+    auto const pats = patterns(state.range(0));
+    size_t     hits = 0;
+
+    for (auto _ : state)
+    {
+        for (auto && read : reads())
+            for (auto const & p : pats)
+                hits += std::search(read.begin(), read.end(), p.begin(), p.end()) != read.end();
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] =
+      benchmark::Counter(n_reads * read_len, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(std_search)->Arg(100);
+
+BENCHMARK_MAIN();
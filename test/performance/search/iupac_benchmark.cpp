@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna15.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/search/iupac.hpp>
+
+using namespace bio::alphabet::literals;
+
+static constexpr size_t text_size = 10'000'000;
+
+static bio::alphabet::dna5_vector const & text()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                       gen{42};
+        std::uniform_int_distribution<int> letter{0, 3};
+
+        bio::alphabet::dna5_vector ret(text_size);
+        for (auto & l : ret)
+            l.assign_rank(std::array{0, 1, 2, 4}[letter(gen)]);
+        return ret;
+    }();
+    return ret;
+}
+
+// a degenerate 16S primer (341F) and a restriction site
+static bio::alphabet::dna15_vector const primer = "CCTACGGGNGGCWGCAG"_dna15;
+static bio::alphabet::dna15_vector const site   = "CCWGG"_dna15;
+
+void iupac_finder(benchmark::State & state)
+{
+    text();
+    bio::search::iupac_finder finder{state.range(0) ? primer : site};
+    size_t                    hits = 0;
+
+    for (auto _ : state)
+    {
+        finder.find(text(), [&](size_t) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(iupac_finder)->Arg(0)->Arg(1);
+
+// std::search with a predicate that looks up the base sets of both letters
+void std_search(benchmark::State & state)
+{
+    text();
+    auto const & pattern = state.range(0) ? primer : site;
+    auto const   pred    = [](bio::alphabet::dna5 const t, bio::alphabet::dna15 const p)
+    { return (bio::search::base_set(t) & bio::search::base_set(p)) != 0; };
+    size_t hits = 0;
+
+    for (auto _ : state)
+    {
+        for (auto it = text().begin();; ++it)
+        {
+            it = std::search(it, text().end(), pattern.begin(), pattern.end(), pred);
+            if (it == text().end())
+                break;
+            ++hits;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(std_search)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/search/pwm.hpp>
+
+static constexpr size_t text_size = 1'000'000;
+
+static bio::alphabet::dna4_vector const & text()
+{
+    static auto const ret = []()
+    {
+        std::mt19937_64            gen{42};
+        bio::alphabet::dna4_vector ret(text_size);
+        for (auto & l : ret)
+            l.assign_rank(gen() % 4);
+        return ret;
+    }();
+    return ret;
+}
+
+// motifs of length 8 to 20 with a threshold that few windows reach (like a p-value of about 1e-5)
+static std::vector<bio::search::position_weight_matrix> motifs(size_t const count)
+{
+    std::mt19937_64                                  gen{7};
+    std::uniform_real_distribution<float>            score{-2.0f, 1.0f};
+    std::vector<bio::search::position_weight_matrix> ret;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bio::search::position_weight_matrix motif;
+        motif.scores.resize(8 + gen() % 13);
+        float best = 0.0f;
+        for (auto & column : motif.scores)
+        {
+            for (float & s : column)
+                s = score(gen);
+            column[gen() % 4] = 2.0f;
+            best += 2.0f;
+        }
+        motif.threshold = best * 0.8f;
+        ret.push_back(motif);
+    }
+    return ret;
+}
+
+void pwm_scanner(benchmark::State & state)
+{
+    text();
+    bio::search::pwm_scanner scanner{motifs(state.range(0))};
+    size_t                   hits = 0;
+
+    for (auto _ : state)
+    {
+        scanner.scan(text(), [&](bio::search::pwm_hit const &) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(pwm_scanner)->Arg(1)->Arg(10)->Arg(100);
+
+// every window of every motif on both strands, one letter at a time
+void naive(benchmark::State & state)
+{
+    text();
+    std::vector<bio::search::position_weight_matrix> const ms = motifs(state.range(0));
+    std::vector<uint8_t>                                   ranks(text_size);
+    size_t                                                 hits = 0;
+
+    for (auto _ : state)
+    {
+        std::ranges::transform(text(), ranks.begin(), [](auto const l) { return l.to_rank(); });
+        for (bio::search::position_weight_matrix const & m : ms)
+        {
+            size_t const len = m.scores.size();
+            for (size_t p = 0; p + len <= text_size; ++p)
+            {
+                float fwd = 0.0f, rev = 0.0f;
+                for (size_t j = 0; j < len; ++j)
+                {
+                    fwd += m.scores[j][ranks[p + j]];
+                    rev += m.scores[len - 1 - j][3 - ranks[p + j]];
+                }
+                hits += (fwd >= m.threshold) + (rev >= m.threshold);
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(naive)->Arg(1)->Arg(10)->Arg(100);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/search/shift_and.hpp>
+
+static constexpr size_t text_size = 10'000'000;
+
+static bio::alphabet::dna4_vector const & text()
+{
+    static auto const ret = []()
+    {
+        std::mt19937                       gen{42};
+        std::uniform_int_distribution<int> letter{0, 3};
+
+        bio::alphabet::dna4_vector ret(text_size);
+        for (auto & l : ret)
+            l.assign_rank(letter(gen));
+        return ret;
+    }();
+    return ret;
+}
+
+// motifs of length 12 taken from the text
+static std::vector<bio::alphabet::dna4_vector> motifs(size_t const n)
+{
+    std::vector<bio::alphabet::dna4_vector> ret;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t const s = (i * 7919 * 1013) % (text_size - 12);
+        ret.emplace_back(text().begin() + s, text().begin() + s + 12);
+    }
+    return ret;
+}
+
+// args: number of motifs, mismatches
+void shift_and(benchmark::State & state)
+{
+    text();
+    bio::search::shift_and finder{motifs(state.range(0)), {.max_mismatches = static_cast<size_t>(state.range(1))}};
+    size_t                 hits = 0;
+
+    for (auto _ : state)
+    {
+        finder.find(text(), [&](bio::search::shift_and_hit const &) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(shift_and)->Args({1, 0})->Args({1, 2})->Args({100, 0})->Args({100, 2});
+
+void shift_and_bitcompressed(benchmark::State & state)
+{
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> const packed{text()};
+    bio::search::shift_and                                       finder{motifs(1)};
+    size_t                                                       hits = 0;
+
+    for (auto _ : state)
+    {
+        finder.find(packed, [&](bio::search::shift_and_hit const &) { ++hits; });
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(shift_and_bitcompressed);
+
+// one std::search pass per motif
+void std_search(benchmark::State & state)
+{
+    text();
+    auto const patterns = motifs(state.range(0));
+    size_t     hits     = 0;
+
+    for (auto _ : state)
+    {
+        for (auto const & pattern : patterns)
+        {
+            for (auto it = text().begin();; ++it)
+            {
+                it = std::search(it, text().end(), pattern.begin(), pattern.end());
+                if (it == text().end())
+                    break;
+                ++hits;
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["letters/s"] = benchmark::Counter(text_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(std_search)->Arg(1)->Arg(100);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,33 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alignment/chain.hpp>
+
+int main()
+{
+    using bio::alignment::anchor;
+
+    // 15-mer matches between a read and a reference: a colinear run with a small indel, plus one spurious hit
+    std::vector<anchor> const anchors{{100, 2'100, 15},
+                                      {120, 2'120, 15},
+                                      {140, 2'143, 15}, // 3 letters inserted in the reference
+                                      {160, 2'163, 15},
+                                      {130, 9'000, 15}};
+
+    bio::alignment::chainer chainer{{.min_score = 20, .min_anchors = 2}};
+    for (bio::alignment::chain const & c : chainer.run(anchors))
+    {
+        fmt::print("score {} with {} anchors: query [{}, {}), target [{}, {})\n",
+                   c.score,
+                   c.anchors,
+                   c.query_begin,
+                   c.query_end,
+                   c.target_begin,
+                   c.target_end);
+    }
+    // score 59 with 4 anchors: query [100, 175), target [2100, 2178)
+
+    bio::alignment::overlap_type const type = bio::alignment::classify_overlap(chainer.result()[0], 200, 10'000);
+    fmt::print("{}\n", type == bio::alignment::overlap_type::query_contained); // true
+}
@@ -0,0 +1,22 @@
+#include <vector>
+
+#include <fmt/ranges.h>
+
+#include <bio/alignment/coverage.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+    using bio::alphabet::cigar;
+
+    bio::alignment::coverage cov{10}; // reference of length 10
+
+    cov.add(1, std::vector<cigar>{{3, 'M'_cigar_op}});
+    cov.add(2, std::vector<cigar>{{2, 'M'_cigar_op}, {1, 'D'_cigar_op}, {2, 'M'_cigar_op}});
+    cov.add(6, std::vector<cigar>{{1, 'M'_cigar_op}, {2, 'N'_cigar_op}, {5, 'M'_cigar_op}}); // clipped at the end
+
+    bio::alignment::coverage_track const track = cov.track();
+    fmt::print("{}\n", track.narrow_depths()); // [0, 1, 2, 2, 1, 1, 2, 0, 0, 1]
+    fmt::print("max: {}\n", track.max_depth()); // max: 2
+}
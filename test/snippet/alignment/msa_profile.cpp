@@ -0,0 +1,27 @@
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <bio/alignment/msa_profile.hpp>
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/gap/gapped.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/views/char_to.hpp>
+
+int main()
+{
+    using gapped_dna5 = bio::alphabet::gapped<bio::alphabet::dna5>;
+
+    bio::ranges::concatenated_sequences<std::vector<gapped_dna5>> msa;
+    for (std::string_view row : {"ACGT-AC", "ACCT-AC", "A-GTTAC", "TCGT-AG"})
+        msa.push_back(row | bio::views::char_to<gapped_dna5>);
+
+    bio::alignment::msa_profile profile{msa};
+
+    fmt::print("{}\n", profile.consensus());     // ACGT-AC
+    fmt::print("{}\n", profile.counts(0));       // [3, 0, 0, 0, 1, 0]  (A C G N T -)
+    fmt::print("{:.2f}\n", profile.entropy(0)); // 0.81
+}
@@ -0,0 +1,42 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alignment/pileup.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+    using bio::alphabet::cigar;
+
+    using record_t = bio::alignment::pileup_record<std::vector<cigar>,
+                                                   std::vector<bio::alphabet::dna5>,
+                                                   std::vector<bio::alphabet::phred42>>;
+
+    // records sorted by position; qualities omitted
+    std::vector<record_t> const records{
+      {100, {{4, 'M'_cigar_op}}, "ACGT"_dna5},
+      {101, {{2, 'M'_cigar_op}, {1, 'D'_cigar_op}, {1, 'M'_cigar_op}}, "CGA"_dna5},
+      {102, {{1, 'M'_cigar_op}, {2, 'I'_cigar_op}, {2, 'M'_cigar_op}}, "GAATT"_dna5},
+    };
+
+    bio::alignment::pileup pileup{};
+    auto                   print = [](bio::alignment::pileup_column const & col)
+    {
+        fmt::print("{}: A={} C={} G={} T={} del={} ins={}\n",
+                   col.position,
+                   col.counts[0],
+                   col.counts[1],
+                   col.counts[2],
+                   col.counts[4],
+                   col.deletions,
+                   col.insertions);
+    };
+
+    for (record_t const & record : records)
+        pileup.add(record, print); // prints the columns that no later record can change
+    pileup.finish(print);
+}
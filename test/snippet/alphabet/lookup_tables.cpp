@@ -0,0 +1,23 @@
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/lookup_tables.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+
+int main()
+{
+    // tables are computed at compile-time for every alphabet
+    static_assert(bio::alphabet::lookup_tables<bio::alphabet::dna4>.char_to_rank['G'] == 2);
+    static_assert(bio::alphabet::lookup_tables<bio::alphabet::dna4>.is_valid('g'));
+    static_assert(!bio::alphabet::lookup_tables<bio::alphabet::dna4>.is_valid('N'));
+
+    // a generic bulk conversion kernel uses them
+    std::string_view     input{"ACGTacgtNACGT"};
+    std::vector<uint8_t> ranks(input.size());
+    size_t const         valid = bio::alphabet::chars_to_ranks<bio::alphabet::dna4>(input, ranks);
+
+    fmt::print("{} valid characters, first invalid: '{}'\n", valid, input[valid]); // 8 valid characters, first invalid: 'N'
+}
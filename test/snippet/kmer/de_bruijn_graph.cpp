@@ -0,0 +1,28 @@
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/de_bruijn_graph.hpp>
+#include <bio/ranges/views/to_char.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // the k-mers of two sequences that share TTGACGG
+    std::vector<uint64_t> kmers;
+    bio::kmer::kmer_codes("CCAGTTGACGGAT"_dna4, {.k = 5}, kmers);
+    bio::kmer::kmer_codes("TCCATTGACGGCA"_dna4, {.k = 5}, kmers);
+
+    bio::kmer::de_bruijn_graph const graph{kmers, {.k = 5}};
+    fmt::print("{} nodes\n", graph.size()); // 15 nodes
+
+    // the two sequences branch before and after the shared part; unitigs may be reverse complemented
+    for (auto && unitig : graph.unitigs())
+        fmt::print("{}\n", fmt::join(unitig | bio::views::to_char, ""));
+    // ACGGAT
+    // ACGGCA
+    // CCAGTTGA
+    // TCCATTGA
+    // CCGTCAA
+}
@@ -0,0 +1,27 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/distance_matrix.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    std::vector<bio::alphabet::dna4_vector> const genomes{"ACGTTGCATTAGCCGATACGGATCCATGCA"_dna4,
+                                                          "ACGTTGCATTAGCCGATACGGTTCCATGCA"_dna4,
+                                                          "TTGACCGTAGGCATCAGTACCGATTGCAAT"_dna4};
+
+    std::vector<bio::kmer::minhash_sketch> const sketches = bio::kmer::sketch_each(genomes, {.k = 11});
+
+    // all pairs, as a condensed upper triangle: (0, 1), (0, 2), (1, 2)
+    bio::kmer::distance_matrix const matrix = bio::kmer::all_vs_all(sketches, {.threads = 2});
+    for (float const d : matrix.condensed())
+        fmt::print("{:.3f} ", d); // 0.054 1.000 1.000
+    fmt::print("\n{:.3f}\n", matrix(1, 0)); // 0.054
+
+    // only the close pairs
+    for (bio::kmer::distance_entry const & e : bio::kmer::all_vs_all_sparse(sketches, {.max_distance = 0.1}))
+        fmt::print("{} {} {:.3f}\n", e.i, e.j, e.distance); // 0 1 0.054
+}
@@ -0,0 +1,33 @@
+#include <unordered_set>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/error_corrector.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/views/to_char.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // the solid k-mers, e.g. all k-mers that occur at least three times in the reads
+    std::unordered_set<uint64_t> solid;
+    bio::kmer::for_each_kmer("ACGTTGCATTAGCCGATACGGATCCATGCA"_dna5,
+                             {.k = 11},
+                             [&](size_t, uint64_t const code) { solid.insert(code); });
+
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> reads;
+    reads.push_back("ACGTTGCATTAGCCGATACGGATCCATGCA"_dna5);
+    reads.push_back("ACGTTGCATTAGCCGTTACGGATCCATGCA"_dna5); // A -> T
+    reads.push_back("TGCATGGATCCGTNTCGGCTAATGCAACGT"_dna5); // reverse complement, A -> N
+
+    bio::kmer::error_corrector corrector{solid, {.k = 11}};
+    fmt::print("{}\n", corrector.correct_all(reads)); // [0, 1, 1]
+    for (auto && read : reads)
+        fmt::print("{}\n", fmt::join(read | bio::views::to_char, ""));
+    // ACGTTGCATTAGCCGATACGGATCCATGCA
+    // ACGTTGCATTAGCCGATACGGATCCATGCA
+    // TGCATGGATCCGTATCGGCTAATGCAACGT
+}
@@ -0,0 +1,26 @@
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/hyperloglog.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> reads;
+    reads.push_back("ACGTTGCATTAGCCGATACGGATCCATGCA"_dna5);
+    reads.push_back("TGCATGGATCCGTATCGGCTAATGCAACGT"_dna5); // reverse complement of the first read
+    reads.push_back("ACGTTGCATTAGNCGATACGGATCCATGCA"_dna5);
+
+    // the first two reads have the same 20 canonical 11-mers, the third has no other 11-mers
+    fmt::print("{:.1f}\n", bio::kmer::estimate_distinct_kmers(reads, {.k = 11})); // 20.0
+
+    // estimators can be filled incrementally and merged
+    bio::kmer::hyperloglog hll{{.k = 11}};
+    hll.add(reads[0]);
+    bio::kmer::hyperloglog other{{.k = 11}};
+    other.add("GGGGGGGGGGGGG"_dna5); // one more distinct 11-mer (GGGGGGGGGGG, three times)
+    hll.merge(other);
+    fmt::print("{:.1f}\n", hll.estimate()); // 21.0
+}
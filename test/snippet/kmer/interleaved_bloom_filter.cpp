@@ -0,0 +1,40 @@
+#include <sstream>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/interleaved_bloom_filter.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    std::vector<bio::alphabet::dna4_vector> const references{"ACGTTGCATTAGCCGATACGGATCCATGCA"_dna4,
+                                                             "TTTTGGGGCCCCAAAATTTTGGGGCCCCAA"_dna4,
+                                                             "GATTACAGATTACAGATTACAGATTACAGA"_dna4};
+
+    // one bin per reference, filled with its canonical 15-mers
+    bio::kmer::interleaved_bloom_filter ibf{{.bins = references.size(), .bin_size = 4096, .hash_count = 2}};
+    std::vector<uint64_t>               kmers;
+    for (size_t bin = 0; bin < references.size(); ++bin)
+    {
+        kmers.clear();
+        bio::kmer::kmer_codes(references[bin], {.k = 15}, kmers);
+        ibf.emplace(kmers, bin);
+    }
+
+    // the bins that contain at least 2 of the 15-mers of a read
+    kmers.clear();
+    bio::kmer::kmer_codes("CCGATACGGATCCATGC"_dna4, {.k = 15}, kmers);
+    auto agent = ibf.counting_agent();
+    fmt::print("{}\n", agent.count(kmers));                      // [3, 0, 0]
+    fmt::print("{}\n", agent.bins_above(kmers, 2).find_first()); // 0
+
+    // write the filter; the written data can be memory-mapped and queried in place
+    std::stringstream stream;
+    ibf.write(stream);
+    fmt::print("{}\n", bio::kmer::interleaved_bloom_filter::read(stream) == ibf); // true
+}
@@ -0,0 +1,32 @@
+#include <string>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/kmer_counter.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> reads;
+    reads.push_back("ACGTTGCATTAGCCGATACG"_dna5);
+    reads.push_back("CGTATCGGCTAATGCAACGT"_dna5); // reverse complement of the first read
+    reads.push_back("TTAGCCGATACGNNNNNNNN"_dna5);
+
+    // canonical 11-mers that occur at least 3 times (the two 11-mers of the last read)
+    bio::kmer::kmer_counter counter{{.k = 11, .minimizer_length = 5, .partitions = 4, .min_count = 3}};
+    counter.add_all(reads);
+
+    counter.for_each_count(
+      [](bio::kmer::kmer_count const & c)
+      {
+          std::string kmer;
+          for (int i = 10; i >= 0; --i)
+              kmer += "ACGT"[(c.kmer >> (2 * i)) & 3];
+          fmt::print("{} {}\n", kmer, c.count);
+      });
+    // CGTATCGGCTA 3
+    // GTATCGGCTAA 3
+}
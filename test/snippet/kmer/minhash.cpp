@@ -0,0 +1,26 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/minhash.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    std::vector<bio::alphabet::dna4_vector> const genomes{"ACGTTGCATTAGCCGATACGGATCCATGCA"_dna4,
+                                                          "ACGTTGCATTAGCCGATACGGTTCCATGCA"_dna4};
+
+    // bottom-k sketches of 11-mers, one per genome
+    bio::kmer::minhash_options const             options{.k = 11, .sketch_size = 100};
+    std::vector<bio::kmer::minhash_sketch> const sketches = bio::kmer::sketch_each(genomes, options);
+
+    fmt::print("{} {}\n", sketches[0].size(), sketches[1].size()); // 20 20
+    fmt::print("{:.2f}\n", bio::kmer::jaccard(sketches[0], sketches[1])); // 0.38
+
+    // sketches can also be built incrementally
+    bio::kmer::minhash_sketcher sketcher{options};
+    sketcher.add(genomes[0]);
+    fmt::print("{}\n", sketcher.sketch() == sketches[0]); // true
+}
@@ -0,0 +1,29 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/demultiplexer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // 8bp sample barcodes at the start of the reads; allow one mismatch
+    bio::preprocessing::demultiplexer demux{std::vector{"ACGTACGT"_dna5, "TTGCAAGC"_dna5, "GATCCTAG"_dna5}};
+
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    reads.push_back("TTGCAAGCATTAGCGGATC"_dna5); // exact match of barcode 1
+    reads.push_back("GATCGTAGCCATTAGGACA"_dna5); // one mismatch to barcode 2
+    reads.push_back("ACGTNCGTAGGCTAGCATT"_dna5); // N counts as mismatch
+    reads.push_back("CCCCCCCCAGGCTAGCATT"_dna5); // no barcode
+
+    for (bio::preprocessing::demux_result const res : demux.barcodes_of(reads))
+    {
+        if (res.barcode == bio::preprocessing::demux_result::unassigned)
+            fmt::print("unassigned\n");
+        else
+            fmt::print("barcode {} with {} mismatches\n", res.barcode, res.mismatches);
+    }
+}
@@ -0,0 +1,31 @@
+#include <vector>
+
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/preprocessing/pair_merger.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // fragment: ACGTTGCAAGGCTTACGATCGGATCCATGACTGACCTAGG
+    auto const seq1 = "ACGTTGCAAGGCTTACGATCGGATCC"_dna5;
+    auto const seq2 = "CCTAGGTCAGTCATGGATCCGATCGTAA"_dna5; // reverse complement of the last 28 letters
+
+    std::vector<bio::alphabet::phred42> const qual1(seq1.size(), bio::alphabet::phred42{}.assign_phred(30));
+    std::vector<bio::alphabet::phred42> const qual2(seq2.size(), bio::alphabet::phred42{}.assign_phred(20));
+
+    bio::preprocessing::pair_merger     merger{{.min_overlap = 10, .max_error_rate = 0.1f}};
+    std::vector<bio::alphabet::dna5>    seq;
+    std::vector<bio::alphabet::phred42> qual;
+
+    auto const res = merger.merge(seq1, qual1, seq2, qual2, seq, qual);
+    fmt::print("offset: {} overlap: {} mismatches: {}\n", res.offset, res.overlap, res.mismatches);
+    // offset: 12 overlap: 14 mismatches: 0
+    fmt::print("{}\n{}\n", seq, qual);
+    // ACGTTGCAAGGCTTACGATCGGATCCATGACTGACCTAGG
+    // ????????????JJJJJJJJJJJJJJ55555555555555
+}
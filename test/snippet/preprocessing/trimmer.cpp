@@ -0,0 +1,28 @@
+#include <vector>
+
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/trimmer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // Illumina TruSeq adapter; also remove poly-G tails (two-colour chemistry)
+    bio::preprocessing::trimmer trimmer{"AGATCGGAAGAGC"_dna5, {.poly_x = {'G'_dna5}}};
+
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    reads.push_back("ACGTTAGCTAAGATCGGAAGAGCACACG"_dna5); // full adapter
+    reads.push_back("ACGTTAGCTAGGCAATAGATCG"_dna5);       // partial adapter at the end
+    reads.push_back("ACGTTAGCTAGGGGGGGGGGGGGGGG"_dna5);   // poly-G tail
+    reads.push_back("ACGTTAGCTAGGCAATCCGA"_dna5);         // nothing to trim
+
+    std::vector<size_t> const ends = trimmer.trim_positions(reads);
+    fmt::print("{}\n", ends); // [10, 16, 10, 20]
+
+    for (size_t i = 0; i < reads.size(); ++i)
+        fmt::print("{}\n", reads[i] | std::views::take(ends[i]));
+}
@@ -0,0 +1,26 @@
+#include <vector>
+
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/preprocessing/umi_grouper.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // mapping position (e.g. reference id, 5' end and strand packed by the caller) and UMI of every read
+    std::vector<uint64_t> const positions{100, 100, 100, 100, 250, 250};
+
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna4>> umis;
+    umis.push_back("ACGTAC"_dna4);
+    umis.push_back("ACGTAC"_dna4);
+    umis.push_back("ACGTAA"_dna4); // sequencing error in the UMI of the first two
+    umis.push_back("TTGACA"_dna4); // a different molecule at the same position
+    umis.push_back("ACGTAC"_dna4); // same UMI, but a different position
+    umis.push_back("ACGTAC"_dna4);
+
+    bio::preprocessing::umi_grouper grouper{};
+    fmt::print("{}\n", grouper.group(positions, umis)); // [0, 0, 0, 1, 2, 2]
+}
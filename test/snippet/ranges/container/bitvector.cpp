@@ -0,0 +1,19 @@
+#include <bio/alphabet/fmt.hpp>
+#include <bio/ranges/container/bitvector.hpp>
+
+int main()
+{
+    // a mask over one million positions, e.g. "N" positions on a contig
+    bio::ranges::bitvector mask(1'000'000, false);
+    mask[17]      = true;
+    mask[500'000] = true;
+
+    bio::ranges::bitvector covered(1'000'000, true);
+    covered &= ~mask;                             // word-wise (and vectorised) operations
+
+    fmt::print("{}\n", covered.count());          // 999998
+
+    for (size_t i = mask.find_first(); i != bio::ranges::bitvector::npos; i = mask.find_next(i))
+        fmt::print("{} ", i);                     // 17 500000
+    fmt::print("\n");
+}
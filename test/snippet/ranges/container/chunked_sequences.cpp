@@ -0,0 +1,22 @@
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <bio/ranges/container/chunked_sequences.hpp>
+
+int main()
+{
+    // chunks hold 32 characters here (the default is 4Mi)
+    bio::ranges::chunked_sequences<std::string> reads{32};
+
+    reads.push_back(std::string_view{"ACGTACGTACGTACGTACGT"});
+    std::string_view first = std::as_const(reads)[0];
+
+    reads.push_back(std::string_view{"GATTACAGATTACAGATTAC"}); // does not fit, so a second chunk is allocated
+    reads.push_back(std::string_view{"TT"});
+
+    fmt::print("{} sequences in {} chunks\n", reads.size(), reads.chunk_count()); // 3 sequences in 2 chunks
+    fmt::print("{}\n", first); // "ACGTACGTACGTACGTACGT" -- still valid, nothing was relocated
+}
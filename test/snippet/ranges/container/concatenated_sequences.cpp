@@ -22,8 +22,7 @@ int main()
     // if you know that you will be adding ten vectors of length ten:
     std::vector<bio::alphabet::dna4> vector_of_length10{"ACGTACGTAC"_dna4};
 
-    concat1.reserve(10);
-    concat1.concat_reserve(10 * vector_of_length10.size());
+    concat1.reserve(10, 10 * vector_of_length10.size()); // number of sequences and total length
     while (concat1.size() < 10)
     {
         // ...
@@ -0,0 +1,16 @@
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/container/run_length_sequence.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::ranges::run_length_sequence rls{"AAACGGTTTT"_dna4};
+
+    fmt::print("{}\n", rls.letters());              // ACGT
+    fmt::print("{} {}\n", rls.size(), rls[5]);      // 10 G
+
+    size_t run = rls.run_of(5);                     // 2
+    fmt::print("[{}, {})\n", rls.run_begin(run), rls.run_end(run)); // [4, 6)
+}
@@ -0,0 +1,11 @@
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/views/rle.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::alphabet::dna4_vector vec = "AAACGGTTTT"_dna4;
+    fmt::print("{}\n", vec | bio::views::homopolymer_compress);   // ACGT
+}
@@ -0,0 +1,14 @@
+#include <bio/alphabet/fmt.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/views/rle.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::alphabet::dna4_vector vec = "AAACGGTTTT"_dna4;
+
+    for (auto [letter, length] : vec | bio::views::rle)
+        fmt::print("{}{} ", length, letter);        // 3A 1C 2G 4T
+    fmt::print("\n");
+}
@@ -0,0 +1,17 @@
+#include <string>
+
+#include <bio/alphabet/fmt.hpp>
+#include <bio/ranges/views/single_pass_input.hpp>
+#include <bio/ranges/views/take_until.hpp>           // provides views::take_line and views::take_line_or_throw
+
+int main()
+{
+    std::string vec{"foo\r\nbar\nbaz"};
+    fmt::print("{}\n", vec | bio::views::take_line); // "foo"
+
+    // on single pass input, the end-of-line marker is consumed
+    auto in = vec | bio::views::single_pass_input;
+    fmt::print("{}\n", in | bio::views::take_line);  // "foo"
+    fmt::print("{}\n", in | bio::views::take_line);  // "bar"
+    fmt::print("{}\n", in | bio::views::take_line);  // "baz"
+}
@@ -0,0 +1,15 @@
+#include <string>
+
+#include <bio/alphabet/fmt.hpp>
+#include <bio/ranges/views/take_until.hpp>           // provides views::take_until and views::take_until_or_throw
+
+int main()
+{
+    std::string vec{"foo\tbar baz"};
+    auto v = vec | bio::views::take_until(" \t");   // delimiter set; searched in bulk on contiguous input
+    fmt::print("{}\n", v);                           // "foo"
+
+    auto is_a = [] (char const c) { return c == 'a'; };
+    auto v2 = vec | bio::views::take_until(is_a);   // any predicate
+    fmt::print("{}\n", v2);                          // "foo\tb"
+}
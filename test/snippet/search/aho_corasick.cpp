@@ -0,0 +1,28 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/search/aho_corasick.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // adapter prefixes to screen for
+    std::vector<bio::alphabet::dna5_vector> const adapters{"AGATCGGAAG"_dna5, "CTGTCTCTTA"_dna5, "GATCGGAAGAGC"_dna5};
+    bio::search::aho_corasick const               screen{adapters};
+
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> reads;
+    reads.push_back("ACGTTAGATCGGAAGAGCACAC"_dna5);
+    reads.push_back("TTTTTTTTTTTTTTTTTTT"_dna5);
+    reads.push_back("GGCTGTCTCTTATACACATC"_dna5);
+
+    screen.find_each(reads,
+                     [](size_t const read, bio::search::aho_corasick_hit const & hit)
+                     { fmt::print("read {}: adapter {} at {}\n", read, hit.pattern, hit.position); });
+    // read 2: adapter 1 at 2
+    // read 0: adapter 0 at 5
+    // read 0: adapter 2 at 6
+}
@@ -0,0 +1,18 @@
+#include <fmt/ranges.h>
+
+#include <bio/alphabet/nucleotide/dna15.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/search/iupac.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::alphabet::dna5_vector const genome = "ACCAGGTNNNNNCCTGGA"_dna5;
+
+    // EcoRII recognition site: CCWGG with W = A or T
+    fmt::print("{}\n", bio::search::find_iupac("CCWGG"_dna15, genome)); // [1, 7, 12]
+
+    // do not let N in the genome match
+    fmt::print("{}\n", bio::search::find_iupac("CCWGG"_dna15, genome, {.strict_text = true})); // [1, 12]
+}
@@ -0,0 +1,26 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/search/pwm.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    // log-odds scores of A, C, G, T at the four positions of the motif TGAC (the last position also allows T)
+    std::vector<bio::search::position_weight_matrix> const motifs{{.scores    = {{-1.0f, -1.0f, -1.0f, 2.0f},
+                                                                                 {-1.0f, -1.0f, 2.0f, -1.0f},
+                                                                                 {2.0f, -1.0f, -1.0f, -1.0f},
+                                                                                 {-1.0f, 1.5f, -1.0f, 1.0f}},
+                                                                    .threshold = 6.5f}};
+
+    bio::alphabet::dna5_vector const genome = "GGTGACCNTGATTTGTCACC"_dna5;
+
+    for (bio::search::pwm_hit const & hit : bio::search::scan_pwm(motifs, genome))
+        fmt::print("{} {} {:.1f}\n", hit.position, hit.reverse ? '-' : '+', hit.score);
+    // 2 + 7.5
+    // 8 + 7.0
+    // 14 - 7.5
+}
@@ -0,0 +1,23 @@
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/search/shift_and.hpp>
+
+int main()
+{
+    using namespace bio::alphabet::literals;
+
+    bio::alphabet::dna4_vector const text = "ACGTTGCAACGAACCT"_dna4;
+
+    // one pattern, up to one mismatch
+    for (bio::search::shift_and_hit const & hit : bio::search::find_shift_and("ACGT"_dna4, text, {.max_mismatches = 1}))
+        fmt::print("ACGT at {} ({} mismatches)\n", hit.position, hit.mismatches);
+
+    // several patterns in one pass
+    std::vector<bio::alphabet::dna4_vector> const motifs{"GCAA"_dna4, "AAC"_dna4};
+    bio::search::shift_and                        finder{motifs};
+    for (bio::search::shift_and_hit const & hit : finder.find(text))
+        fmt::print("motif {} at {}\n", hit.pattern, hit.position);
+}
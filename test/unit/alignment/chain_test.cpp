@@ -0,0 +1,251 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alignment/chain.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using bio::alignment::anchor;
+using bio::alignment::chain;
+using bio::alignment::chainer;
+using bio::alignment::chaining_mode;
+using bio::alignment::chaining_options;
+
+// anchors of k = 15 every 5 to 14 letters along a diagonal with some small indels, plus random noise
+static std::vector<anchor> make_anchors(std::mt19937_64 & gen, size_t const colinear, size_t const noise)
+{
+    std::vector<anchor> ret;
+    uint32_t            q = 1'000 + gen() % 1'000;
+    uint32_t            t = 5'000 + gen() % 1'000;
+    for (size_t i = 0; i < colinear; ++i)
+    {
+        ret.push_back({q, t, 15});
+        uint32_t const step = 5 + gen() % 10;
+        q += step;
+        t += step + (i % 20 == 19 ? 3 : 0);
+    }
+    for (size_t i = 0; i < noise; ++i)
+        ret.push_back({static_cast<uint32_t>(gen() % 20'000), static_cast<uint32_t>(gen() % 50'000), 15});
+    return ret;
+}
+
+static std::vector<anchor> sorted_anchors(std::vector<anchor> anchors)
+{
+    std::ranges::sort(anchors,
+                      [](anchor const & l, anchor const & r)
+                      { return l.target < r.target || (l.target == r.target && l.query < r.query); });
+    return anchors;
+}
+
+// the lookback DP over all predecessors, with log2 computed in the loop
+static std::vector<int32_t> naive_lookback(std::vector<anchor> const & anchors, chaining_options const & o)
+{
+    std::vector<int32_t> f(anchors.size());
+    for (size_t i = 0; i < anchors.size(); ++i)
+    {
+        anchor const & a = anchors[i];
+        f[i]             = a.length;
+        for (size_t j = 0; j < i; ++j)
+        {
+            anchor const & b = anchors[j];
+            if (b.target >= a.target || b.query >= a.query)
+                continue;
+            int64_t const dt = a.target - b.target, dq = a.query - b.query;
+            int64_t const l  = std::abs(dq - dt);
+            if (dt > o.max_distance || dq > o.max_distance || l > o.max_skew)
+                continue;
+            int32_t const cost = l == 0 ? 0 : static_cast<int32_t>(o.gap_cost * l / 100.0 + 0.5 * std::log2(l));
+            int32_t const gain = static_cast<int32_t>(std::min<int64_t>({dq, dt, a.length}));
+            f[i]               = std::max(f[i], f[j] + gain - cost);
+        }
+    }
+    return f;
+}
+
+// the range_max DP over all predecessors
+static std::vector<int32_t> naive_range_max(std::vector<anchor> const & anchors, chaining_options const & o)
+{
+    std::vector<int32_t> f(anchors.size());
+    for (size_t i = 0; i < anchors.size(); ++i)
+    {
+        anchor const & a = anchors[i];
+        f[i]             = a.length;
+        for (size_t j = 0; j < i; ++j)
+        {
+            anchor const & b = anchors[j];
+            if (b.target >= a.target || b.query >= a.query)
+                continue;
+            int64_t const dt = a.target - b.target, dq = a.query - b.query;
+            if (dt > o.max_distance || dq > o.max_distance)
+                continue;
+            int64_t const cost = (o.distance_cost * (dq + dt) + 99) / 100;
+            f[i]               = std::max<int32_t>(f[i], f[j] - cost + a.length);
+        }
+    }
+    return f;
+}
+
+TEST(chain, single_chain)
+{
+    std::mt19937_64     gen{1};
+    std::vector<anchor> anchors = make_anchors(gen, 100, 0);
+    std::ranges::shuffle(anchors, gen);
+
+    for (chaining_mode const mode : {chaining_mode::lookback, chaining_mode::range_max})
+    {
+        chainer                      c{{.mode = mode}};
+        std::span<chain const> const chains = c.run(anchors);
+        ASSERT_EQ(chains.size(), 1u);
+        EXPECT_EQ(chains[0].anchors, 100u);
+
+        std::vector<anchor> const in_chain = c.anchors_of(0);
+        EXPECT_EQ(in_chain, sorted_anchors(anchors));
+        EXPECT_EQ(chains[0].query_begin, in_chain.front().query);
+        EXPECT_EQ(chains[0].target_begin, in_chain.front().target);
+        EXPECT_EQ(chains[0].query_end, in_chain.back().query + 15);
+        EXPECT_EQ(chains[0].target_end, in_chain.back().target + 15);
+        EXPECT_EQ(chains[0].score, *std::ranges::max_element(c.anchor_scores()));
+    }
+
+    chainer c{chaining_options{}};
+    EXPECT_TRUE(c.run({}).empty());
+}
+
+TEST(chain, lookback_matches_naive)
+{
+    std::mt19937_64 gen{2};
+    for (size_t round = 0; round < 5; ++round)
+    {
+        std::vector<anchor> anchors = make_anchors(gen, 200, 300);
+        // dense random anchors so that many predecessors are in range
+        for (size_t i = 0; i < 200; ++i)
+            anchors.push_back({static_cast<uint32_t>(gen() % 2'000), static_cast<uint32_t>(gen() % 2'000), 15});
+
+        chaining_options const o{.max_distance = 500,
+                                 .max_skew     = 100,
+                                 .max_lookback = 100'000,
+                                 .mode         = chaining_mode::lookback};
+        chainer                c{o};
+        c.run(anchors);
+        std::vector<int32_t> const expected = naive_lookback(sorted_anchors(anchors), o);
+        EXPECT_TRUE(std::ranges::equal(c.anchor_scores(), expected));
+    }
+}
+
+TEST(chain, range_max_matches_naive)
+{
+    std::mt19937_64 gen{3};
+    for (uint32_t const distance_cost : {1u, 7u, 50u})
+    {
+        std::vector<anchor> anchors = make_anchors(gen, 200, 300);
+        for (size_t i = 0; i < 300; ++i)
+            anchors.push_back({static_cast<uint32_t>(gen() % 1'000), static_cast<uint32_t>(gen() % 300), 15});
+
+        chaining_options const o{.max_distance  = 400,
+                                 .distance_cost = distance_cost,
+                                 .mode          = chaining_mode::range_max};
+        chainer                c{o};
+        c.run(anchors);
+        std::vector<int32_t> const expected = naive_range_max(sorted_anchors(anchors), o);
+        EXPECT_TRUE(std::ranges::equal(c.anchor_scores(), expected)) << distance_cost;
+    }
+}
+
+TEST(chain, filters)
+{
+    std::mt19937_64           gen{4};
+    std::vector<anchor> const anchors = make_anchors(gen, 4, 0);
+
+    EXPECT_EQ(chainer{{.min_anchors = 4}}.run(anchors).size(), 1u);
+    EXPECT_EQ(chainer{{.min_anchors = 5}}.run(anchors).size(), 0u);
+    EXPECT_EQ(chainer{{.min_score = 1'000}}.run(anchors).size(), 0u);
+}
+
+TEST(chain, two_chains)
+{
+    // two colinear sets that are too far apart to be chained
+    std::mt19937_64     gen{5};
+    std::vector<anchor> anchors = make_anchors(gen, 50, 0);
+    std::vector<anchor> second  = make_anchors(gen, 80, 0);
+    for (anchor & a : second)
+        a.target += 100'000;
+    anchors.insert(anchors.end(), second.begin(), second.end());
+
+    for (chaining_mode const mode : {chaining_mode::lookback, chaining_mode::range_max})
+    {
+        chainer                      c{{.mode = mode}};
+        std::span<chain const> const chains = c.run(anchors);
+        ASSERT_EQ(chains.size(), 2u);
+        EXPECT_EQ(chains[0].anchors, 80u); // by decreasing score
+        EXPECT_EQ(chains[1].anchors, 50u);
+        EXPECT_GT(chains[0].score, chains[1].score);
+    }
+}
+
+TEST(chain, automatic)
+{
+    std::mt19937_64           gen{6};
+    std::vector<anchor> const anchors = make_anchors(gen, 100, 100);
+
+    chainer range_max{{.mode = chaining_mode::range_max}};
+    chainer automatic{{.range_max_threshold = 100}};
+    EXPECT_TRUE(std::ranges::equal(range_max.run(anchors), automatic.run(anchors)));
+    EXPECT_TRUE(std::ranges::equal(range_max.anchor_scores(), automatic.anchor_scores()));
+}
+
+TEST(chain, chain_all)
+{
+    std::mt19937_64                                          gen{7};
+    bio::ranges::concatenated_sequences<std::vector<anchor>> lists;
+    for (size_t i = 0; i < 50; ++i)
+        lists.push_back(make_anchors(gen, gen() % 100, gen() % 100));
+
+    chainer                         c{chaining_options{}};
+    std::vector<std::vector<chain>> expected;
+    for (auto && list : lists)
+    {
+        std::vector<anchor> const copy{list.begin(), list.end()};
+        std::span<chain const>    chains = c.run(copy);
+        expected.emplace_back(chains.begin(), chains.end());
+    }
+
+    for (size_t const threads : {1, 3, 8})
+        EXPECT_EQ(bio::alignment::chain_all(lists, {.threads = threads}), expected);
+}
+
+TEST(chain, classify_overlap)
+{
+    using bio::alignment::classify_overlap;
+    using bio::alignment::overlap_type;
+
+    // query [0, 10000), target [0, 12000)
+    chain c{.score = 1'000, .anchors = 100};
+    auto  with = [&](uint32_t const qb, uint32_t const qe, uint32_t const tb, uint32_t const te)
+    {
+        c.query_begin  = qb;
+        c.query_end    = qe;
+        c.target_begin = tb;
+        c.target_end   = te;
+        return classify_overlap(c, 10'000, 12'000, 100);
+    };
+
+    EXPECT_EQ(with(50, 9'950, 1'000, 10'900), overlap_type::query_contained);
+    EXPECT_EQ(with(5'000, 10'000, 0, 5'000), overlap_type::query_to_target);
+    EXPECT_EQ(with(0, 4'000, 8'000, 12'000), overlap_type::target_to_query);
+    EXPECT_EQ(with(3'000, 7'000, 4'000, 8'000), overlap_type::internal);
+
+    c.query_begin  = 3'000;
+    c.query_end    = 4'000;
+    c.target_begin = 0;
+    c.target_end   = 1'000;
+    EXPECT_EQ(classify_overlap(c, 10'000, 1'000, 100), overlap_type::target_contained);
+}
@@ -0,0 +1,155 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alignment/coverage.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using bio::alignment::coverage;
+using bio::alignment::coverage_track;
+
+static std::vector<bio::alphabet::cigar> cigar(std::string_view str)
+{
+    std::vector<bio::alphabet::cigar> ret;
+    while (!str.empty())
+    {
+        size_t const n = str.find_first_not_of("0123456789") + 1;
+        ret.push_back(bio::alphabet::cigar{}.assign_string(str.substr(0, n)));
+        str.remove_prefix(n);
+    }
+    return ret;
+}
+
+static std::vector<uint32_t> depths(coverage_track const & track)
+{
+    std::vector<uint32_t> ret;
+    for (size_t i = 0; i < track.size(); ++i)
+        ret.push_back(track[i]);
+    return ret;
+}
+
+// walks every position of every alignment
+static std::vector<uint32_t> naive_coverage(size_t const                                           length,
+                                            std::vector<uint64_t> const &                          positions,
+                                            std::vector<std::vector<bio::alphabet::cigar>> const & cigars,
+                                            bool const                                             deletions)
+{
+    std::vector<uint32_t> ret(length);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        uint64_t ref = positions[i];
+        for (auto const c : cigars[i])
+        {
+            char const op = get<1>(c).to_char();
+            for (uint32_t j = 0; j < get<0>(c); ++j)
+            {
+                if ((op == 'M' || op == '=' || op == 'X' || (deletions && op == 'D')) && ref < length)
+                    ++ret[ref];
+                ref += op == 'M' || op == '=' || op == 'X' || op == 'D' || op == 'N';
+            }
+        }
+    }
+    return ret;
+}
+
+TEST(coverage, add)
+{
+    coverage cov{12};
+    EXPECT_EQ(cov.size(), 12u);
+    cov.add(1, cigar("3M"));
+    cov.add(2, cigar("2S2M1D1M2I1M5H"));
+    cov.add(6, cigar("1M3N2M"));
+
+    //                                        0  1  2  3  4  5  6  7  8  9 10 11
+    EXPECT_EQ(depths(cov.track()), (std::vector<uint32_t>{0, 1, 2, 2, 1, 1, 2, 0, 0, 0, 1, 1}));
+
+    coverage no_del{12, {.count_deletions = false}};
+    no_del.add(2, cigar("2M1D1M"));
+    EXPECT_EQ(depths(no_del.track()), (std::vector<uint32_t>{0, 0, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0}));
+
+    cov.clear();
+    EXPECT_EQ(cov.track().max_depth(), 0u);
+}
+
+TEST(coverage, clipped)
+{
+    coverage cov{5};
+    cov.add(3, cigar("10M"));
+    cov.add(7, cigar("10M"));
+    EXPECT_EQ(depths(cov.track()), (std::vector<uint32_t>{0, 0, 0, 1, 1}));
+
+    coverage empty{0};
+    empty.add(0, cigar("10M"));
+    EXPECT_EQ(empty.track().size(), 0u);
+}
+
+TEST(coverage, narrow_and_wide)
+{
+    coverage cov{10};
+    for (size_t i = 0; i < 65535; ++i)
+        cov.add(2, cigar("3M"));
+
+    coverage_track track = cov.track();
+    EXPECT_TRUE(track.is_narrow());
+    EXPECT_EQ(track.max_depth(), 65535u);
+    EXPECT_EQ(track.narrow_depths().size(), 10u);
+    EXPECT_TRUE(track.wide_depths().empty());
+
+    cov.add(4, cigar("1M"));
+    track = cov.track();
+    EXPECT_FALSE(track.is_narrow());
+    EXPECT_EQ(track.max_depth(), 65536u);
+    EXPECT_EQ(track[4], 65536u);
+    EXPECT_EQ(track[3], 65535u);
+    EXPECT_EQ(track.wide_depths().size(), 10u);
+}
+
+TEST(coverage, add_all)
+{
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<size_t> position{0, 2000};
+    std::uniform_int_distribution<int>    op{0, 9};
+    std::uniform_int_distribution<int>    len{1, 50};
+
+    std::vector<uint64_t>                                                  positions;
+    std::vector<std::vector<bio::alphabet::cigar>>                         cigars;
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::cigar>> concat;
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        positions.push_back(position(gen));
+        cigars.emplace_back();
+        for (size_t j = 0, n = op(gen) + 1; j < n; ++j)
+            cigars.back().push_back(bio::alphabet::cigar{static_cast<uint32_t>(len(gen)),
+                                                         bio::alphabet::cigar_op{}.assign_char("MMMMIDNS=X"[op(gen)])});
+        concat.push_back(cigars.back());
+    }
+
+    for (bool deletions : {true, false})
+    {
+        auto const expected = naive_coverage(2048, positions, cigars, deletions);
+
+        coverage single{2048, {.count_deletions = deletions}};
+        for (size_t i = 0; i < positions.size(); ++i)
+            single.add(positions[i], cigars[i]);
+        EXPECT_EQ(depths(single.track()), expected);
+
+        for (size_t threads : {1, 2, 5})
+        {
+            coverage cov{2048, {.count_deletions = deletions, .threads = threads}};
+            cov.add_all(positions, concat);
+            EXPECT_EQ(depths(cov.track()), expected);
+        }
+    }
+
+    coverage cov{10};
+    EXPECT_THROW(cov.add_all(std::vector<uint64_t>{1}, concat), std::invalid_argument);
+}
@@ -0,0 +1,144 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <cmath>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alignment/msa_profile.hpp>
+#include <bio/alphabet/aminoacid/aa27.hpp>
+#include <bio/alphabet/gap/gapped.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+using namespace bio::alphabet::literals;
+
+using gapped_dna5 = bio::alphabet::gapped<bio::alphabet::dna5>;
+
+static std::vector<gapped_dna5> row(std::string_view const str)
+{
+    return str | bio::views::char_to<gapped_dna5> | bio::ranges::to<std::vector>();
+}
+
+TEST(msa_profile, counts)
+{
+    std::vector<std::vector<gapped_dna5>> const msa{row("ACGT-A"), row("ACCT-A"), row("A-GTTA"), row("TCGT-C")};
+
+    bio::alignment::msa_profile profile{msa};
+    EXPECT_EQ(profile.rows(), 4u);
+    EXPECT_EQ(profile.columns(), 6u);
+    EXPECT_EQ(profile.alphabet_size, 6u);
+
+    // A C G N T -
+    EXPECT_RANGE_EQ(profile.counts(0), (std::vector<uint32_t>{3, 0, 0, 0, 1, 0}));
+    EXPECT_RANGE_EQ(profile.counts(1), (std::vector<uint32_t>{0, 3, 0, 0, 0, 1}));
+    EXPECT_RANGE_EQ(profile.counts(4), (std::vector<uint32_t>{0, 0, 0, 0, 1, 3}));
+    EXPECT_RANGE_EQ(profile.weights(2), (std::vector<float>{0, 1, 3, 0, 0, 0}));
+
+    EXPECT_RANGE_EQ(profile.consensus(), row("ACGT-A"));
+
+    EXPECT_FLOAT_EQ(profile.frequencies(0)[0], 0.75f);
+    EXPECT_FLOAT_EQ(profile.entropy(3), 0.0f);
+    EXPECT_FLOAT_EQ(profile.entropy(0), -(0.75f * std::log2(0.75f) + 0.25f * std::log2(0.25f)));
+
+    auto const p = profile.profile();
+    ASSERT_EQ(p.size(), 6u);
+    EXPECT_FLOAT_EQ(p[4][5], 0.75f);
+}
+
+TEST(msa_profile, ties_and_empty)
+{
+    std::vector<std::vector<gapped_dna5>> const msa{row("AC"), row("CA")};
+
+    bio::alignment::msa_profile profile{msa};
+    EXPECT_RANGE_EQ(profile.consensus(), row("AA")); // smallest rank wins
+
+    bio::alignment::msa_profile<gapped_dna5> empty{std::vector<std::vector<gapped_dna5>>{}};
+    EXPECT_EQ(empty.rows(), 0u);
+    EXPECT_EQ(empty.columns(), 0u);
+    EXPECT_TRUE(empty.consensus().empty());
+}
+
+TEST(msa_profile, qualities)
+{
+    std::vector<std::vector<gapped_dna5>> const msa{row("AC-"), row("GC-"), row("GCA")};
+
+    auto qual = [](std::vector<int> const & phreds)
+    {
+        std::vector<bio::alphabet::phred42> ret;
+        for (int const p : phreds)
+            ret.push_back(bio::alphabet::phred42{}.assign_phred(p));
+        return ret;
+    };
+    std::vector<std::vector<bio::alphabet::phred42>> const quals{qual({40, 30, 0}), qual({3, 30, 0}), qual({3, 30, 0})};
+
+    bio::alignment::msa_profile profile{msa, quals};
+    // one confident A outweighs two unreliable G
+    EXPECT_EQ(profile.consensus(0), gapped_dna5{'A'_dna5});
+    EXPECT_RANGE_EQ(profile.counts(0), (std::vector<uint32_t>{1, 0, 2, 0, 0, 0}));
+    EXPECT_NEAR(profile.weights(0)[0], 0.9999f, 1e-4f);
+    EXPECT_NEAR(profile.weights(0)[2], 2 * (1.0f - std::pow(10.0f, -0.3f)), 1e-5f);
+    // gaps have weight 1, phred 0 has weight 0
+    EXPECT_FLOAT_EQ(profile.weights(2)[5], 2.0f);
+    EXPECT_FLOAT_EQ(profile.weights(2)[0], 0.0f);
+    EXPECT_EQ(profile.consensus(2), gapped_dna5{bio::alphabet::gap{}});
+}
+
+TEST(msa_profile, errors)
+{
+    std::vector<std::vector<gapped_dna5>> const msa{row("ACGT"), row("ACG")};
+    EXPECT_THROW(bio::alignment::msa_profile{msa}, std::invalid_argument);
+
+    std::vector<std::vector<gapped_dna5>> const            msa2{row("ACGT"), row("ACGT")};
+    std::vector<std::vector<bio::alphabet::phred42>> const quals(2, std::vector<bio::alphabet::phred42>(3));
+    EXPECT_THROW((bio::alignment::msa_profile{msa2, quals}), std::invalid_argument);
+}
+
+// many rows and columns (multiple tiles), protein alphabet, threads; compared with straightforward counting
+TEST(msa_profile, random)
+{
+    using gapped_aa27 = bio::alphabet::gapped<bio::alphabet::aa27>;
+
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> rank{0, 27};
+
+    for (auto [n_rows, n_cols] : {std::pair<size_t, size_t>{1, 1}, {127, 129}, {300, 500}, {129, 1000}})
+    {
+        bio::ranges::concatenated_sequences<std::vector<gapped_aa27>> msa;
+        std::vector<gapped_aa27>                                      r(n_cols);
+        for (size_t i = 0; i < n_rows; ++i)
+        {
+            for (auto & l : r)
+                l.assign_rank(rank(gen) % (i % 3 == 0 ? 28 : 4)); // bias towards a few letters
+            msa.push_back(r);
+        }
+
+        std::vector<uint32_t> expected(n_cols * 28);
+        for (size_t i = 0; i < n_rows; ++i)
+            for (size_t c = 0; c < n_cols; ++c)
+                ++expected[c * 28 + msa[i][c].to_rank()];
+
+        for (size_t threads : {1, 3})
+        {
+            bio::alignment::msa_profile profile{msa, {.threads = threads}};
+            ASSERT_EQ(profile.columns(), n_cols);
+            for (size_t c = 0; c < n_cols; ++c)
+            {
+                EXPECT_RANGE_EQ(profile.counts(c), (std::span<uint32_t const>{expected.data() + c * 28, 28}));
+                auto const   counts = profile.counts(c);
+                size_t const best   = std::ranges::max_element(counts) - counts.begin();
+                EXPECT_EQ(profile.consensus(c).to_rank(), best);
+            }
+        }
+    }
+}
@@ -0,0 +1,245 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alignment/pileup.hpp>
+#include <bio/alphabet/cigar/cigar.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+
+using namespace bio::alphabet::literals;
+
+using bio::alignment::pileup;
+using bio::alignment::pileup_column;
+
+using record_t = bio::alignment::pileup_record<std::vector<bio::alphabet::cigar>,
+                                               std::vector<bio::alphabet::dna5>,
+                                               std::vector<bio::alphabet::phred42>>;
+
+static std::vector<bio::alphabet::cigar> cigar(std::string_view str)
+{
+    std::vector<bio::alphabet::cigar> ret;
+    while (!str.empty())
+    {
+        size_t const n = str.find_first_not_of("0123456789") + 1;
+        ret.push_back(bio::alphabet::cigar{}.assign_string(str.substr(0, n)));
+        str.remove_prefix(n);
+    }
+    return ret;
+}
+
+static record_t record(uint64_t const position, std::string_view const c, std::string_view const seq, int phred = -1)
+{
+    record_t ret{position, cigar(c), seq | bio::views::char_to<bio::alphabet::dna5> | bio::ranges::to<std::vector>()};
+    if (phred >= 0)
+        ret.qualities.assign(seq.size(), bio::alphabet::phred42{}.assign_phred(phred));
+    return ret;
+}
+
+static std::vector<pileup_column> run(pileup & p, std::vector<record_t> const & records)
+{
+    std::vector<pileup_column> ret;
+    auto                       emit = [&](pileup_column const & col) { ret.push_back(col); };
+    for (record_t const & r : records)
+        p.add(r, emit);
+    p.finish(emit);
+    return ret;
+}
+
+// applies every record to a map of columns
+static std::vector<pileup_column> naive_pileup(std::vector<record_t> const & records, uint8_t const min_quality)
+{
+    std::map<uint64_t, pileup_column> columns;
+    for (record_t const & r : records)
+    {
+        uint64_t ref = r.position;
+        size_t   q   = 0;
+        for (auto const c : r.cigar)
+        {
+            char const op = get<1>(c).to_char();
+            for (uint32_t i = 0; i < get<0>(c); ++i)
+            {
+                if (op == 'M' || op == '=' || op == 'X')
+                {
+                    int const phred = r.qualities.empty() ? 0 : r.qualities[q].to_phred();
+                    if (r.qualities.empty() || phred >= min_quality)
+                    {
+                        ++columns[ref].counts[r.sequence[q].to_rank()];
+                        columns[ref].quality_sums[r.sequence[q].to_rank()] += phred;
+                    }
+                }
+                if (op == 'D')
+                    ++columns[ref].deletions;
+                if (op == 'I' && i == 0)
+                    ++columns[ref].insertions;
+                ref += op == 'M' || op == '=' || op == 'X' || op == 'D' || op == 'N';
+                q += op == 'M' || op == '=' || op == 'X' || op == 'I' || op == 'S';
+            }
+        }
+    }
+
+    std::vector<pileup_column> ret;
+    for (auto & [position, col] : columns)
+    {
+        col.position = position;
+        ret.push_back(col);
+    }
+    return ret;
+}
+
+TEST(pileup, simple)
+{
+    pileup     p{};
+    auto const cols = run(p, {record(10, "4M", "ACGT", 30), record(12, "2M1D2M", "GTAC", 20)});
+
+    ASSERT_EQ(cols.size(), 7u);
+    EXPECT_EQ(cols[0].position, 10u);
+    EXPECT_EQ(cols[0].counts, (std::array<uint32_t, 5>{1, 0, 0, 0, 0}));
+    EXPECT_EQ(cols[2].position, 12u);
+    EXPECT_EQ(cols[2].counts, (std::array<uint32_t, 5>{0, 0, 2, 0, 0}));
+    EXPECT_EQ(cols[2].quality_sums, (std::array<uint32_t, 5>{0, 0, 50, 0, 0}));
+    EXPECT_EQ(cols[2].depth(), 2u);
+    EXPECT_EQ(cols[4].position, 14u);
+    EXPECT_EQ(cols[4].deletions, 1u);
+    EXPECT_EQ(cols[4].depth(), 1u);
+    EXPECT_EQ(cols[6].position, 16u);
+}
+
+TEST(pileup, insertions_and_clips)
+{
+    pileup     p{};
+    auto const cols = run(p, {record(0, "2S2M2I2M1H", "TTACGGTA"), record(1, "3M3I", "CTGAAA")});
+
+    // read 1: A@0 C@1 (insertion GG before 2) T@2 A@3; read 2: C@1 T@2 G@3, insertion before 4
+    ASSERT_EQ(cols.size(), 5u);
+    EXPECT_EQ(cols[1].counts[1], 2u);
+    EXPECT_EQ(cols[2].insertions, 1u);
+    EXPECT_EQ(cols[2].counts[4], 2u);
+    EXPECT_EQ(cols[4].position, 4u);
+    EXPECT_EQ(cols[4].insertions, 1u);
+    EXPECT_EQ(cols[4].depth(), 0u);
+}
+
+TEST(pileup, gaps_and_skips)
+{
+    pileup     p{};
+    auto const cols = run(p, {record(0, "2M100N2M", "ACGT"), record(1000, "1M", "A")});
+
+    ASSERT_EQ(cols.size(), 5u);
+    EXPECT_EQ(cols[2].position, 102u);
+    EXPECT_EQ(cols[4].position, 1000u);
+}
+
+TEST(pileup, min_quality)
+{
+    pileup     p{{.min_quality = 25}};
+    auto const cols = run(p, {record(0, "2M", "AC", 30), record(0, "2M", "AC", 20), record(0, "2M", "AG")});
+
+    ASSERT_EQ(cols.size(), 2u);
+    EXPECT_EQ(cols[0].counts[0], 2u);
+    EXPECT_EQ(cols[0].quality_sums[0], 30u);
+    EXPECT_EQ(cols[1].counts, (std::array<uint32_t, 5>{0, 1, 1, 0, 0}));
+}
+
+TEST(pileup, long_reads)
+{
+    // longer than the initial ring buffer, overlapping
+    std::string const seq(5000, 'A');
+    pileup            p{};
+    auto const        cols = run(p, {record(0, "3000M", seq), record(1500, "5000M", seq), record(2000, "10M", seq)});
+
+    ASSERT_EQ(cols.size(), 6500u);
+    EXPECT_EQ(cols[1499].depth(), 1u);
+    EXPECT_EQ(cols[1500].depth(), 2u);
+    EXPECT_EQ(cols[2005].depth(), 3u);
+    EXPECT_EQ(cols[3000].depth(), 1u);
+    EXPECT_EQ(cols.back().position, 6499u);
+}
+
+TEST(pileup, errors)
+{
+    pileup p{};
+    auto   emit = [](pileup_column const &) {};
+    p.add(record(10, "2M", "AC"), emit);
+    EXPECT_THROW(p.add(record(9, "2M", "AC"), emit), std::invalid_argument);
+    EXPECT_THROW(p.add(record(10, "3M", "AC"), emit), std::invalid_argument);
+
+    record_t r = record(10, "2M", "AC", 30);
+    r.qualities.pop_back();
+    EXPECT_THROW(p.add(r, emit), std::invalid_argument);
+
+    // after finish(), any position is fine
+    p.finish(emit);
+    EXPECT_NO_THROW(p.add(record(0, "2M", "AC"), emit));
+}
+
+TEST(pileup, random)
+{
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<int>    letter{0, 4};
+    std::uniform_int_distribution<size_t> len{1, 30};
+    std::uniform_int_distribution<int>    op{0, 9};
+
+    std::vector<std::vector<record_t>> regions;
+    for (size_t region = 0; region < 7; ++region)
+    {
+        std::vector<record_t> records;
+        uint64_t              position = 0;
+        for (size_t i = 0; i < 300; ++i)
+        {
+            position += len(gen) % 7 == 0 ? len(gen) * 50 : len(gen) / 5;
+
+            record_t r{position};
+            for (size_t j = 0, n = len(gen) % 6 + 1; j < n; ++j)
+            {
+                char const     o = "MMMMMIDNS="[op(gen)];
+                uint32_t const l = len(gen);
+                r.cigar.push_back(bio::alphabet::cigar{l, bio::alphabet::cigar_op{}.assign_char(o)});
+                if (o == 'M' || o == 'I' || o == 'S' || o == '=')
+                    for (uint32_t k = 0; k < l; ++k)
+                        r.sequence.push_back(bio::alphabet::dna5{}.assign_rank(letter(gen)));
+            }
+            if (op(gen) < 7)
+                for (size_t k = 0; k < r.sequence.size(); ++k)
+                    r.qualities.push_back(bio::alphabet::phred42{}.assign_rank(len(gen)));
+            records.push_back(std::move(r));
+        }
+        regions.push_back(std::move(records));
+    }
+
+    for (uint8_t min_quality : {0, 15})
+    {
+        std::vector<std::vector<pileup_column>> expected;
+        for (auto const & records : regions)
+        {
+            pileup p{{.min_quality = min_quality}};
+            expected.push_back(naive_pileup(records, min_quality));
+            EXPECT_EQ(run(p, records), expected.back());
+        }
+
+        // all regions in parallel
+        std::vector<std::vector<pileup_column>> results(regions.size());
+        std::mutex                              mutex;
+        bio::alignment::pileup_regions(
+          regions,
+          [&](size_t const region, pileup_column const & col)
+          {
+              std::lock_guard lock{mutex};
+              results[region].push_back(col);
+          },
+          {.min_quality = min_quality, .threads = 3});
+        EXPECT_EQ(results, expected);
+    }
+}
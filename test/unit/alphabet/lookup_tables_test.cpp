@@ -0,0 +1,133 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/adaptation/char.hpp>
+#include <bio/alphabet/aminoacid/all.hpp>
+#include <bio/alphabet/gap/all.hpp>
+#include <bio/alphabet/lookup_tables.hpp>
+#include <bio/alphabet/nucleotide/all.hpp>
+#include <bio/alphabet/quality/all.hpp>
+
+template <typename T>
+class lookup_tables : public ::testing::Test
+{};
+
+using lookup_tables_types = ::testing::Types<bio::alphabet::dna4,
+                                             bio::alphabet::rna4,
+                                             bio::alphabet::dna5,
+                                             bio::alphabet::dna15,
+                                             bio::alphabet::dna16sam,
+                                             bio::alphabet::aa10li,
+                                             bio::alphabet::aa10murphy,
+                                             bio::alphabet::aa20,
+                                             bio::alphabet::aa27,
+                                             bio::alphabet::gap,
+                                             bio::alphabet::gapped<bio::alphabet::dna4>,
+                                             bio::alphabet::phred42,
+                                             bio::alphabet::phred63,
+                                             char>;
+
+TYPED_TEST_SUITE(lookup_tables, lookup_tables_types, );
+
+TYPED_TEST(lookup_tables, scalar)
+{
+    constexpr auto & t = bio::alphabet::lookup_tables<TypeParam>;
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        char const c = static_cast<char>(i);
+        EXPECT_EQ(t.char_to_rank[i], bio::alphabet::to_rank(bio::alphabet::assign_char_to(c, TypeParam{}))) << i;
+        EXPECT_EQ(t.is_valid(c), bio::alphabet::char_is_valid_for<TypeParam>(c)) << i;
+        EXPECT_EQ(t.rank_by_nibbles[i >> 4][i & 0xF], t.char_to_rank[i]) << i;
+        if (t.is_valid(c))
+        {
+            EXPECT_TRUE((t.valid_high_nibbles >> (i >> 4)) & 1u) << i;
+        }
+    }
+
+    for (size_t r = 0; r < bio::alphabet::size<TypeParam>; ++r)
+        EXPECT_EQ(t.rank_to_char[r], bio::alphabet::to_char(bio::alphabet::assign_rank_to(r, TypeParam{})));
+}
+
+TYPED_TEST(lookup_tables, nibbles)
+{
+    constexpr auto & t = bio::alphabet::lookup_tables<TypeParam>;
+
+    if constexpr (t.valid_by_nibbles)
+    {
+        for (size_t i = 0; i < 256; ++i)
+            EXPECT_EQ((t.valid_lo[i & 0xF] & t.valid_hi[i >> 4]) != 0, t.is_valid(static_cast<char>(i))) << i;
+    }
+    else
+    {
+        EXPECT_EQ(t.valid_lo, (std::array<uint8_t, 16>{}));
+        EXPECT_EQ(t.valid_hi, (std::array<uint8_t, 16>{}));
+    }
+}
+
+TYPED_TEST(lookup_tables, chars_to_ranks)
+{
+    constexpr auto & t = bio::alphabet::lookup_tables<TypeParam>;
+
+    // all valid characters
+    std::string valid_chars;
+    for (size_t i = 0; i < 256; ++i)
+        if (t.is_valid(static_cast<char>(i)))
+            valid_chars.push_back(static_cast<char>(i));
+    ASSERT_FALSE(valid_chars.empty());
+
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<size_t> dis{0, valid_chars.size() - 1};
+
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000})
+    {
+        std::string in(len, ' ');
+        for (char & c : in)
+            c = valid_chars[dis(gen)];
+
+        std::vector<uint8_t> out(len);
+        EXPECT_EQ(bio::alphabet::chars_to_ranks<TypeParam>(in, out), len);
+        for (size_t i = 0; i < len; ++i)
+            EXPECT_EQ(out[i], bio::alphabet::to_rank(bio::alphabet::assign_char_strictly_to(in[i], TypeParam{})));
+
+        // an invalid character at every position
+        if constexpr (!std::same_as<TypeParam, char>)
+        {
+            char invalid = 0;
+            while (t.is_valid(invalid))
+                ++invalid;
+
+            for (size_t pos = 0; pos < len; pos += (len > 100 ? 37 : 1))
+            {
+                std::string in2 = in;
+                in2[pos]        = invalid;
+                std::ranges::fill(out, 0xFF);
+                EXPECT_EQ(bio::alphabet::chars_to_ranks<TypeParam>(in2, out), pos);
+                for (size_t i = 0; i < pos; ++i)
+                    EXPECT_EQ(out[i], t.char_to_rank[static_cast<uint8_t>(in2[i])]);
+            }
+        }
+    }
+}
+
+TEST(lookup_tables_, properties)
+{
+    // case-insensitive nucleotides and amino acids are representable by nibbles
+    EXPECT_TRUE(bio::alphabet::lookup_tables<bio::alphabet::dna4>.valid_by_nibbles);
+    EXPECT_TRUE(bio::alphabet::lookup_tables<bio::alphabet::dna15>.valid_by_nibbles);
+    EXPECT_TRUE(bio::alphabet::lookup_tables<bio::alphabet::aa27>.valid_by_nibbles);
+    EXPECT_EQ(bio::alphabet::lookup_tables<bio::alphabet::dna4>.valid_high_nibbles, 0b0000'0000'1111'0000);
+
+    EXPECT_TRUE(bio::alphabet::detail::chars_to_ranks_vectorised<bio::alphabet::dna4>);
+    EXPECT_TRUE(bio::alphabet::detail::chars_to_ranks_vectorised<bio::alphabet::aa27>);
+    EXPECT_FALSE(bio::alphabet::detail::chars_to_ranks_vectorised<char>);
+}
@@ -0,0 +1,202 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/de_bruijn_graph.hpp>
+#include <bio/ranges/views/complement.hpp>
+
+using namespace bio::alphabet::literals;
+
+namespace
+{
+
+bio::alphabet::dna4_vector random_sequence(size_t const length, uint64_t const seed)
+{
+    std::mt19937_64            gen{seed};
+    bio::alphabet::dna4_vector ret(length);
+    for (auto & l : ret)
+        l.assign_rank(gen() % 4);
+    return ret;
+}
+
+std::vector<uint64_t> codes_of(auto const & seq, uint8_t const k, bool const canonical = true)
+{
+    std::vector<uint64_t> ret;
+    bio::kmer::kmer_codes(seq, {.k = k, .canonical = canonical}, ret);
+    return ret;
+}
+
+// every node is in exactly one unitig and the unitigs consist of nodes
+void check_partition(bio::kmer::de_bruijn_graph const & graph)
+{
+    uint8_t const         k = graph.options().k;
+    std::vector<uint64_t> spelled;
+    for (auto && unitig : graph.unitigs())
+    {
+        ASSERT_GE(unitig.size(), k);
+        bio::kmer::kmer_codes(unitig, {.k = k, .canonical = graph.options().canonical}, spelled);
+    }
+    std::ranges::sort(spelled);
+    EXPECT_TRUE(std::ranges::equal(spelled, graph.nodes()));
+}
+
+} // namespace
+
+TEST(de_bruijn_graph, construction)
+{
+    EXPECT_THROW((bio::kmer::de_bruijn_graph{{}, {.k = 0}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::de_bruijn_graph{{}, {.k = 33}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::de_bruijn_graph{{}, {.k = 20}}), std::invalid_argument);
+    EXPECT_NO_THROW((bio::kmer::de_bruijn_graph{{}, {.k = 20, .canonical = false}}));
+
+    bio::kmer::de_bruijn_graph const empty{{}, {.k = 31}};
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_FALSE(empty.contains(42));
+    EXPECT_TRUE(empty.unitigs().empty());
+    EXPECT_FALSE(bio::kmer::de_bruijn_graph{}.contains(42));
+
+    // duplicates and both orientations are the same node
+    auto const                  seq   = random_sequence(100, 1);
+    std::vector<uint64_t>       kmers = codes_of(seq, 21, false);
+    std::vector<uint64_t> const rc    = codes_of(seq | std::views::reverse | bio::views::complement, 21, false);
+    kmers.insert(kmers.end(), rc.begin(), rc.end());
+    kmers.insert(kmers.end(), rc.begin(), rc.end());
+
+    bio::kmer::de_bruijn_graph const graph{kmers, {.k = 21}};
+    EXPECT_EQ(graph.size(), 80u);
+    EXPECT_TRUE(std::ranges::is_sorted(graph.nodes()));
+    EXPECT_EQ(graph, (bio::kmer::de_bruijn_graph{codes_of(seq, 21), {.k = 21, .threads = 3}}));
+}
+
+TEST(de_bruijn_graph, find)
+{
+    auto const                       seq = random_sequence(100, 2);
+    std::vector<uint64_t> const      fwd = codes_of(seq, 21, false);
+    bio::kmer::de_bruijn_graph const graph{fwd, {.k = 21}};
+
+    for (uint64_t const code : fwd)
+    {
+        size_t const i = graph.find(code);
+        ASSERT_NE(i, bio::kmer::de_bruijn_graph::npos);
+        EXPECT_EQ(graph.nodes()[i], bio::kmer::canonical(code, 21));
+        EXPECT_EQ(graph.find(bio::kmer::reverse_complement(code, 21)), i);
+    }
+    EXPECT_FALSE(graph.contains(bio::kmer::canonical(fwd[0] ^ 1, 21)));
+}
+
+TEST(de_bruijn_graph, edge_masks)
+{
+    // ACGTA -> CGTAC and CGTAG; AACGT -> ACGTA
+    std::vector<uint64_t> const kmers = codes_of("AACGTAC"_dna4, 5, false);
+    std::vector<uint64_t> const more  = codes_of("CGTAG"_dna4, 5, false);
+
+    std::vector<uint64_t> all = kmers;
+    all.insert(all.end(), more.begin(), more.end());
+    bio::kmer::de_bruijn_graph const graph{all, {.k = 5, .canonical = false}};
+    ASSERT_EQ(graph.size(), 4u);
+
+    size_t const i = graph.find(codes_of("ACGTA"_dna4, 5, false)[0]);
+    EXPECT_EQ(graph.edge_masks()[i], 0b0001'0110); // prepend A; append C, G
+
+    // in the canonical graph, AACGT + T = ACGTT is also a node: the reverse complement of AACGT
+    bio::kmer::de_bruijn_graph const bidirected{all, {.k = 5}};
+    size_t const                     j = bidirected.find(codes_of("AACGT"_dna4, 5, false)[0]);
+    EXPECT_EQ(bidirected.nodes()[j], codes_of("AACGT"_dna4, 5, false)[0]);
+    EXPECT_EQ(bidirected.edge_masks()[j] & 0x0F, 0b1001);
+}
+
+TEST(de_bruijn_graph, linear)
+{
+    auto const seq = random_sequence(1'000, 3);
+
+    for (bool const canonical : {true, false})
+    {
+        bio::kmer::de_bruijn_graph const graph{codes_of(seq, 21, canonical), {.k = 21, .canonical = canonical}};
+        auto const                       unitigs = graph.unitigs();
+        ASSERT_EQ(unitigs.size(), 1u);
+
+        bio::alphabet::dna4_vector const unitig{unitigs[0].begin(), unitigs[0].end()};
+        bio::alphabet::dna4_vector       rc;
+        std::ranges::copy(seq | std::views::reverse | bio::views::complement, std::back_inserter(rc));
+        EXPECT_TRUE(unitig == seq || (canonical && unitig == rc));
+    }
+}
+
+TEST(de_bruijn_graph, branches)
+{
+    // two sequences that share 100 letters in the middle (in opposite orientations): 5 unitigs
+    auto const shared = random_sequence(100, 4);
+    auto       first  = random_sequence(50, 5);
+    auto       second = random_sequence(50, 6);
+    first.insert(first.end(), shared.begin(), shared.end());
+    second.insert(second.end(), shared.begin(), shared.end());
+    auto const tail1 = random_sequence(50, 7);
+    auto const tail2 = random_sequence(50, 8);
+    first.insert(first.end(), tail1.begin(), tail1.end());
+    second.insert(second.end(), tail2.begin(), tail2.end());
+
+    std::vector<uint64_t>       kmers = codes_of(first, 21);
+    std::vector<uint64_t> const other = codes_of(second | std::views::reverse | bio::views::complement, 21);
+    kmers.insert(kmers.end(), other.begin(), other.end());
+
+    bio::kmer::de_bruijn_graph const graph{kmers, {.k = 21}};
+    auto const                       unitigs = graph.unitigs();
+    EXPECT_EQ(unitigs.size(), 5u);
+    check_partition(graph);
+
+    std::vector<size_t> lengths;
+    for (auto && unitig : unitigs)
+        lengths.push_back(unitig.size());
+    std::ranges::sort(lengths);
+    EXPECT_EQ(lengths, (std::vector<size_t>{70, 70, 70, 70, 100}));
+}
+
+TEST(de_bruijn_graph, cycle)
+{
+    // all k-mers of a circular sequence
+    auto circular = random_sequence(200, 9);
+    auto seq      = circular;
+    seq.insert(seq.end(), circular.begin(), circular.begin() + 20);
+
+    bio::kmer::de_bruijn_graph const graph{codes_of(seq, 21), {.k = 21}};
+    auto const                       unitigs = graph.unitigs();
+    ASSERT_EQ(unitigs.size(), 1u);
+    EXPECT_EQ(unitigs[0].size(), 220u);
+    check_partition(graph);
+}
+
+TEST(de_bruijn_graph, random_graphs)
+{
+    // dense graphs of short k-mers with many branches and cycles
+    std::mt19937_64 gen{10};
+    for (uint8_t const k : {5, 7, 9})
+    {
+        for (bool const canonical : {true, false})
+        {
+            std::vector<uint64_t> kmers(300);
+            for (uint64_t & code : kmers)
+                code = gen() & bio::kmer::kmer_mask(k);
+
+            bio::kmer::de_bruijn_graph const graph{kmers, {.k = k, .canonical = canonical}};
+            check_partition(graph);
+
+            auto const unitigs = graph.unitigs();
+            for (size_t const threads : {2, 5})
+            {
+                bio::kmer::de_bruijn_graph const parallel{kmers, {.k = k, .canonical = canonical, .threads = threads}};
+                EXPECT_TRUE(std::ranges::equal(parallel.edge_masks(), graph.edge_masks()));
+                EXPECT_EQ(parallel.unitigs(), unitigs);
+            }
+        }
+    }
+}
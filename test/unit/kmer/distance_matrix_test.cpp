@@ -0,0 +1,211 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/kmer/distance_matrix.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/views/pairwise_combine.hpp>
+
+namespace
+{
+
+// mutated copies of one random genome, with increasing mutation rates
+std::vector<bio::alphabet::dna4_vector> related_genomes(size_t const count, size_t const length, uint64_t const seed)
+{
+    std::mt19937_64            gen{seed};
+    bio::alphabet::dna4_vector base(length);
+    for (auto & l : base)
+        l.assign_rank(gen() % 4);
+
+    std::vector<bio::alphabet::dna4_vector> ret;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bio::alphabet::dna4_vector genome = base;
+        for (auto & l : genome)
+            if (gen() % 1000 < i * 20)
+                l.assign_rank(gen() % 4);
+        ret.push_back(std::move(genome));
+    }
+    return ret;
+}
+
+std::vector<bio::kmer::minhash_sketch> sketches_of(std::vector<bio::alphabet::dna4_vector> const & genomes,
+                                                   bio::kmer::minhash_options const                options)
+{
+    return bio::kmer::sketch_each(genomes, options);
+}
+
+} // namespace
+
+TEST(distance_matrix, mash_distance)
+{
+    EXPECT_EQ(bio::kmer::mash_distance(1.0, 21), 0.0);
+    EXPECT_EQ(bio::kmer::mash_distance(0.0, 21), 1.0);
+    EXPECT_EQ(bio::kmer::mash_distance(1e-30, 21), 1.0);
+    EXPECT_DOUBLE_EQ(bio::kmer::mash_distance(0.5, 21), -std::log(2.0 / 3.0) / 21);
+
+    auto const genomes  = related_genomes(3, 5'000, 1);
+    auto const sketches = sketches_of(genomes, {.k = 21, .sketch_size = 200});
+    EXPECT_EQ(bio::kmer::mash_distance(sketches[0], sketches[0]), 0.0);
+    EXPECT_DOUBLE_EQ(bio::kmer::mash_distance(sketches[0], sketches[2]),
+                     bio::kmer::mash_distance(bio::kmer::jaccard(sketches[0], sketches[2]), 21));
+}
+
+TEST(distance_matrix, merge_intersect)
+{
+    // random sorted sets with varying overlap and size, bounded by different limits
+    std::mt19937_64 gen{2};
+    for (size_t round = 0; round < 200; ++round)
+    {
+        std::vector<uint64_t> a(gen() % 300), b(gen() % 300);
+        uint64_t const        range = 1 + gen() % 1'000;
+        for (uint64_t & v : a)
+            v = (gen() % range) << 54 | 42; // also exercises the sign bit
+        for (uint64_t & v : b)
+            v = (gen() % range) << 54 | 42;
+        for (std::vector<uint64_t> * v : {&a, &b})
+        {
+            std::ranges::sort(*v);
+            v->erase(std::ranges::unique(*v).begin(), v->end());
+        }
+
+        size_t const limit = round % 2 ? gen() % 400 : std::numeric_limits<size_t>::max();
+        size_t       i = 0, j = 0, total = 0, shared = 0;
+        for (; total < limit && (i < a.size() || j < b.size()); ++total)
+        {
+            if (j == b.size() || (i < a.size() && a[i] < b[j]))
+                ++i;
+            else if (i == a.size() || b[j] < a[i])
+                ++j;
+            else
+                ++shared, ++i, ++j;
+        }
+
+        EXPECT_EQ(bio::kmer::detail::merge_intersect(a, b, limit), std::pair(shared, total)) << round;
+    }
+}
+
+TEST(distance_matrix, matrix)
+{
+    bio::kmer::distance_matrix m{4};
+    EXPECT_EQ(m.size(), 4u);
+    EXPECT_EQ(m.condensed().size(), 6u);
+    EXPECT_EQ(m.index(0, 1), 0u);
+    EXPECT_EQ(m.index(0, 3), 2u);
+    EXPECT_EQ(m.index(1, 2), 3u);
+    EXPECT_EQ(m.index(2, 3), 5u);
+
+    m.condensed()[m.index(1, 3)] = 0.5f;
+    EXPECT_EQ(m(1, 3), 0.5f);
+    EXPECT_EQ(m(3, 1), 0.5f);
+    EXPECT_EQ(m(2, 2), 0.0f);
+
+    EXPECT_TRUE(bio::kmer::distance_matrix{1}.condensed().empty());
+    EXPECT_TRUE(bio::kmer::distance_matrix{}.condensed().empty());
+}
+
+TEST(distance_matrix, sketches)
+{
+    auto const genomes = related_genomes(23, 3'000, 3);
+    for (bio::kmer::minhash_options const options : {bio::kmer::minhash_options{.k = 21, .sketch_size = 100},
+                                                     bio::kmer::minhash_options{.k = 15, .scaled = 10}})
+    {
+        auto const sketches = sketches_of(genomes, options);
+
+        // the distances of bio::views::pairwise_combine, in the same order
+        std::vector<float> expected;
+        for (auto && [lhs, rhs] : sketches | bio::views::pairwise_combine)
+            expected.push_back(static_cast<float>(bio::kmer::mash_distance(lhs, rhs)));
+        ASSERT_GT(std::ranges::count(expected, 1.0f), 0);
+        ASSERT_LT(std::ranges::count(expected, 1.0f), std::ranges::ssize(expected));
+
+        for (size_t const tile_size : {1, 5, 64})
+        {
+            for (size_t const threads : {1, 3})
+            {
+                bio::kmer::distance_matrix const m =
+                  bio::kmer::all_vs_all(sketches, {.tile_size = tile_size, .threads = threads});
+                EXPECT_EQ(m.size(), sketches.size());
+                EXPECT_TRUE(std::ranges::equal(m.condensed(), expected)) << tile_size << ' ' << threads;
+            }
+        }
+    }
+
+    std::vector<bio::kmer::minhash_sketch> sketches = sketches_of(genomes, {.k = 21, .sketch_size = 100});
+    EXPECT_EQ(bio::kmer::all_vs_all(std::vector<bio::kmer::minhash_sketch>{}).size(), 0u);
+    EXPECT_EQ(bio::kmer::all_vs_all(std::span{sketches}.first(1)).size(), 1u);
+
+    sketches.push_back(bio::kmer::minhash_sketch{{.k = 21, .sketch_size = 200}});
+    EXPECT_THROW(bio::kmer::all_vs_all(sketches), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::all_vs_all(sketches, {.threads = 4}), std::invalid_argument);
+}
+
+TEST(distance_matrix, kmer_sets)
+{
+    auto const genomes = related_genomes(10, 1'000, 4);
+
+    bio::ranges::concatenated_sequences<std::vector<uint64_t>> sets;
+    for (auto const & genome : genomes)
+    {
+        std::vector<uint64_t> codes;
+        bio::kmer::kmer_codes(genome, {.k = 11}, codes);
+        std::ranges::sort(codes);
+        codes.erase(std::ranges::unique(codes).begin(), codes.end());
+        sets.push_back(codes);
+    }
+
+    bio::kmer::distance_matrix const m = bio::kmer::all_vs_all(sets, {.k = 11, .tile_size = 3, .threads = 2});
+    for (size_t i = 0; i < sets.size(); ++i)
+    {
+        for (size_t j = i + 1; j < sets.size(); ++j)
+        {
+            std::vector<uint64_t> shared;
+            std::ranges::set_intersection(sets[i], sets[j], std::back_inserter(shared));
+            size_t const total   = sets[i].size() + sets[j].size() - shared.size();
+            double const jaccard = static_cast<double>(shared.size()) / total;
+            EXPECT_EQ(m(i, j), static_cast<float>(bio::kmer::mash_distance(jaccard, 11)));
+        }
+    }
+
+    EXPECT_THROW(bio::kmer::all_vs_all(sets), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::all_vs_all(sets, {.k = 33}), std::invalid_argument);
+}
+
+TEST(distance_matrix, sparse)
+{
+    auto const                       genomes  = related_genomes(30, 2'000, 5);
+    auto const                       sketches = sketches_of(genomes, {.k = 21, .sketch_size = 200});
+    bio::kmer::distance_matrix const dense    = bio::kmer::all_vs_all(sketches);
+
+    for (double const max_distance : {0.03, 0.1, 1.0})
+    {
+        std::vector<bio::kmer::distance_entry> expected;
+        for (uint32_t i = 0; i < dense.size(); ++i)
+            for (uint32_t j = i + 1; j < dense.size(); ++j)
+                if (dense(i, j) <= max_distance)
+                    expected.push_back({i, j, dense(i, j)});
+        ASSERT_FALSE(expected.empty());
+
+        for (size_t const threads : {1, 4})
+        {
+            EXPECT_EQ(bio::kmer::all_vs_all_sparse(sketches,
+                                                   {.max_distance = max_distance, .tile_size = 7, .threads = threads}),
+                      expected);
+        }
+    }
+}
@@ -0,0 +1,231 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/aliases.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/kmer/error_corrector.hpp>
+#include <bio/kmer/interleaved_bloom_filter.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+namespace
+{
+
+// one of the three other letters
+char other_letter(char const c, size_t const i)
+{
+    std::string_view const acgt = "ACGT";
+    return acgt[(acgt.find(c) + 1 + i) % 4];
+}
+
+constexpr bio::kmer::error_correction_options options{.k = 21, .canonical = true, .max_quality = 20};
+
+struct fixture
+{
+    std::vector<bio::alphabet::dna5>                                      genome;
+    std::unordered_set<uint64_t>                                          solid;
+    // the correct reads and the reads with errors
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> truth;
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    // low quality at the errors and at some correct positions
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::phred42>> quals;
+
+    fixture()
+    {
+        std::mt19937_64 gen{42};
+        genome.resize(5'000);
+        for (auto & l : genome)
+            l.assign_char("ACGT"[gen() % 4]);
+
+        // the solid set is taken from the genome (and its reverse strand via canonical k-mers)
+        bio::kmer::for_each_kmer(genome,
+                                 {.k = options.k, .canonical = options.canonical},
+                                 [&](size_t, uint64_t const code) { solid.insert(code); });
+
+        for (size_t i = 0; i < 500; ++i)
+        {
+            size_t const                        start = gen() % (genome.size() - 100);
+            std::vector<bio::alphabet::dna5>    read{genome.begin() + start, genome.begin() + start + 100};
+            std::vector<bio::alphabet::phred42> qual(100, bio::alphabet::phred42{}.assign_phred(35));
+            truth.push_back(read);
+
+            // one or two errors that are far apart, sometimes an N
+            for (size_t const p : {gen() % 40, 60 + gen() % 40})
+            {
+                if (p >= 60 && i % 2 == 0)
+                    continue;
+                if (i % 7 == 0)
+                    read[p] = 'N'_dna5;
+                else
+                    read[p].assign_char(other_letter(read[p].to_char(), gen() % 3));
+                qual[p].assign_phred(5);
+            }
+            qual[gen() % 100].assign_phred(8);
+            reads.push_back(read);
+            quals.push_back(qual);
+        }
+    }
+};
+
+// the number of reads that differ from the truth
+size_t wrong_reads(auto const & reads, auto const & truth)
+{
+    size_t ret = 0;
+    for (size_t i = 0; i < reads.size(); ++i)
+        ret += !std::ranges::equal(reads[i], truth[i]);
+    return ret;
+}
+
+} // namespace
+
+TEST(error_corrector, construction)
+{
+    std::unordered_set<uint64_t> const solid;
+    EXPECT_THROW((bio::kmer::error_corrector{solid, {.k = 0}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::error_corrector{solid, {.k = 33}}), std::invalid_argument);
+
+    bio::kmer::error_corrector const corrector{solid, {.k = 15}};
+    EXPECT_EQ(corrector.options().k, 15);
+}
+
+TEST(error_corrector, solid_read)
+{
+    fixture                          f;
+    bio::kmer::error_corrector       corrector{f.solid, options};
+    std::vector<bio::alphabet::dna5> read{f.truth[0].begin(), f.truth[0].end()};
+    EXPECT_EQ(corrector.correct(read), 0u);
+    EXPECT_TRUE(std::ranges::equal(read, f.truth[0]));
+
+    // shorter than k
+    std::vector<bio::alphabet::dna5> tiny{read.begin(), read.begin() + 10};
+    tiny[3] = 'N'_dna5;
+    EXPECT_EQ(corrector.correct(tiny), 0u);
+}
+
+TEST(error_corrector, without_qualities)
+{
+    fixture                    f;
+    bio::kmer::error_corrector corrector{f.solid, options};
+
+    for (size_t i = 0; i < f.reads.size(); ++i)
+    {
+        size_t const errors = i % 2 == 0 ? 1 : 2;
+        EXPECT_EQ(corrector.correct(f.reads[i]), errors) << i;
+        EXPECT_TRUE(std::ranges::equal(f.reads[i], f.truth[i])) << i;
+    }
+}
+
+TEST(error_corrector, separate_qualities)
+{
+    fixture                    f;
+    bio::kmer::error_corrector corrector{f.solid, options};
+
+    for (size_t i = 0; i < f.reads.size(); ++i)
+        corrector.correct(f.reads[i], f.quals[i]);
+    EXPECT_EQ(wrong_reads(f.reads, f.truth), 0u);
+}
+
+TEST(error_corrector, qualified)
+{
+    fixture f;
+
+    std::vector<bio::alphabet::dna5q> read;
+    for (size_t j = 0; j < f.reads[1].size(); ++j)
+        read.push_back({f.reads[1][j], f.quals[1][j]});
+
+    bio::kmer::error_corrector corrector{f.solid, options};
+    EXPECT_EQ(corrector.correct(read), 2u);
+    for (size_t j = 0; j < read.size(); ++j)
+    {
+        EXPECT_EQ(get<0>(read[j]), f.truth[1][j]);
+        EXPECT_EQ(get<1>(read[j]), f.quals[1][j]); // qualities are kept
+    }
+}
+
+TEST(error_corrector, max_corrections)
+{
+    fixture                    f;
+    bio::kmer::error_corrector corrector{f.solid, {.k = options.k, .max_corrections = 1}};
+    EXPECT_EQ(corrector.correct(f.reads[1]), 1u);
+    EXPECT_FALSE(std::ranges::equal(f.reads[1], f.truth[1]));
+}
+
+TEST(error_corrector, only_low_quality_positions)
+{
+    // errors inside the read without bounding solid k-mers are only fixed at low-quality positions
+    fixture                          f;
+    std::vector<bio::alphabet::dna5> read{f.truth[2].begin(), f.truth[2].begin() + 30};
+    read[15] = read[15] == 'A'_dna5 ? 'C'_dna5 : 'A'_dna5;
+    std::vector<bio::alphabet::phred42> qual(30, bio::alphabet::phred42{}.assign_phred(35));
+
+    bio::kmer::error_corrector corrector{f.solid, options};
+    auto                       copy = read;
+    EXPECT_EQ(corrector.correct(copy, qual), 0u);
+
+    qual[15].assign_phred(2);
+    EXPECT_EQ(corrector.correct(read, qual), 1u);
+    EXPECT_TRUE(std::ranges::equal(read, f.truth[2] | std::views::take(30)));
+}
+
+TEST(error_corrector, correct_all)
+{
+    fixture f;
+    auto    reads = f.reads;
+
+    bio::kmer::error_corrector corrector{f.solid, options};
+    std::vector<size_t> const  counts = corrector.correct_all(reads, f.quals);
+    ASSERT_EQ(counts.size(), reads.size());
+    EXPECT_EQ(wrong_reads(reads, f.truth), 0u);
+
+    for (size_t const threads : {2, 3, 8})
+    {
+        auto                       copy = f.reads;
+        bio::kmer::error_corrector parallel{f.solid, {.k = options.k, .threads = threads}};
+        EXPECT_EQ(parallel.correct_all(copy, f.quals), counts);
+        EXPECT_EQ(wrong_reads(copy, f.truth), 0u);
+
+        copy = f.reads;
+        EXPECT_EQ(parallel.correct_all(copy), counts);
+        EXPECT_EQ(wrong_reads(copy, f.truth), 0u);
+    }
+}
+
+TEST(error_corrector, bloom_filter)
+{
+    fixture                             f;
+    bio::kmer::interleaved_bloom_filter ibf{{.bins = 1, .bin_size = 1 << 18, .hash_count = 3}};
+    for (uint64_t const code : f.solid)
+        ibf.emplace(code, 0);
+
+    auto                       solid = [&](uint64_t const code) { return ibf.contains(code, 0); };
+    bio::kmer::error_corrector corrector{solid, options};
+    corrector.correct_all(f.reads, f.quals);
+    EXPECT_EQ(wrong_reads(f.reads, f.truth), 0u);
+}
+
+TEST(error_corrector, not_canonical)
+{
+    fixture                      f;
+    std::unordered_set<uint64_t> solid;
+    bio::kmer::for_each_kmer(f.genome,
+                             {.k = options.k, .canonical = false},
+                             [&](size_t, uint64_t const code) { solid.insert(code); });
+
+    bio::kmer::error_corrector corrector{solid, {.k = options.k, .canonical = false}};
+    corrector.correct_all(f.reads, f.quals);
+    EXPECT_EQ(wrong_reads(f.reads, f.truth), 0u);
+}
@@ -0,0 +1,45 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/kmer/hash.hpp>
+
+TEST(mix64, scalar)
+{
+    static_assert(bio::kmer::mix64(0) == 0);
+    EXPECT_NE(bio::kmer::mix64(1), 1u);
+
+    // neighbouring inputs differ in about half of the output bits
+    size_t bits = 0;
+    for (uint64_t i = 0; i < 1000; ++i)
+        bits += std::popcount(bio::kmer::mix64(i) ^ bio::kmer::mix64(i + 1));
+    EXPECT_GT(bits, 1000u * 28);
+    EXPECT_LT(bits, 1000u * 36);
+}
+
+TEST(mix64, bulk)
+{
+    std::vector<uint64_t> in(1003);
+    std::iota(in.begin(), in.end(), 0xFFFF'FFFF'FFFF'0000ull);
+
+    std::vector<uint64_t> out(in.size());
+    bio::kmer::mix64(in, out);
+    for (size_t i = 0; i < in.size(); ++i)
+        EXPECT_EQ(out[i], bio::kmer::mix64(in[i]));
+
+    // in place
+    bio::kmer::mix64(in, in);
+    EXPECT_EQ(in, out);
+
+    std::ranges::sort(out);
+    EXPECT_EQ(std::ranges::adjacent_find(out), out.end());
+}
@@ -0,0 +1,130 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/hyperloglog.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+namespace
+{
+
+std::vector<bio::alphabet::dna5> random_sequence(size_t const length, unsigned const seed)
+{
+    std::mt19937_64                  gen{seed};
+    std::vector<bio::alphabet::dna5> ret(length);
+    for (auto & l : ret)
+        l.assign_rank(gen() % 4);
+    return ret;
+}
+
+} // namespace
+
+TEST(hyperloglog, small_cardinalities)
+{
+    bio::kmer::hyperloglog hll{{.k = 3, .canonical = false}};
+    EXPECT_DOUBLE_EQ(hll.estimate(), 0.0);
+
+    // 4 distinct 3-mers
+    hll.add("ACGTACGTACGT"_dna4);
+    EXPECT_NEAR(hll.estimate(), 4.0, 0.01);
+
+    // duplicates do not change the estimate
+    bio::kmer::hyperloglog const before = hll;
+    hll.add("ACGTACGTACGT"_dna4);
+    EXPECT_EQ(hll, before);
+
+    hll.clear();
+    EXPECT_DOUBLE_EQ(hll.estimate(), 0.0);
+}
+
+TEST(hyperloglog, accuracy)
+{
+    for (uint64_t const n : {100ull, 10'000ull, 1'000'000ull})
+    {
+        std::vector<uint64_t> hashes(n);
+        for (uint64_t i = 0; i < n; ++i)
+            hashes[i] = bio::kmer::mix64(i);
+
+        for (uint8_t const p : {10, 14})
+        {
+            bio::kmer::hyperloglog hll{{.precision = p}};
+            hll.add_hashes(hashes);
+            EXPECT_EQ(hll.registers().size(), size_t{1} << p);
+            // five standard errors
+            EXPECT_NEAR(hll.estimate() / n, 1.0, 5 * 1.04 / std::sqrt(hll.registers().size())) << n << ' ' << int{p};
+        }
+    }
+}
+
+TEST(hyperloglog, kmers)
+{
+    std::vector<bio::alphabet::dna5> seq = random_sequence(200'000, 1);
+    seq[1000]                            = 'N'_dna5;
+
+    std::unordered_set<uint64_t> distinct;
+    bio::kmer::for_each_kmer(seq, {.k = 21}, [&](size_t, uint64_t const code) { distinct.insert(code); });
+
+    bio::kmer::hyperloglog hll{{.k = 21}};
+    hll.add(seq);
+    EXPECT_NEAR(hll.estimate() / distinct.size(), 1.0, 0.05);
+
+    // canonical: the reverse complement adds nothing
+    bio::kmer::hyperloglog const before = hll;
+    std::vector<bio::alphabet::dna5> rc;
+    for (auto it = seq.rbegin(); it != seq.rend(); ++it)
+        rc.push_back(bio::alphabet::complement(*it));
+    hll.add(rc);
+    EXPECT_EQ(hll, before);
+}
+
+TEST(hyperloglog, merge)
+{
+    std::vector<bio::alphabet::dna5> const a = random_sequence(10'000, 2);
+    std::vector<bio::alphabet::dna5> const b = random_sequence(10'000, 3);
+
+    bio::kmer::hyperloglog both{{.k = 15}};
+    bio::kmer::hyperloglog first{{.k = 15}};
+    bio::kmer::hyperloglog second{{.k = 15}};
+    both.add(a);
+    both.add(b);
+    first.add(a);
+    second.add(b);
+    first.merge(second);
+    EXPECT_EQ(first, both);
+
+    EXPECT_THROW(first.merge(bio::kmer::hyperloglog{{.k = 15, .precision = 12}}), std::invalid_argument);
+    EXPECT_THROW(first.merge(bio::kmer::hyperloglog{{.k = 16}}), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::hyperloglog{{.precision = 3}}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::hyperloglog{{.precision = 19}}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::hyperloglog{{.k = 0}}, std::invalid_argument);
+}
+
+TEST(hyperloglog, estimate_distinct_kmers)
+{
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    std::unordered_set<uint64_t>                                          distinct;
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        reads.push_back(random_sequence(150, i % 700)); // some duplicate reads
+        bio::kmer::for_each_kmer(reads.back(), {.k = 21}, [&](size_t, uint64_t const code) { distinct.insert(code); });
+    }
+
+    double const estimate = bio::kmer::estimate_distinct_kmers(reads, {.k = 21});
+    EXPECT_NEAR(estimate / distinct.size(), 1.0, 0.05);
+    EXPECT_DOUBLE_EQ(bio::kmer::estimate_distinct_kmers(reads, {.k = 21, .threads = 4}), estimate);
+
+    EXPECT_DOUBLE_EQ(bio::kmer::estimate_distinct_kmers(std::vector<std::vector<bio::alphabet::dna4>>{}), 0.0);
+}
@@ -0,0 +1,248 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/kmer/interleaved_bloom_filter.hpp>
+
+#if __has_include(<cereal/archives/binary.hpp>)
+#    include <cereal/archives/binary.hpp>
+#    include <cereal/types/vector.hpp>
+#endif
+
+namespace
+{
+
+// values 1000 * bin + [0, 100) in every bin
+bio::kmer::interleaved_bloom_filter make_filter(size_t const bins)
+{
+    bio::kmer::interleaved_bloom_filter ibf{{.bins = bins, .bin_size = 8192, .hash_count = 3}};
+    for (size_t b = 0; b < bins; ++b)
+        for (uint64_t v = 0; v < 100; ++v)
+            ibf.emplace(1000 * b + v, b);
+    return ibf;
+}
+
+// a stream buffer that cannot seek, like a pipe
+struct unseekable_buffer : std::streambuf
+{
+    explicit unseekable_buffer(std::string & bytes) { setg(bytes.data(), bytes.data(), bytes.data() + bytes.size()); }
+};
+
+} // namespace
+
+TEST(interleaved_bloom_filter, construction)
+{
+    bio::kmer::interleaved_bloom_filter const ibf{{.bins = 130, .bin_size = 1000, .hash_count = 2}};
+    EXPECT_EQ(ibf.bins(), 130u);
+    EXPECT_EQ(ibf.bin_size(), 1000u);
+    EXPECT_EQ(ibf.hash_count(), 2u);
+    EXPECT_EQ(ibf.raw_data().size(), 3000u);
+    EXPECT_EQ(ibf.view().words_per_position(), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ibf.raw_data().data()) % 64, 0u);
+
+    EXPECT_THROW((bio::kmer::interleaved_bloom_filter{{.bins = 0}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::interleaved_bloom_filter{{.bin_size = 0}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::interleaved_bloom_filter{{.hash_count = 0}}), std::invalid_argument);
+    EXPECT_THROW((bio::kmer::interleaved_bloom_filter{{.hash_count = 6}}), std::invalid_argument);
+}
+
+TEST(interleaved_bloom_filter, contains)
+{
+    bio::kmer::interleaved_bloom_filter ibf   = make_filter(130);
+    auto                                agent = ibf.membership_agent();
+
+    size_t false_positives = 0;
+    for (size_t b = 0; b < 130; ++b)
+    {
+        for (uint64_t v = 0; v < 100; ++v)
+        {
+            bio::ranges::bitvector const & bins = agent.contains(1000 * b + v);
+            ASSERT_EQ(bins.size(), 130u);
+            EXPECT_TRUE(bins[b]);
+            EXPECT_TRUE(ibf.contains(1000 * b + v, b));
+            EXPECT_EQ(ibf.view().contains(1000 * b + v, (b + 1) % 130), bins[(b + 1) % 130]);
+            false_positives += bins.count() - 1;
+        }
+    }
+    // 100 values, 3 hash functions and 8192 bits: about 0.005% false positives
+    EXPECT_LT(false_positives, 130u * 130 * 100 / 1000);
+
+    // the other bins are not affected by clearing a bin
+    ibf.clear(64);
+    agent = ibf.membership_agent();
+    EXPECT_FALSE(agent.contains(64'000)[64]);
+    EXPECT_TRUE(agent.contains(65'000)[65]);
+    EXPECT_TRUE(agent.contains(63'000)[63]);
+
+    EXPECT_TRUE(bio::kmer::interleaved_bloom_filter{{.bins = 3}}.membership_agent().contains(42).none());
+}
+
+TEST(interleaved_bloom_filter, contains_all)
+{
+    bio::kmer::interleaved_bloom_filter ibf = make_filter(100);
+    std::vector<uint64_t>               values{5'000, 5'001, 5'002, 5'003};
+    for (uint64_t const v : values)
+        ibf.emplace(v, 7);
+
+    auto                           agent = ibf.membership_agent();
+    bio::ranges::bitvector const & bins  = agent.contains_all(values);
+    EXPECT_EQ(bins.size(), 100u);
+    EXPECT_EQ(bins.count(), 2u);
+    EXPECT_TRUE(bins[5]);
+    EXPECT_TRUE(bins[7]);
+
+    // no bin contains all values
+    std::vector<uint64_t> mixed;
+    for (uint64_t v = 0; v < 50; ++v)
+        mixed.push_back(1000 * (v % 3) + v);
+    EXPECT_TRUE(agent.contains_all(mixed).none());
+
+    // all bins contain nothing
+    EXPECT_EQ(agent.contains_all({}).count(), 100u);
+}
+
+TEST(interleaved_bloom_filter, counting)
+{
+    bio::kmer::interleaved_bloom_filter const ibf   = make_filter(70);
+    auto                                      agent = ibf.counting_agent();
+
+    // 60 values of bin 3, 20 of bin 69, 20 absent
+    std::vector<uint64_t> values;
+    for (uint64_t v = 0; v < 60; ++v)
+        values.push_back(3'000 + v);
+    for (uint64_t v = 0; v < 20; ++v)
+        values.push_back(69'000 + v);
+    for (uint64_t v = 0; v < 20; ++v)
+        values.push_back(1'000'000 + v);
+
+    std::vector<uint32_t> const & counts = agent.count(values);
+    ASSERT_EQ(counts.size(), 70u);
+    EXPECT_GE(counts[3], 60u);
+    EXPECT_GE(counts[69], 20u);
+    EXPECT_LT(counts[0], 5u);
+
+    bio::ranges::bitvector const & above = agent.bins_above(values, 50);
+    EXPECT_EQ(above.size(), 70u);
+    EXPECT_EQ(above.count(), 1u);
+    EXPECT_TRUE(above[3]);
+    EXPECT_EQ(agent.bins_above(values, 15).count(), 2u);
+}
+
+TEST(interleaved_bloom_filter, serialisation)
+{
+    bio::kmer::interleaved_bloom_filter const ibf = make_filter(100);
+
+    std::stringstream stream;
+    ibf.write(stream);
+    std::string const bytes = stream.str();
+    EXPECT_EQ(bytes.size(), 64 + ibf.raw_data().size() * 8);
+
+    EXPECT_EQ(bio::kmer::interleaved_bloom_filter::read(stream), ibf);
+
+    // in place, as in a memory-mapped file
+    std::vector<uint64_t> aligned(bytes.size() / 8);
+    std::memcpy(aligned.data(), bytes.data(), bytes.size());
+    std::span<std::byte const> const        mapped = std::as_bytes(std::span{aligned});
+    bio::kmer::interleaved_bloom_filter_view view{mapped};
+    EXPECT_EQ(view.bins(), 100u);
+    EXPECT_EQ(view.bin_size(), 8192u);
+    EXPECT_EQ(view.hash_count(), 3u);
+    EXPECT_EQ(view.raw_data().data(), aligned.data() + 8);
+
+    auto original = ibf.membership_agent();
+    auto agent    = view.membership_agent();
+    for (uint64_t v = 0; v < 100'000; v += 77)
+        EXPECT_EQ(agent.contains(v), original.contains(v));
+
+    // errors
+    EXPECT_THROW(bio::kmer::interleaved_bloom_filter_view{mapped.first(32)}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::interleaved_bloom_filter_view{mapped.first(mapped.size() - 8)}, std::invalid_argument);
+    aligned[0] = 0;
+    EXPECT_THROW(bio::kmer::interleaved_bloom_filter_view{mapped}, std::invalid_argument);
+
+    std::stringstream truncated{bytes.substr(0, 1000)};
+    EXPECT_THROW(bio::kmer::interleaved_bloom_filter::read(truncated), std::runtime_error);
+    std::stringstream garbage{std::string(100, 'x')};
+    EXPECT_THROW(bio::kmer::interleaved_bloom_filter::read(garbage), std::runtime_error);
+}
+
+TEST(interleaved_bloom_filter, corrupt_header)
+{
+    std::stringstream stream;
+    make_filter(100).write(stream);
+    std::string const bytes = stream.str();
+
+    // overwrites one field of a header and checks that both the stream and the in-place reader reject it
+    auto expect_rejected = [&](size_t const field, uint64_t const value, std::string corrupt)
+    {
+        std::memcpy(corrupt.data() + field * 8, &value, 8);
+
+        std::stringstream seekable{corrupt};
+        EXPECT_THROW(bio::kmer::interleaved_bloom_filter::read(seekable), std::runtime_error) << field << ' ' << value;
+
+        unseekable_buffer buffer{corrupt};
+        std::istream      unseekable{&buffer};
+        EXPECT_THROW(bio::kmer::interleaved_bloom_filter::read(unseekable), std::runtime_error)
+          << field << ' ' << value;
+
+        std::vector<uint64_t> aligned(corrupt.size() / 8);
+        std::memcpy(aligned.data(), corrupt.data(), corrupt.size());
+        EXPECT_THROW(bio::kmer::interleaved_bloom_filter_view{std::as_bytes(std::span{aligned})}, std::invalid_argument)
+          << field << ' ' << value;
+    };
+
+    constexpr uint64_t huge = std::numeric_limits<uint64_t>::max();
+    for (uint64_t const bins : std::initializer_list<uint64_t>{0, 64, 1000, huge})
+        expect_rejected(1, bins, bytes);
+    for (uint64_t const bin_size : std::initializer_list<uint64_t>{0, 8193, uint64_t{1} << 40, huge})
+        expect_rejected(2, bin_size, bytes);
+    for (uint64_t const hash_count : std::initializer_list<uint64_t>{0, 6, 256 + 3, huge})
+        expect_rejected(3, hash_count, bytes);
+    for (uint64_t const words_per_position : std::initializer_list<uint64_t>{0, 1, 3, huge})
+        expect_rejected(4, words_per_position, bytes);
+
+    // ceil(bins / 64) overflows to 0 for these numbers of bins, so they must not match 0 words per position
+    std::string no_words = bytes;
+    std::memset(no_words.data() + 4 * 8, 0, 8);
+    for (uint64_t const bins : std::initializer_list<uint64_t>{huge - 62, huge - 1, huge})
+        expect_rejected(1, bins, no_words);
+
+    // an intact filter is also read from a stream that cannot seek
+    std::string       copy = bytes;
+    unseekable_buffer buffer{copy};
+    std::istream      unseekable{&buffer};
+    EXPECT_EQ(bio::kmer::interleaved_bloom_filter::read(unseekable), make_filter(100));
+}
+
+#if __has_include(<cereal/archives/binary.hpp>)
+TEST(interleaved_bloom_filter, cereal)
+{
+    bio::kmer::interleaved_bloom_filter const ibf = make_filter(10);
+
+    std::stringstream stream;
+    {
+        cereal::BinaryOutputArchive archive{stream};
+        archive(ibf);
+    }
+    bio::kmer::interleaved_bloom_filter in;
+    {
+        cereal::BinaryInputArchive archive{stream};
+        archive(in);
+    }
+    EXPECT_EQ(in, ibf);
+}
+#endif
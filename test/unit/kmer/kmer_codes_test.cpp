@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/nucleotide/rna4.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/kmer/kmer_codes.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+
+using namespace bio::alphabet::literals;
+
+TEST(kmer_codes, reverse_complement)
+{
+    // ACG -> CGT
+    EXPECT_EQ(bio::kmer::reverse_complement(0b00'01'10, 3), 0b01'10'11u);
+    EXPECT_EQ(bio::kmer::canonical(0b01'10'11, 3), 0b00'01'10u);
+    EXPECT_EQ(bio::kmer::reverse_complement(0, 32), ~0ull);
+    EXPECT_EQ(bio::kmer::reverse_complement(0b00, 1), 0b11u);
+    EXPECT_EQ(bio::kmer::kmer_mask(3), 0b111111u);
+    EXPECT_EQ(bio::kmer::kmer_mask(32), ~0ull);
+
+    for (uint64_t code : {0x0123'4567'89AB'CDEFull, 0xFEDC'BA98'7654'3210ull})
+    {
+        for (uint8_t k : {1, 7, 21, 31, 32})
+        {
+            uint64_t const masked = code & bio::kmer::kmer_mask(k);
+            EXPECT_EQ(bio::kmer::reverse_complement(bio::kmer::reverse_complement(masked, k), k), masked);
+        }
+    }
+}
+
+TEST(kmer_codes, for_each_kmer)
+{
+    std::vector<std::pair<size_t, uint64_t>> kmers;
+    auto collect = [&](size_t const pos, uint64_t const code) { kmers.emplace_back(pos, code); };
+
+    // ACGT: ACG = 0b000110, CGT = 0b011011
+    bio::kmer::for_each_kmer("ACGT"_dna4, {.k = 3, .canonical = false}, collect);
+    EXPECT_EQ(kmers, (std::vector<std::pair<size_t, uint64_t>>{{0, 0b000110}, {1, 0b011011}}));
+
+    // canonical: CGT -> ACG
+    kmers.clear();
+    bio::kmer::for_each_kmer("ACGT"_dna4, {.k = 3}, collect);
+    EXPECT_EQ(kmers, (std::vector<std::pair<size_t, uint64_t>>{{0, 0b000110}, {1, 0b000110}}));
+
+    // N breaks k-mers
+    kmers.clear();
+    bio::kmer::for_each_kmer("ACGNACGTT"_dna5, {.k = 3, .canonical = false}, collect);
+    EXPECT_EQ(kmers, (std::vector<std::pair<size_t, uint64_t>>{{0, 0b000110}, {4, 0b000110}, {5, 0b011011},
+                                                               {6, 0b101111}}));
+
+    // too short, k out of range
+    kmers.clear();
+    bio::kmer::for_each_kmer("AC"_dna4, {.k = 3}, collect);
+    EXPECT_TRUE(kmers.empty());
+    EXPECT_THROW(bio::kmer::for_each_kmer("AC"_dna4, {.k = 0}, collect), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::for_each_kmer("AC"_dna4, {.k = 33}, collect), std::invalid_argument);
+}
+
+TEST(kmer_codes, alphabets_and_ranges)
+{
+    std::vector<uint64_t> expected;
+    bio::kmer::kmer_codes("ACGTTGCA"_dna4, {.k = 5}, expected);
+    EXPECT_EQ(expected.size(), 4u);
+
+    std::vector<uint64_t> codes;
+    bio::kmer::kmer_codes("ACGUUGCA"_rna4, {.k = 5}, codes);
+    EXPECT_EQ(codes, expected);
+
+    codes.clear();
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> const packed{"ACGTTGCA"_dna4};
+    bio::kmer::kmer_codes(packed, {.k = 5}, codes);
+    EXPECT_EQ(codes, expected);
+
+    codes.clear();
+    std::list<bio::alphabet::dna5> const list{'A'_dna5, 'C'_dna5, 'G'_dna5, 'T'_dna5, 'T'_dna5, 'G'_dna5, 'C'_dna5,
+                                              'A'_dna5};
+    bio::kmer::kmer_codes(list, {.k = 5}, codes);
+    EXPECT_EQ(codes, expected);
+
+    codes.clear();
+    std::vector<bio::alphabet::qualified<bio::alphabet::dna5, bio::alphabet::phred42>> qualified;
+    for (bio::alphabet::dna5 const l : list)
+        qualified.push_back({l, bio::alphabet::phred42{}});
+    bio::kmer::kmer_codes(qualified, {.k = 5}, codes);
+    EXPECT_EQ(codes, expected);
+
+    // a palindrome and its reverse complement have the same canonical k-mers
+    std::vector<uint64_t> rc;
+    bio::kmer::kmer_codes("TGCAACGT"_dna4, {.k = 5}, rc);
+    std::ranges::reverse(rc);
+    EXPECT_EQ(rc, expected);
+}
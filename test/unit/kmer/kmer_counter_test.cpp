@@ -0,0 +1,173 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/kmer_counter.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+namespace
+{
+
+// reads from a random genome of 20000 bases, so most k-mers occur several times
+bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> make_reads()
+{
+    std::mt19937_64                  gen{42};
+    std::vector<bio::alphabet::dna5> genome(20'000);
+    for (auto & l : genome)
+        l.assign_rank(gen() % 4);
+
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    for (size_t i = 0; i < 2'000; ++i)
+    {
+        size_t const                     start = gen() % (genome.size() - 100);
+        std::vector<bio::alphabet::dna5> read{genome.begin() + start, genome.begin() + start + 100};
+        if (i % 10 == 0)
+            read[gen() % 100] = 'N'_dna5;
+        reads.push_back(read);
+    }
+    return reads;
+}
+
+std::vector<bio::kmer::kmer_count> count_in_memory(auto const & reads, bio::kmer::kmer_options const options)
+{
+    std::map<uint64_t, uint64_t> counts;
+    for (auto const & read : reads)
+        bio::kmer::for_each_kmer(read, options, [&](size_t, uint64_t const code) { ++counts[code]; });
+
+    std::vector<bio::kmer::kmer_count> ret;
+    for (auto const & [kmer, count] : counts)
+        ret.push_back({kmer, count});
+    return ret;
+}
+
+} // namespace
+
+TEST(kmer_counter, radix_sort)
+{
+    std::mt19937_64       gen{1};
+    std::vector<uint64_t> values(10'000);
+    for (uint64_t & v : values)
+        v = gen() & bio::kmer::kmer_mask(21);
+    std::vector<uint64_t> expected = values;
+    std::ranges::sort(expected);
+
+    std::vector<uint64_t> scratch;
+    bio::kmer::detail::radix_sort(values, scratch, 42);
+    EXPECT_EQ(values, expected);
+
+    std::vector<uint64_t> empty;
+    bio::kmer::detail::radix_sort(empty, scratch, 42);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(kmer_counter, small)
+{
+    bio::kmer::kmer_counter counter{{.k = 3, .canonical = false, .minimizer_length = 2, .partitions = 4}};
+    counter.add("ACGTACGTN"_dna5);
+    counter.add("ACGA"_dna5);
+
+    // ACG x3, CGT x2, GTA, TAC, CGA
+    EXPECT_EQ(counter.counts(),
+              (std::vector<bio::kmer::kmer_count>{{0b000110, 3}, {0b011000, 1}, {0b011011, 2}, {0b101100, 1},
+                                                  {0b110001, 1}}));
+
+    // counting does not consume the k-mers
+    counter.add("ACG"_dna4);
+    EXPECT_EQ(counter.counts().front(), (bio::kmer::kmer_count{0b000110, 4}));
+}
+
+TEST(kmer_counter, reads)
+{
+    auto const reads    = make_reads();
+    auto const expected = count_in_memory(reads, {.k = 31});
+
+    // a small memory budget and several partitions
+    bio::kmer::kmer_counter counter{{.k = 31, .partitions = 16, .memory_budget = 1 << 16}};
+    for (auto const & read : reads)
+        counter.add(read);
+    EXPECT_EQ(counter.counts(), expected);
+}
+
+TEST(kmer_counter, threads)
+{
+    auto const reads    = make_reads();
+    auto const expected = count_in_memory(reads, {.k = 25});
+
+    for (size_t const threads : {1, 4})
+    {
+        bio::kmer::kmer_counter counter{
+          {.k = 25, .minimizer_length = 9, .partitions = 7, .memory_budget = 1 << 17, .threads = threads}};
+        counter.add_all(reads);
+        EXPECT_EQ(counter.counts(), expected);
+    }
+}
+
+TEST(kmer_counter, min_count_and_write)
+{
+    auto const reads    = make_reads();
+    auto       expected = count_in_memory(reads, {.k = 21});
+    std::erase_if(expected, [](bio::kmer::kmer_count const & c) { return c.count < 5; });
+
+    bio::kmer::kmer_counter counter{{.k = 21, .min_count = 5}};
+    counter.add_all(reads);
+
+    std::stringstream stream;
+    counter.write(stream);
+    std::string const bytes = stream.str();
+    ASSERT_EQ(bytes.size(), expected.size() * sizeof(bio::kmer::kmer_count));
+    std::vector<bio::kmer::kmer_count> written(expected.size());
+    std::memcpy(written.data(), bytes.data(), bytes.size());
+    EXPECT_EQ(written, expected);
+}
+
+TEST(kmer_counter, temporary_files)
+{
+    std::filesystem::path const dir = std::filesystem::temp_directory_path() / "bio_kmer_counter_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    {
+        bio::kmer::kmer_counter counter{{.partitions = 3, .temporary_directory = dir}};
+        counter.add("ACGTTGCATTAGCCGATACGGATCCATGCATTT"_dna4);
+        EXPECT_EQ(counter.counts().size(), 3u);
+        EXPECT_FALSE(std::filesystem::is_empty(dir));
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(dir));
+    std::filesystem::remove_all(dir);
+
+    // counting fails in every thread while the others wait for the memory budget
+    std::filesystem::create_directories(dir);
+    {
+        bio::kmer::kmer_counter counter{
+          {.k = 25, .partitions = 16, .memory_budget = 1, .threads = 4, .temporary_directory = dir}};
+        counter.add_all(make_reads());
+
+        std::filesystem::path const files = *std::filesystem::directory_iterator{dir};
+        for (size_t p = 0; p < 16; ++p) // the counts of a partition cannot be written over a directory
+            std::filesystem::create_directory(files / (std::to_string(p) + ".counts"));
+        EXPECT_THROW(counter.counts(), std::runtime_error);
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(dir));
+    std::filesystem::remove_all(dir);
+
+    EXPECT_THROW(bio::kmer::kmer_counter{{.k = 33}}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::kmer_counter{{.minimizer_length = 0}}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::kmer_counter{{.partitions = 0}}, std::invalid_argument);
+    EXPECT_THROW(bio::kmer::kmer_counter{{.memory_budget = 0}}, std::invalid_argument);
+}
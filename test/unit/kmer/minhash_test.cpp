@@ -0,0 +1,169 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/kmer/minhash.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+
+using namespace bio::alphabet::literals;
+
+namespace
+{
+
+std::vector<bio::alphabet::dna4> random_sequence(size_t const length, unsigned const seed)
+{
+    std::mt19937_64                 gen{seed};
+    std::vector<bio::alphabet::dna4> ret(length);
+    for (auto & l : ret)
+        l.assign_rank(gen() % 4);
+    return ret;
+}
+
+// all distinct hash values, sorted
+std::vector<uint64_t> all_hashes(std::vector<std::vector<bio::alphabet::dna4>> const & seqs,
+                                 bio::kmer::minhash_options const                        options)
+{
+    std::set<uint64_t> hashes;
+    for (auto const & seq : seqs)
+        bio::kmer::for_each_kmer(seq,
+                                 {.k = options.k, .canonical = options.canonical},
+                                 [&](size_t, uint64_t const code) { hashes.insert(bio::kmer::mix64(code)); });
+    return {hashes.begin(), hashes.end()};
+}
+
+} // namespace
+
+TEST(minhash, bottom_k)
+{
+    std::vector<std::vector<bio::alphabet::dna4>> const seqs{random_sequence(20000, 1), random_sequence(777, 2)};
+    bio::kmer::minhash_options const                    options{.k = 15, .sketch_size = 500};
+
+    bio::kmer::minhash_sketcher sketcher{options};
+    for (auto const & seq : seqs)
+        sketcher.add(seq);
+    bio::kmer::minhash_sketch const sketch = sketcher.sketch();
+
+    std::vector<uint64_t> expected = all_hashes(seqs, options);
+    expected.resize(500);
+    EXPECT_EQ(sketch.hashes(), expected);
+    EXPECT_TRUE(sketch.full());
+
+    // fewer k-mers than the sketch size
+    bio::kmer::minhash_sketcher small{options};
+    small.add("ACGTTGCAACGTAGCTAGCTAGCTGATCGA"_dna4);
+    EXPECT_EQ(small.sketch().hashes(), all_hashes({std::vector{"ACGTTGCAACGTAGCTAGCTAGCTGATCGA"_dna4}}, options));
+    EXPECT_FALSE(small.sketch().full());
+
+    small.clear();
+    EXPECT_TRUE(small.sketch().empty());
+}
+
+TEST(minhash, frac_minhash)
+{
+    std::vector<std::vector<bio::alphabet::dna4>> const seqs{random_sequence(50000, 3)};
+    bio::kmer::minhash_options const                    options{.k = 21, .sketch_size = 0, .scaled = 100};
+
+    bio::kmer::minhash_sketch const sketch = bio::kmer::sketch_all(seqs, options);
+
+    std::vector<uint64_t> expected = all_hashes(seqs, options);
+    std::erase_if(expected, [&](uint64_t const h) { return h > sketch.max_hash(); });
+    EXPECT_EQ(sketch.hashes(), expected);
+    EXPECT_GT(sketch.size(), 300u);
+    EXPECT_LT(sketch.size(), 700u);
+    EXPECT_FALSE(sketch.full());
+}
+
+TEST(minhash, merge)
+{
+    std::vector<std::vector<bio::alphabet::dna4>> const seqs{random_sequence(5000, 4), random_sequence(5000, 5)};
+    bio::kmer::minhash_options const                    options{.k = 17, .sketch_size = 200};
+
+    bio::kmer::minhash_sketcher both{options};
+    bio::kmer::minhash_sketcher first{options};
+    bio::kmer::minhash_sketcher second{options};
+    both.add(seqs[0]);
+    both.add(seqs[1]);
+    first.add(seqs[0]);
+    second.add(seqs[1]);
+
+    bio::kmer::minhash_sketch merged = first.sketch();
+    merged.merge(second.sketch());
+    EXPECT_EQ(merged, both.sketch());
+
+    bio::kmer::minhash_sketch other = bio::kmer::minhash_sketcher{{.k = 17, .sketch_size = 100}}.sketch();
+    EXPECT_FALSE(merged.compatible(other));
+    EXPECT_THROW(merged.merge(other), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::jaccard(merged, other), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::containment(merged, other), std::invalid_argument);
+}
+
+TEST(minhash, threads)
+{
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        std::vector<bio::alphabet::dna5> read;
+        for (bio::alphabet::dna4 const l : random_sequence(150, i))
+            read.push_back(bio::alphabet::assign_char_to(bio::alphabet::to_char(l), bio::alphabet::dna5{}));
+        read[75] = 'N'_dna5;
+        reads.push_back(read);
+    }
+
+    bio::kmer::minhash_options options{.k = 21, .sketch_size = 300};
+    bio::kmer::minhash_sketch const single = bio::kmer::sketch_all(reads, options);
+    std::vector<bio::kmer::minhash_sketch> const each = bio::kmer::sketch_each(reads, options);
+
+    options.threads = 4;
+    EXPECT_EQ(bio::kmer::sketch_all(reads, options), single);
+    EXPECT_EQ(bio::kmer::sketch_each(reads, options), each);
+
+    ASSERT_EQ(each.size(), 200u);
+    bio::kmer::minhash_sketch merged{options};
+    for (auto const & s : each)
+    {
+        EXPECT_EQ(s.size(), 2u * (75 - 21 + 1) - 1); // at most one repeated k-mer
+        merged.merge(s);
+    }
+    EXPECT_EQ(merged, single);
+
+    EXPECT_TRUE(bio::kmer::sketch_each(std::vector<std::vector<bio::alphabet::dna4>>{}, options).empty());
+    EXPECT_THROW(bio::kmer::sketch_all(reads, {.k = 33}), std::invalid_argument);
+    EXPECT_THROW(bio::kmer::sketch_all(reads, {.scaled = 0}), std::invalid_argument);
+}
+
+TEST(minhash, jaccard_and_containment)
+{
+    // b shares the first half of a
+    std::vector<bio::alphabet::dna4> const a = random_sequence(100000, 6);
+    std::vector<bio::alphabet::dna4>       b{a.begin(), a.begin() + 50000};
+    std::vector<bio::alphabet::dna4> const tail = random_sequence(50000, 7);
+    b.insert(b.end(), tail.begin(), tail.end());
+    std::vector<bio::alphabet::dna4> const half{a.begin(), a.begin() + 50000};
+
+    bio::kmer::minhash_options const options{.k = 21, .sketch_size = 2000};
+    auto const sketches = bio::kmer::sketch_each(std::vector{a, b, half}, options);
+
+    EXPECT_DOUBLE_EQ(bio::kmer::jaccard(sketches[0], sketches[0]), 1.0);
+    EXPECT_NEAR(bio::kmer::jaccard(sketches[0], sketches[1]), 1.0 / 3.0, 0.05);
+    EXPECT_NEAR(bio::kmer::jaccard(sketches[0], sketches[2]), 0.5, 0.05);
+    EXPECT_DOUBLE_EQ(bio::kmer::jaccard(bio::kmer::minhash_sketch{options}, bio::kmer::minhash_sketch{options}),
+                     0.0);
+
+    // FracMinHash containment
+    bio::kmer::minhash_options const frac{.k = 21, .sketch_size = 0, .scaled = 50};
+    auto const fsketches = bio::kmer::sketch_each(std::vector{a, half}, frac);
+    EXPECT_DOUBLE_EQ(bio::kmer::containment(fsketches[1], fsketches[0]), 1.0);
+    EXPECT_NEAR(bio::kmer::containment(fsketches[0], fsketches[1]), 0.5, 0.05);
+    EXPECT_DOUBLE_EQ(bio::kmer::containment(bio::kmer::minhash_sketch{frac}, fsketches[0]), 0.0);
+}
@@ -0,0 +1,129 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#define BIOCPP_INSTRUMENTATION 2
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/meta/instrumentation.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_strictly_to.hpp>
+
+using bio::meta::instrumentation_counter;
+
+TEST(instrumentation, enabled)
+{
+    EXPECT_TRUE(bio::meta::instrumentation_enabled);
+    EXPECT_TRUE(bio::meta::instrumentation_timings_enabled);
+    EXPECT_EQ(bio::meta::instrumentation_counter_name(instrumentation_counter::bitcompressed_vector_proxy_writes),
+              "bitcompressed_vector_proxy_writes");
+}
+
+TEST(instrumentation, char_strictly_to)
+{
+    auto const before = bio::meta::take_instrumentation_snapshot();
+
+    std::string_view const str{"ACGTACGT"};
+    auto v = str | bio::views::char_strictly_to<bio::alphabet::dna4> | bio::ranges::to<std::vector>();
+    EXPECT_EQ(v.size(), 8u);
+
+    auto const diff = bio::meta::take_instrumentation_snapshot() - before;
+    EXPECT_EQ(diff[instrumentation_counter::char_strictly_to_elements], 8u);
+    EXPECT_EQ(diff[instrumentation_counter::bitcompressed_vector_proxy_writes], 0u);
+}
+
+TEST(instrumentation, bitcompressed_vector)
+{
+    using namespace bio::alphabet::literals;
+
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> vec(10, 'A'_dna4);
+
+    auto const before = bio::meta::take_instrumentation_snapshot();
+    vec[0]            = 'C'_dna4;
+    vec[9]            = 'G'_dna4;
+
+    bio::alphabet::dna4 l = vec[1]; // reads are not counted
+    EXPECT_EQ(l, 'A'_dna4);
+
+    auto const diff = bio::meta::take_instrumentation_snapshot() - before;
+    EXPECT_EQ(diff[instrumentation_counter::bitcompressed_vector_proxy_writes], 2u);
+}
+
+TEST(instrumentation, concatenated_sequences)
+{
+    bio::ranges::concatenated_sequences<std::string> seqs;
+
+    auto before = bio::meta::take_instrumentation_snapshot();
+    seqs.reserve(100);
+    seqs.concat_reserve(1000);
+    auto diff = bio::meta::take_instrumentation_snapshot() - before;
+    EXPECT_EQ(diff[instrumentation_counter::concatenated_sequences_reallocations], 2u);
+
+    // no reallocations within capacity
+    before = bio::meta::take_instrumentation_snapshot();
+    for (size_t i = 0; i < 10; ++i)
+        seqs.push_back(std::string_view{"ACGTACGT"});
+    diff = bio::meta::take_instrumentation_snapshot() - before;
+    EXPECT_EQ(diff[instrumentation_counter::concatenated_sequences_reallocations], 0u);
+
+    // but beyond
+    before = bio::meta::take_instrumentation_snapshot();
+    for (size_t i = 0; i < 1000; ++i)
+        seqs.push_back(std::string_view{"ACGTACGT"});
+    diff = bio::meta::take_instrumentation_snapshot() - before;
+    EXPECT_GT(diff[instrumentation_counter::concatenated_sequences_reallocations], 2u);
+    EXPECT_GT(diff.cycles[static_cast<size_t>(instrumentation_counter::concatenated_sequences_reallocations)], 0u);
+}
+
+TEST(instrumentation, threads)
+{
+    using namespace bio::alphabet::literals;
+
+    bio::meta::reset_instrumentation();
+    EXPECT_EQ(bio::meta::take_instrumentation_snapshot(), bio::meta::instrumentation_snapshot{});
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+          []
+          {
+              bio::ranges::bitcompressed_vector<bio::alphabet::dna4> vec(100, 'A'_dna4);
+              for (auto && l : vec)
+                  l = 'T'_dna4;
+          });
+    }
+    for (auto & t : threads)
+        t.join();
+
+    // counts of finished threads are retained; 100 writes in the constructor and 100 in the loop per thread
+    auto const snap = bio::meta::take_instrumentation_snapshot();
+    EXPECT_EQ(snap[instrumentation_counter::bitcompressed_vector_proxy_writes], 800u);
+
+    bio::meta::reset_instrumentation();
+    EXPECT_EQ(bio::meta::take_instrumentation_snapshot()[instrumentation_counter::bitcompressed_vector_proxy_writes],
+              0u);
+}
+
+TEST(instrumentation, fmt)
+{
+    bio::meta::instrumentation_snapshot snap;
+    snap.counts[0] = 3;
+    snap.cycles[1] = 42;
+
+    std::string expected = fmt::format("{:<40}{:>16}\n", "char_strictly_to_elements", 3) +
+                           fmt::format("{:<40}{:>16}  (42 cycles)\n", "concatenated_sequences_reallocations", 0) +
+                           fmt::format("{:<40}{:>16}", "bitcompressed_vector_proxy_writes", 0);
+    EXPECT_EQ(fmt::format("{}", snap), expected);
+}
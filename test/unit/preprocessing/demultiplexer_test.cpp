@@ -0,0 +1,196 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/preprocessing/demultiplexer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+
+using namespace bio::alphabet::literals;
+
+using bio::preprocessing::demultiplexer;
+using bio::preprocessing::demux_options;
+using bio::preprocessing::demux_result;
+
+static std::vector<bio::alphabet::dna5> seq(std::string_view const str)
+{
+    return str | bio::views::char_to<bio::alphabet::dna5> | bio::ranges::to<std::vector>();
+}
+
+// the documented semantics, letter by letter
+static demux_result naive_barcode_of(std::vector<std::vector<bio::alphabet::dna5>> const & barcodes,
+                                     std::vector<bio::alphabet::dna5> const &              read,
+                                     demux_options const &                                 opts)
+{
+    size_t const length = barcodes[0].size();
+    if (read.size() < opts.offset + length)
+        return {};
+
+    demux_result ret{};
+    size_t       best = opts.max_mismatches + 1;
+    for (uint32_t b = 0; b < barcodes.size(); ++b)
+    {
+        size_t mm = 0;
+        for (size_t j = 0; j < length; ++j)
+            mm += read[opts.offset + j] != barcodes[b][j];
+
+        if (mm < best)
+        {
+            best = mm;
+            ret  = {b, static_cast<uint8_t>(mm)};
+        }
+        else if (mm == best && ret.barcode != demux_result::unassigned)
+        {
+            ret.barcode = demux_result::ambiguous;
+        }
+    }
+    return ret;
+}
+
+TEST(demultiplexer, exact_and_mismatches)
+{
+    demultiplexer d{std::vector{seq("ACGTACGT"), seq("TTTTGGGG"), seq("CCCCAAAA")}};
+    EXPECT_EQ(d.barcode_size(), 8u);
+    EXPECT_EQ(d.table_size(), 3u * (1 + 3 * 8));
+
+    EXPECT_EQ(d.barcode_of(seq("ACGTACGT")), (demux_result{0, 0}));
+    EXPECT_EQ(d.barcode_of(seq("TTTTGGGGACGT")), (demux_result{1, 0})); // rest of the read is ignored
+    EXPECT_EQ(d.barcode_of(seq("CCCCAATA")), (demux_result{2, 1}));
+    EXPECT_EQ(d.barcode_of(seq("CCCCATTA")), (demux_result{}));        // two mismatches
+    EXPECT_EQ(d.barcode_of(seq("CCCCAAA")), (demux_result{}));         // too short
+    EXPECT_EQ(d.barcode_of(seq("")), (demux_result{}));
+}
+
+TEST(demultiplexer, ambiguous)
+{
+    demultiplexer d{std::vector{seq("AAAA"), seq("AATT")}, {.max_mismatches = 2}};
+
+    EXPECT_EQ(d.barcode_of(seq("AATA")).barcode, demux_result::ambiguous);
+    EXPECT_EQ(d.barcode_of(seq("AAAT")).barcode, demux_result::ambiguous);
+    EXPECT_EQ(d.barcode_of(seq("AAAA")), (demux_result{0, 0})); // closer to the first
+    EXPECT_EQ(d.barcode_of(seq("CAAA")), (demux_result{0, 1}));
+    EXPECT_EQ(d.barcode_of(seq("CCTT")), (demux_result{1, 2}));
+}
+
+TEST(demultiplexer, n)
+{
+    demultiplexer d{std::vector{seq("ACGTACGT"), seq("TTTTGGGG")}};
+
+    EXPECT_EQ(d.barcode_of(seq("ACGTNCGT")), (demux_result{0, 1}));
+    EXPECT_EQ(d.barcode_of(seq("ACGTNCGA")), (demux_result{}));
+    EXPECT_EQ(d.barcode_of(seq("NNNNNNNN")), (demux_result{}));
+
+    demultiplexer d2{std::vector{seq("AAAA"), seq("AAAT")}};
+    EXPECT_EQ(d2.barcode_of(seq("AAAN")).barcode, demux_result::ambiguous);
+}
+
+TEST(demultiplexer, offset)
+{
+    demultiplexer d{std::vector{seq("ACGT"), seq("TTTT")}, {.max_mismatches = 0, .offset = 3}};
+
+    EXPECT_EQ(d.barcode_of(seq("GGGACGTGG")), (demux_result{0, 0}));
+    EXPECT_EQ(d.barcode_of(seq("GGGTTTT")), (demux_result{1, 0}));
+    EXPECT_EQ(d.barcode_of(seq("GGGTTT")), (demux_result{}));
+    EXPECT_EQ(d.barcode_of(seq("ACGTGGG")), (demux_result{}));
+}
+
+TEST(demultiplexer, errors)
+{
+    using barcodes_t = std::vector<std::vector<bio::alphabet::dna5>>;
+    EXPECT_THROW((demultiplexer{barcodes_t{}}), std::invalid_argument);
+    EXPECT_THROW((demultiplexer{barcodes_t{seq("ACGT"), seq("ACG")}}), std::invalid_argument);
+    EXPECT_THROW((demultiplexer{barcodes_t{seq("ACGT"), seq("ACGT")}}), std::invalid_argument);
+    EXPECT_THROW((demultiplexer{barcodes_t{seq("ACNT")}}), std::invalid_argument);
+    EXPECT_THROW((demultiplexer{barcodes_t{seq("")}}), std::invalid_argument);
+    EXPECT_THROW((demultiplexer{barcodes_t{std::vector<bio::alphabet::dna5>(33, 'A'_dna5)}}), std::invalid_argument);
+    EXPECT_NO_THROW((demultiplexer{barcodes_t{std::vector<bio::alphabet::dna5>(32, 'A'_dna5)}}));
+}
+
+TEST(demultiplexer, alphabets)
+{
+    demultiplexer d{std::vector{"ACGTACGT"_dna4, "TTTTGGGG"_dna4}};
+
+    EXPECT_EQ(d.barcode_of("TTTTGGGC"_dna4), (demux_result{1, 1}));
+
+    std::vector<bio::alphabet::qualified<bio::alphabet::dna5, bio::alphabet::phred42>> qual;
+    for (bio::alphabet::dna5 const l : seq("ACGTACGTCCCC"))
+        qual.push_back({l, bio::alphabet::phred42{}.assign_phred(30)});
+    EXPECT_EQ(d.barcode_of(qual), (demux_result{0, 0}));
+}
+
+TEST(demultiplexer, batch)
+{
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    reads.push_back(seq("ACGTACGTAAAAAA"));
+    reads.push_back(seq("GGGGGGGGGGGGGG"));
+    reads.push_back(seq("TTTTGGGAAAAAAA"));
+
+    demultiplexer d{std::vector{seq("ACGTACGT"), seq("TTTTGGGG")}};
+
+    std::vector<demux_result> const expected{{0, 0}, {}, {1, 1}};
+    EXPECT_EQ(d.barcodes_of(reads), expected);
+
+    std::vector<demux_result> out(3);
+    d.barcodes_of(reads, out);
+    EXPECT_EQ(out, expected);
+}
+
+TEST(demultiplexer, random)
+{
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> letter{0, 3};
+
+    auto random_seq = [&](size_t const n)
+    {
+        std::vector<bio::alphabet::dna5> ret(n);
+        for (auto & l : ret)
+            l.assign_char("ACGT"[letter(gen)]);
+        return ret;
+    };
+
+    for (size_t max_mismatches : {0, 1, 2, 3})
+    {
+        for (size_t length : {4, 6, 12, 32})
+        {
+            std::vector<std::vector<bio::alphabet::dna5>> barcodes;
+            while (barcodes.size() < 20)
+            {
+                auto b = random_seq(length);
+                if (std::ranges::find(barcodes, b) == barcodes.end())
+                    barcodes.push_back(std::move(b));
+            }
+
+            demux_options const opts{.max_mismatches = max_mismatches, .offset = 2};
+            demultiplexer       d{barcodes, opts};
+
+            for (size_t iteration = 0; iteration < 200; ++iteration)
+            {
+                auto read = random_seq(2 + length + letter(gen));
+                // mutate a barcode
+                auto const & b = barcodes[iteration % barcodes.size()];
+                for (size_t j = 0; j < length; ++j)
+                {
+                    read[2 + j] = b[j];
+                    if (letter(gen) == 0 && letter(gen) == 0)
+                        read[2 + j] =
+                          letter(gen) == 0 ? 'N'_dna5 : bio::alphabet::dna5{}.assign_char("ACGT"[letter(gen)]);
+                }
+
+                EXPECT_EQ(d.barcode_of(read), naive_barcode_of(barcodes, read, opts));
+            }
+        }
+    }
+}
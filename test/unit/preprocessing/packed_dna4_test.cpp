@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/packed_dna4.hpp>
+
+using namespace bio::alphabet::literals;
+
+TEST(packed_dna4, pack)
+{
+    EXPECT_EQ(bio::preprocessing::pack_dna4(""_dna4), 0u);
+    EXPECT_EQ(bio::preprocessing::pack_dna4("ACGT"_dna4), 0b00'01'10'11u);
+    EXPECT_EQ(bio::preprocessing::pack_dna4("TA"_dna5), 0b11'00u);
+    EXPECT_EQ(bio::preprocessing::pack_dna4("ACNT"_dna5), std::nullopt);
+    EXPECT_EQ(bio::preprocessing::pack_dna4("TTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTT"_dna4), ~0ull);
+
+    // codes of equal length compare like the sequences
+    EXPECT_LT(bio::preprocessing::pack_dna4("ACGT"_dna4), bio::preprocessing::pack_dna4("AGAA"_dna4));
+}
+
+TEST(packed_dna4, hamming_distance)
+{
+    uint64_t const a = *bio::preprocessing::pack_dna4("ACGTACGT"_dna4);
+    uint64_t const b = *bio::preprocessing::pack_dna4("ACGAACCT"_dna4);
+
+    EXPECT_EQ(bio::preprocessing::hamming_distance(a, a), 0u);
+    EXPECT_EQ(bio::preprocessing::hamming_distance(a, b), 2u);
+    // ignore the fourth letter
+    EXPECT_EQ(bio::preprocessing::hamming_distance(a, b, ~(0b11ull << 8)), 1u);
+}
+
+TEST(packed_dna4, hamming_distances)
+{
+    std::mt19937_64 gen{42};
+
+    for (size_t n : {0, 1, 3, 4, 5, 17, 100})
+    {
+        std::vector<uint64_t> codes(n);
+        for (auto & c : codes)
+            c = gen();
+
+        uint64_t const query = gen();
+        uint64_t const mask  = gen() | gen();
+
+        std::vector<uint8_t> out(n);
+        bio::preprocessing::hamming_distances(query, codes, out, mask);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], bio::preprocessing::hamming_distance(query, codes[i], mask));
+
+        bio::preprocessing::hamming_distances(query, codes, out);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(out[i], bio::preprocessing::hamming_distance(query, codes[i]));
+    }
+}
+
+TEST(packed_dna4, for_each_neighbour)
+{
+    uint64_t const     code = *bio::preprocessing::pack_dna4("ACGTA"_dna4);
+    std::set<uint64_t> neighbours;
+    bio::preprocessing::for_each_neighbour(code,
+                                           5,
+                                           [&](uint64_t const n)
+                                           {
+                                               EXPECT_EQ(bio::preprocessing::hamming_distance(code, n), 1u);
+                                               EXPECT_LT(n, 1u << 10);
+                                               neighbours.insert(n);
+                                           });
+    EXPECT_EQ(neighbours.size(), 15u);
+}
@@ -0,0 +1,222 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/preprocessing/pair_merger.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+#include <bio/ranges/views/complement.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+using namespace bio::alphabet::literals;
+
+using bio::preprocessing::merge_options;
+using bio::preprocessing::merge_result;
+using bio::preprocessing::pair_merger;
+
+using qualified_t = bio::alphabet::qualified<bio::alphabet::dna5, bio::alphabet::phred42>;
+
+static std::vector<bio::alphabet::dna5> seq(std::string_view const str)
+{
+    return str | bio::views::char_to<bio::alphabet::dna5> | bio::ranges::to<std::vector>();
+}
+
+static std::vector<bio::alphabet::dna5> revcomp(std::vector<bio::alphabet::dna5> const & s)
+{
+    return s | std::views::reverse | bio::views::complement | bio::ranges::to<std::vector>();
+}
+
+static std::vector<qualified_t> qualify(std::vector<bio::alphabet::dna5> const & s, int const phred)
+{
+    std::vector<qualified_t> ret;
+    for (bio::alphabet::dna5 const l : s)
+        ret.push_back({l, bio::alphabet::phred42{}.assign_phred(phred)});
+    return ret;
+}
+
+// the documented semantics, letter by letter
+static merge_result naive_overlap(std::vector<bio::alphabet::dna5> const & r1,
+                                  std::vector<bio::alphabet::dna5> const & r2,
+                                  merge_options const &                    opts)
+{
+    auto const      rc2 = revcomp(r2);
+    ptrdiff_t const n1  = r1.size();
+    ptrdiff_t const n2  = r2.size();
+    ptrdiff_t const mo  = std::max<size_t>(opts.min_overlap, 1);
+
+    merge_result best{};
+    for (ptrdiff_t d = mo - n2; d <= n1 - mo; ++d)
+    {
+        size_t overlap = 0;
+        size_t mm      = 0;
+        for (ptrdiff_t p = std::max<ptrdiff_t>(d, 0); p < std::min(n1, d + n2); ++p)
+        {
+            ++overlap;
+            mm += r1[p] != rc2[p - d] && r1[p] != 'N'_dna5 && rc2[p - d] != 'N'_dna5;
+        }
+
+        if (mm > static_cast<size_t>(opts.max_error_rate * static_cast<float>(overlap)))
+            continue;
+        if (!best.merged || mm * best.overlap < best.mismatches * overlap ||
+            (mm * best.overlap == best.mismatches * overlap && overlap > best.overlap))
+            best = {true, d, overlap, mm, static_cast<size_t>(d + n2)};
+    }
+    return best;
+}
+
+TEST(pair_merger, find_overlap)
+{
+    // fragment: ACGTTGCAAGGCTTACGATCGGATCCATGACTGACCTAGG (40)
+    auto const r1 = seq("ACGTTGCAAGGCTTACGATCGGATCC");                // first 26
+    auto const r2 = revcomp(seq("TTACGATCGGATCCATGACTGACCTAGG")); // last 28
+
+    pair_merger        m{};
+    merge_result const res = m.find_overlap(r1, r2);
+    EXPECT_TRUE(res.merged);
+    EXPECT_EQ(res.offset, 12);
+    EXPECT_EQ(res.overlap, 14u);
+    EXPECT_EQ(res.mismatches, 0u);
+    EXPECT_EQ(res.length, 40u);
+
+    // too short
+    pair_merger m2{{.min_overlap = 15}};
+    EXPECT_FALSE(m2.find_overlap(r1, r2).merged);
+}
+
+TEST(pair_merger, dovetail)
+{
+    // fragment shorter than the reads: read 1 runs into the adapter, so does read 2
+    auto const fragment = seq("ACGTTGCAAGGCTTACGATC");
+    auto       r1       = fragment;
+    r1.insert(r1.end(), {'A'_dna5, 'G'_dna5, 'A'_dna5, 'T'_dna5, 'C'_dna5});
+    auto r2 = revcomp(fragment);
+    r2.insert(r2.end(), {'A'_dna5, 'G'_dna5, 'A'_dna5, 'T'_dna5, 'C'_dna5});
+
+    pair_merger        m{};
+    merge_result const res = m.find_overlap(r1, r2);
+    EXPECT_TRUE(res.merged);
+    EXPECT_EQ(res.offset, -5);
+    EXPECT_EQ(res.length, 20u);
+    EXPECT_EQ(res.mismatches, 0u);
+}
+
+TEST(pair_merger, merge_qualities)
+{
+    auto const r1 = seq("ACGTTGCAAGGCTTACGATCGGATCC");
+    auto       f2 = seq("TTACGATCGGATCCATGACTGACCTAGG");
+    f2[1]         = 'G'_dna5; // mismatch in the overlap at fragment position 13
+    f2[3]         = 'N'_dna5; // N at fragment position 15
+    auto const r2 = revcomp(f2);
+
+    std::vector<bio::alphabet::phred42> q1(r1.size(), bio::alphabet::phred42{}.assign_phred(30));
+    std::vector<bio::alphabet::phred42> q2(r2.size(), bio::alphabet::phred42{}.assign_phred(20));
+
+    pair_merger                         m{{.min_overlap = 10, .max_error_rate = 0.1f}};
+    std::vector<bio::alphabet::dna5>    out_seq;
+    std::vector<bio::alphabet::phred42> out_qual;
+    merge_result const                  res = m.merge(r1, q1, r2, q2, out_seq, out_qual);
+
+    ASSERT_TRUE(res.merged);
+    EXPECT_EQ(res.mismatches, 1u);
+    EXPECT_RANGE_EQ(out_seq, seq("ACGTTGCAAGGCTTACGATCGGATCCATGACTGACCTAGG"));
+    ASSERT_EQ(out_qual.size(), 40u);
+
+    auto const & tab = bio::preprocessing::detail::merge_quality_tables::get();
+    EXPECT_EQ(out_qual[0].to_phred(), 30);                                    // only read 1
+    EXPECT_EQ(out_qual[12].to_phred(), std::min<int>(tab.match[30][20], 41)); // both agree
+    EXPECT_EQ(out_qual[13].to_phred(), tab.mismatch[30][20]);                 // read 1 wins
+    EXPECT_EQ(out_qual[15].to_phred(), 30);                                   // N in read 2
+    EXPECT_EQ(out_qual[39].to_phred(), 20);                                   // only read 2
+
+    // nothing appended if there is no overlap
+    EXPECT_FALSE(m.merge(r1, q1, seq("CCCCCCCCCCCC"), q2, out_seq, out_qual).merged);
+    EXPECT_EQ(out_seq.size(), 40u);
+}
+
+TEST(pair_merger, quality_tables)
+{
+    auto const & tab = bio::preprocessing::detail::merge_quality_tables::get();
+    EXPECT_EQ(tab.match[20][20], 45);    // agreement increases the quality
+    EXPECT_EQ(tab.mismatch[30][30], 3);  // equal qualities: coin toss
+    EXPECT_EQ(tab.mismatch[40][10], 30); // disagreement decreases it
+    EXPECT_LT(tab.mismatch[30][20], 30);
+}
+
+TEST(pair_merger, qualified)
+{
+    auto const r1 = qualify(seq("ACGTTGCAAGGCTTACGATCGGATCC"), 30);
+    auto const r2 = qualify(revcomp(seq("TTACGATCGGATCCATGACTGACCTAGG")), 30);
+
+    pair_merger              m{};
+    std::vector<qualified_t> out;
+    merge_result const       res = m.merge(r1, r2, out);
+    ASSERT_TRUE(res.merged);
+    ASSERT_EQ(out.size(), 40u);
+    EXPECT_RANGE_EQ(out | std::views::transform([](qualified_t const l) { return get<0>(l); }),
+                    seq("ACGTTGCAAGGCTTACGATCGGATCCATGACTGACCTAGG"));
+    EXPECT_EQ(get<1>(out[20]).to_phred(), 41); // clamped
+}
+
+TEST(pair_merger, batch)
+{
+    bio::ranges::concatenated_sequences<std::vector<qualified_t>> reads1;
+    bio::ranges::concatenated_sequences<std::vector<qualified_t>> reads2;
+    reads1.push_back(qualify(seq("ACGTTGCAAGGCTTACGATCGGATCC"), 30));
+    reads2.push_back(qualify(revcomp(seq("TTACGATCGGATCCATGACTGACCTAGG")), 30));
+    reads1.push_back(qualify(seq("ACGTACGTACGTACGTACGT"), 30));
+    reads2.push_back(qualify(seq("GGGGGGGGGGGGGGGGGGGG"), 30));
+
+    pair_merger                                                   m{};
+    bio::ranges::concatenated_sequences<std::vector<qualified_t>> out;
+    auto const                                                    res = m.merge_pairs(reads1, reads2, out);
+
+    ASSERT_EQ(res.size(), 2u);
+    EXPECT_TRUE(res[0].merged);
+    EXPECT_FALSE(res[1].merged);
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].size(), 40u);
+    EXPECT_EQ(out[1].size(), 0u);
+}
+
+TEST(pair_merger, random)
+{
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> letter{0, 3};
+    std::uniform_int_distribution<int> len{20, 200};
+
+    auto random_seq = [&](size_t const n)
+    {
+        std::vector<bio::alphabet::dna5> ret(n);
+        for (auto & l : ret)
+            l.assign_char("ACGT"[letter(gen)]);
+        return ret;
+    };
+
+    pair_merger m{{.min_overlap = 8, .max_error_rate = 0.15f}};
+    for (size_t iteration = 0; iteration < 300; ++iteration)
+    {
+        auto const fragment = random_seq(len(gen));
+        size_t     n1       = std::min<size_t>(fragment.size(), len(gen));
+        size_t     n2       = std::min<size_t>(fragment.size(), len(gen));
+
+        std::vector<bio::alphabet::dna5> r1{fragment.begin(), fragment.begin() + n1};
+        auto r2 = revcomp(std::vector<bio::alphabet::dna5>{fragment.end() - n2, fragment.end()});
+        for (auto & l : r1)
+            if (letter(gen) == 0 && letter(gen) == 0 && letter(gen) == 0)
+                l = letter(gen) == 0 ? 'N'_dna5 : bio::alphabet::dna5{}.assign_char("ACGT"[letter(gen)]);
+
+        EXPECT_EQ(m.find_overlap(r1, r2), naive_overlap(r1, r2, m.options()));
+    }
+}
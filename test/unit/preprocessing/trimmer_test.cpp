@@ -0,0 +1,253 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/quality/phred42.hpp>
+#include <bio/alphabet/quality/qualified.hpp>
+#include <bio/preprocessing/trimmer.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+
+using namespace bio::alphabet::literals;
+
+using bio::preprocessing::trim_options;
+using bio::preprocessing::trimmer;
+
+static std::vector<bio::alphabet::dna5> seq(std::string_view const str)
+{
+    return str | bio::views::char_to<bio::alphabet::dna5> | bio::ranges::to<std::vector>();
+}
+
+// straightforward implementations of the documented semantics
+static size_t naive_adapter_position(std::vector<bio::alphabet::dna5> const & read,
+                                     std::vector<bio::alphabet::dna5> const & adapter,
+                                     trim_options const &                     opts)
+{
+    size_t const m = std::min<size_t>(adapter.size(), 64);
+    size_t const n = read.size();
+    if (m == 0)
+        return n;
+    size_t const min_overlap = std::clamp<size_t>(opts.min_overlap, 1, m);
+
+    for (size_t i = 0; i + min_overlap <= n; ++i)
+    {
+        size_t const overlap = std::min(m, n - i);
+        size_t       errors  = 0;
+        for (size_t j = 0; j < overlap; ++j)
+            errors += adapter[j] != 'N'_dna5 && adapter[j] != read[i + j];
+
+        if (errors <= static_cast<size_t>(opts.max_error_rate * static_cast<float>(overlap)))
+            return i;
+    }
+    return n;
+}
+
+static size_t naive_poly_x_position(std::vector<bio::alphabet::dna5> const & read,
+                                    bio::alphabet::dna5 const                x,
+                                    size_t const                             min_length)
+{
+    size_t    best       = read.size();
+    ptrdiff_t score      = 0;
+    ptrdiff_t best_score = 0;
+    for (size_t i = read.size(); i-- > 0;)
+    {
+        score += read[i] == x ? 1 : -2;
+        if (score > best_score)
+        {
+            best_score = score;
+            best       = i;
+        }
+    }
+    return read.size() - best >= min_length ? best : read.size();
+}
+
+TEST(trimmer, adapter_full)
+{
+    auto const adapter = seq("AGATCGGAAGAGC");
+    trimmer    t{adapter};
+
+    EXPECT_EQ(t.adapter_position(seq("ACGTACGTACAGATCGGAAGAGCTTTT")), 10u);
+    EXPECT_EQ(t.adapter_position(seq("AGATCGGAAGAGC")), 0u);
+    EXPECT_EQ(t.adapter_position(seq("ACGTACGTACGTACGTACGT")), 20u);
+    EXPECT_EQ(t.adapter_position(seq("")), 0u);
+}
+
+TEST(trimmer, adapter_partial)
+{
+    trimmer t{seq("AGATCGGAAGAGC")};
+
+    EXPECT_EQ(t.adapter_position(seq("CCCCCCCCCCAGATCG")), 10u);
+    EXPECT_EQ(t.adapter_position(seq("CCCCCCCCCCAGA")), 10u);
+    EXPECT_EQ(t.adapter_position(seq("CCCCCCCCCCAG")), 12u); // shorter than min_overlap
+
+    trimmer t2{seq("AGATCGGAAGAGC"), {.min_overlap = 1}};
+    EXPECT_EQ(t2.adapter_position(seq("CCCCCCCCCCAG")), 10u);
+}
+
+TEST(trimmer, adapter_mismatches)
+{
+    trimmer t{seq("AGATCGGAAGAGC")};
+
+    // one mismatch in 13 letters is allowed with the default error rate of 0.1
+    EXPECT_EQ(t.adapter_position(seq("CCCCCCAGATCGTAAGAGCCC")), 6u);
+    // two are not
+    EXPECT_EQ(t.adapter_position(seq("CCCCCCAGTTCGTAAGAGCCC")), 21u);
+
+    trimmer t2{seq("AGATCGGAAGAGC"), {.max_error_rate = 0.2f}};
+    EXPECT_EQ(t2.adapter_position(seq("CCCCCCAGTTCGTAAGAGCCC")), 6u);
+
+    trimmer t3{seq("AGATCGGAAGAGC"), {.max_error_rate = 0.0f}};
+    EXPECT_EQ(t3.adapter_position(seq("CCCCCCAGATCGTAAGAGCCC")), 21u);
+}
+
+TEST(trimmer, adapter_n)
+{
+    trimmer t{seq("AGANNGGA"), {.max_error_rate = 0.0f}};
+    EXPECT_EQ(t.adapter_position(seq("CCCCAGATCGGACC")), 4u);
+    EXPECT_EQ(t.adapter_position(seq("CCCCAGANNGGACC")), 4u);
+
+    trimmer t2{seq("AGATCGGA"), {.max_error_rate = 0.0f}};
+    EXPECT_EQ(t2.adapter_position(seq("CCCCAGANCGGACC")), 14u); // N in read is a mismatch
+}
+
+TEST(trimmer, adapter_long_reads)
+{
+    // matches across word boundaries of the masks
+    auto const adapter = seq("AGATCGGAAGAGCACACGTCTGAACTCCAGTCACAGATCGGAAGAGCACACGTCTGAACTCCAGTCAC");
+    trimmer    t{adapter, {.max_error_rate = 0.0f}};
+
+    for (size_t prefix : {0, 1, 50, 63, 64, 65, 127, 128, 200})
+    {
+        std::vector<bio::alphabet::dna5> read(prefix, 'T'_dna5);
+        read.insert(read.end(), adapter.begin(), adapter.end());
+        EXPECT_EQ(t.adapter_position(read), prefix);
+
+        read.resize(prefix + 5); // partial
+        EXPECT_EQ(t.adapter_position(read), prefix);
+    }
+}
+
+TEST(trimmer, poly_x)
+{
+    trimmer t{seq(""), {.poly_x = {'G'_dna5}}};
+
+    EXPECT_EQ(t.poly_x_position(seq("ACGTACGTACGGGGGGGGGGGG")), 10u);
+    EXPECT_EQ(t.poly_x_position(seq("ACGTACGTACGGGGGGGGG")), 19u);           // too short
+    EXPECT_EQ(t.poly_x_position(seq("ACGTACGTACGGGGGAGGGGGGGG")), 10u);      // single mismatch
+    EXPECT_EQ(t.poly_x_position(seq("ACGTACGTACGGGGGGGGGGGGTACTTAC")), 29u); // no tail
+    EXPECT_EQ(t.poly_x_position(seq("GGGGGGGGGGGGGG")), 0u);
+    EXPECT_EQ(t.poly_x_position(seq("")), 0u);
+
+    std::vector<bio::alphabet::dna5> read(10, 'A'_dna5);
+    read.insert(read.end(), 150, 'G'_dna5);
+    EXPECT_EQ(t.poly_x_position(read), 10u);
+}
+
+TEST(trimmer, trim_position)
+{
+    trimmer t{seq("AGATCGGAAGAGC"), {.poly_x = {'G'_dna5, 'A'_dna5}}};
+
+    // poly-G after the adapter, poly-A before it
+    EXPECT_EQ(t.trim_position(seq("ACGTACGTACAAAAAAAAAAAAGATCGGAAGAGCTTGGGGGGGGGGGGGGGG")), 10u);
+    // only poly-G
+    EXPECT_EQ(t.trim_position(seq("ACGTACGTACTTGGGGGGGGGGGG")), 12u);
+    // poly-A at the end is not removed if there is no adapter
+    EXPECT_EQ(t.trim_position(seq("ACGTACGTACAAAAAAAAAAAATCGTTCG")), 29u);
+}
+
+TEST(trimmer, poly_x_only)
+{
+    // an empty adapter never matches, but poly-X tails are still trimmed
+    trimmer t{seq(""), {.min_overlap = 5, .poly_x = {'G'_dna5}}};
+    EXPECT_EQ(t.adapter_position(seq("ACGTACGTACAGATCGGAAGAGC")), 23u);
+    EXPECT_EQ(t.adapter_position(seq("")), 0u);
+    EXPECT_EQ(t.trim_position(seq("ACGTACGTACTTGGGGGGGGGGGG")), 12u);
+    EXPECT_EQ(t.trim_position(seq("ACGTACGTACAAAAAAAAAAAA")), 22u);
+
+    // the default trimmer removes nothing
+    trimmer d{};
+    EXPECT_EQ(d.adapter_position(seq("ACGTACGTACAGATCGGAAGAGC")), 23u);
+    EXPECT_EQ(d.trim_position(seq("ACGTACGTACTTGGGGGGGGGGGG")), 24u);
+    EXPECT_EQ(d.trim_position(seq("")), 0u);
+}
+
+TEST(trimmer, alphabets)
+{
+    trimmer t{"AGATCGGAAGAGC"_dna4};
+
+    EXPECT_EQ(t.adapter_position("ACGTACGTACAGATCGGAAGAGCTTTT"_dna4), 10u);
+
+    std::vector<bio::alphabet::qualified<bio::alphabet::dna5, bio::alphabet::phred42>> qual;
+    for (bio::alphabet::dna5 const l : seq("ACGTACGTACAGATCGGAAGAGCTTTT"))
+        qual.push_back({l, bio::alphabet::phred42{}.assign_phred(30)});
+    EXPECT_EQ(t.trim_position(qual), 10u);
+}
+
+TEST(trimmer, random)
+{
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<int>    letter{0, 4};
+    std::uniform_int_distribution<int>    len{0, 300};
+    std::uniform_real_distribution<float> rate{0.0f, 0.3f};
+
+    auto random_seq = [&](size_t const n)
+    {
+        std::vector<bio::alphabet::dna5> ret(n);
+        for (auto & l : ret)
+            l.assign_rank(letter(gen));
+        return ret;
+    };
+
+    for (size_t iteration = 0; iteration < 500; ++iteration)
+    {
+        trim_options opts{.max_error_rate = rate(gen), .min_overlap = static_cast<size_t>(len(gen) % 8)};
+        auto const   adapter = random_seq(len(gen) % 80);
+        trimmer      t{adapter, opts};
+
+        // plant a mutated adapter somewhere
+        auto   read = random_seq(len(gen));
+        size_t pos  = read.empty() ? 0 : len(gen) % read.size();
+        for (size_t j = 0; j < adapter.size() && pos + j < read.size(); ++j)
+            read[pos + j] = letter(gen) == 0 ? bio::alphabet::dna5{}.assign_rank(letter(gen)) : adapter[j];
+
+        EXPECT_EQ(t.adapter_position(read), naive_adapter_position(read, adapter, opts));
+
+        // plant a tail
+        read.resize(read.size() + len(gen) % 40, letter(gen) == 0 ? 'A'_dna5 : 'G'_dna5);
+        for (auto & l : read | std::views::reverse | std::views::take(40))
+            if (letter(gen) == 0 && letter(gen) == 0)
+                l = 'T'_dna5;
+
+        trimmer tp{seq(""), {.poly_x = {'G'_dna5}}};
+        EXPECT_EQ(tp.poly_x_position(read), naive_poly_x_position(read, 'G'_dna5, 10));
+    }
+}
+
+TEST(trimmer, batch)
+{
+    bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>> reads;
+    reads.push_back(seq("ACGTACGTACAGATCGGAAGAGCTTTT"));
+    reads.push_back(seq("ACGTACGTACGTACGTACGT"));
+    reads.push_back(seq(""));
+    reads.push_back(seq("CCCCCCCCCCAGATCG"));
+
+    trimmer t{seq("AGATCGGAAGAGC")};
+
+    std::vector<size_t> const expected{10, 20, 0, 10};
+    EXPECT_EQ(t.trim_positions(reads), expected);
+
+    std::vector<size_t> out(4);
+    t.trim_positions(reads, out);
+    EXPECT_EQ(out, expected);
+}
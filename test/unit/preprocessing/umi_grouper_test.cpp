@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/preprocessing/umi_grouper.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/char_to.hpp>
+#include <bio/ranges/views/to_char.hpp>
+
+using namespace bio::alphabet::literals;
+
+using bio::preprocessing::umi_grouper;
+
+using umis_t = bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna5>>;
+
+static umis_t umis(std::vector<std::string_view> const & strs)
+{
+    umis_t ret;
+    for (std::string_view const s : strs)
+        ret.push_back(s | bio::views::char_to<bio::alphabet::dna5>);
+    return ret;
+}
+
+// the documented semantics on strings
+static std::vector<uint32_t> naive_group(std::vector<uint64_t> const & positions, umis_t const & u)
+{
+    std::map<uint64_t, std::map<std::string, std::vector<size_t>>> by_position;
+    for (size_t i = 0; i < positions.size(); ++i)
+        by_position[positions[i]][u[i] | bio::views::to_char | bio::ranges::to<std::string>()].push_back(i);
+
+    auto distance = [](std::string const & a, std::string const & b)
+    {
+        size_t d = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+            d += a[i] != b[i];
+        return d;
+    };
+
+    std::vector<uint32_t> ret(positions.size());
+    uint32_t              n_groups = 0;
+    for (auto const & [position, by_umi] : by_position)
+    {
+        std::vector<std::pair<std::string, std::vector<size_t>>> nodes;
+        std::vector<std::vector<size_t>>                         with_n;
+        for (auto const & [umi, reads] : by_umi)
+        {
+            if (umi.find('N') == std::string::npos)
+                nodes.emplace_back(umi, reads);
+            else
+                for (size_t r : reads)
+                    with_n.push_back({r});
+        }
+        std::ranges::stable_sort(nodes,
+                                 [](auto const & l, auto const & r) { return l.second.size() > r.second.size(); });
+
+        std::vector<bool> done(nodes.size());
+        for (size_t root = 0; root < nodes.size(); ++root)
+        {
+            if (done[root])
+                continue;
+            std::vector<size_t> stack{root};
+            done[root] = true;
+            while (!stack.empty())
+            {
+                size_t const v = stack.back();
+                stack.pop_back();
+                for (size_t r : nodes[v].second)
+                    ret[r] = n_groups;
+                for (size_t w = 0; w < nodes.size(); ++w)
+                {
+                    if (!done[w] && distance(nodes[v].first, nodes[w].first) == 1 &&
+                        nodes[v].second.size() >= 2 * nodes[w].second.size() - 1)
+                    {
+                        done[w] = true;
+                        stack.push_back(w);
+                    }
+                }
+            }
+            ++n_groups;
+        }
+
+        // N reads sorted by read index
+        std::ranges::sort(with_n);
+        for (auto const & r : with_n)
+            ret[r[0]] = n_groups++;
+    }
+    return ret;
+}
+
+TEST(umi_grouper, directional)
+{
+    // ACGT (5x) absorbs ACGA (2x) and ACGC (1x); ACGA does not absorb AGGA (2x): 2 < 2 * 2 - 1
+    std::vector<uint64_t> const positions(10, 7);
+    auto const u = umis({"ACGT", "ACGT", "ACGA", "ACGT", "ACGC", "ACGT", "AGGA", "ACGA", "ACGT", "AGGA"});
+
+    umi_grouper           g{};
+    std::vector<uint32_t> out(10);
+    EXPECT_EQ(g.group(positions, u, out), 2u);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 0, 0, 0, 0, 0, 1, 0, 0, 1}));
+}
+
+TEST(umi_grouper, positions)
+{
+    std::vector<uint64_t> const positions{3, 1, 3, 1, 2};
+    auto const                  u = umis({"AAAA", "AAAA", "AAAA", "AAAT", "TTTT"});
+
+    umi_grouper g{};
+    // position 1: AAAA and AAAT have equal counts (1 >= 2 * 1 - 1), so they are merged
+    EXPECT_EQ(g.group(positions, u), (std::vector<uint32_t>{2, 0, 2, 0, 1}));
+}
+
+TEST(umi_grouper, n)
+{
+    std::vector<uint64_t> const positions{1, 1, 1, 1};
+    auto const                  u = umis({"ACGT", "ACNT", "ACGT", "ACNT"});
+
+    umi_grouper g{};
+    EXPECT_EQ(g.group(positions, u), (std::vector<uint32_t>{0, 1, 0, 2}));
+}
+
+TEST(umi_grouper, errors)
+{
+    umi_grouper g{};
+    EXPECT_THROW(g.group(std::vector<uint64_t>{1, 2}, umis({"ACGT"})), std::invalid_argument);
+    EXPECT_THROW(g.group(std::vector<uint64_t>{1}, umis({"ACGT", "ACGT"})), std::invalid_argument);
+    EXPECT_THROW(g.group(std::vector<uint64_t>{1, 2}, umis({"ACGT", "ACG"})), std::invalid_argument);
+    EXPECT_THROW(g.group(std::vector<uint64_t>{1}, umis({"ACGTACGTACGTACGTACGTACGTACGTACGTA"})), std::invalid_argument);
+    EXPECT_EQ(g.group(std::vector<uint64_t>{}, umis({})), std::vector<uint32_t>{});
+}
+
+TEST(umi_grouper, dna4)
+{
+    std::vector<uint64_t> const                         positions{1, 1, 1};
+    std::vector<std::vector<bio::alphabet::dna4>> const u{"ACGT"_dna4, "ACGT"_dna4, "ACGG"_dna4};
+
+    umi_grouper g{};
+    EXPECT_EQ(g.group(positions, u), (std::vector<uint32_t>{0, 0, 0}));
+}
+
+TEST(umi_grouper, random)
+{
+    std::mt19937                          gen{42};
+    std::uniform_int_distribution<int>    letter{0, 3};
+    std::uniform_int_distribution<size_t> position{0, 30};
+
+    for (size_t length : {1, 3, 6, 10})
+    {
+        // a few true UMIs per position, with errors
+        std::vector<std::string> truth;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            std::string s(length, 'A');
+            for (char & c : s)
+                c = "ACGT"[letter(gen)];
+            truth.push_back(s);
+        }
+
+        std::vector<uint64_t>    positions;
+        std::vector<std::string> strs;
+        for (size_t i = 0; i < 3000; ++i)
+        {
+            positions.push_back(position(gen));
+            std::string s = truth[(positions.back() + letter(gen)) % truth.size()];
+            for (char & c : s)
+                if (letter(gen) == 0 && letter(gen) == 0)
+                    c = letter(gen) == 0 && letter(gen) == 0 ? 'N' : "ACGT"[letter(gen)];
+            strs.push_back(s);
+        }
+        auto const u = umis({strs.begin(), strs.end()});
+
+        auto const expected = naive_group(positions, u);
+        for (size_t threads : {1, 2, 3, 8})
+        {
+            umi_grouper g{{.threads = threads}};
+            EXPECT_EQ(g.group(positions, u), expected) << "length " << length << " threads " << threads;
+        }
+    }
+}
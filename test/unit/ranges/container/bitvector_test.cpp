@@ -0,0 +1,213 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include <bio/ranges/container/bitvector.hpp>
+#include <bio/ranges/container/concept.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+// a reference implementation on std::vector<bool>
+static std::vector<bool> random_bits(size_t const n, unsigned const seed)
+{
+    std::mt19937_64          gen{seed};
+    std::bernoulli_distribution dist{0.3};
+    std::vector<bool>        ret(n);
+    for (size_t i = 0; i < n; ++i)
+        ret[i] = dist(gen);
+    return ret;
+}
+
+TEST(bitvector, standard_construction)
+{
+    EXPECT_TRUE((std::is_default_constructible_v<bio::ranges::bitvector>));
+    EXPECT_TRUE((std::is_copy_constructible_v<bio::ranges::bitvector>));
+    EXPECT_TRUE((std::is_nothrow_move_constructible_v<bio::ranges::bitvector>));
+    EXPECT_TRUE((std::is_copy_assignable_v<bio::ranges::bitvector>));
+    EXPECT_TRUE((std::is_nothrow_move_assignable_v<bio::ranges::bitvector>));
+    EXPECT_THROW(bio::ranges::bitvector{"10101011x0101"}, std::invalid_argument);
+}
+
+TEST(bitvector, concepts)
+{
+    EXPECT_TRUE((bio::ranges::detail::reservible_container<bio::ranges::bitvector>));
+    EXPECT_TRUE((std::ranges::random_access_range<bio::ranges::bitvector>));
+}
+
+TEST(bitvector, construction)
+{
+    bio::ranges::bitvector t1{"1011"};
+    bio::ranges::bitvector t2;
+    t2 = {true, true, false, true};
+    bio::ranges::bitvector t3{std::vector<bool>{true, true, false, true}};
+    bio::ranges::bitvector t4{t2.begin(), t2.end()};
+    EXPECT_EQ(t1, t2);
+    EXPECT_EQ(t1, t3);
+    EXPECT_EQ(t1, t4);
+
+    bio::ranges::bitvector t5(1000, true);
+    EXPECT_EQ(t5.size(), 1000u);
+    EXPECT_EQ(t5.count(), 1000u);
+    EXPECT_EQ(t5.raw_data().size(), 16u);
+    EXPECT_EQ(t5.raw_data().back(), (1ULL << (1000 % 64)) - 1);
+}
+
+TEST(bitvector, access)
+{
+    bio::ranges::bitvector t1(130, false);
+    t1[0]   = true;
+    t1[64]  = true;
+    t1[129] = true;
+
+    EXPECT_TRUE(t1[0]);
+    EXPECT_FALSE(t1[1]);
+    EXPECT_TRUE(t1.test(64));
+    EXPECT_TRUE(t1.back());
+    EXPECT_TRUE(t1.front());
+    EXPECT_THROW(t1.at(130), std::out_of_range);
+    EXPECT_THROW(t1.test(130), std::out_of_range);
+
+    t1.flip(64);
+    EXPECT_FALSE(t1[64]);
+    t1.set(65);
+    EXPECT_TRUE(t1[65]);
+    t1.reset(65);
+    EXPECT_FALSE(t1[65]);
+    t1[3] ^= true;
+    EXPECT_TRUE(t1[3]);
+    t1[3] &= false;
+    EXPECT_FALSE(t1[3]);
+    t1[3] |= true;
+    EXPECT_TRUE(t1[3]);
+}
+
+TEST(bitvector, count_all_any_none)
+{
+    for (size_t n : {0ul, 1ul, 63ul, 64ul, 65ul, 255ul, 256ul, 1001ul})
+    {
+        std::vector<bool> ref = random_bits(n, n);
+        bio::ranges::bitvector t1{ref};
+
+        EXPECT_EQ(t1.count(), static_cast<size_t>(std::ranges::count(ref, true)));
+        EXPECT_EQ(t1.any(), std::ranges::any_of(ref, std::identity{}));
+        EXPECT_EQ(t1.none(), std::ranges::none_of(ref, std::identity{}));
+        EXPECT_EQ(t1.all(), std::ranges::all_of(ref, std::identity{}));
+
+        t1.set();
+        EXPECT_EQ(t1.count(), n);
+        EXPECT_TRUE(t1.all());
+        t1.reset();
+        EXPECT_EQ(t1.count(), 0u);
+        EXPECT_TRUE(t1.none());
+    }
+}
+
+TEST(bitvector, bitwise)
+{
+    for (size_t n : {1ul, 63ul, 64ul, 65ul, 300ul, 1001ul})
+    {
+        std::vector<bool> r1 = random_bits(n, 1);
+        std::vector<bool> r2 = random_bits(n, 2);
+        std::vector<bool> r_and(n), r_or(n), r_xor(n), r_not(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            r_and[i] = r1[i] && r2[i];
+            r_or[i]  = r1[i] || r2[i];
+            r_xor[i] = r1[i] != r2[i];
+            r_not[i] = !r1[i];
+        }
+
+        bio::ranges::bitvector t1{r1};
+        bio::ranges::bitvector t2{r2};
+        EXPECT_RANGE_EQ(t1 & t2, r_and);
+        EXPECT_RANGE_EQ(t1 | t2, r_or);
+        EXPECT_RANGE_EQ(t1 ^ t2, r_xor);
+        EXPECT_RANGE_EQ(~t1, r_not);
+        EXPECT_EQ((~t1).count(), n - t1.count()); // no garbage in the last word
+    }
+}
+
+TEST(bitvector, shift)
+{
+    for (size_t n : {1ul, 64ul, 100ul, 1001ul})
+    {
+        std::vector<bool> ref = random_bits(n, 3);
+        bio::ranges::bitvector t1{ref};
+
+        for (size_t count : {0ul, 1ul, 7ul, 63ul, 64ul, 65ul, 128ul, 500ul, 2000ul})
+        {
+            std::vector<bool> left(n), right(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (i >= count)
+                    left[i] = ref[i - count];
+                if (i + count < n)
+                    right[i] = ref[i + count];
+            }
+
+            EXPECT_RANGE_EQ(t1 << count, left);
+            EXPECT_RANGE_EQ(t1 >> count, right);
+            EXPECT_EQ((t1 << count).count(), static_cast<size_t>(std::ranges::count(left, true)));
+        }
+    }
+}
+
+TEST(bitvector, find)
+{
+    bio::ranges::bitvector t1(1000, false);
+    EXPECT_EQ(t1.find_first(), bio::ranges::bitvector::npos);
+
+    std::vector<size_t> positions{0, 5, 63, 64, 200, 999};
+    for (size_t p : positions)
+        t1[p] = true;
+
+    std::vector<size_t> found;
+    for (size_t i = t1.find_first(); i != bio::ranges::bitvector::npos; i = t1.find_next(i))
+        found.push_back(i);
+    EXPECT_EQ(found, positions);
+
+    t1[0] = false;
+    EXPECT_EQ(t1.find_first(), 5u);
+    EXPECT_EQ(t1.find_next(999), bio::ranges::bitvector::npos);
+}
+
+TEST(bitvector, modifiers)
+{
+    bio::ranges::bitvector t1;
+    for (size_t i = 0; i < 200; ++i)
+        t1.push_back(i % 3 == 0);
+    EXPECT_EQ(t1.size(), 200u);
+    EXPECT_EQ(t1.count(), 67u);
+
+    t1.pop_back();
+    t1.pop_back();
+    EXPECT_EQ(t1.size(), 198u);
+    EXPECT_EQ(t1.count(), 66u);
+
+    t1.resize(300, true);
+    EXPECT_EQ(t1.count(), 66u + 102u);
+    t1.resize(10);
+    EXPECT_EQ(t1, (bio::ranges::bitvector{"1001001001"}));
+
+    t1.insert(t1.cbegin() + 1, 2, true);
+    EXPECT_EQ(t1, (bio::ranges::bitvector{"100100100111"}));
+    t1.erase(t1.cbegin() + 1, t1.cbegin() + 3);
+    EXPECT_EQ(t1, (bio::ranges::bitvector{"1001001001"}));
+    t1.erase(t1.cbegin());
+    EXPECT_EQ(t1, (bio::ranges::bitvector{"100100100"}));
+
+    bio::ranges::bitvector t2;
+    swap(t1, t2);
+    EXPECT_TRUE(t1.empty());
+    EXPECT_EQ(t2.size(), 9u);
+
+    t2.clear();
+    EXPECT_TRUE(t2.empty());
+    t2.reserve(1000);
+    EXPECT_GE(t2.capacity(), 1000u);
+}
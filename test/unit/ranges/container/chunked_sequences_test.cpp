@@ -0,0 +1,182 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/chunked_sequences.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+using namespace bio::alphabet::literals;
+using namespace std::string_view_literals;
+
+// std::vector<char> has no small buffer, so the capacity of the chunks is exactly the chunk size
+using chunked_t = bio::ranges::chunked_sequences<std::vector<char>>;
+
+static std::vector<std::string> to_strings(chunked_t const & t)
+{
+    std::vector<std::string> ret;
+    for (auto && seq : t)
+        ret.emplace_back(seq.begin(), seq.end());
+    return ret;
+}
+
+TEST(chunked_sequences, concepts)
+{
+    using t = bio::ranges::chunked_sequences<std::string>;
+
+    EXPECT_TRUE(std::ranges::random_access_range<t>);
+    EXPECT_TRUE(std::ranges::sized_range<t>);
+    EXPECT_TRUE((std::same_as<std::ranges::range_reference_t<t>, std::span<char>>));
+    EXPECT_TRUE((std::same_as<std::ranges::range_reference_t<t const>, std::string_view>));
+}
+
+TEST(chunked_sequences, construction)
+{
+    std::vector<std::string> const vec{"ACGT", "", "GAGGA"};
+    chunked_t                      t1{vec};
+    chunked_t                      t2{vec, 4};
+    chunked_t                      t3{"ACGT"sv, ""sv, "GAGGA"sv};
+
+    EXPECT_EQ(t1.size(), 3u);
+    EXPECT_EQ(t1.concat_size(), 9u);
+    EXPECT_EQ(t1.chunk_count(), 1u);
+    EXPECT_EQ(t2.chunk_count(), 2u);
+    EXPECT_EQ(t2.chunk_size(), 4u);
+
+    // equality does not depend on chunking
+    EXPECT_EQ(t1, t2);
+    EXPECT_EQ(t1, t3);
+    EXPECT_EQ(to_strings(t2), vec);
+
+    EXPECT_TRUE(chunked_t{}.empty());
+}
+
+TEST(chunked_sequences, element_access)
+{
+    chunked_t t{std::vector<std::string>{"ACGT", "", "GAGGA", "T"}, 6};
+
+    EXPECT_RANGE_EQ(t[0], "ACGT"sv);
+    EXPECT_TRUE(t.at(1).empty());
+    EXPECT_RANGE_EQ(t.at(2), "GAGGA"sv);
+    EXPECT_RANGE_EQ(t.front(), "ACGT"sv);
+    EXPECT_RANGE_EQ(t.back(), "T"sv);
+    EXPECT_THROW(t.at(4), std::out_of_range);
+
+    t[2][0] = 'C';
+    EXPECT_EQ(std::as_const(t)[2], "CAGGA"sv);
+}
+
+TEST(chunked_sequences, no_relocation)
+{
+    chunked_t                    t{16};
+    std::vector<std::string>     ref;
+    std::vector<std::span<char>> views;
+
+    for (size_t i = 0; i < 200; ++i)
+    {
+        ref.emplace_back(i % 23, 'A' + i % 26); // includes empty sequences and ones longer than the chunk size
+        t.push_back(ref.back());
+        views.push_back(t.back());
+    }
+
+    EXPECT_EQ(to_strings(t), ref);
+    EXPECT_GT(t.chunk_count(), 50u);
+    EXPECT_GE(t.concat_capacity(), t.concat_size());
+
+    // the views obtained directly after insertion still point to the same memory
+    for (size_t i = 0; i < ref.size(); ++i)
+    {
+        EXPECT_EQ(views[i].data(), t[i].data());
+        EXPECT_RANGE_EQ(views[i], ref[i]);
+    }
+}
+
+TEST(chunked_sequences, push_back_inner)
+{
+    chunked_t t{8};
+
+    t.push_back("ACGT"sv);
+    t.push_back("GA"sv);
+    t.push_back_inner('G');
+    t.append_inner("G"sv);
+    EXPECT_EQ(t.chunk_count(), 1u);
+    EXPECT_RANGE_EQ(t[1], "GAGG"sv);
+
+    // moves the last sequence to a new chunk
+    t.append_inner("CCCC"sv);
+    EXPECT_EQ(t.chunk_count(), 2u);
+    EXPECT_RANGE_EQ(t[0], "ACGT"sv);
+    EXPECT_RANGE_EQ(t[1], "GAGGCCCC"sv);
+
+    // chunk with a single sequence grows
+    for (size_t i = 0; i < 100; ++i)
+        t.push_back_inner('T');
+    EXPECT_EQ(t.chunk_count(), 2u);
+    EXPECT_EQ(t[1].size(), 108u);
+
+    t.push_back();
+    t.push_back_inner('A');
+    EXPECT_RANGE_EQ(t.back(), "A"sv);
+    EXPECT_EQ(t.size(), 3u);
+    EXPECT_EQ(t.concat_size(), 113u);
+}
+
+TEST(chunked_sequences, pop_back_clear)
+{
+    chunked_t t{std::vector<std::string>{"ACGT", "GAGGA", "TT"}, 5};
+    EXPECT_EQ(t.chunk_count(), 3u);
+
+    t.pop_back();
+    EXPECT_EQ(t.chunk_count(), 2u);
+    t.push_back_inner('C');
+    EXPECT_RANGE_EQ(t.back(), "GAGGAC"sv);
+    EXPECT_RANGE_EQ(t.front(), "ACGT"sv);
+
+    t.pop_back();
+    t.pop_back();
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(t.concat_size(), 0u);
+
+    t.push_back("AC"sv);
+    t.clear();
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(t.chunk_count(), 1u);
+    t.push_back("AC"sv);
+    EXPECT_RANGE_EQ(t.front(), "AC"sv);
+}
+
+TEST(chunked_sequences, small_buffer)
+{
+    // the chunks of std::string are in the small buffer, so they must not be moved
+    bio::ranges::chunked_sequences<std::string> t{4};
+    t.push_back("ACGT"sv);
+    std::string_view first = std::as_const(t)[0];
+    for (size_t i = 0; i < 100; ++i)
+        t.push_back("ACGTACGTACGTACGTACGT"sv);
+    EXPECT_EQ(first.data(), std::as_const(t)[0].data());
+    EXPECT_EQ(first, "ACGT"sv);
+}
+
+TEST(chunked_sequences, bitcompressed)
+{
+    bio::ranges::chunked_sequences<bio::ranges::bitcompressed_vector<bio::alphabet::dna4>> t{64};
+
+    for (size_t i = 0; i < 100; ++i)
+        t.push_back("ACGTACGTAC"_dna4);
+
+    EXPECT_EQ(t.size(), 100u);
+    EXPECT_GT(t.chunk_count(), 1u);
+    for (auto && seq : t)
+        EXPECT_RANGE_EQ(seq, "ACGTACGTAC"_dna4);
+}
@@ -413,6 +413,75 @@ TYPED_TEST(concatenated_sequences, append_inner)
     EXPECT_EQ(t0, (TypeParam{"ACGT"_dna4, "CGT"_dna4, "CGT"_dna4}));
 }
 
+TYPED_TEST(concatenated_sequences, reserve_both)
+{
+    TypeParam t0{};
+    t0.reserve(10, 100);
+    EXPECT_GE(t0.capacity(), 10u);
+    EXPECT_GE(t0.concat_capacity(), 100u);
+
+    auto const cap        = t0.capacity();
+    auto const concat_cap = t0.concat_capacity();
+    for (size_t i = 0; i < 10; ++i)
+        t0.push_back("ACGTACGTAC"_dna4);
+
+    // no reallocations happened
+    EXPECT_EQ(t0.capacity(), cap);
+    EXPECT_EQ(t0.concat_capacity(), concat_cap);
+    EXPECT_EQ(t0.concat_size(), 100u);
+}
+
+TEST(concatenated_sequences_, growth_policy)
+{
+    // std::vector allocates exactly what is reserved (bitcompressed_vector rounds up)
+    using TypeParam = bio::ranges::concatenated_sequences<std::vector<bio::alphabet::dna4>>;
+    TypeParam t0{};
+    EXPECT_EQ(t0.get_growth_policy(), bio::ranges::growth_policy{});
+
+    t0.set_growth_policy({.factor = 1.5, .max_step = 1000});
+    EXPECT_EQ(t0.get_growth_policy().factor, 1.5);
+
+    t0.concat_reserve(1000);
+    t0.push_back(std::vector<bio::alphabet::dna4>(1000, 'A'_dna4));
+    EXPECT_EQ(t0.concat_capacity(), 1000u);
+
+    t0.push_back_inner('C'_dna4); // 1.5 * 1000
+    EXPECT_EQ(t0.concat_capacity(), 1500u);
+
+    t0.append_inner(std::vector<bio::alphabet::dna4>(1000, 'A'_dna4)); // 1.5 * 1500
+    EXPECT_EQ(t0.concat_capacity(), 2250u);
+
+    t0.push_back(std::vector<bio::alphabet::dna4>(1000, 'A'_dna4)); // 2250 + max_step
+    EXPECT_EQ(t0.concat_capacity(), 3250u);
+
+    t0.push_back(std::vector<bio::alphabet::dna4>(5000, 'A'_dna4)); // as much as required
+    EXPECT_EQ(t0.concat_capacity(), 8001u);
+
+    // policy is retained by assign, but exchanged by swap
+    t0.assign(std::vector<std::vector<bio::alphabet::dna4>>{"ACGT"_dna4});
+    EXPECT_EQ(t0.get_growth_policy().max_step, 1000u);
+    TypeParam t1{};
+    t1.swap(t0);
+    EXPECT_EQ(t1.get_growth_policy().max_step, 1000u);
+    EXPECT_EQ(t0.get_growth_policy().max_step, 0u);
+}
+
+TEST(growth_policy, compute)
+{
+    bio::ranges::growth_policy p{};
+    EXPECT_EQ(p(0, 1), 1u);
+    EXPECT_EQ(p(10, 11), 20u);
+    EXPECT_EQ(p(10, 100), 100u);
+
+    p = {.factor = 1.5, .max_step = 100};
+    EXPECT_EQ(p(10, 11), 15u);
+    EXPECT_EQ(p(1000, 1001), 1100u);
+    EXPECT_EQ(p(1000, 2000), 2000u);
+
+    p = {.factor = 0.5};
+    EXPECT_EQ(p(10, 11), 11u);
+}
+
 TEST(concatenated_sequences_, associated_types)
 {
     {
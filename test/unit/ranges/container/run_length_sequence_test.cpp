@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/run_length_sequence.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+using namespace bio::alphabet::literals;
+
+TEST(run_length_sequence, construction)
+{
+    bio::ranges::run_length_sequence const rls{"AAACGGTTTTA"_dna4};
+    EXPECT_TRUE((std::same_as<decltype(rls), bio::ranges::run_length_sequence<bio::alphabet::dna4> const>));
+
+    EXPECT_EQ(rls.size(), 11u);
+    EXPECT_FALSE(rls.empty());
+    EXPECT_EQ(rls.run_count(), 5u);
+    EXPECT_RANGE_EQ(rls.letters(), "ACGTA"_dna4);
+    EXPECT_RANGE_EQ(rls.ends(), (std::vector<size_t>{3, 4, 6, 10, 11}));
+
+    // same result from other ranges
+    std::list<bio::alphabet::dna4> const                         list{rls.letters().begin(), rls.letters().end()};
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> const packed{"AAACGGTTTTA"_dna4};
+    EXPECT_EQ(bio::ranges::run_length_sequence{packed}, rls);
+    EXPECT_NE(bio::ranges::run_length_sequence{list}, rls);
+    EXPECT_EQ(bio::ranges::run_length_sequence{list}.size(), 5u);
+
+    // non-alphabets
+    bio::ranges::run_length_sequence const chars{std::string{"xxyzz"}};
+    EXPECT_RANGE_EQ(chars.letters(), std::string{"xyz"});
+
+    bio::ranges::run_length_sequence<bio::alphabet::dna4> const empty{};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_EQ(empty, bio::ranges::run_length_sequence{bio::alphabet::dna4_vector{}});
+}
+
+TEST(run_length_sequence, position_mapping)
+{
+    bio::alphabet::dna4_vector const                      seq = "AAACGGTTTTA"_dna4;
+    bio::ranges::run_length_sequence<bio::alphabet::dna4> rls{seq};
+
+    std::vector<size_t> const runs{0, 0, 0, 1, 2, 2, 3, 3, 3, 3, 4};
+    for (size_t i = 0; i < seq.size(); ++i)
+    {
+        EXPECT_EQ(rls[i], seq[i]);
+        EXPECT_EQ(rls.run_of(i), runs[i]);
+        EXPECT_LE(rls.run_begin(rls.run_of(i)), i);
+        EXPECT_GT(rls.run_end(rls.run_of(i)), i);
+    }
+
+    EXPECT_EQ(rls.run_begin(3), 6u);
+    EXPECT_EQ(rls.run_end(3), 10u);
+    EXPECT_EQ(rls.run_length(3), 4u);
+    EXPECT_EQ(rls.run_letter(3), 'T'_dna4);
+}
+
+TEST(run_length_sequence, push_back)
+{
+    bio::ranges::run_length_sequence<bio::alphabet::dna4> rls{};
+    rls.push_back('A'_dna4, 3);
+    rls.push_back('C'_dna4);
+    rls.push_back('G'_dna4, 0);
+    rls.push_back('G'_dna4, 2);
+    rls.push_back('G'_dna4);
+    EXPECT_EQ(rls, bio::ranges::run_length_sequence{"AAACGGG"_dna4});
+
+    rls.clear();
+    EXPECT_TRUE(rls.empty());
+}
+
+TEST(run_length_sequence, long_sequence)
+{
+    std::mt19937_64            gen{42};
+    bio::alphabet::dna4_vector seq;
+    uint8_t                    rank = 0;
+    for (size_t i = 0; i < 100'000; ++i)
+    {
+        if (gen() % 4 == 0)
+            rank = gen() % 4;
+        seq.push_back(bio::alphabet::assign_rank_to(rank, bio::alphabet::dna4{}));
+    }
+
+    bio::ranges::run_length_sequence<bio::alphabet::dna4> const rls{seq};
+    bio::ranges::run_length_sequence<bio::alphabet::dna4>       expected{};
+    for (bio::alphabet::dna4 const l : seq)
+        expected.push_back(l);
+
+    EXPECT_EQ(rls, expected);
+    for (size_t i = 0; i < seq.size(); i += 97)
+        EXPECT_EQ(rls[i], seq[i]);
+}
@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <list>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/ranges/find_any_of.hpp>
+
+TEST(char_set, construction)
+{
+    constexpr bio::ranges::char_set s0{};
+    EXPECT_TRUE(s0.empty());
+    EXPECT_EQ(s0.size(), 0u);
+
+    constexpr bio::ranges::char_set s1{'\n'};
+    EXPECT_EQ(s1.size(), 1u);
+    EXPECT_EQ(s1.chars(), "\n");
+
+    constexpr bio::ranges::char_set s2{"\r\n\r"};
+    EXPECT_EQ(s2.size(), 2u);
+    EXPECT_EQ(s2.chars(), "\r\n");
+
+    constexpr bio::ranges::char_set s3{std::string_view{"\n\r"}};
+    EXPECT_EQ(s2, s3);
+    EXPECT_NE(s1, s3);
+
+    // more characters than are stored for vectorisation
+    bio::ranges::char_set s4{"ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+    EXPECT_EQ(s4.size(), 26u);
+    EXPECT_EQ(s4.chars(), "ABCDEFGHIJKLMNOP");
+    EXPECT_TRUE(s4('Z'));
+}
+
+TEST(char_set, membership)
+{
+    constexpr bio::ranges::char_set s{"\t\n\xff"};
+    static_assert(s('\t'));
+    static_assert(!s(' '));
+
+    for (int c = -128; c < 128; ++c)
+        EXPECT_EQ(s(static_cast<char>(c)), c == '\t' || c == '\n' || c == -1) << c;
+}
+
+TEST(find_any_of, basic)
+{
+    std::string_view const s{"@read1 desc\nACGT\r\n+\nIIII\n"};
+
+    EXPECT_EQ(bio::ranges::find_any_of(s, '\n') - s.begin(), 11);
+    EXPECT_EQ(bio::ranges::find_any_of(s, "\r\n") - s.begin(), 11);
+    EXPECT_EQ(bio::ranges::find_any_of(s, " \t") - s.begin(), 6);
+    EXPECT_EQ(bio::ranges::find_any_of(s, "xyz"), s.end());
+    EXPECT_EQ(bio::ranges::find_any_of(s, bio::ranges::char_set{}), s.end());
+    EXPECT_EQ(bio::ranges::find_any_of(s.substr(12), "\r\n") - s.begin(), 16);
+    EXPECT_EQ(bio::ranges::find_any_of(std::string_view{}, "\r\n"), std::string_view{}.end());
+
+    // constexpr
+    static_assert(*bio::ranges::find_any_of(std::string_view{"foo;bar"}, ";,") == ';');
+}
+
+TEST(find_any_of, range_types)
+{
+    std::string       str{"ACGT;ACGT"};
+    std::vector<char> vec{str.begin(), str.end()};
+    std::list<char>   lst{str.begin(), str.end()};
+
+    EXPECT_EQ(*bio::ranges::find_any_of(str, ";,"), ';');
+    EXPECT_EQ(bio::ranges::find_any_of(str, ";,") - str.begin(), 4);
+    EXPECT_EQ(bio::ranges::find_any_of(vec, ";,") - vec.begin(), 4);
+    EXPECT_EQ(bio::ranges::find_any_of(std::span{vec}, ";,") - std::span{vec}.begin(), 4);
+    EXPECT_EQ(std::ranges::distance(lst.begin(), bio::ranges::find_any_of(lst, ";,")), 4);
+
+    EXPECT_TRUE((std::same_as<decltype(bio::ranges::find_any_of(std::string{}, ';')), std::ranges::dangling>));
+}
+
+// compare against std::ranges::find_if for all set sizes and match positions around the vector block boundaries
+TEST(find_any_of, against_find_if)
+{
+    std::mt19937                    gen{42};
+    std::uniform_int_distribution<> dis{'a', 'z'};
+
+    std::string const all_delims{"0123456789!#$%&()*+,-./"};
+
+    for (size_t n_delims : {1, 2, 3, 8, 16, 17, 23})
+    {
+        bio::ranges::char_set const set{std::string_view{all_delims}.substr(0, n_delims)};
+
+        for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200})
+        {
+            std::string s(len, ' ');
+            for (char & c : s)
+                c = dis(gen);
+
+            // no match
+            EXPECT_EQ(bio::ranges::find_any_of(s, set), s.end());
+
+            // single match at every position
+            for (size_t pos = 0; pos < len; ++pos)
+            {
+                std::string t = s;
+                t[pos]        = all_delims[pos % n_delims];
+                EXPECT_EQ(bio::ranges::find_any_of(t, set) - t.begin(), std::ranges::find_if(t, set) - t.begin());
+                EXPECT_EQ(bio::ranges::find_any_of(t, set) - t.begin(), static_cast<ptrdiff_t>(pos));
+
+                // second match later on does not change the result
+                t.back() = all_delims[0];
+                EXPECT_EQ(bio::ranges::find_any_of(t, set) - t.begin(), static_cast<ptrdiff_t>(pos));
+            }
+        }
+    }
+}
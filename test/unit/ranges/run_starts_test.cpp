@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/aminoacid/aa27.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/run_starts.hpp>
+#include <bio/ranges/views/single_pass_input.hpp>
+
+using namespace bio::alphabet::literals;
+
+//!\brief The run starts computed one by one.
+template <typename rng_t>
+std::vector<size_t> naive_run_starts(rng_t const & rng)
+{
+    std::vector<size_t> ret;
+    for (size_t i = 0; i < rng.size(); ++i)
+        if (i == 0 || !(rng[i] == rng[i - 1]))
+            ret.push_back(i);
+    return ret;
+}
+
+//!\brief Random sequence with runs of up to 2 * `mean_run` letters.
+template <typename alph_t>
+std::vector<alph_t> random_runs(size_t const size, size_t const mean_run, unsigned const seed)
+{
+    std::mt19937_64                       gen{seed};
+    std::uniform_int_distribution<size_t> len{1, 2 * mean_run};
+    std::vector<alph_t>                   ret;
+    while (ret.size() < size)
+    {
+        alph_t const l = bio::alphabet::assign_rank_to(gen() % bio::alphabet::size<alph_t>, alph_t{});
+        for (size_t i = len(gen); i > 0 && ret.size() < size; --i)
+            ret.push_back(l);
+    }
+    return ret;
+}
+
+TEST(run_starts, small)
+{
+    EXPECT_EQ(bio::ranges::run_starts("AAACGGT"_dna4), (std::vector<size_t>{0, 3, 4, 6}));
+    EXPECT_EQ(bio::ranges::run_starts("A"_dna4), (std::vector<size_t>{0}));
+    EXPECT_TRUE(bio::ranges::run_starts(bio::alphabet::dna4_vector{}).empty());
+
+    // non-alphabets and non-random-access ranges
+    EXPECT_EQ(bio::ranges::run_starts(std::string{"xxyzz"}), (std::vector<size_t>{0, 2, 3}));
+    EXPECT_EQ(bio::ranges::run_starts(std::vector<int>{1000, 1000, -1}), (std::vector<size_t>{0, 2}));
+    std::list<bio::alphabet::dna4> l{'A'_dna4, 'A'_dna4, 'T'_dna4};
+    EXPECT_EQ(bio::ranges::run_starts(l), (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(bio::ranges::run_starts(l | bio::views::single_pass_input), (std::vector<size_t>{0, 2}));
+}
+
+TEST(run_starts, long_sequences)
+{
+    // longer than one block of ranks; short and long runs
+    for (size_t const mean_run : {1u, 3u, 50u})
+    {
+        auto const dna4 = random_runs<bio::alphabet::dna4>(40'000, mean_run, mean_run);
+        EXPECT_EQ(bio::ranges::run_starts(dna4), naive_run_starts(dna4));
+
+        std::list<bio::alphabet::dna4> const dna4_list(dna4.begin(), dna4.end());
+        EXPECT_EQ(bio::ranges::run_starts(dna4_list), naive_run_starts(dna4));
+
+        auto const aa27 = random_runs<bio::alphabet::aa27>(40'000, mean_run, mean_run + 1);
+        EXPECT_EQ(bio::ranges::run_starts(aa27), naive_run_starts(aa27));
+    }
+
+    // a single run across blocks
+    std::vector<bio::alphabet::dna4> const same(50'000, 'G'_dna4);
+    EXPECT_EQ(bio::ranges::run_starts(same), (std::vector<size_t>{0}));
+}
+
+TEST(run_starts, bitcompressed_vector)
+{
+    for (size_t const size : {0u, 1u, 20u, 21u, 22u, 63u, 64u, 65u, 1000u})
+    {
+        for (size_t const mean_run : {1u, 4u})
+        {
+            auto const dna4 = random_runs<bio::alphabet::dna4>(size, mean_run, 7);
+            auto const dna5 = random_runs<bio::alphabet::dna5>(size, mean_run, 8);
+
+            bio::ranges::bitcompressed_vector<bio::alphabet::dna4> const packed4(dna4.begin(), dna4.end());
+            EXPECT_EQ(bio::ranges::run_starts(packed4), naive_run_starts(dna4)) << size;
+
+            bio::ranges::bitcompressed_vector<bio::alphabet::dna5> const packed5(dna5.begin(), dna5.end());
+            EXPECT_EQ(bio::ranges::run_starts(packed5), naive_run_starts(dna5)) << size;
+        }
+    }
+
+    // stale bits after pop_back are ignored
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> v{"AACT"_dna4};
+    v.pop_back();
+    EXPECT_EQ(bio::ranges::run_starts(v), (std::vector<size_t>{0, 2}));
+}
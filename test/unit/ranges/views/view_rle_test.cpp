@@ -0,0 +1,75 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <forward_list>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/ranges/concept.hpp>
+#include <bio/ranges/views/complement.hpp>
+#include <bio/ranges/views/rle.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+using namespace bio::alphabet::literals;
+
+TEST(view_rle, basic)
+{
+    bio::alphabet::dna4_vector const vec = "AAACGGTTTTA"_dna4;
+
+    using pair_t = std::pair<bio::alphabet::dna4, size_t>;
+    std::vector<pair_t> const expected{{'A'_dna4, 3}, {'C'_dna4, 1}, {'G'_dna4, 2}, {'T'_dna4, 4}, {'A'_dna4, 1}};
+
+    // pipe notation
+    auto v = vec | bio::views::rle;
+    EXPECT_RANGE_EQ(v, expected);
+
+    // function notation
+    EXPECT_RANGE_EQ(bio::views::rle(vec), expected);
+
+    // combinability
+    auto lengths = std::views::transform([](pair_t const p) { return p.second; });
+    EXPECT_RANGE_EQ(vec | bio::views::complement | bio::views::rle | lengths, (std::vector<size_t>{3, 1, 2, 4, 1}));
+
+    // iterators
+    auto it = v.begin();
+    EXPECT_EQ(it.base() - vec.begin(), 0);
+    ++it;
+    EXPECT_EQ(it.base() - vec.begin(), 3);
+    EXPECT_EQ(std::ranges::distance(v), 5);
+
+    // empty and single runs
+    EXPECT_TRUE(std::ranges::empty(bio::alphabet::dna4_vector{} | bio::views::rle));
+    EXPECT_RANGE_EQ(std::string{"xxxx"} | bio::views::rle, (std::vector<std::pair<char, size_t>>{{'x', 4}}));
+}
+
+TEST(view_rle, concepts)
+{
+    std::forward_list<int> list{1, 1, 2};
+    auto                   v = list | bio::views::rle;
+    EXPECT_RANGE_EQ(v, (std::vector<std::pair<int, size_t>>{{1, 2}, {2, 1}}));
+
+    EXPECT_TRUE(std::ranges::forward_range<decltype(v)>);
+    EXPECT_FALSE(std::ranges::bidirectional_range<decltype(v)>);
+    EXPECT_FALSE(std::ranges::sized_range<decltype(v)>);
+    EXPECT_TRUE(std::ranges::view<decltype(v)>);
+    EXPECT_TRUE(bio::ranges::const_iterable_range<decltype(v)>);
+}
+
+TEST(view_homopolymer_compress, basic)
+{
+    bio::alphabet::dna4_vector const vec = "AAACGGTTTTA"_dna4;
+
+    EXPECT_RANGE_EQ(vec | bio::views::homopolymer_compress, "ACGTA"_dna4);
+    EXPECT_RANGE_EQ(bio::views::homopolymer_compress(vec), "ACGTA"_dna4);
+    EXPECT_RANGE_EQ(vec | bio::views::homopolymer_compress | std::views::take(2), "AC"_dna4);
+    EXPECT_RANGE_EQ(std::string{"abba"} | bio::views::homopolymer_compress, std::string{"aba"});
+    EXPECT_TRUE(std::ranges::empty(std::string{} | bio::views::homopolymer_compress));
+}
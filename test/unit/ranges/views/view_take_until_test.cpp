@@ -0,0 +1,207 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <concepts>
+#include <list>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/ranges/concept.hpp>
+#include <bio/ranges/to.hpp>
+#include <bio/ranges/views/single_pass_input.hpp>
+#include <bio/ranges/views/take_until.hpp>
+#include <bio/test/expect_range_eq.hpp>
+
+// ============================================================================
+//  test templates
+// ============================================================================
+
+template <typename adaptor_t>
+void do_test(adaptor_t const & adaptor, auto && rng)
+{
+    auto is_semicolon = [](char const c) { return c == ';'; };
+
+    // pipe notation
+    auto v = rng | adaptor(is_semicolon);
+    EXPECT_RANGE_EQ(v, std::string_view{"foo"});
+
+    // iterators (code coverage)
+    EXPECT_NE(v.begin(), v.end());
+
+    // function notation
+    EXPECT_RANGE_EQ(adaptor(rng, is_semicolon), std::string_view{"foo"});
+
+    // char and char_set
+    EXPECT_RANGE_EQ(rng | adaptor(';'), std::string_view{"foo"});
+    EXPECT_RANGE_EQ(rng | adaptor("b;"), std::string_view{"foo"});
+    EXPECT_RANGE_EQ(rng | adaptor(bio::ranges::char_set{"ab"}), std::string_view{"foo;"});
+
+    // combinability
+    auto v2 = rng | adaptor(';') | adaptor('o');
+    EXPECT_RANGE_EQ(v2, std::string_view{"f"});
+    auto v3 = rng | adaptor(';') | std::views::reverse;
+    EXPECT_RANGE_EQ(v3, std::string_view{"oof"});
+}
+
+// ============================================================================
+//  view_take_until
+// ============================================================================
+
+TEST(view_take_until, unix_eol)
+{
+    std::string const str{"foo;bar"};
+    do_test(bio::views::take_until, str);
+    do_test(bio::views::take_until_or_throw, str);
+    do_test(bio::views::take_until, std::string_view{str});
+    do_test(bio::views::take_until, std::vector<char>{str.begin(), str.end()});
+    do_test(bio::views::take_until, std::list<char>{str.begin(), str.end()});
+}
+
+TEST(view_take_until, type_erasure)
+{
+    std::string       str{"foo;bar"};
+    std::string const cstr{str};
+    std::vector<char> vec{str.begin(), str.end()};
+    std::list<char>   lst{str.begin(), str.end()};
+
+    auto is_semicolon = [](char const c) { return c == ';'; };
+
+    // delimiter given as char/char_set on contiguous input → eager
+    EXPECT_TRUE((std::same_as<decltype(std::string_view{str} | bio::views::take_until(';')), std::string_view>));
+    EXPECT_TRUE((std::same_as<decltype(cstr | bio::views::take_until(';')), std::string_view>));
+    EXPECT_TRUE((std::same_as<decltype(str | bio::views::take_until(';')), std::span<char>>));
+    EXPECT_TRUE((std::same_as<decltype(vec | bio::views::take_until("\n;")), std::span<char>>));
+
+    // generic predicate or non-contiguous input → lazy
+    EXPECT_FALSE((std::same_as<decltype(str | bio::views::take_until(is_semicolon)), std::span<char>>));
+    EXPECT_FALSE((std::same_as<decltype(lst | bio::views::take_until(';')), std::span<char>>));
+
+    EXPECT_EQ((str | bio::views::take_until(';')).size(), 3u);
+    EXPECT_EQ((str | bio::views::take_until('x')).size(), 7u);
+}
+
+TEST(view_take_until, concepts)
+{
+    std::string str{"foo;bar"};
+    auto        is_semicolon = [](char const c) { return c == ';'; };
+
+    auto v1 = str | bio::views::take_until(is_semicolon);
+    EXPECT_TRUE(std::ranges::input_range<decltype(v1)>);
+    EXPECT_TRUE(std::ranges::forward_range<decltype(v1)>);
+    EXPECT_TRUE(std::ranges::bidirectional_range<decltype(v1)>);
+    EXPECT_TRUE(std::ranges::random_access_range<decltype(v1)>);
+    EXPECT_TRUE(std::ranges::view<decltype(v1)>);
+    EXPECT_FALSE(std::ranges::sized_range<decltype(v1)>);
+    EXPECT_FALSE(std::ranges::common_range<decltype(v1)>);
+    EXPECT_TRUE(bio::ranges::const_iterable_range<decltype(v1)>);
+    EXPECT_TRUE((std::ranges::output_range<decltype(v1), char>));
+    EXPECT_EQ(*(v1.begin() + 2), 'o');
+    EXPECT_EQ(*(2 + v1.begin()), 'o');
+    EXPECT_EQ((v1.begin() + 3) - v1.begin(), 3);
+    EXPECT_TRUE(v1.begin() + 3 == v1.end());
+    EXPECT_FALSE(v1.begin() + 2 == v1.end());
+
+    auto v2 = str | bio::views::single_pass_input | bio::views::take_until(is_semicolon);
+    EXPECT_TRUE(std::ranges::input_range<decltype(v2)>);
+    EXPECT_FALSE(std::ranges::forward_range<decltype(v2)>);
+    EXPECT_TRUE(std::ranges::view<decltype(v2)>);
+    EXPECT_FALSE(std::ranges::sized_range<decltype(v2)>);
+    EXPECT_FALSE(std::ranges::common_range<decltype(v2)>);
+    EXPECT_FALSE(bio::ranges::const_iterable_range<decltype(v2)>);
+
+    auto v3 = str | bio::views::take_until(';');
+    EXPECT_TRUE(std::ranges::contiguous_range<decltype(v3)>);
+    EXPECT_TRUE(std::ranges::view<decltype(v3)>);
+    EXPECT_TRUE(std::ranges::sized_range<decltype(v3)>);
+    EXPECT_TRUE(std::ranges::common_range<decltype(v3)>);
+}
+
+TEST(view_take_until, single_pass)
+{
+    std::string str{"foo;bar;baz"};
+    auto        in = str | bio::views::single_pass_input;
+
+    // delimiter is not consumed
+    EXPECT_RANGE_EQ(in | bio::views::take_until(';'), std::string_view{"foo"});
+    EXPECT_EQ(*std::ranges::begin(in), ';');
+}
+
+TEST(view_take_until, or_throw)
+{
+    std::string str{"foo;bar"};
+    auto        is_x = [](char const c) { return c == 'x'; };
+
+    EXPECT_NO_THROW(str | bio::views::take_until_or_throw(';'));
+    EXPECT_THROW(str | bio::views::take_until_or_throw('x'), std::runtime_error);
+    EXPECT_THROW(std::string_view{str} | bio::views::take_until_or_throw("xy"), std::runtime_error);
+
+    auto v = str | bio::views::take_until_or_throw(is_x); // lazy, throws on iteration
+    EXPECT_THROW((v | bio::ranges::to<std::string>()), std::runtime_error);
+
+    std::list<char> lst{str.begin(), str.end()};
+    EXPECT_THROW((lst | bio::views::take_until_or_throw('x') | bio::ranges::to<std::string>()), std::runtime_error);
+    EXPECT_RANGE_EQ(lst | bio::views::take_until_or_throw(';'), std::string_view{"foo"});
+}
+
+// ============================================================================
+//  view_take_line
+// ============================================================================
+
+TEST(view_take_line, contiguous)
+{
+    std::string_view const unix_eol{"foo\nbar"};
+    std::string_view const win_eol{"foo\r\nbar"};
+    std::string_view const no_eol{"foo"};
+
+    EXPECT_EQ(unix_eol | bio::views::take_line, "foo");
+    EXPECT_EQ(win_eol | bio::views::take_line, "foo");
+    EXPECT_EQ(no_eol | bio::views::take_line, "foo");
+    EXPECT_EQ(std::string_view{} | bio::views::take_line, "");
+
+    EXPECT_EQ(unix_eol | bio::views::take_line_or_throw, "foo");
+    EXPECT_THROW(no_eol | bio::views::take_line_or_throw, std::runtime_error);
+
+    // long line that exercises the vectorised search
+    std::string long_line(1000, 'A');
+    long_line += "\r\n";
+    EXPECT_EQ((long_line | bio::views::take_line).size(), 1000u);
+}
+
+TEST(view_take_line, forward)
+{
+    std::list<char> lst;
+    for (char c : std::string_view{"foo\r\nbar"})
+        lst.push_back(c);
+
+    EXPECT_RANGE_EQ(lst | bio::views::take_line, std::string_view{"foo"});
+    EXPECT_RANGE_EQ(lst | bio::views::take_line_or_throw, std::string_view{"foo"});
+
+    // forward ranges are not modified
+    EXPECT_EQ(lst.size(), 8u);
+}
+
+TEST(view_take_line, single_pass_consume)
+{
+    std::string str{"foo\nbar\r\n\nbaz\r\nbat"};
+    auto        in = str | bio::views::single_pass_input;
+
+    EXPECT_RANGE_EQ(in | bio::views::take_line, std::string_view{"foo"});
+    EXPECT_RANGE_EQ(in | bio::views::take_line, std::string_view{"bar"});
+    EXPECT_RANGE_EQ(in | bio::views::take_line, std::string_view{""});
+    EXPECT_RANGE_EQ(in | bio::views::take_line, std::string_view{"baz"});
+    EXPECT_THROW((in | bio::views::take_line_or_throw | bio::ranges::to<std::string>()), std::runtime_error);
+
+    std::string str2{"foo\r\nbar"};
+    auto        in2 = str2 | bio::views::single_pass_input;
+    EXPECT_RANGE_EQ(in2 | bio::views::take_line, std::string_view{"foo"});
+    EXPECT_RANGE_EQ(in2 | bio::views::take_line, std::string_view{"bar"});
+    EXPECT_TRUE(std::ranges::begin(in2) == std::ranges::end(in2));
+}
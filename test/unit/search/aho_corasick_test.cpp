@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/search/aho_corasick.hpp>
+
+using namespace bio::alphabet::literals;
+using bio::search::aho_corasick_hit;
+
+// hits sorted by end position, then by decreasing length, then pattern
+template <typename patterns_t, typename text_t>
+static std::vector<aho_corasick_hit> naive_find(patterns_t const & patterns, text_t const & text)
+{
+    std::vector<aho_corasick_hit> ret;
+    for (uint32_t p = 0; p < patterns.size(); ++p)
+        for (size_t s = 0; s + patterns[p].size() <= text.size(); ++s)
+            if (std::equal(patterns[p].begin(), patterns[p].end(), text.begin() + s))
+                ret.push_back({s, p});
+
+    std::ranges::sort(ret,
+                      [&](aho_corasick_hit const & l, aho_corasick_hit const & r)
+                      {
+                          size_t const l_end = l.position + patterns[l.pattern].size();
+                          size_t const r_end = r.position + patterns[r.pattern].size();
+                          if (l_end != r_end)
+                              return l_end < r_end;
+                          if (l.position != r.position)
+                              return l.position < r.position;
+                          return l.pattern < r.pattern;
+                      });
+    return ret;
+}
+
+TEST(aho_corasick, find)
+{
+    // the classic example: he, she, his, hers over {A, C, G, T}
+    std::vector<bio::alphabet::dna4_vector> const patterns{"AC"_dna4, "TAC"_dna4, "AGT"_dna4, "ACGT"_dna4};
+    bio::search::aho_corasick                     ac{patterns};
+    EXPECT_EQ(ac.size(), 4u);
+    EXPECT_EQ(ac.states(), 10u);
+
+    auto const text = "TACGTAGTAC"_dna4;
+    EXPECT_EQ(ac.find(text),
+              (std::vector<aho_corasick_hit>{{0, 1}, {1, 0}, {1, 3}, {5, 2}, {7, 1}, {8, 0}}));
+    EXPECT_EQ(ac.find(text), naive_find(patterns, text));
+}
+
+TEST(aho_corasick, duplicates_and_errors)
+{
+    std::vector<bio::alphabet::dna5_vector> const patterns{"NA"_dna5, "A"_dna5, "NA"_dna5};
+    bio::search::aho_corasick                     ac{patterns};
+    EXPECT_EQ(ac.find("NNAN"_dna5), (std::vector<aho_corasick_hit>{{1, 0}, {1, 2}, {2, 1}}));
+
+    EXPECT_THROW(bio::search::aho_corasick{std::vector<bio::alphabet::dna4_vector>{}}, std::invalid_argument);
+    EXPECT_THROW((bio::search::aho_corasick{std::vector<bio::alphabet::dna4_vector>{"A"_dna4, {}}}),
+                 std::invalid_argument);
+}
+
+TEST(aho_corasick, streaming)
+{
+    std::vector<bio::alphabet::dna4_vector> const patterns{"ACGT"_dna4, "GTA"_dna4};
+    bio::search::aho_corasick                     ac{patterns};
+
+    std::vector<aho_corasick_hit>    hits;
+    bio::search::aho_corasick_cursor cursor{};
+    for (auto const & piece : {"TAC"_dna4, "G"_dna4, "TA"_dna4, "CGTA"_dna4})
+    {
+        // a single-pass view
+        ac.find(piece | std::views::filter([](auto) { return true; }),
+                cursor,
+                [&](aho_corasick_hit const & hit) { hits.push_back(hit); });
+    }
+    EXPECT_EQ(cursor.position, 10u);
+    EXPECT_EQ(hits, naive_find(patterns, "TACGTACGTA"_dna4));
+}
+
+TEST(aho_corasick, random)
+{
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> letter{0, 4};
+
+    bio::alphabet::dna5_vector text(10'000);
+    for (auto & l : text)
+        l.assign_rank(letter(gen));
+
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> patterns;
+    for (size_t i = 0; i < 3000; ++i) // large enough for find_each() to interleave texts
+    {
+        size_t const m = 1 + gen() % 12;
+        size_t const s = gen() % (text.size() - m);
+        patterns.push_back(text | std::views::drop(s) | std::views::take(m));
+    }
+
+    bio::search::aho_corasick ac{patterns};
+    EXPECT_EQ(ac.find(text), naive_find(patterns, text));
+
+    // many texts of different lengths
+    bio::ranges::concatenated_sequences<bio::alphabet::dna5_vector> texts;
+    for (size_t i = 0; i < 21; ++i)
+        texts.push_back(text | std::views::drop(i * 300) | std::views::take(i * 37 % 300));
+
+    std::vector<std::vector<aho_corasick_hit>> hits(texts.size());
+    ac.find_each(texts, [&](size_t const t, aho_corasick_hit const & hit) { hits[t].push_back(hit); });
+    for (size_t t = 0; t < texts.size(); ++t)
+        EXPECT_EQ(hits[t], naive_find(patterns, texts[t])) << t;
+}
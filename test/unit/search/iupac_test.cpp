@@ -0,0 +1,140 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna15.hpp>
+#include <bio/alphabet/nucleotide/dna16sam.hpp>
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/alphabet/nucleotide/rna15.hpp>
+#include <bio/search/iupac.hpp>
+
+using namespace bio::alphabet::literals;
+
+template <typename pattern_t, typename text_t>
+static std::vector<size_t> naive_find(pattern_t const & pattern, text_t const & text, bool const strict)
+{
+    std::vector<size_t> ret;
+    for (size_t s = 0; s + pattern.size() <= text.size(); ++s)
+    {
+        bool match = true;
+        for (size_t j = 0; j < pattern.size() && match; ++j)
+        {
+            uint8_t const p = bio::search::base_set(pattern[j]);
+            uint8_t const t = bio::search::base_set(text[s + j]);
+            match           = strict ? t != 0 && (t & ~p) == 0 : (t & p) != 0;
+        }
+        if (match)
+            ret.push_back(s);
+    }
+    return ret;
+}
+
+TEST(iupac, base_set)
+{
+    EXPECT_EQ(bio::search::base_set('A'_dna4), 0b0001);
+    EXPECT_EQ(bio::search::base_set('T'_dna5), 0b1000);
+    EXPECT_EQ(bio::search::base_set('N'_dna5), 0b1111);
+    EXPECT_EQ(bio::search::base_set('R'_dna15), 0b0101);
+    EXPECT_EQ(bio::search::base_set('B'_dna15), 0b1110);
+    EXPECT_EQ(bio::search::base_set('Y'_rna15), 0b1010);
+    EXPECT_EQ(bio::search::base_set('='_dna16sam), 0);
+    EXPECT_EQ(bio::search::base_set('V'_dna16sam), 0b0111);
+}
+
+TEST(iupac, find)
+{
+    // EcoRII site CCWGG
+    EXPECT_EQ(bio::search::find_iupac("CCWGG"_dna15, "ACCAGGTCCTGGCCCGG"_dna5), (std::vector<size_t>{1, 7}));
+    EXPECT_EQ(bio::search::find_iupac("NN"_dna15, "ACG"_dna4), (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(bio::search::find_iupac("ACGTA"_dna15, "ACG"_dna4), (std::vector<size_t>{}));
+    EXPECT_EQ(bio::search::find_iupac("AA"_dna4, "AAAA"_dna4), (std::vector<size_t>{0, 1, 2}));
+    EXPECT_THROW(bio::search::iupac_finder{bio::alphabet::dna15_vector{}}, std::invalid_argument);
+}
+
+TEST(iupac, strict_text)
+{
+    bio::alphabet::dna5_vector const text = "ACNNNTACGT"_dna5;
+    EXPECT_EQ(bio::search::find_iupac("ACG"_dna4, text), (std::vector<size_t>{0, 2, 6}));
+    EXPECT_EQ(bio::search::find_iupac("ACG"_dna4, text, {.strict_text = true}), (std::vector<size_t>{6}));
+    EXPECT_EQ(bio::search::find_iupac("ACN"_dna15, text, {.strict_text = true}), (std::vector<size_t>{0, 6}));
+}
+
+TEST(iupac, single_pass)
+{
+    bio::alphabet::dna5_vector const text = "ACCGTTTCGTA"_dna5;
+    auto                             view = text | std::views::filter([](auto) { return true; });
+    bio::search::iupac_finder        finder{"YCG"_dna15};
+
+    std::vector<size_t> hits;
+    finder.find(view, [&](size_t const p) { hits.push_back(p); });
+    EXPECT_EQ(hits, (std::vector<size_t>{1, 6}));
+}
+
+// a sentinel that cannot be subtracted from the iterator
+struct unsized_sentinel
+{
+    bio::alphabet::dna5_vector::const_iterator last;
+
+    friend bool operator==(bio::alphabet::dna5_vector::const_iterator const & it, unsized_sentinel const & s)
+    {
+        return it == s.last;
+    }
+};
+
+TEST(iupac, unsized_sentinel)
+{
+    // random access and sized, but without a sized sentinel
+    using it_t     = bio::alphabet::dna5_vector::const_iterator;
+    using sentinel = unsized_sentinel;
+
+    bio::alphabet::dna5_vector const text = "ACCGTTTCGTA"_dna5;
+    std::ranges::subrange<it_t, sentinel, std::ranges::subrange_kind::sized> const view{text.begin(),
+                                                                                       sentinel{text.end()},
+                                                                                       text.size()};
+    static_assert(std::ranges::random_access_range<decltype(view)> && std::ranges::sized_range<decltype(view)>);
+    static_assert(!std::sized_sentinel_for<sentinel, it_t>);
+
+    EXPECT_EQ(bio::search::find_iupac("YCG"_dna15, view), (std::vector<size_t>{1, 6}));
+}
+
+TEST(iupac, random)
+{
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> ambiguous{0, 14};
+    std::uniform_int_distribution<int> base{0, 3};
+
+    // long enough for several chunks
+    std::vector<bio::alphabet::dna16sam> text(70'000);
+    for (auto & t : text)
+        t.assign_rank(gen() % 50 == 0 ? gen() % 16 : std::array{1, 2, 4, 8}[base(gen)]);
+
+    for (size_t m : {1, 2, 5, 13, 40, 100})
+    {
+        bio::alphabet::dna15_vector pattern(m);
+        for (auto & p : pattern)
+            p.assign_rank(ambiguous(gen) < 4 ? ambiguous(gen) : std::array{0, 2, 4, 11}[base(gen)]);
+
+        // plant hits, also across chunk boundaries
+        for (size_t s : {size_t{0}, size_t{16384 - m / 2}, size_t{32768 - 1}, text.size() - m})
+            for (size_t j = 0; j < m; ++j)
+                text[s + j] = bio::alphabet::dna16sam{}.assign_char(pattern[j].to_char() == 'N' ? 'A'
+                                                                                               : pattern[j].to_char());
+
+        for (bool strict : {false, true})
+        {
+            auto const expected = naive_find(pattern, text, strict);
+            EXPECT_GE(expected.size(), 4u);
+            EXPECT_EQ(bio::search::find_iupac(pattern, text, {.strict_text = strict}), expected) << m;
+        }
+    }
+}
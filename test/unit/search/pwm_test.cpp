@@ -0,0 +1,214 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/search/pwm.hpp>
+
+using namespace bio::alphabet::literals;
+using bio::search::position_weight_matrix;
+using bio::search::pwm_hit;
+
+// scores in multiples of 1/4, so that all sums are exact
+static std::vector<position_weight_matrix> random_motifs(std::mt19937_64 & gen, size_t const count)
+{
+    std::vector<position_weight_matrix> ret;
+    for (size_t i = 0; i < count; ++i)
+    {
+        position_weight_matrix motif;
+        motif.scores.resize(1 + gen() % 20);
+        float best = 0.0f;
+        for (auto & column : motif.scores)
+        {
+            for (float & s : column)
+                s = static_cast<int>(gen() % 17) / 4.0f - 2.0f;
+            best += std::ranges::max(column);
+        }
+        motif.threshold = best - static_cast<float>(motif.scores.size()) * 0.75f; // a few hits per kbp
+        ret.push_back(motif);
+    }
+    return ret;
+}
+
+// score every window of the forward and reverse strand
+template <typename alph_t>
+static std::vector<pwm_hit> naive_scan(std::vector<position_weight_matrix> const & motifs,
+                                       std::vector<alph_t> const &                 text,
+                                       bool const                                  both_strands)
+{
+    std::vector<pwm_hit> ret;
+    for (size_t p = 0; p < text.size(); ++p)
+    {
+        for (uint32_t m = 0; m < motifs.size(); ++m)
+        {
+            std::vector<std::array<float, 4>> const & scores = motifs[m].scores;
+            if (p + scores.size() > text.size())
+                continue;
+
+            bool  valid = true;
+            float fwd = 0.0f, rev = 0.0f;
+            for (size_t j = 0; j < scores.size(); ++j)
+            {
+                char const   c = bio::alphabet::to_char(text[p + j]);
+                size_t const r = c == 'A' ? 0 : c == 'C' ? 1 : c == 'G' ? 2 : c == 'T' ? 3 : 4;
+                valid &= r < 4;
+                if (r < 4)
+                {
+                    fwd += scores[j][r];
+                    rev += scores[scores.size() - 1 - j][3 - r];
+                }
+            }
+
+            if (valid && fwd >= motifs[m].threshold)
+                ret.push_back({p, m, false, fwd});
+            if (valid && both_strands && rev >= motifs[m].threshold)
+                ret.push_back({p, m, true, rev});
+        }
+    }
+    return ret;
+}
+
+TEST(pwm, construction)
+{
+    EXPECT_THROW((bio::search::pwm_scanner{std::vector<position_weight_matrix>{{}}}), std::invalid_argument);
+    EXPECT_THROW((bio::search::pwm_scanner{std::vector<position_weight_matrix>{
+                   {.scores = {{0.0f, std::numeric_limits<float>::infinity(), 0.0f, 0.0f}}}}}),
+                 std::invalid_argument);
+    EXPECT_THROW((bio::search::pwm_scanner{std::vector<position_weight_matrix>{
+                   {.scores = {{0.0f, std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f}}}}}),
+                 std::invalid_argument);
+
+    std::mt19937_64          gen{1};
+    bio::search::pwm_scanner scanner{random_motifs(gen, 3), {.both_strands = false}};
+    EXPECT_EQ(scanner.size(), 3u);
+    EXPECT_FALSE(scanner.options().both_strands);
+
+    EXPECT_TRUE(scanner.scan(""_dna4).empty());
+    EXPECT_TRUE(bio::search::pwm_scanner{std::vector<position_weight_matrix>{}}.scan("ACGT"_dna4).empty());
+}
+
+TEST(pwm, strands)
+{
+    // ACG scores 3, its reverse complement CGT scores 3 on the reverse strand
+    std::vector<position_weight_matrix> const motifs{
+      {.scores = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}, .threshold = 3}};
+
+    EXPECT_EQ(bio::search::scan_pwm(motifs, "TTACGTT"_dna4),
+              (std::vector<pwm_hit>{{2, 0, false, 3.0f}, {3, 0, true, 3.0f}}));
+    EXPECT_EQ(bio::search::scan_pwm(motifs, "TTACGTT"_dna4, {.both_strands = false}),
+              (std::vector<pwm_hit>{{2, 0, false, 3.0f}}));
+
+    // windows with ambiguous letters are not reported
+    EXPECT_TRUE(bio::search::scan_pwm(motifs, "TTANGTT"_dna5).empty());
+    EXPECT_EQ(bio::search::scan_pwm(motifs, "ACGNACG"_dna5),
+              (std::vector<pwm_hit>{{0, 0, false, 3.0f}, {4, 0, false, 3.0f}}));
+}
+
+TEST(pwm, matches_naive)
+{
+    std::mt19937_64 gen{2};
+
+    // longer than a chunk, so that windows span chunk boundaries
+    bio::alphabet::dna4_vector text(30'000);
+    for (auto & l : text)
+        l.assign_rank(gen() % 4);
+
+    for (bool const both_strands : {true, false})
+    {
+        std::vector<position_weight_matrix> const motifs = random_motifs(gen, 20);
+        std::vector<pwm_hit> const                expected = naive_scan(motifs, text, both_strands);
+        ASSERT_GT(expected.size(), 100u);
+
+        bio::search::pwm_scanner scanner{motifs, {.both_strands = both_strands}};
+        EXPECT_EQ(scanner.scan(text), expected);
+
+        // a second text with the same scanner, and an input range
+        bio::alphabet::dna4_vector const prefix(text.begin(), text.begin() + 9'000);
+        auto                             input = prefix | std::views::filter([](auto) { return true; });
+        EXPECT_EQ(scanner.scan(input), naive_scan(motifs, prefix, both_strands));
+    }
+}
+
+// a sentinel that cannot be subtracted from the iterator
+struct unsized_sentinel
+{
+    bio::alphabet::dna4_vector::const_iterator last;
+
+    friend bool operator==(bio::alphabet::dna4_vector::const_iterator const & it, unsized_sentinel const & s)
+    {
+        return it == s.last;
+    }
+};
+
+TEST(pwm, unsized_sentinel)
+{
+    // random access and sized, but without a sized sentinel
+    using it_t     = bio::alphabet::dna4_vector::const_iterator;
+    using sentinel = unsized_sentinel;
+
+    std::vector<position_weight_matrix> const motifs{
+      {.scores = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}, .threshold = 3}};
+
+    bio::alphabet::dna4_vector const text = "TTACGTT"_dna4;
+    std::ranges::subrange<it_t, sentinel, std::ranges::subrange_kind::sized> const view{text.begin(),
+                                                                                       sentinel{text.end()},
+                                                                                       text.size()};
+    static_assert(!std::sized_sentinel_for<sentinel, it_t>);
+
+    EXPECT_EQ(bio::search::scan_pwm(motifs, view), bio::search::scan_pwm(motifs, text));
+    EXPECT_EQ(bio::search::scan_pwm(motifs, view).size(), 2u);
+}
+
+TEST(pwm, ambiguous_text)
+{
+    std::mt19937_64            gen{3};
+    bio::alphabet::dna5_vector text(20'000);
+    for (auto & l : text)
+        l = bio::alphabet::dna5{}.assign_char("ACGTN"[gen() % 100 == 0 ? 4 : gen() % 4]);
+
+    std::vector<position_weight_matrix> const motifs = random_motifs(gen, 10);
+    EXPECT_EQ(bio::search::scan_pwm(motifs, text), naive_scan(motifs, text, true));
+}
+
+TEST(pwm, callback)
+{
+    std::mt19937_64            gen{4};
+    bio::alphabet::dna4_vector text(20'000);
+    for (auto & l : text)
+        l.assign_rank(gen() % 4);
+
+    std::vector<position_weight_matrix> const motifs = random_motifs(gen, 5);
+    bio::search::pwm_scanner                  scanner{motifs};
+
+    std::vector<pwm_hit> hits;
+    scanner.scan(text, [&](pwm_hit const & hit) { hits.push_back(hit); });
+
+    // every hit once; increasing positions for each matrix and strand
+    std::vector<pwm_hit> const sorted = scanner.scan(text);
+    EXPECT_TRUE(std::ranges::is_permutation(hits, sorted));
+    for (uint32_t m = 0; m < motifs.size(); ++m)
+    {
+        for (bool const reverse : {false, true})
+        {
+            std::vector<size_t> positions;
+            for (pwm_hit const & hit : hits)
+                if (hit.motif == m && hit.reverse == reverse)
+                    positions.push_back(hit.position);
+            EXPECT_TRUE(std::ranges::is_sorted(positions));
+        }
+    }
+}
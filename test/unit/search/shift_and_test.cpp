@@ -0,0 +1,122 @@
+// -----------------------------------------------------------------------------------------------------
+// Copyright (c) 2022 deCODE Genetics
+// This file may be used, modified and/or redistributed under the terms of the 3-clause BSD-License
+// shipped with this file and also available at: https://github.com/biocpp/biocpp-core/blob/main/LICENSE.md
+// -----------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <bio/alphabet/nucleotide/dna4.hpp>
+#include <bio/alphabet/nucleotide/dna5.hpp>
+#include <bio/ranges/container/bitcompressed_vector.hpp>
+#include <bio/ranges/container/concatenated_sequences.hpp>
+#include <bio/search/shift_and.hpp>
+
+using namespace bio::alphabet::literals;
+using bio::search::shift_and_hit;
+
+// hits sorted by end position, then pattern
+template <typename patterns_t, typename text_t>
+static std::vector<shift_and_hit> naive_find(patterns_t const & patterns, text_t const & text, size_t const k)
+{
+    std::vector<std::pair<size_t, shift_and_hit>> hits;
+    for (uint32_t p = 0; p < patterns.size(); ++p)
+    {
+        size_t const m = patterns[p].size();
+        for (size_t s = 0; s + m <= text.size(); ++s)
+        {
+            size_t d = 0;
+            for (size_t j = 0; j < m; ++j)
+                d += patterns[p][j] != text[s + j];
+            if (d <= k)
+                hits.push_back({s + m - 1, shift_and_hit{s, p, static_cast<uint8_t>(d)}});
+        }
+    }
+    std::ranges::sort(hits,
+                      [](auto const & l, auto const & r)
+                      { return l.first != r.first ? l.first < r.first : l.second.pattern < r.second.pattern; });
+
+    std::vector<shift_and_hit> ret;
+    for (auto const & [end, hit] : hits)
+        ret.push_back(hit);
+    return ret;
+}
+
+TEST(shift_and, single)
+{
+    auto const text = "ACGTACGAACGT"_dna4;
+    EXPECT_EQ(bio::search::find_shift_and("ACGT"_dna4, text),
+              (std::vector<shift_and_hit>{{0, 0, 0}, {8, 0, 0}}));
+    EXPECT_EQ(bio::search::find_shift_and("ACGT"_dna4, text, {.max_mismatches = 1}),
+              (std::vector<shift_and_hit>{{0, 0, 0}, {4, 0, 1}, {8, 0, 0}}));
+    EXPECT_EQ(bio::search::find_shift_and("ACGTACGTACGTACGT"_dna4, text), (std::vector<shift_and_hit>{}));
+    EXPECT_THROW(bio::search::find_shift_and(bio::alphabet::dna4_vector{}, text), std::invalid_argument);
+}
+
+TEST(shift_and, batch)
+{
+    std::vector<bio::alphabet::dna5_vector> const patterns{"ACG"_dna5, "CGT"_dna5, "N"_dna5, "GTNA"_dna5};
+    bio::search::shift_and                        finder{patterns};
+    EXPECT_EQ(finder.size(), 4u);
+    EXPECT_EQ(finder.state_words(), 1u);
+
+    auto const text = "ACGTNAN"_dna5;
+    EXPECT_EQ(finder.find(text), naive_find(patterns, text, 0));
+    EXPECT_EQ(finder.find(text).size(), 5u);
+}
+
+TEST(shift_and, bitcompressed_and_views)
+{
+    std::vector<bio::alphabet::dna4_vector> const          patterns{"ACG"_dna4};
+    bio::ranges::bitcompressed_vector<bio::alphabet::dna4> text{"TTACGTTACGAT"_dna4};
+    bio::search::shift_and                                 finder{patterns, {.max_mismatches = 1}};
+
+    auto const expected = naive_find(patterns, "TTACGTTACGAT"_dna4, 1);
+    EXPECT_EQ(finder.find(text), expected);
+
+    std::vector<shift_and_hit> hits;
+    finder.find(text | std::views::filter([](auto) { return true; }),
+                [&](shift_and_hit const & hit) { hits.push_back(hit); });
+    EXPECT_EQ(hits, expected);
+}
+
+TEST(shift_and, random)
+{
+    std::mt19937                       gen{42};
+    std::uniform_int_distribution<int> letter{0, 3};
+
+    bio::alphabet::dna4_vector text(20'000);
+    for (auto & l : text)
+        l.assign_rank(letter(gen));
+
+    for (std::vector<size_t> const & lengths : std::vector<std::vector<size_t>>{{1},
+                                                                              {12},
+                                                                              {64},
+                                                                              {65},
+                                                                              {150},
+                                                                              {8, 8, 8, 8, 8, 8, 8, 8},
+                                                                              {30, 30, 30},
+                                                                              {5, 70, 3, 64, 11}})
+    {
+        bio::ranges::concatenated_sequences<bio::alphabet::dna4_vector> patterns;
+        for (size_t const m : lengths)
+        {
+            size_t const               s = gen() % (text.size() - m);
+            bio::alphabet::dna4_vector pattern(text.begin() + s, text.begin() + s + m);
+            pattern[gen() % m].assign_rank(letter(gen)); // possibly one mismatch
+            patterns.push_back(pattern);
+        }
+
+        for (size_t k : {0, 1, 3})
+        {
+            bio::search::shift_and finder{patterns, {.max_mismatches = k}};
+            auto const             expected = naive_find(patterns, text, k);
+            EXPECT_EQ(finder.find(text), expected) << lengths.size() << ' ' << lengths[0] << ' ' << k;
+        }
+    }
+}